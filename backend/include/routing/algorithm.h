@@ -3,8 +3,11 @@
 #include "routing/edges/basic_edge.h"
 #include "routing/vertices/basic_vertex.h"
 #include "routing/types.h"
+#include "routing/query/alternative_route_parameters.h"
+#include "routing/utility/deadline.h"
                                    
 #include <vector>
+#include <cstddef>
 
 namespace routing {
 
@@ -27,6 +30,24 @@ namespace routing {
          */
         Algorithm(typename Implementation::Graph& graph) : impl_(graph) {}
 
+        /**
+         * Forward `graph` to implementation class as reference.
+         *
+         * @param graph Graph where routing happens.
+         * @param length Provides lengths of graph edges for this search.
+         */
+        Algorithm(typename Implementation::Graph& graph, const typename Implementation::EdgeLength& length) : impl_(graph, length) {}
+
+        /**
+         * Forward `graph` to implementation class as reference.
+         *
+         * @param graph Graph where routing happens.
+         * @param length Provides lengths of graph edges for this search.
+         * @param workspace Memory of the implementation that is reused by consecutive searches.
+         */
+        Algorithm(typename Implementation::Graph& graph, const typename Implementation::EdgeLength& length, typename Implementation::Workspace* workspace)
+            : impl_(graph, length, workspace) {}
+
         /**
          * Find the best route from `start_node` to `end_node`.
          *
@@ -47,6 +68,37 @@ namespace routing {
             return impl_.GetRoute();
         }
 
+        /**
+         * Number of vertices settled by the last search.
+         */
+        size_t GetSettledVertexCount() const {
+            return impl_.GetSettledVertexCount();
+        }
+
+        /**
+         * Stop searches by TimeoutException when `deadline` expires. Null deadline is never checked.
+         */
+        void SetDeadline(const utility::Deadline* deadline) {
+            impl_.SetDeadline(deadline);
+        }
+
+        /**
+         * Find the best route from `start_node` to `end_node` and search further so that alternative routes can be retrieved.
+         *
+         * @param parameters Limits of admissible alternative routes.
+         */
+        void RunAlternatives(unsigned_id_type start_node, unsigned_id_type end_node, const query::AlternativeRouteParameters& parameters) {
+            impl_.RunAlternatives(start_node, end_node, parameters);
+        }
+
+        /**
+         * Get at most `max_count` alternative routes of the last `RunAlternatives` ordered by their length.
+         * The shortest route is not included - it is returned by `GetRoute`.
+         */
+        std::vector<std::vector<typename Implementation::Edge>> GetAlternativeRoutes(size_t max_count) {
+            return impl_.GetAlternativeRoutes(max_count);
+        }
+
     };
 
 }
@@ -0,0 +1,218 @@
+#ifndef ROUTING_BENCH_BENCH_REPORT_H
+#define ROUTING_BENCH_BENCH_REPORT_H
+
+#include "routing/query/router_metrics.h"
+#include "routing/utility/json_writer.h"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+namespace routing {
+namespace bench {
+
+/**
+ * Summed duration and number of observations of one stage of route calculations.
+ */
+struct StageTotal {
+    double sum;
+    uint64_t count;
+
+    StageTotal() : sum(0), count(0) {}
+
+    StageTotal(double s, uint64_t c) : sum(s), count(c) {}
+};
+
+/**
+ * Totals of stages measured by RouterMetrics keyed by the stage name.
+ */
+using StageTotals = std::map<std::string, StageTotal>;
+
+inline StageTotals GetStageTotals(const query::RouterMetrics& metrics) {
+    return StageTotals{
+        {"snapping", StageTotal{metrics.snapping.GetSum(), metrics.snapping.GetCount()}},
+        {"endpoints", StageTotal{metrics.endpoints.GetSum(), metrics.endpoints.GetCount()}},
+        {"search", StageTotal{metrics.search.GetSum(), metrics.search.GetCount()}},
+        {"unpacking", StageTotal{metrics.unpacking.GetSum(), metrics.unpacking.GetCount()}},
+        {"geometry", StageTotal{metrics.geometry.GetSum(), metrics.geometry.GetCount()}}
+    };
+}
+
+/**
+ * Read stage totals from the /metrics response of the routing server.
+ */
+inline StageTotals ParseStageTotals(const std::string& prometheus_text) {
+    static const std::string kSumPrefix = "routing_stage_duration_seconds_sum{stage=\"";
+    static const std::string kCountPrefix = "routing_stage_duration_seconds_count{stage=\"";
+    StageTotals totals{};
+    std::istringstream in{prometheus_text};
+    std::string line{};
+    while (std::getline(in, line)) {
+        bool is_sum = line.compare(0, kSumPrefix.size(), kSumPrefix) == 0;
+        bool is_count = line.compare(0, kCountPrefix.size(), kCountPrefix) == 0;
+        if (!is_sum && !is_count) {
+            continue;
+        }
+        size_t name_begin = is_sum ? kSumPrefix.size() : kCountPrefix.size();
+        size_t name_end = line.find('"', name_begin);
+        size_t value_begin = line.find(' ', name_end);
+        if (name_end == std::string::npos || value_begin == std::string::npos) {
+            continue;
+        }
+        auto&& total = totals[line.substr(name_begin, name_end - name_begin)];
+        if (is_sum) {
+            total.sum = std::stod(line.substr(value_begin + 1));
+        } else {
+            total.count = std::stoull(line.substr(value_begin + 1));
+        }
+    }
+    return totals;
+}
+
+/**
+ * Totals of the stages observed between `before` and `after` snapshots of the same metrics.
+ */
+inline StageTotals SubtractStageTotals(const StageTotals& after, const StageTotals& before) {
+    StageTotals difference{after};
+    for (auto&& [stage, total] : before) {
+        auto&& it = difference.find(stage);
+        if (it != difference.end()) {
+            it->second.sum -= total.sum;
+            it->second.count -= std::min(it->second.count, total.count);
+        }
+    }
+    return difference;
+}
+
+/**
+ * Nearest-rank percentile of `sorted` latencies.
+ *
+ * @param percentile Percentile in (0, 100].
+ */
+inline double GetPercentile(const std::vector<double>& sorted, double percentile) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100 * sorted.size()));
+    return sorted[std::min(std::max(rank, size_t{1}), sorted.size()) - 1];
+}
+
+/**
+ * BenchResult summarizes one run of a workload. Latencies are in seconds.
+ */
+struct BenchResult {
+    /**
+     * Name of the run, e.g. the mode and the build, so that results of more runs can be compared.
+     */
+    std::string label;
+    size_t concurrency;
+
+    /**
+     * Latencies of successful queries in increasing order.
+     */
+    std::vector<double> latencies;
+    size_t errors;
+    double wall_seconds;
+    StageTotals stages;
+
+    BenchResult(std::string&& l, size_t c, std::vector<double>&& lat, size_t e, double ws, StageTotals&& s)
+        : label(std::move(l)), concurrency(c), latencies(std::move(lat)), errors(e), wall_seconds(ws), stages(std::move(s)) {
+        std::sort(latencies.begin(), latencies.end());
+    }
+
+    size_t GetQueryCount() const {
+        return latencies.size() + errors;
+    }
+
+    /**
+     * Queries per second including failed ones.
+     */
+    double GetThroughput() const {
+        return wall_seconds > 0 ? GetQueryCount() / wall_seconds : 0;
+    }
+
+    double GetMeanLatency() const {
+        double sum = 0;
+        for (double latency : latencies) {
+            sum += latency;
+        }
+        return latencies.empty() ? 0 : sum / latencies.size();
+    }
+};
+
+/**
+ * Mean duration of a stage in ms per observation.
+ */
+inline double GetMeanMs(const StageTotal& total) {
+    return total.count > 0 ? total.sum / total.count * 1000 : 0;
+}
+
+/**
+ * Write CSV header and one row of the result. Stage columns are mean ms of each stage.
+ */
+inline void WriteCsv(std::ostream& out, const BenchResult& result) {
+    out << "label,queries,errors,concurrency,wall_seconds,throughput_qps,mean_ms,p50_ms,p95_ms,p99_ms,max_ms";
+    for (auto&& [stage, total] : result.stages) {
+        out << "," << stage << "_ms";
+    }
+    out << "\n";
+    auto&& ms = [&](double percentile) {
+        return GetPercentile(result.latencies, percentile) * 1000;
+    };
+    out << result.label << "," << result.GetQueryCount() << "," << result.errors << "," << result.concurrency << "," << result.wall_seconds << ","
+        << result.GetThroughput() << "," << result.GetMeanLatency() * 1000 << "," << ms(50) << "," << ms(95) << "," << ms(99) << "," << ms(100);
+    for (auto&& [stage, total] : result.stages) {
+        out << "," << GetMeanMs(total);
+    }
+    out << "\n";
+}
+
+inline void WriteJson(std::ostream& out, const BenchResult& result) {
+    std::string json{};
+    utility::JsonWriter writer{json};
+    writer.BeginObject();
+    writer.Key("label");
+    writer.String(result.label);
+    writer.Key("queries");
+    writer.Number(result.GetQueryCount());
+    writer.Key("errors");
+    writer.Number(result.errors);
+    writer.Key("concurrency");
+    writer.Number(result.concurrency);
+    writer.Key("wall_seconds");
+    writer.Number(result.wall_seconds);
+    writer.Key("throughput_qps");
+    writer.Number(result.GetThroughput());
+    writer.Key("latency_ms");
+    writer.BeginObject();
+    writer.Key("mean");
+    writer.Number(result.GetMeanLatency() * 1000);
+    writer.Key("p50");
+    writer.Number(GetPercentile(result.latencies, 50) * 1000);
+    writer.Key("p95");
+    writer.Number(GetPercentile(result.latencies, 95) * 1000);
+    writer.Key("p99");
+    writer.Number(GetPercentile(result.latencies, 99) * 1000);
+    writer.Key("max");
+    writer.Number(GetPercentile(result.latencies, 100) * 1000);
+    writer.EndObject();
+    writer.Key("stages_ms");
+    writer.BeginObject();
+    for (auto&& [stage, total] : result.stages) {
+        writer.Key(stage.c_str());
+        writer.Number(GetMeanMs(total));
+    }
+    writer.EndObject();
+    writer.EndObject();
+    out << json << "\n";
+}
+
+}
+}
+#endif //ROUTING_BENCH_BENCH_REPORT_H
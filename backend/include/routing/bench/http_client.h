@@ -0,0 +1,58 @@
+#ifndef ROUTING_BENCH_HTTP_CLIENT_H
+#define ROUTING_BENCH_HTTP_CLIENT_H
+
+#include <string>
+
+namespace routing {
+namespace bench {
+
+/**
+ * HttpClient sends GET requests to one server over a kept-alive HTTP/1.1 connection.
+ * It is meant for load tests of the routing server - each thread of a test has its own client.
+ * The connection is opened again if the server closes it.
+ */
+class HttpClient {
+public:
+    HttpClient(const std::string& host, int port);
+
+    HttpClient(const HttpClient& other) = delete;
+    HttpClient& operator=(const HttpClient& other) = delete;
+
+    ~HttpClient();
+
+    /**
+     * Send GET request of `target` (path and query string) and read the response.
+     *
+     * @return Status code of the response. The body is stored to `body`.
+     * @throw std::runtime_error if the server cannot be reached or the response is malformed.
+     */
+    int Get(const std::string& target, std::string& body);
+
+    /**
+     * Percent-encode `value` so that it can be a query string parameter.
+     */
+    static std::string UrlEncode(const std::string& value);
+
+private:
+    std::string host_;
+    int port_;
+    int socket_;
+
+    void Connect();
+
+    void Close();
+
+    /**
+     * @return False if the connection was closed before the whole request was sent.
+     */
+    bool Send(const std::string& request);
+
+    /**
+     * Read data to `buffer` as long as it has less than `size` characters.
+     */
+    void ReadAtLeast(std::string& buffer, size_t size);
+};
+
+}
+}
+#endif //ROUTING_BENCH_HTTP_CLIENT_H
@@ -0,0 +1,175 @@
+#ifndef ROUTING_BENCH_WORKLOAD_H
+#define ROUTING_BENCH_WORKLOAD_H
+
+#include "routing/utility/point.h"
+#include "routing/utility/json_writer.h"
+#include "routing/exception.h"
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+
+namespace routing {
+namespace bench {
+
+/**
+ * Preferences of a profile - names of preference indices and their importances as in routing requests.
+ * Empty preferences route with the base index only.
+ */
+using Preferences = std::vector<std::pair<std::string, float>>;
+
+/**
+ * BenchQuery is one routing request of a workload.
+ */
+struct BenchQuery {
+    utility::Point source;
+    utility::Point target;
+    Preferences preferences;
+
+    BenchQuery(utility::Point s, utility::Point t, Preferences&& p) : source(s), target(t), preferences(std::move(p)) {}
+};
+
+/**
+ * Parse preferences written as `green:1|peak_distance:0.5`.
+ *
+ * @throw ParseException if an importance is missing or is not a number.
+ */
+inline Preferences ParsePreferences(const std::string& text) {
+    Preferences preferences{};
+    std::istringstream in{text};
+    std::string preference{};
+    while (std::getline(in, preference, '|')) {
+        if (preference.empty()) {
+            continue;
+        }
+        size_t colon = preference.find(':');
+        if (colon == std::string::npos) {
+            throw ParseException{"Preference `" + preference + "` has no importance."};
+        }
+        try {
+            preferences.emplace_back(preference.substr(0, colon), std::stof(preference.substr(colon + 1)));
+        } catch (const std::exception&) {
+            throw ParseException{"Preference `" + preference + "` has invalid importance."};
+        }
+    }
+    return preferences;
+}
+
+inline std::string WritePreferences(const Preferences& preferences) {
+    std::string text{};
+    for (auto&& preference : preferences) {
+        if (!text.empty()) {
+            text += '|';
+        }
+        char importance[32];
+        std::snprintf(importance, sizeof(importance), "%.9g", preference.second);
+        text += preference.first + ":" + importance;
+    }
+    return text;
+}
+
+/**
+ * Write preferences as the `profile` parameter of routing requests - [{"name": "green", "importance": 1}].
+ */
+inline std::string WriteProfileJson(const Preferences& preferences) {
+    std::string json{};
+    utility::JsonWriter writer{json};
+    writer.BeginArray();
+    for (auto&& preference : preferences) {
+        writer.BeginObject();
+        writer.Key("name");
+        writer.String(preference.first);
+        writer.Key("importance");
+        writer.Number(preference.second);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    return json;
+}
+
+/**
+ * Read workload with one query per line - `source_lon,source_lat,target_lon,target_lat,preferences`.
+ * Preferences are optional. Empty lines and lines starting with # are skipped.
+ *
+ * @throw ParseException if a line does not have four coordinates.
+ */
+inline std::vector<BenchQuery> ReadWorkload(std::istream& in) {
+    std::vector<BenchQuery> queries{};
+    std::string line{};
+    size_t line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields{line};
+        std::vector<std::string> values{};
+        std::string value{};
+        while (values.size() < 4 && std::getline(fields, value, ',')) {
+            values.push_back(value);
+        }
+        std::string preferences{};
+        std::getline(fields, preferences);
+        if (values.size() < 4) {
+            throw ParseException{"Workload line " + std::to_string(line_number) + " does not have four coordinates."};
+        }
+        std::vector<float> coordinates{};
+        try {
+            for (auto&& coordinate : values) {
+                coordinates.push_back(std::stof(coordinate));
+            }
+        } catch (const std::exception&) {
+            throw ParseException{"Workload line " + std::to_string(line_number) + " has invalid coordinates."};
+        }
+        queries.emplace_back(utility::Point{coordinates[0], coordinates[1]}, utility::Point{coordinates[2], coordinates[3]},
+            ParsePreferences(preferences));
+    }
+    return queries;
+}
+
+/**
+ * Write queries in the format of `ReadWorkload` so that a generated workload can be replayed.
+ */
+inline void WriteWorkload(std::ostream& out, const std::vector<BenchQuery>& queries) {
+    char coordinates[128];
+    for (auto&& query : queries) {
+        std::snprintf(coordinates, sizeof(coordinates), "%.7f,%.7f,%.7f,%.7f", query.source.lon_, query.source.lat_, query.target.lon_, query.target.lat_);
+        out << coordinates << "," << WritePreferences(query.preferences) << "\n";
+    }
+}
+
+/**
+ * Generate `count` queries with endpoints uniformly distributed between `min` and `max` corners.
+ * Preferences of each query are chosen from `profiles` in turn.
+ *
+ * The same seed generates the same workload with any standard library - random numbers are
+ * mapped to coordinates without std distributions whose results are implementation defined.
+ */
+inline std::vector<BenchQuery> GenerateWorkload(utility::Point min, utility::Point max, size_t count, const std::vector<Preferences>& profiles,
+    uint64_t seed) {
+    std::mt19937_64 generator{seed};
+    auto&& next = [&](float low, float high) {
+        // 53 random bits are a uniform double in [0, 1).
+        double unit = static_cast<double>(generator() >> 11) * (1.0 / 9007199254740992.0);
+        return static_cast<float>(low + (high - low) * unit);
+    };
+    std::vector<BenchQuery> queries{};
+    queries.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        utility::Point source{next(min.lon_, max.lon_), next(min.lat_, max.lat_)};
+        utility::Point target{next(min.lon_, max.lon_), next(min.lat_, max.lat_)};
+        queries.emplace_back(source, target, profiles.empty() ? Preferences{} : Preferences{profiles[i % profiles.size()]});
+    }
+    return queries;
+}
+
+}
+}
+#endif //ROUTING_BENCH_WORKLOAD_H
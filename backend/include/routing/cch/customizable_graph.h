@@ -0,0 +1,199 @@
+#ifndef ROUTING_CCH_CUSTOMIZABLE_GRAPH_H
+#define ROUTING_CCH_CUSTOMIZABLE_GRAPH_H
+
+#include "routing/types.h"
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace routing {
+namespace cch {
+
+/**
+ * CustomizableGraph is the metric independent part of Customizable Contraction Hierarchies.
+ *
+ * The base graph is contracted in a given (nested dissection) ordering without any witness searches
+ * so the result does not depend on edge lengths. Each pair of vertices connected in the contracted graph is
+ * an arc from the vertex with the lower rank to the vertex with the higher rank. Each arc has a forward
+ * length (from its lower vertex to its upper vertex) and a backward length. Lengths of arcs are computed
+ * by customization from base edge lengths of a profile and lower triangles of arcs - arc (u, w) is
+ * a shortcut of arcs (v, u) and (v, w) if v has a lower rank than both u and w.
+ *
+ * Arcs of each vertex are customized after all arcs of its lower neighbours. Vertices are therefore
+ * divided to levels (a vertex has higher level than all its lower neighbours) and all vertices of
+ * one level are customized in parallel.
+ *
+ * The graph is immutable after it is created so it can be customized concurrently for multiple profiles.
+ */
+class CustomizableGraph {
+public:
+    /**
+     * Edge of the base graph.
+     */
+    struct BaseEdge {
+        unsigned_id_type uid;
+        unsigned_id_type from;
+        unsigned_id_type to;
+        bool twoway;
+
+        BaseEdge(unsigned_id_type u, unsigned_id_type f, unsigned_id_type t, bool tw) : uid(u), from(f), to(t), twoway(tw) {}
+    };
+
+    /**
+     * Lengths of arcs of one profile. Middle vertex of an arc direction is the lowest vertex
+     * of the triangle that gave the length or kNoMiddleVertex if the length is given by a base edge.
+     */
+    struct Metric {
+        std::vector<float> forward_lengths;
+        std::vector<float> backward_lengths;
+        std::vector<unsigned_id_type> forward_middle_vertices;
+        std::vector<unsigned_id_type> backward_middle_vertices;
+
+        /**
+         * Lengths of base edges in the order they are stored in the graph.
+         */
+        std::vector<float> base_edge_lengths;
+    };
+
+    /**
+     * Same as the contracted vertex of CH edges that are not shortcuts.
+     */
+    static constexpr unsigned_id_type kNoMiddleVertex = 0;
+
+    CustomizableGraph();
+
+    /**
+     * Contract the graph in the order given by ordering ranks.
+     *
+     * @param ordering_ranks Ordering rank of each vertex id. Vertices with the same rank are ordered by their ids.
+     * @param edges Edges of the base graph. Twoway edges are contained only once.
+     */
+    CustomizableGraph(const std::vector<unsigned_id_type>& ordering_ranks, const std::vector<BaseEdge>& edges);
+
+    /**
+     * Compute lengths of all arcs.
+     *
+     * @param edge_length Returns length of a base edge with given uid. It is called concurrently.
+     * @param thread_count Number of threads that customize the graph.
+     */
+    Metric Customize(const std::function<float(unsigned_id_type)>& edge_length, size_t thread_count) const;
+
+    /**
+     * Create search graph of Contraction Hierarchies with lengths of the metric.
+     * It contains all base edges and a shortcut for each arc direction which is shorter than
+     * base edges of the arc. Uids of the shortcuts are higher than uids of base edges.
+     *
+     * @tparam SearchGraph CHSearchGraph whose edge lengths are numbers.
+     */
+    template <typename SearchGraph>
+    SearchGraph CreateSearchGraph(const Metric& metric) const;
+
+    size_t GetVertexCount() const {
+        return ordering_ranks_.size();
+    }
+
+    size_t GetArcCount() const {
+        return arc_heads_.size();
+    }
+
+    size_t GetTriangleCount() const {
+        return triangles_.size();
+    }
+
+    size_t GetLevelCount() const {
+        return first_level_vertices_.empty() ? 0 : first_level_vertices_.size() - 1;
+    }
+
+private:
+    /**
+     * Base edge stored at its vertex with the lower rank.
+     */
+    struct StoredEdge {
+        unsigned_id_type uid;
+        unsigned_id_type to;
+        unsigned_id_type arc;
+        bool forward;
+        bool backward;
+    };
+
+    /**
+     * Triangle of arcs (v, u), (v, w) and (u, w) where v is the lowest vertex. It is stored at u.
+     */
+    struct Triangle {
+        unsigned_id_type upper_arc;
+        unsigned_id_type lower_arc;
+        unsigned_id_type intermediate_arc;
+        unsigned_id_type lowest_vertex;
+    };
+
+    /**
+     * Unique ordering ranks of vertices.
+     */
+    std::vector<unsigned_id_type> ordering_ranks_;
+
+    /**
+     * Arcs of vertex v are [first_arcs_[v], first_arcs_[v + 1]) sorted by ranks of their heads.
+     */
+    std::vector<size_t> first_arcs_;
+    std::vector<unsigned_id_type> arc_heads_;
+
+    std::vector<size_t> first_edges_;
+    std::vector<StoredEdge> edges_;
+
+    std::vector<size_t> first_triangles_;
+    std::vector<Triangle> triangles_;
+
+    /**
+     * Vertices of level l are level_vertices_[first_level_vertices_[l], first_level_vertices_[l + 1]).
+     */
+    std::vector<size_t> first_level_vertices_;
+    std::vector<unsigned_id_type> level_vertices_;
+
+    unsigned_id_type max_edge_id_;
+
+    unsigned_id_type FindArc(unsigned_id_type tail, unsigned_id_type head) const;
+
+    /**
+     * Set lengths of arcs of `vertex` from its base edges and lower triangles.
+     */
+    void CustomizeVertex(unsigned_id_type vertex, const std::function<float(unsigned_id_type)>& edge_length, Metric& metric) const;
+};
+
+template <typename SearchGraph>
+SearchGraph CustomizableGraph::CreateSearchGraph(const Metric& metric) const {
+    using Edge = typename SearchGraph::Edge;
+    using EdgeType = typename Edge::EdgeType;
+    std::vector<Edge> edges{};
+    std::vector<size_t> first_edges{};
+    edges.reserve(edges_.size() + arc_heads_.size());
+    first_edges.reserve(GetVertexCount() + 1);
+    for (unsigned_id_type vertex = 0; vertex < GetVertexCount(); ++vertex) {
+        first_edges.push_back(edges.size());
+        for (size_t i = first_edges_[vertex]; i < first_edges_[vertex + 1]; ++i) {
+            const StoredEdge& e = edges_[i];
+            EdgeType type = e.forward && e.backward ? EdgeType::twoway : (e.forward ? EdgeType::forward : EdgeType::backward);
+            edges.emplace_back(e.uid, vertex, e.to, typename Edge::LengthSource{metric.base_edge_lengths[i]}, type, kNoMiddleVertex);
+        }
+        for (size_t arc = first_arcs_[vertex]; arc < first_arcs_[vertex + 1]; ++arc) {
+            // Arc directions given by base edges need no shortcut.
+            if (metric.forward_middle_vertices[arc] != kNoMiddleVertex) {
+                edges.emplace_back(max_edge_id_ + 1 + 2 * arc, vertex, arc_heads_[arc], typename Edge::LengthSource{metric.forward_lengths[arc]},
+                    EdgeType::forward, metric.forward_middle_vertices[arc]);
+            }
+            if (metric.backward_middle_vertices[arc] != kNoMiddleVertex) {
+                edges.emplace_back(max_edge_id_ + 2 + 2 * arc, vertex, arc_heads_[arc], typename Edge::LengthSource{metric.backward_lengths[arc]},
+                    EdgeType::backward, metric.backward_middle_vertices[arc]);
+            }
+        }
+    }
+    first_edges.push_back(edges.size());
+    SearchGraph search_graph{};
+    search_graph.Load(std::move(edges), first_edges, ordering_ranks_);
+    return search_graph;
+}
+
+}
+}
+#endif //ROUTING_CCH_CUSTOMIZABLE_GRAPH_H
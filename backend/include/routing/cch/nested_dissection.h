@@ -0,0 +1,103 @@
+#ifndef ROUTING_CCH_NESTED_DISSECTION_H
+#define ROUTING_CCH_NESTED_DISSECTION_H
+
+#include "routing/types.h"
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace routing {
+namespace cch {
+
+/**
+ * NestedDissection computes a vertex ordering of a road graph that does not depend on edge lengths.
+ * Such ordering is the only preprocessing of Customizable Contraction Hierarchies that is done
+ * before the server starts. Any profile can then be applied to the contracted graph.
+ *
+ * The graph is recursively split by small vertex separators. Separator vertices get the highest
+ * ordering ranks of the split part and both of the remaining parts are ordered recursively. Separators
+ * are found by breadth first search from a pseudo-peripheral vertex - one of its levels that splits
+ * the part to balanced halves is a separator. Only the vertices of the level that have a neighbour
+ * in the next level are needed in the separator.
+ *
+ * Edge directions are ignored. Edges are added first and then the ordering is computed.
+ */
+class NestedDissection {
+public:
+    NestedDissection();
+
+    /**
+     * Add an edge between `from` and `to`. Self loops are ignored.
+     */
+    void AddEdge(unsigned_id_type from, unsigned_id_type to);
+
+    /**
+     * Compute ordering ranks of all vertices with ids from 0 to the maximum vertex id of added edges
+     * (vertices without edges included).
+     *
+     * @return Ordering ranks indexed by vertex ids. Ranks are unique and form a permutation.
+     */
+    std::vector<unsigned_id_type> ComputeOrdering();
+
+private:
+    std::vector<std::pair<unsigned_id_type, unsigned_id_type>> edges_;
+    size_t vertex_count_;
+
+    /**
+     * Neighbours of vertex v are neighbours_[first_neighbour_[v], first_neighbour_[v + 1]).
+     */
+    std::vector<size_t> first_neighbour_;
+    std::vector<unsigned_id_type> neighbours_;
+
+    /**
+     * Vertices of the currently processed part are marked with the current stamp.
+     */
+    std::vector<unsigned_id_type> stamps_;
+    unsigned_id_type stamp_;
+
+    /**
+     * Breadth first search levels of the last search.
+     */
+    std::vector<unsigned_id_type> levels_;
+
+    /**
+     * Part of the graph whose vertices get ranks [rank_begin, rank_begin + vertices.size()).
+     */
+    struct Part {
+        std::vector<unsigned_id_type> vertices;
+        unsigned_id_type rank_begin;
+
+        Part(std::vector<unsigned_id_type>&& v, unsigned_id_type rb) : vertices(std::move(v)), rank_begin(rb) {}
+    };
+
+    void BuildAdjacency();
+
+    /**
+     * Mark vertices of the part so that searches do not leave it.
+     */
+    void Mark(const std::vector<unsigned_id_type>& vertices);
+
+    /**
+     * Breadth first search from `source` restricted to marked vertices. Levels of found vertices are set
+     * and their stamp is changed to `visited_stamp`.
+     *
+     * @return Found vertices in the order of their discovery.
+     */
+    std::vector<unsigned_id_type> Search(unsigned_id_type source, unsigned_id_type visited_stamp);
+
+    /**
+     * Split part into its connected components.
+     */
+    std::vector<std::vector<unsigned_id_type>> FindComponents(const std::vector<unsigned_id_type>& vertices);
+
+    /**
+     * Split connected part into two parts and a separator. Ranks of the separator are assigned right away
+     * and the other two parts are added to `parts`.
+     */
+    void Dissect(Part&& part, std::vector<unsigned_id_type>& ranks, std::vector<Part>& parts);
+};
+
+}
+}
+#endif //ROUTING_CCH_NESTED_DISSECTION_H
@@ -4,6 +4,7 @@
 #include "routing/edges/basic_edge.h"
 #include "routing/database/database_helper.h"
 #include "routing/vertices/basic_vertex.h"
+#include "routing/snapshot/ch_graph_snapshot.h"
 #include "routing/exception.h"
 #include "routing/types.h"
 
@@ -40,6 +41,19 @@ public:
     template <typename Graph>
     void Load(Graph& graph);
 
+    /**
+     * Copy vertices and edges from a snapshot of a search graph. The snapshot already contains
+     * only edges leading to vertices with higher ordering rank sorted by vertices so the graph
+     * is created in one pass over the snapshot.
+     */
+    void LoadSnapshot(const snapshot::CHGraphSnapshot& snapshot);
+
+    /**
+     * Take edges that only lead to vertices with higher ordering rank and are sorted by vertices they belong to.
+     * Edges of vertex with id i are [first_edges[i], first_edges[i + 1]).
+     */
+    void Load(std::vector<E>&& edges, const std::vector<size_t>& first_edges, const std::vector<unsigned_id_type>& ordering_ranks);
+
     V& GetVertex(unsigned_id_type id);
 
     void ForEachVertex(const std::function<void(V&)>& f);
@@ -98,6 +112,36 @@ void CHSearchGraph<V, E>::Load(Graph& graph) {
     assert(capacities.edges_capacity == edges_.capacity());
 }
 
+template <typename V, typename E>
+void CHSearchGraph<V, E>::LoadSnapshot(const snapshot::CHGraphSnapshot& snapshot) {
+    const snapshot::CHGraphSnapshotEdge* snapshot_edges = snapshot.GetEdges();
+    const uint64_t* first_edges = snapshot.GetFirstEdges();
+    const uint32_t* ordering_ranks = snapshot.GetOrderingRanks();
+    vertices_.clear();
+    edges_.clear();
+    edges_.reserve(snapshot.GetEdgeCount());
+    for (size_t i = 0; i < snapshot.GetEdgeCount(); ++i) {
+        const snapshot::CHGraphSnapshotEdge& e = snapshot_edges[i];
+        edges_.emplace_back(e.uid, e.from, e.to, typename E::LengthSource{e.length}, static_cast<typename E::EdgeType>(e.type), e.contracted_vertex);
+    }
+    vertices_.reserve(snapshot.GetVertexCount());
+    for (size_t i = 0; i < snapshot.GetVertexCount(); ++i) {
+        vertices_.emplace_back(static_cast<unsigned_id_type>(i), typename V::EdgeRange{edges_.begin() + first_edges[i], edges_.begin() + first_edges[i + 1]},
+            ordering_ranks[i]);
+    }
+}
+
+template <typename V, typename E>
+void CHSearchGraph<V, E>::Load(std::vector<E>&& edges, const std::vector<size_t>& first_edges, const std::vector<unsigned_id_type>& ordering_ranks) {
+    edges_ = std::move(edges);
+    vertices_.clear();
+    vertices_.reserve(ordering_ranks.size());
+    for (size_t i = 0; i < ordering_ranks.size(); ++i) {
+        vertices_.emplace_back(static_cast<unsigned_id_type>(i), typename V::EdgeRange{edges_.begin() + first_edges[i], edges_.begin() + first_edges[i + 1]},
+            ordering_ranks[i]);
+    }
+}
+
 template <typename V, typename E>
 inline V& CHSearchGraph<V, E>::GetVertex(unsigned_id_type id) {
     assert(id < vertices_.size());
@@ -0,0 +1,222 @@
+#ifndef ROUTING_COMPACT_CH_SEARCH_GRAPH_H
+#define ROUTING_COMPACT_CH_SEARCH_GRAPH_H
+
+#include "routing/edge_ranges/compact_edge_range.h"
+#include "routing/vertices/compact_ch_vertex.h"
+#include "routing/snapshot/ch_graph_snapshot.h"
+#include "routing/exception.h"
+#include "routing/types.h"
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cassert>
+
+namespace routing {
+
+/**
+ * Immutable search graph for Contraction Hierarchies whose edge lengths are numbers.
+ * It contains only edges that lead to a vertex with higher ordering rank as CHSearchGraph does.
+ *
+ * Edges are stored in compressed sparse row format - edges of each vertex are consecutive
+ * in CompactEdges and vertices keep offsets of their first and past-the-end edges. No edge stores its source
+ * vertex, virtual table pointer or length source so the graph needs about half of the memory
+ * of CHSearchGraph and relaxing edges of a vertex reads only a few small arrays.
+ *
+ * Edges are created from the arrays when they are iterated so they are given to functions by value.
+ */
+template <typename E>
+class CompactCHSearchGraph {
+public:
+    using Vertex = CompactCHVertex<E>;
+    using Edge = E;
+
+    CompactCHSearchGraph();
+
+    /**
+     * Vertices point to edges of the graph so the graph can be moved but not copied.
+     */
+    CompactCHSearchGraph(CompactCHSearchGraph&& other) = default;
+    CompactCHSearchGraph(const CompactCHSearchGraph& other) = delete;
+    CompactCHSearchGraph& operator=(CompactCHSearchGraph&& other) = default;
+    CompactCHSearchGraph& operator=(const CompactCHSearchGraph& other) = delete;
+    ~CompactCHSearchGraph() = default;
+
+    /**
+     * Copy vertices and edges from a graph to this graph. Only edges leading to vertices with higher
+     * ordering rank are copied.
+     */
+    template <typename Graph>
+    void Load(Graph& graph);
+
+    /**
+     * Copy vertices and edges from a snapshot of a search graph.
+     */
+    void LoadSnapshot(const snapshot::CHGraphSnapshot& snapshot);
+
+    /**
+     * Take edges that only lead to vertices with higher ordering rank and are sorted by vertices they belong to.
+     * Edges of vertex with id i are [first_edges[i], first_edges[i + 1]).
+     */
+    void Load(std::vector<E>&& edges, const std::vector<size_t>& first_edges, const std::vector<unsigned_id_type>& ordering_ranks);
+
+    Vertex& GetVertex(unsigned_id_type id);
+
+    void ForEachVertex(const std::function<void(Vertex&)>& f);
+
+    void ForEachEdge(const std::function<void(E&)>& f);
+
+    size_t GetVertexCount() const;
+
+    size_t GetEdgeCount() const;
+
+    unsigned_id_type GetMaxVertexId() const;
+
+    unsigned_id_type GetMaxEdgeId() const;
+
+    /**
+     * Memory in bytes used by vertices and edges.
+     */
+    size_t GetMemorySize() const;
+
+private:
+    std::vector<Vertex> vertices_;
+
+    /**
+     * Edges are on heap so that vertices point to them even if the graph is moved.
+     */
+    std::unique_ptr<CompactEdges<E>> edges_;
+
+    void AddVertex(unsigned_id_type id, size_t first_edge, unsigned_id_type ordering_rank);
+};
+
+template <typename E>
+CompactCHSearchGraph<E>::CompactCHSearchGraph() : vertices_(), edges_(std::make_unique<CompactEdges<E>>()) {}
+
+template <typename E>
+template <typename Graph>
+void CompactCHSearchGraph<E>::Load(Graph& graph) {
+    auto&& is_to_higher_rank = [&](const typename Graph::Edge& edge) {
+        return graph.GetVertex(edge.get_from()).get_ordering_rank() < graph.GetVertex(edge.get_to()).get_ordering_rank();
+    };
+    size_t max_vertex_id = 0;
+    size_t edge_count = 0;
+    graph.ForEachVertex([&](typename Graph::Vertex& vertex) {
+        for (auto&& edge : vertex.get_edges()) {
+            if (is_to_higher_rank(edge)) {
+                ++edge_count;
+            }
+        }
+        if (vertex.get_uid() > max_vertex_id) {
+            max_vertex_id = vertex.get_uid();
+        }
+    });
+    edges_ = std::make_unique<CompactEdges<E>>();
+    edges_->Reserve(edge_count);
+    vertices_.assign(max_vertex_id + 1, Vertex{});
+    graph.ForEachVertex([&](typename Graph::Vertex& vertex) {
+        size_t first_edge = edges_->GetEdgeCount();
+        for (auto&& edge : vertex.get_edges()) {
+            if (is_to_higher_rank(edge)) {
+                edges_->AddEdge(edge);
+            }
+        }
+        AddVertex(vertex.get_uid(), first_edge, vertex.get_ordering_rank());
+    });
+}
+
+template <typename E>
+void CompactCHSearchGraph<E>::LoadSnapshot(const snapshot::CHGraphSnapshot& snapshot) {
+    const snapshot::CHGraphSnapshotEdge* snapshot_edges = snapshot.GetEdges();
+    const uint64_t* first_edges = snapshot.GetFirstEdges();
+    const uint32_t* ordering_ranks = snapshot.GetOrderingRanks();
+    edges_ = std::make_unique<CompactEdges<E>>();
+    edges_->Reserve(snapshot.GetEdgeCount());
+    for (size_t i = 0; i < snapshot.GetEdgeCount(); ++i) {
+        const snapshot::CHGraphSnapshotEdge& e = snapshot_edges[i];
+        edges_->AddEdge(e.uid, e.to, e.length, static_cast<typename E::EdgeType>(e.type), e.contracted_vertex);
+    }
+    vertices_.clear();
+    vertices_.reserve(snapshot.GetVertexCount());
+    for (size_t i = 0; i < snapshot.GetVertexCount(); ++i) {
+        vertices_.emplace_back(static_cast<unsigned_id_type>(i), CompactEdgeRange<E>{edges_.get(), first_edges[i], first_edges[i + 1]}, ordering_ranks[i]);
+    }
+}
+
+template <typename E>
+void CompactCHSearchGraph<E>::Load(std::vector<E>&& edges, const std::vector<size_t>& first_edges, const std::vector<unsigned_id_type>& ordering_ranks) {
+    edges_ = std::make_unique<CompactEdges<E>>();
+    edges_->Reserve(edges.size());
+    for (auto&& edge : edges) {
+        edges_->AddEdge(edge);
+    }
+    // The edges are copied so the memory is released right away.
+    std::vector<E>{}.swap(edges);
+    vertices_.clear();
+    vertices_.reserve(ordering_ranks.size());
+    for (size_t i = 0; i < ordering_ranks.size(); ++i) {
+        vertices_.emplace_back(static_cast<unsigned_id_type>(i), CompactEdgeRange<E>{edges_.get(), first_edges[i], first_edges[i + 1]}, ordering_ranks[i]);
+    }
+}
+
+template <typename E>
+inline typename CompactCHSearchGraph<E>::Vertex& CompactCHSearchGraph<E>::GetVertex(unsigned_id_type id) {
+    assert(id < vertices_.size());
+    return vertices_[id];
+}
+
+template <typename E>
+void CompactCHSearchGraph<E>::ForEachVertex(const std::function<void(Vertex&)>& f) {
+    for (auto&& vertex : vertices_) {
+        f(vertex);
+    }
+}
+
+template <typename E>
+void CompactCHSearchGraph<E>::ForEachEdge(const std::function<void(E&)>& f) {
+    for (auto&& vertex : vertices_) {
+        for (auto&& edge : vertex.get_edges()) {
+            f(edge);
+        }
+    }
+}
+
+template <typename E>
+size_t CompactCHSearchGraph<E>::GetVertexCount() const {
+    return vertices_.size();
+}
+
+template <typename E>
+size_t CompactCHSearchGraph<E>::GetEdgeCount() const {
+    return edges_->GetEdgeCount();
+}
+
+template <typename E>
+unsigned_id_type CompactCHSearchGraph<E>::GetMaxVertexId() const {
+    return vertices_.size();
+}
+
+template <typename E>
+unsigned_id_type CompactCHSearchGraph<E>::GetMaxEdgeId() const {
+    unsigned_id_type max_id = 0;
+    for (size_t i = 0; i < edges_->GetEdgeCount(); ++i) {
+        if (edges_->GetUid(i) > max_id) {
+            max_id = edges_->GetUid(i);
+        }
+    }
+    return max_id;
+}
+
+template <typename E>
+size_t CompactCHSearchGraph<E>::GetMemorySize() const {
+    return vertices_.capacity() * sizeof(Vertex) + edges_->GetMemorySize();
+}
+
+template <typename E>
+void CompactCHSearchGraph<E>::AddVertex(unsigned_id_type id, size_t first_edge, unsigned_id_type ordering_rank) {
+    vertices_[id] = Vertex{id, CompactEdgeRange<E>{edges_.get(), first_edge, edges_->GetEdgeCount()}, ordering_rank};
+}
+
+}
+
+#endif //ROUTING_COMPACT_CH_SEARCH_GRAPH_H
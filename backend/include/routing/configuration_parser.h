@@ -19,6 +19,8 @@
 #include <unordered_map>
 #include <memory>
 #include <string>
+#include <thread>
+#include <algorithm>
 
 /**
  * The whole configuration data is loaded to matching classes before any special events are done.
@@ -33,12 +35,40 @@ struct DatabaseConfig{
     std::string host;
     std::string port;
 
+    /**
+     * Maximum number of connections that are open at once.
+     */
+    size_t pool_size;
+
     DatabaseConfig(const toml::value& table) :
         name(toml::find<std::string>(table, Constants::Input::Database::kName)),
         user(toml::find<std::string>(table, Constants::Input::Database::kUser)),
         password(toml::find<std::string>(table, Constants::Input::Database::kPassword)),
         host(toml::find<std::string>(table, Constants::Input::Database::kHost)),
-        port(toml::find<std::string>(table, Constants::Input::Database::kPort))  {}
+        port(toml::find<std::string>(table, Constants::Input::Database::kPort)),
+        pool_size(ParsePoolSize(table))  {}
+
+    /**
+     * Create pool of connections to the database with at most `pool_size` connections.
+     */
+    std::unique_ptr<database::DatabaseConnectionPool> CreateConnectionPool(size_t max_size) const {
+        return std::make_unique<database::DatabaseConnectionPool>(max_size, [=]() {
+            return std::make_unique<database::DatabaseHelper>(name, user, password, host, port);
+        });
+    }
+
+    std::unique_ptr<database::DatabaseConnectionPool> CreateConnectionPool() const {
+        return CreateConnectionPool(pool_size);
+    }
+
+private:
+    static const size_t kDefaultPoolSize = 4;
+
+    static size_t ParsePoolSize(const toml::value& table) {
+        auto&& t = table.as_table();
+        auto&& it = t.find(Constants::Input::Database::kPoolSize);
+        return it != t.end() ? static_cast<size_t>(it->second.as_integer()) : kDefaultPoolSize;
+    }
 };
 
 struct ProfilePreference {
@@ -60,7 +90,13 @@ struct AlgorithmConfig {
     std::string base_graph_table;
     std::string mode;
 
-    AlgorithmConfig(std::string&& n, std::string&& bgt, std::string&& m) : name(std::move(n)), base_graph_table(std::move(bgt)), mode(std::move(m)) {}
+    /**
+     * Directory with binary snapshots of preprocessed graphs. Snapshots are not used if it is empty.
+     */
+    std::string snapshot_directory;
+
+    AlgorithmConfig(std::string&& n, std::string&& bgt, std::string&& m, std::string&& sd)
+        : name(std::move(n)), base_graph_table(std::move(bgt)), mode(std::move(m)), snapshot_directory(std::move(sd)) {}
 };
 
 struct CHConfig : public AlgorithmConfig {
@@ -69,9 +105,39 @@ struct CHConfig : public AlgorithmConfig {
     int32_t deleted_neighbours_coefficient;
     int32_t space_size_coefficient;
 
-    CHConfig(std::string&& n, std::string&& bgt, std::string&&m, size_t hc, int32_t edc, int32_t dnc, int32_t ssc) 
-        : AlgorithmConfig(std::move(n), std::move(bgt), std::move(m)), hop_count(hc), edge_difference_coefficient(edc), deleted_neighbours_coefficient(dnc),
-        space_size_coefficient(ssc) {}
+    /**
+     * Number of threads that contract the graph. One thread contracts vertices one by one.
+     */
+    size_t threads;
+
+    /**
+     * Number of profiles of static mode that are preprocessed at once.
+     */
+    size_t profile_threads;
+
+    /**
+     * Memory in bytes that concurrently preprocessed profiles can use. Zero means no limit.
+     */
+    size_t memory_budget;
+
+    CHConfig(std::string&& n, std::string&& bgt, std::string&&m, std::string&& sd, size_t hc, int32_t edc, int32_t dnc, int32_t ssc, size_t t, size_t pt, size_t mb) 
+        : AlgorithmConfig(std::move(n), std::move(bgt), std::move(m), std::move(sd)), hop_count(hc), edge_difference_coefficient(edc), deleted_neighbours_coefficient(dnc),
+        space_size_coefficient(ssc), threads(t), profile_threads(pt), memory_budget(mb) {}
+};
+
+struct CCHConfig : public AlgorithmConfig {
+    /**
+     * Number of threads that customize the graph for a new profile.
+     */
+    size_t threads;
+
+    /**
+     * Maximum number of customized graphs that are kept in memory.
+     */
+    size_t cached_profiles;
+
+    CCHConfig(std::string&& n, std::string&& bgt, std::string&&m, std::string&& sd, size_t t, size_t cp)
+        : AlgorithmConfig(std::move(n), std::move(bgt), std::move(m), std::move(sd)), threads(t), cached_profiles(cp) {}
 };
 
 struct ProfilePreferences{
@@ -102,13 +168,40 @@ struct ProfilePreferences{
     }
 };
 
+struct ServerConfig {
+    /**
+     * Number of threads that calculate routes of batch requests and legs of routes through waypoints.
+     */
+    size_t batch_threads;
+
+    /**
+     * Memory budget of cached routes of the routing mode in MB. Routes of all profiles share it.
+     */
+    size_t route_cache_size;
+
+    /**
+     * Time in ms after which route calculations of one request are stopped. Zero means no limit.
+     */
+    size_t request_timeout;
+
+    /**
+     * Token that requests of admin endpoints (e.g. /admin/reload) must send in X-Admin-Token header.
+     * Empty token disables admin endpoints.
+     */
+    std::string admin_token;
+
+    ServerConfig(size_t bt, size_t rcs, size_t rt, std::string&& at)
+        : batch_threads(bt), route_cache_size(rcs), request_timeout(rt), admin_token(std::move(at)) {}
+};
+
 struct Configuration {
     DatabaseConfig database;
     ProfilePreferences profile_preferences;
     std::unique_ptr<AlgorithmConfig> algorithm;
+    ServerConfig server;
 
-    Configuration(DatabaseConfig&& db, ProfilePreferences&& pp, std::unique_ptr<AlgorithmConfig> alg)
-        : database(std::move(db)), profile_preferences(std::move(pp)), algorithm(std::move(alg)) {}
+    Configuration(DatabaseConfig&& db, ProfilePreferences&& pp, std::unique_ptr<AlgorithmConfig> alg, ServerConfig&& s)
+        : database(std::move(db)), profile_preferences(std::move(pp)), algorithm(std::move(alg)), server(std::move(s)) {}
 };
 
 class ConfigurationParser {
@@ -124,6 +217,8 @@ public:
 private:
     const toml::value data_;
 
+    static const size_t kDefaultCachedProfiles = 16;
+
 };
 
 ConfigurationParser::ConfigurationParser(const std::string& config_path) : data_(toml::parse(config_path)) {}
@@ -131,25 +226,76 @@ ConfigurationParser::ConfigurationParser(const std::string& config_path) : data_
 Configuration ConfigurationParser::Parse() {
     auto&& database = toml::find(data_, Constants::Input::TableNames::kDatabase);
     std::string default_algorithm = Constants::AlgorithmNames::kContractionHierarchies;
+    auto&& parse_snapshot_directory = [](const toml::table& algorithm_config) {
+        std::string snapshot_directory{};
+        auto&& it = algorithm_config.find(Constants::Input::kSnapshotDirectory);
+        if (it != algorithm_config.end()) {
+            snapshot_directory = toml::get<std::string>(it->second);
+        }
+        return snapshot_directory;
+    };
     std::unordered_map<std::string, std::function<std::unique_ptr<AlgorithmConfig>(const toml::table&)>> algorithms {
-        {Constants::AlgorithmNames::kContractionHierarchies, [](const toml::table& algorithm_config){
+        {Constants::AlgorithmNames::kContractionHierarchies, [&](const toml::table& algorithm_config){
                 std::string name = algorithm_config.at(Constants::Input::kName).as_string();
                 std::string base_graph_table = algorithm_config.at(Constants::Input::kBaseGraphTable).as_string();
                 std::string mode = algorithm_config.at(Constants::Input::kMode).as_string();
                 auto&& param = algorithm_config.at(Constants::Input::TableNames::kParameters).as_table();
+                size_t threads = 1;
+                if (param.find(Constants::Input::Preprocessing::kThreads) != param.end()) {
+                    threads = static_cast<size_t>(param.at(Constants::Input::Preprocessing::kThreads).as_integer());
+                }
+                size_t profile_threads = 1;
+                if (param.find(Constants::Input::Preprocessing::kProfileThreads) != param.end()) {
+                    profile_threads = static_cast<size_t>(param.at(Constants::Input::Preprocessing::kProfileThreads).as_integer());
+                }
+                size_t memory_budget = 0;
+                if (param.find(Constants::Input::Preprocessing::kMemoryBudget) != param.end()) {
+                    memory_budget = static_cast<size_t>(param.at(Constants::Input::Preprocessing::kMemoryBudget).as_integer()) * 1024 * 1024;
+                }
 
                 return std::make_unique<CHConfig>(
                     std::move(name),
                     std::move(base_graph_table),
                     std::move(mode),
+                    parse_snapshot_directory(algorithm_config),
                     static_cast<size_t>(param.at(Constants::Input::Preprocessing::kHopCount).as_integer()),
                     static_cast<int32_t>(param.at(Constants::Input::Preprocessing::kEdgeDifference).as_integer()),
                     static_cast<int32_t>(param.at(Constants::Input::Preprocessing::kDeletedNeighbours).as_integer()),
-                    static_cast<int32_t>(param.at(Constants::Input::Preprocessing::kSpaceSize).as_integer())
+                    static_cast<int32_t>(param.at(Constants::Input::Preprocessing::kSpaceSize).as_integer()),
+                    threads,
+                    profile_threads,
+                    memory_budget
                 );
             }
         },
-        {Constants::AlgorithmNames::kDijkstra, [](const toml::table& algorithm_config){
+        {Constants::AlgorithmNames::kCustomizableContractionHierarchies, [&](const toml::table& algorithm_config){
+                std::string name = algorithm_config.at(Constants::Input::kName).as_string();
+                std::string base_graph_table = algorithm_config.at(Constants::Input::kBaseGraphTable).as_string();
+                std::string mode = algorithm_config.at(Constants::Input::kMode).as_string();
+                size_t threads = std::max(std::thread::hardware_concurrency(), 1U);
+                size_t cached_profiles = kDefaultCachedProfiles;
+                auto&& param_it = algorithm_config.find(Constants::Input::TableNames::kParameters);
+                if (param_it != algorithm_config.end()) {
+                    auto&& param = param_it->second.as_table();
+                    if (param.find(Constants::Input::Customization::kThreads) != param.end()) {
+                        threads = static_cast<size_t>(param.at(Constants::Input::Customization::kThreads).as_integer());
+                    }
+                    if (param.find(Constants::Input::Customization::kCachedProfiles) != param.end()) {
+                        cached_profiles = static_cast<size_t>(param.at(Constants::Input::Customization::kCachedProfiles).as_integer());
+                    }
+                }
+
+                return std::make_unique<CCHConfig>(
+                    std::move(name),
+                    std::move(base_graph_table),
+                    std::move(mode),
+                    parse_snapshot_directory(algorithm_config),
+                    threads,
+                    cached_profiles
+                );
+            }
+        },
+        {Constants::AlgorithmNames::kDijkstra, [&](const toml::table& algorithm_config){
                 std::string name = algorithm_config.at(Constants::Input::kName).as_string();
                 std::string base_graph_table = algorithm_config.at(Constants::Input::kBaseGraphTable).as_string();
                 std::string mode = algorithm_config.at(Constants::Input::kMode).as_string();
@@ -157,7 +303,8 @@ Configuration ConfigurationParser::Parse() {
                 return std::make_unique<AlgorithmConfig>(
                     std::move(name),
                     std::move(base_graph_table),
-                    std::move(mode)
+                    std::move(mode),
+                    parse_snapshot_directory(algorithm_config)
                 );
             }
         }
@@ -215,7 +362,29 @@ Configuration ConfigurationParser::Parse() {
         std::move(profile_preferences)
     };
 
-    return Configuration{std::move(db_config), std::move(pref), std::move(alg)};
+    // Server table is optional - batch requests use all cores by default.
+    size_t batch_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    size_t route_cache_size = 64;
+    size_t request_timeout = 0;
+    std::string admin_token{};
+    auto&& server_it = data_.as_table().find(Constants::Input::TableNames::kServer);
+    if (server_it != data_.as_table().end()) {
+        auto&& server = server_it->second.as_table();
+        if (server.find(Constants::Input::Server::kBatchThreads) != server.end()) {
+            batch_threads = static_cast<size_t>(server.at(Constants::Input::Server::kBatchThreads).as_integer());
+        }
+        if (server.find(Constants::Input::Server::kRouteCacheSize) != server.end()) {
+            route_cache_size = static_cast<size_t>(server.at(Constants::Input::Server::kRouteCacheSize).as_integer());
+        }
+        if (server.find(Constants::Input::Server::kRequestTimeout) != server.end()) {
+            request_timeout = static_cast<size_t>(server.at(Constants::Input::Server::kRequestTimeout).as_integer());
+        }
+        if (server.find(Constants::Input::Server::kAdminToken) != server.end()) {
+            admin_token = server.at(Constants::Input::Server::kAdminToken).as_string();
+        }
+    }
+
+    return Configuration{std::move(db_config), std::move(pref), std::move(alg), ServerConfig{batch_threads, route_cache_size, request_timeout, std::move(admin_token)}};
 }
 
 
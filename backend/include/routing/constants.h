@@ -13,6 +13,7 @@ struct Constants{
             static inline const std::string kParameters = "parameters";
             static inline const std::string kPreferences = "preferences";
             static inline const std::string kIndices = "indices";
+            static inline const std::string kServer = "server";
         };
 
         struct Preprocessing {
@@ -20,6 +21,21 @@ struct Constants{
             static inline const std::string kEdgeDifference = "edge_difference";
             static inline const std::string kDeletedNeighbours = "deleted_neighbours";
             static inline const std::string kSpaceSize = "space_size";
+            static inline const std::string kThreads = "threads";
+            static inline const std::string kProfileThreads = "profile_threads";
+            static inline const std::string kMemoryBudget = "memory_budget_mb";
+        };
+
+        struct Customization {
+            static inline const std::string kThreads = "threads";
+            static inline const std::string kCachedProfiles = "cached_profiles";
+        };
+
+        struct Server {
+            static inline const std::string kBatchThreads = "batch_threads";
+            static inline const std::string kRouteCacheSize = "route_cache_size";
+            static inline const std::string kRequestTimeout = "request_timeout";
+            static inline const std::string kAdminToken = "admin_token";
         };
 
         struct Database{
@@ -28,6 +44,7 @@ struct Constants{
             static inline const std::string kPassword = "password";
             static inline const std::string kHost = "host";
             static inline const std::string kPort = "port";
+            static inline const std::string kPoolSize = "pool_size";
         };
 
         static inline const std::string kName = "name";
@@ -40,6 +57,7 @@ struct Constants{
         static inline const std::string kBaseIndexTable = "base_index_table";
         
         static inline const std::string kMode = "mode";
+        static inline const std::string kSnapshotDirectory = "snapshot_directory";
 
         struct Indices{
             static inline const std::string kEdgesTable = "edges_table";
@@ -51,6 +69,7 @@ struct Constants{
 
     struct AlgorithmNames{
         static inline const std::string kContractionHierarchies = "ch";
+        static inline const std::string kCustomizableContractionHierarchies = "cch";
         static inline const std::string kDijkstra = "dijkstra";
     };
 
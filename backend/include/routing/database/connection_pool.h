@@ -0,0 +1,225 @@
+#ifndef ROUTING_DATABASE_CONNECTION_POOL_H
+#define ROUTING_DATABASE_CONNECTION_POOL_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <cstddef>
+#include <algorithm>
+
+namespace routing {
+namespace database {
+
+/**
+ * ConnectionPool keeps open database connections so that they are not opened for each use.
+ * It is thread-safe and holds at most `max_size` connections - `Acquire` waits until a connection
+ * is returned if all of them are leased.
+ *
+ * Connections are opened lazily by the factory. A connection that was idle for longer than
+ * the health check interval is checked by `connection.IsHealthy()` before it is leased and reopened if
+ * the check fails. Leases whose connection failed can be invalidated so that the connection is closed
+ * instead of being returned to the pool.
+ *
+ * The pool must outlive all leases it gave out.
+ *
+ * @tparam Connection Connection to database, e.g. DatabaseHelper.
+ */
+template <typename Connection>
+class ConnectionPool {
+    struct IdleConnection;
+public:
+    using Factory = std::function<std::unique_ptr<Connection>()>;
+    using Clock = std::chrono::steady_clock;
+    class Lease;
+
+    /**
+     * @param max_size Maximum number of open connections.
+     * @param factory Opens a new connection.
+     * @param health_check_interval Connections idle for a shorter time are leased without a health check.
+     */
+    ConnectionPool(size_t max_size, Factory&& factory, Clock::duration health_check_interval = std::chrono::seconds{30});
+
+    ConnectionPool(const ConnectionPool& other) = delete;
+    ConnectionPool& operator=(const ConnectionPool& other) = delete;
+
+    /**
+     * Lease a connection. Waits until a connection is free if `max_size` connections are leased.
+     * Exceptions thrown while opening a connection are propagated and the slot is freed.
+     */
+    Lease Acquire();
+
+    /**
+     * Close connections that are not leased.
+     */
+    void CloseIdle();
+
+    size_t GetMaxSize() const {
+        return max_size_;
+    }
+
+    /**
+     * Number of open connections including the leased ones.
+     */
+    size_t GetOpenCount();
+
+    size_t GetIdleCount();
+
+    /**
+     * Lease of one connection. The connection is returned to the pool when the lease is destroyed.
+     */
+    class Lease {
+    public:
+        Lease(ConnectionPool* pool, std::unique_ptr<Connection>&& connection) : pool_(pool), connection_(std::move(connection)), valid_(true) {}
+
+        Lease(Lease&& other) = default;
+        Lease& operator=(Lease&& other) = delete;
+        Lease(const Lease& other) = delete;
+        Lease& operator=(const Lease& other) = delete;
+
+        ~Lease() {
+            Release();
+        }
+
+        Connection& operator*() const {
+            return *connection_;
+        }
+
+        Connection* operator->() const {
+            return connection_.get();
+        }
+
+        /**
+         * Close the connection instead of returning it to the pool, e.g. after the connection broke.
+         */
+        void Invalidate() {
+            valid_ = false;
+        }
+
+        /**
+         * Return the connection to the pool before the lease is destroyed. The lease cannot be used afterwards.
+         */
+        void Release() {
+            if (connection_) {
+                pool_->Return(std::move(connection_), valid_);
+            }
+        }
+
+    private:
+        ConnectionPool* pool_;
+        std::unique_ptr<Connection> connection_;
+        bool valid_;
+    };
+
+private:
+    struct IdleConnection {
+        std::unique_ptr<Connection> connection;
+        Clock::time_point returned;
+    };
+
+    size_t max_size_;
+    Factory factory_;
+    Clock::duration health_check_interval_;
+    std::mutex mutex_;
+    std::condition_variable connection_returned_;
+    std::vector<IdleConnection> idle_connections_;
+
+    /**
+     * Open connections including the leased ones and the ones being opened.
+     */
+    size_t open_count_;
+
+    void Return(std::unique_ptr<Connection>&& connection, bool valid);
+
+    /**
+     * Release a slot of a connection that was closed.
+     */
+    void Close();
+};
+
+template <typename Connection>
+ConnectionPool<Connection>::ConnectionPool(size_t max_size, Factory&& factory, Clock::duration health_check_interval)
+    : max_size_(std::max(max_size, size_t{1})), factory_(std::move(factory)), health_check_interval_(health_check_interval), mutex_(),
+        connection_returned_(), idle_connections_(), open_count_(0) {}
+
+template <typename Connection>
+typename ConnectionPool<Connection>::Lease ConnectionPool<Connection>::Acquire() {
+    IdleConnection idle{};
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        connection_returned_.wait(lock, [&]() {
+            return !idle_connections_.empty() || open_count_ < max_size_;
+        });
+        if (!idle_connections_.empty()) {
+            idle = std::move(idle_connections_.back());
+            idle_connections_.pop_back();
+        } else {
+            ++open_count_;
+        }
+    }
+    // Connections are checked and opened without the lock since it takes a round trip to the database.
+    try {
+        if (idle.connection && Clock::now() - idle.returned >= health_check_interval_ && !idle.connection->IsHealthy()) {
+            idle.connection.reset();
+        }
+        if (!idle.connection) {
+            idle.connection = factory_();
+        }
+    } catch (...) {
+        Close();
+        throw;
+    }
+    return Lease{this, std::move(idle.connection)};
+}
+
+template <typename Connection>
+void ConnectionPool<Connection>::CloseIdle() {
+    std::vector<IdleConnection> idle_connections{};
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        idle_connections.swap(idle_connections_);
+        open_count_ -= idle_connections.size();
+    }
+    connection_returned_.notify_all();
+}
+
+template <typename Connection>
+size_t ConnectionPool<Connection>::GetOpenCount() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return open_count_;
+}
+
+template <typename Connection>
+size_t ConnectionPool<Connection>::GetIdleCount() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return idle_connections_.size();
+}
+
+template <typename Connection>
+void ConnectionPool<Connection>::Return(std::unique_ptr<Connection>&& connection, bool valid) {
+    if (!valid) {
+        connection.reset();
+        Close();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        idle_connections_.push_back(IdleConnection{std::move(connection), Clock::now()});
+    }
+    connection_returned_.notify_one();
+}
+
+template <typename Connection>
+void ConnectionPool<Connection>::Close() {
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        --open_count_;
+    }
+    connection_returned_.notify_one();
+}
+
+}
+}
+#endif //ROUTING_DATABASE_CONNECTION_POOL_H
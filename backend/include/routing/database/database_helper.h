@@ -3,6 +3,7 @@
 #include "routing/database/csv_convertor.h"
 #include "routing/database/db_graph.h"
 #include "routing/database/db_edge_iterator.h"
+#include "routing/database/connection_pool.h"
 #include "routing/types.h"
 
 #include <string>
@@ -17,7 +18,9 @@
 #include <functional>
 #include <memory>
 #include <utility>
+#include <cstdint>
 #include "routing/utility/point.h"
+#include "routing/spatial/geometry.h"
 #include <filesystem>
 
 namespace routing {
@@ -74,6 +77,11 @@ public:
      */
     bool IsDbOpen();
 
+    /**
+     * Check that the database answers a query through the connection.
+     */
+    bool IsHealthy();
+
     void DisconnectIfOpen();
 
     void RunTransactional(const std::string& sql);
@@ -95,33 +103,6 @@ public:
      */
     std::string MakeGeographyPoint(utility::Point point);
 
-    /**
-     * Find an edge that is closest to 'endpoint` and split it into segments.
-     * The segments have one intersection at the location on the closest edge
-     * the `endpoint` is closest to. The other intersection is always an
-     * intersection of the closest edge.
-     *
-     * By having segments it is possible to calculate best paths much more
-     * accurately since it is possible to start the routing algorithm
-     * at the closest point in graph from the `endpoint`.
-     *
-     * @param table_name Table from which segments are got.
-     * @param endpoint Endpoint of a route for which segments are found.
-     * @return Vector of DbRows each representing one segment. Each segment can be transformed to graph edge.
-     */
-    std::vector<DbRow> GetClosestSegments(utility::Point endpoint, const std::string& table_name, DbGraph* db_graph);
-
-    /**
-     * Find geometries of all edges in `edges` and return them.
-     *
-     * @tparam Edge Graph Edge type.
-     * @param edges Vector of edges whose geometries are found.
-     * @param table_name Table where to look for geometries.
-     * @return String of geometries in geoJSON format.
-     */
-    template <typename Edge>
-    std::string GetRouteCoordinates(typename std::vector<Edge>::const_iterator begin, typename std::vector<Edge>::const_iterator end, const std::string& table_name);
-
     /**
      * Load the entire graph from the database table (edgelist)
      */
@@ -141,10 +122,30 @@ public:
 
     void CreateGeographyIndex(const std::string& table_name);
 
+    /**
+     * Mark table with id of the preprocessing run that created it (as a table comment).
+     */
+    void SavePreprocessingId(const std::string& table_name, uint64_t preprocessing_id);
+
+    /**
+     * @return Id saved by SavePreprocessingId or 0 if the table does not exist or has no id.
+     */
+    uint64_t LoadPreprocessingId(const std::string& table_name);
+
     template <typename Graph>
     void LoadAdditionalVertexProperties(const std::string& vertices_table, Graph&g);  
 
+    /**
+     * Load geometries of all edges in the table (must not contain shortcuts) in increasing order of their uids.
+     *
+     * @param f Function called as f(uid, from, to, geometry) for each edge.
+     */
+    template <typename Function>
+    void LoadEdgeGeometries(const std::string& table_name, const Function& f);
+
 private:
+    static inline const std::string kPreprocessingIdPrefix = "preprocessing_id=";
+
     /**
      * Database name.
      */
@@ -180,43 +181,11 @@ private:
 
 };
 
-template <typename Edge>
-std::string DatabaseHelper::GetRouteCoordinates(typename std::vector<Edge>::const_iterator begin, typename std::vector<Edge>::const_iterator end, const std::string& table_name) {
-
-    std::string sql_start = " SELECT uid, ST_AsGeoJSON(geog) " \
-                            " FROM " + table_name + " WHERE ";
-    // Define fold function for std::accumulate.
-    auto fold = [](const std::string& a, const Edge& e) {
-        return std::move(a) + " or uid = " + std::to_string(e.get_uid());
-    };
-
-    // WHERE clause looks like: WHERE uid=3 or uid=42 ...
-    std::string first_cond = " uid = " + std::to_string(begin->get_uid());
-    std::string cond = std::accumulate(begin, end, first_cond, fold);
-    std::string sql_end = " ;";
-    std::string complete_sql = sql_start + cond + sql_end;
-
-    pqxx::nontransaction n(*connection_);
-    pqxx::result result{n.exec(complete_sql)};
-
-    std::unordered_map<unsigned_id_type, std::string> geometries{};
-    for(auto it = result.begin(); it != result.end(); ++it) {
-        geometries.emplace(it[0].as<unsigned_id_type>(), it[1].as<std::string>());
-    }
-    std::string geojson = "";
-    for(auto it = begin; it != end; ++it) {
-        auto&& edge = *it;
-        auto geom_it = geometries.find(edge.get_uid());
-        if (geom_it != geometries.end()) {
-            geojson += std::move(geom_it->second);
-            geojson += ",";
-        } else {
-            std::cout << edge.get_uid() << " not found in edge table but is part of routing result." << std::endl;
-        }
-
-    }
-    return geojson;
-}
+/**
+ * Pool of connections shared by threads. Connections are opened lazily so the pool
+ * itself does not connect to database.
+ */
+using DatabaseConnectionPool = ConnectionPool<DatabaseHelper>;
 
 /*
     * Example of query
@@ -241,7 +210,7 @@ void DatabaseHelper::LoadGraphEdges(const std::string& table_name, Graph& graph,
 template <typename Graph, typename EdgeConvertor>
 void DatabaseHelper::SaveEdges(const std::string& table_name, const std::string& geom_table, Graph& graph, const EdgeConvertor& edge_convertor, DbGraph* db_graph) {
     auto&& current_dir = std::filesystem::current_path();
-    std::string data_path{current_dir.string() + "/graph.csv"};
+    std::string data_path{current_dir.string() + "/" + table_name + ".csv"};
 
     std::string drop_table = "DROP TABLE IF EXISTS " + table_name + "; ";
 					
@@ -296,6 +265,17 @@ void DatabaseHelper::LoadAdditionalVertexProperties(const std::string& vertices_
     }
 }
 
+template <typename Function>
+void DatabaseHelper::LoadEdgeGeometries(const std::string& table_name, const Function& f) {
+    std::string sql = " SELECT uid, from_node, to_node, ST_AsText(geog) FROM " + table_name + " ORDER BY uid;";
+    pqxx::nontransaction n{*connection_};
+    pqxx::result result{n.exec(sql)};
+    for (auto&& it = result.begin(); it != result.end(); ++it) {
+        f(it[0].as<unsigned_id_type>(), it[1].as<unsigned_id_type>(), it[2].as<unsigned_id_type>(),
+            spatial::ParseWktLineString(it[3].as<std::string>()));
+    }
+}
+
 
 
 }
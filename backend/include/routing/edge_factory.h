@@ -8,6 +8,8 @@
 
 #include "routing/profile/profile.h"
 
+#include <memory>
+
 namespace routing{
 
 /**
@@ -96,20 +98,25 @@ public:
     }
 };
 
+/**
+ * ProfileEndpointEdgeFactory creates endpoint edges whose lengths are stored in the factory.
+ * Copies of the factory share the lengths. The created edges are valid only while
+ * the factory or one of its copies exists.
+ */
 template <typename E>
 class ProfileEndpointEdgeFactory{
 public:
     using Edge = E;
 
-    ProfileEndpointEdgeFactory(EndpointEdgesLengths* edge_lengths) : edge_lengths_(edge_lengths) {}
+    ProfileEndpointEdgeFactory() : edge_lengths_(std::make_shared<EndpointEdgesLengths>()) {}
 
     template <typename Input>
     E Create(const Input& input) {
         edge_lengths_->AddLength(input.GetUid(), input.GetLength());
-        return E{input.GetUid(), input.GetFrom(), input.GetTo(), ProfileLengthSource{edge_lengths_}};
+        return E{input.GetUid(), input.GetFrom(), input.GetTo(), ProfileLengthSource{edge_lengths_.get()}};
     }
 private:
-    EndpointEdgesLengths* edge_lengths_;
+    std::shared_ptr<EndpointEdgesLengths> edge_lengths_;
 };
 
 
@@ -0,0 +1,197 @@
+#ifndef ROUTING_EDGE_RANGES_COMPACT_EDGE_RANGE_H
+#define ROUTING_EDGE_RANGES_COMPACT_EDGE_RANGE_H
+
+#include "routing/types.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <iterator>
+
+namespace routing {
+
+/**
+ * CompactEdges stores edges of Contraction Hierarchies as a structure of arrays. Arrays that are read
+ * when an edge is relaxed (targets, lengths, types) are separated from arrays that are only read
+ * when a route is retrieved (uids, middle vertices of shortcuts).
+ *
+ * Edges do not store their source vertex - it is the vertex whose range they belong to. They are only
+ * created as `Edge` objects when they are given to a query algorithm.
+ *
+ * @tparam Edge CHEdge whose length source can be created from a number.
+ */
+template <typename Edge>
+class CompactEdges {
+public:
+    using EdgeType = typename Edge::EdgeType;
+
+    CompactEdges() : targets_(), lengths_(), types_(), uids_(), contracted_vertices_() {}
+
+    void Reserve(size_t edge_count) {
+        targets_.reserve(edge_count);
+        lengths_.reserve(edge_count);
+        types_.reserve(edge_count);
+        uids_.reserve(edge_count);
+        contracted_vertices_.reserve(edge_count);
+    }
+
+    void AddEdge(const Edge& edge) {
+        AddEdge(edge.get_uid(), edge.get_to(), edge.get_length(), edge.IsTwoway() ? EdgeType::twoway : (edge.IsForward() ? EdgeType::forward : EdgeType::backward),
+            edge.get_contracted_vertex());
+    }
+
+    void AddEdge(unsigned_id_type uid, unsigned_id_type to, float length, EdgeType type, unsigned_id_type contracted_vertex) {
+        targets_.push_back(to);
+        lengths_.push_back(length);
+        types_.push_back(static_cast<std::uint8_t>(type));
+        uids_.push_back(uid);
+        contracted_vertices_.push_back(contracted_vertex);
+    }
+
+    size_t GetEdgeCount() const {
+        return targets_.size();
+    }
+
+    bool IsForward(size_t i) const {
+        return types_[i] != static_cast<std::uint8_t>(EdgeType::backward);
+    }
+
+    bool IsBackward(size_t i) const {
+        return types_[i] != static_cast<std::uint8_t>(EdgeType::forward);
+    }
+
+    unsigned_id_type GetUid(size_t i) const {
+        return uids_[i];
+    }
+
+    /**
+     * Create edge `i` that leads from vertex `from`.
+     */
+    Edge CreateEdge(size_t i, unsigned_id_type from) const {
+        return Edge{uids_[i], from, targets_[i], typename Edge::LengthSource{lengths_[i]}, static_cast<EdgeType>(types_[i]), contracted_vertices_[i]};
+    }
+
+    /**
+     * Memory in bytes used by the edges.
+     */
+    size_t GetMemorySize() const {
+        return targets_.capacity() * sizeof(unsigned_id_type) + lengths_.capacity() * sizeof(float) + types_.capacity() * sizeof(std::uint8_t)
+            + uids_.capacity() * sizeof(unsigned_id_type) + contracted_vertices_.capacity() * sizeof(unsigned_id_type);
+    }
+
+private:
+    std::vector<unsigned_id_type> targets_;
+    std::vector<float> lengths_;
+    std::vector<std::uint8_t> types_;
+    std::vector<unsigned_id_type> uids_;
+
+    /**
+     * Middle vertices of shortcuts. Zero for edges that are not shortcuts.
+     */
+    std::vector<unsigned_id_type> contracted_vertices_;
+};
+
+/**
+ * CompactEdgeRange is a range of edges [begin, end) in CompactEdges.
+ */
+template <typename Edge>
+class CompactEdgeRange {
+public:
+    class Iterator;
+    class View;
+
+    /**
+     * Empty range. It points to shared empty edges so that it can be iterated like any other range.
+     */
+    CompactEdgeRange() : edges_(&GetEmptyEdges()), begin_(0), end_(0) {}
+
+    CompactEdgeRange(const CompactEdges<Edge>* edges, size_t begin, size_t end)
+        : edges_(edges), begin_(static_cast<std::uint32_t>(begin)), end_(static_cast<std::uint32_t>(end)) {
+        assert(end <= UINT32_MAX);
+    }
+
+    const CompactEdges<Edge>& get_edges() const {
+        return *edges_;
+    }
+
+    size_t begin() const {
+        return begin_;
+    }
+
+    size_t end() const {
+        return end_;
+    }
+
+    /**
+     * Edges of the range as if they were stored in vector - they lead from vertex `from`.
+     */
+    View GetView(unsigned_id_type from) const {
+        return View{*this, from};
+    }
+
+    /**
+     * Input iterator that creates edges of a range.
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Edge;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Edge*;
+        using reference = Edge;
+
+        Iterator(const CompactEdges<Edge>* edges, size_t i, unsigned_id_type from) : edges_(edges), i_(i), from_(from) {}
+
+        Edge operator*() const {
+            return edges_->CreateEdge(i_, from_);
+        }
+
+        Iterator& operator++() {
+            ++i_;
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return i_ == other.i_;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return i_ != other.i_;
+        }
+    private:
+        const CompactEdges<Edge>* edges_;
+        size_t i_;
+        unsigned_id_type from_;
+    };
+
+    class View {
+    public:
+        View(const CompactEdgeRange& range, unsigned_id_type from) : range_(range), from_(from) {}
+
+        Iterator begin() const {
+            return Iterator{range_.edges_, range_.begin_, from_};
+        }
+
+        Iterator end() const {
+            return Iterator{range_.edges_, range_.end_, from_};
+        }
+    private:
+        CompactEdgeRange range_;
+        unsigned_id_type from_;
+    };
+
+private:
+    const CompactEdges<Edge>* edges_;
+    std::uint32_t begin_;
+    std::uint32_t end_;
+
+    static const CompactEdges<Edge>& GetEmptyEdges() {
+        static const CompactEdges<Edge> empty_edges{};
+        return empty_edges;
+    }
+};
+
+}
+
+#endif //ROUTING_EDGE_RANGES_COMPACT_EDGE_RANGE_H
@@ -98,6 +98,43 @@ private:
     DynamicLengthSource* profile_;
 };
 
+/**
+ * EdgeLength provides lengths of edges to query algorithms. The lengths are
+ * the ones that are given by the length sources of the edges.
+ */
+class EdgeLength{
+public:
+    template <typename Edge>
+    float operator()(const Edge& edge) const {
+        return edge.get_length();
+    }
+};
+
+/**
+ * ProfileEdgeLength provides lengths of edges to query algorithms based on a profile of one routing request.
+ * Edges of a graph do not need to reference the profile so requests with different profiles
+ * can be routed in the same graph at the same time.
+ * 
+ * Temporary endpoint edges are not part of any profile. They are recognized by having an endpoint vertex
+ * with id greater than the maximum vertex id of the graph and their lengths are given by their length sources.
+ */
+class ProfileEdgeLength{
+public:
+    ProfileEdgeLength(const profile::Profile& profile, unsigned_id_type max_vertex_id) : profile_(&profile), max_vertex_id_(max_vertex_id) {}
+
+    template <typename Edge>
+    float operator()(const Edge& edge) const {
+        if (edge.get_from() > max_vertex_id_ || edge.get_to() > max_vertex_id_) {
+            return edge.get_length();
+        }
+        return profile_->GetLength(edge.get_uid());
+    }
+
+private:
+    const profile::Profile* profile_;
+    unsigned_id_type max_vertex_id_;
+};
+
 
 
 }
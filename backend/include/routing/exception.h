@@ -90,6 +90,26 @@ public:
     const char* what() const _GLIBCXX_TXN_SAFE_DYN _GLIBCXX_NOTHROW override;
 };
 
+class SnapshotException : public std::exception {
+    std::string message_;
+public:
+    SnapshotException();
+    SnapshotException(const std::string& message);
+    SnapshotException(std::string&& message);
+
+    const char* what() const _GLIBCXX_TXN_SAFE_DYN _GLIBCXX_NOTHROW override;
+};
+
+class TimeoutException : public std::exception {
+    std::string message_;
+public:
+    TimeoutException();
+    TimeoutException(const std::string& message);
+    TimeoutException(std::string&& message);
+
+    const char* what() const _GLIBCXX_TXN_SAFE_DYN _GLIBCXX_NOTHROW override;
+};
+
 
 
 
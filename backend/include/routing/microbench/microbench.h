@@ -0,0 +1,177 @@
+#ifndef ROUTING_MICROBENCH_MICROBENCH_H
+#define ROUTING_MICROBENCH_MICROBENCH_H
+
+#include "routing/microbench/synthetic_graph.h"
+#include "routing/adjacency_list_graph.h"
+#include "routing/bidirectional_graph.h"
+#include "routing/ch_search_graph.h"
+#include "routing/edges/basic_edge.h"
+#include "routing/edges/ch_edge.h"
+#include "routing/edges/length_source.h"
+#include "routing/vertices/basic_vertex.h"
+#include "routing/vertices/ch_vertex.h"
+#include "routing/edge_ranges/vector_edge_range.h"
+#include "routing/edge_ranges/iterator_edge_range.h"
+#include "routing/preprocessing/graph_contractor.h"
+#include "routing/preprocessing/contraction_parameters.h"
+#include "routing/types.h"
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace routing {
+namespace microbench {
+
+using BaseEdge = BasicEdge<NumberLengthSource>;
+using BaseGraph = AdjacencyListGraph<BasicVertex<BaseEdge, VectorEdgeRange<BaseEdge>>, BaseEdge>;
+using CHGraphEdge = CHEdge<NumberLengthSource>;
+using CHGraph = BidirectionalGraph<AdjacencyListGraph<CHVertex<CHGraphEdge, VectorEdgeRange<CHGraphEdge>>, CHGraphEdge>>;
+using SearchGraph = CHSearchGraph<CHVertex<CHGraphEdge, IteratorEdgeRange<CHGraphEdge, std::vector<CHGraphEdge>::iterator>>, CHGraphEdge>;
+
+struct MicrobenchOptions {
+    std::vector<GraphKind> graph_kinds;
+    std::vector<size_t> graph_sizes;
+    uint64_t seed;
+
+    /**
+     * Threads that contract graphs for the query benchmarks. Contraction itself is not measured.
+     */
+    size_t contraction_threads;
+
+    /**
+     * Parameters of the preprocessing kernels - the defaults of the routing configurations.
+     */
+    preprocessing::ContractionParameters GetContractionParameters() const {
+        return preprocessing::ContractionParameters{5, 190, 120, 0, contraction_threads};
+    }
+};
+
+/**
+ * GraphCache builds each graph needed by the benchmarks once - the same graph is used by benchmarks
+ * of all kernels and by their repetitions. Graphs are built lazily so that filtered out benchmarks
+ * do not wait for contraction of graphs they do not use.
+ */
+class GraphCache {
+public:
+    GraphCache(const MicrobenchOptions& options) : options_(options), graphs_() {}
+
+    GraphCache(const GraphCache& other) = delete;
+    GraphCache& operator=(const GraphCache& other) = delete;
+
+    const SyntheticGraph& GetSyntheticGraph(GraphKind kind, size_t size) {
+        return GetGraphs(kind, size).synthetic;
+    }
+
+    /**
+     * Graph for unidirectional Dijkstra.
+     */
+    BaseGraph& GetBaseGraph(GraphKind kind, size_t size) {
+        auto&& graphs = GetGraphs(kind, size);
+        if (!graphs.base) {
+            graphs.base = std::make_unique<BaseGraph>();
+            graphs.synthetic.AddTo(*graphs.base);
+        }
+        return *graphs.base;
+    }
+
+    /**
+     * Graph before contraction as it is searched by the preprocessing kernels.
+     */
+    CHGraph& GetUncontractedGraph(GraphKind kind, size_t size) {
+        auto&& graphs = GetGraphs(kind, size);
+        if (!graphs.uncontracted) {
+            graphs.uncontracted = std::make_unique<CHGraph>();
+            graphs.synthetic.AddTo(*graphs.uncontracted);
+        }
+        return *graphs.uncontracted;
+    }
+
+    /**
+     * Contracted graph for queries of Contraction Hierarchies.
+     */
+    SearchGraph& GetSearchGraph(GraphKind kind, size_t size) {
+        auto&& graphs = GetGraphs(kind, size);
+        if (!graphs.search) {
+            CHGraph g{};
+            graphs.synthetic.AddTo(g);
+            preprocessing::GraphContractor<CHGraph> contractor{g, options_.GetContractionParameters(), graphs.synthetic.GetMaxEdgeId() + 1};
+            contractor.ContractGraph();
+            graphs.search = std::make_unique<SearchGraph>();
+            graphs.search->Load(g);
+        }
+        return *graphs.search;
+    }
+
+    const std::vector<std::pair<unsigned_id_type, unsigned_id_type>>& GetQueries(GraphKind kind, size_t size) {
+        auto&& graphs = GetGraphs(kind, size);
+        if (graphs.queries.empty()) {
+            SyntheticRandom random{options_.seed};
+            auto&& get_vertex = [&]() {
+                return static_cast<unsigned_id_type>(1 + random.NextUnit() * graphs.synthetic.vertex_count);
+            };
+            for (size_t i = 0; i < kQueryCount; ++i) {
+                unsigned_id_type source = get_vertex();
+                unsigned_id_type target = get_vertex();
+                if (source != target) {
+                    graphs.queries.emplace_back(source, target);
+                }
+            }
+        }
+        return graphs.queries;
+    }
+
+    const MicrobenchOptions& get_options() const {
+        return options_;
+    }
+
+private:
+    /**
+     * Number of random source-target pairs which the query benchmarks cycle through.
+     */
+    static const size_t kQueryCount = 1000;
+
+    struct Graphs {
+        SyntheticGraph synthetic;
+        std::unique_ptr<BaseGraph> base;
+        std::unique_ptr<CHGraph> uncontracted;
+        std::unique_ptr<SearchGraph> search;
+        std::vector<std::pair<unsigned_id_type, unsigned_id_type>> queries;
+
+        Graphs(SyntheticGraph&& s) : synthetic(std::move(s)), base(), uncontracted(), search(), queries() {}
+    };
+
+    MicrobenchOptions options_;
+    std::map<std::pair<GraphKind, size_t>, std::unique_ptr<Graphs>> graphs_;
+
+    Graphs& GetGraphs(GraphKind kind, size_t size) {
+        auto&& it = graphs_.find(std::make_pair(kind, size));
+        if (it == graphs_.end()) {
+            it = graphs_.emplace(std::make_pair(kind, size), std::make_unique<Graphs>(GenerateGraph(kind, size, options_.seed))).first;
+        }
+        return *it->second;
+    }
+};
+
+/**
+ * Register benchmarks of Dijkstra, BidirectionalDijkstra on CHSearchGraph and route unpacking
+ * for each graph kind and size of the options.
+ */
+void RegisterQueryBenchmarks(GraphCache& cache);
+
+/**
+ * Register benchmarks of CHDijkstra witness searches and ShortcutFinder::FindShortcuts.
+ */
+void RegisterPreprocessingBenchmarks(GraphCache& cache);
+
+/**
+ * Register benchmarks of Profile::GetLength with in-memory preference indices.
+ */
+void RegisterProfileBenchmarks(GraphCache& cache);
+
+}
+}
+#endif //ROUTING_MICROBENCH_MICROBENCH_H
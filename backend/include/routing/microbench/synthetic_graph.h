@@ -0,0 +1,332 @@
+#ifndef ROUTING_MICROBENCH_SYNTHETIC_GRAPH_H
+#define ROUTING_MICROBENCH_SYNTHETIC_GRAPH_H
+
+#include "routing/types.h"
+#include "routing/exception.h"
+
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace routing {
+namespace microbench {
+
+enum class GraphKind {
+    /**
+     * Square grid of twoway streets with slightly varying lengths.
+     */
+    kGrid,
+
+    /**
+     * Random points in a square connected to all points within a radius.
+     */
+    kRandomGeometric,
+
+    /**
+     * Perturbed grid with missing and oneway streets and faster arterial roads.
+     */
+    kRoadLike
+};
+
+inline GraphKind ParseGraphKind(const std::string& name) {
+    if (name == "grid") {
+        return GraphKind::kGrid;
+    } else if (name == "random_geometric") {
+        return GraphKind::kRandomGeometric;
+    } else if (name == "road_like") {
+        return GraphKind::kRoadLike;
+    }
+    throw InvalidArgumentException{"Unknown graph kind " + name + " - use grid, random_geometric or road_like."};
+}
+
+inline std::string GetGraphKindName(GraphKind kind) {
+    switch (kind) {
+        case GraphKind::kGrid:
+            return "grid";
+        case GraphKind::kRandomGeometric:
+            return "random_geometric";
+        default:
+            return "road_like";
+    }
+}
+
+struct SyntheticEdge {
+    unsigned_id_type from;
+    unsigned_id_type to;
+    float length;
+    bool twoway;
+
+    SyntheticEdge(unsigned_id_type f, unsigned_id_type t, float l, bool tw) : from(f), to(t), length(l), twoway(tw) {}
+};
+
+/**
+ * SyntheticGraph is a generated road network for benchmarks which do not need a database.
+ * Vertices have ids 1..vertex_count and every vertex can reach every other vertex.
+ * Edge ids are positions in `edges` plus one.
+ */
+struct SyntheticGraph {
+    size_t vertex_count;
+    std::vector<SyntheticEdge> edges;
+
+    SyntheticGraph() : vertex_count(0), edges() {}
+
+    /**
+     * Add edges to a graph of BasicEdge or CHEdge. Twoway edges are added as twoway edges
+     * which the graph stores in both directions.
+     */
+    template <typename Graph>
+    void AddTo(Graph& g) const {
+        using Edge = typename Graph::Edge;
+        for (size_t i = 0; i < edges.size(); ++i) {
+            auto&& e = edges[i];
+            g.AddEdge(Edge{static_cast<unsigned_id_type>(i + 1), e.from, e.to, e.length, e.twoway ? Edge::EdgeType::twoway : Edge::EdgeType::forward});
+        }
+    }
+
+    unsigned_id_type GetMaxEdgeId() const {
+        return static_cast<unsigned_id_type>(edges.size());
+    }
+};
+
+/**
+ * Deterministic source of random numbers for the generators.
+ *
+ * The same seed generates the same graph with any standard library - numbers are
+ * mapped without std distributions whose results are implementation defined.
+ */
+class SyntheticRandom {
+public:
+    SyntheticRandom(uint64_t seed) : generator_(seed) {}
+
+    /**
+     * Uniform double in [0, 1) from 53 random bits.
+     */
+    double NextUnit() {
+        return static_cast<double>(generator_() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    double Next(double low, double high) {
+        return low + (high - low) * NextUnit();
+    }
+
+    bool NextBool(double probability) {
+        return NextUnit() < probability;
+    }
+
+private:
+    std::mt19937_64 generator_;
+};
+
+/**
+ * Keep only vertices which are in the same strongly connected component as most vertices
+ * and renumber them to 1..count. Queries between any two generated vertices then always succeed.
+ */
+inline void KeepLargestComponent(SyntheticGraph& graph) {
+    size_t n = graph.vertex_count;
+    std::vector<std::vector<unsigned_id_type>> forward(n + 1);
+    std::vector<std::vector<unsigned_id_type>> backward(n + 1);
+    for (auto&& e : graph.edges) {
+        forward[e.from].push_back(e.to);
+        backward[e.to].push_back(e.from);
+        if (e.twoway) {
+            forward[e.to].push_back(e.from);
+            backward[e.from].push_back(e.to);
+        }
+    }
+    auto&& reach = [&](unsigned_id_type root, const std::vector<std::vector<unsigned_id_type>>& adjacency) {
+        std::vector<bool> reached(n + 1, false);
+        std::vector<unsigned_id_type> stack{root};
+        reached[root] = true;
+        while (!stack.empty()) {
+            unsigned_id_type v = stack.back();
+            stack.pop_back();
+            for (unsigned_id_type w : adjacency[v]) {
+                if (!reached[w]) {
+                    reached[w] = true;
+                    stack.push_back(w);
+                }
+            }
+        }
+        return reached;
+    };
+
+    std::vector<bool> component{};
+    size_t component_size = 0;
+    std::vector<bool> checked(n + 1, false);
+    // A component with more than half of the vertices is the largest one - usually the first root finds it.
+    for (unsigned_id_type root = 1; root <= n && component_size * 2 <= n; ++root) {
+        if (checked[root]) {
+            continue;
+        }
+        auto&& forward_reached = reach(root, forward);
+        auto&& backward_reached = reach(root, backward);
+        std::vector<bool> root_component(n + 1, false);
+        size_t size = 0;
+        for (size_t v = 1; v <= n; ++v) {
+            if (forward_reached[v] && backward_reached[v]) {
+                root_component[v] = true;
+                checked[v] = true;
+                ++size;
+            }
+        }
+        if (size > component_size) {
+            component = std::move(root_component);
+            component_size = size;
+        }
+    }
+
+    std::vector<unsigned_id_type> new_ids(n + 1, 0);
+    unsigned_id_type next_id = 0;
+    for (size_t v = 1; v <= n; ++v) {
+        if (component[v]) {
+            new_ids[v] = ++next_id;
+        }
+    }
+    std::vector<SyntheticEdge> edges{};
+    edges.reserve(graph.edges.size());
+    for (auto&& e : graph.edges) {
+        if (component[e.from] && component[e.to]) {
+            edges.emplace_back(new_ids[e.from], new_ids[e.to], e.length, e.twoway);
+        }
+    }
+    graph.vertex_count = component_size;
+    graph.edges = std::move(edges);
+}
+
+/**
+ * Grid of about `vertex_count` vertices. Edges are 100 long +-20%.
+ */
+inline SyntheticGraph GenerateGridGraph(size_t vertex_count, uint64_t seed) {
+    SyntheticRandom random{seed};
+    size_t columns = std::max<size_t>(2, static_cast<size_t>(std::sqrt(static_cast<double>(vertex_count))));
+    size_t rows = std::max<size_t>(2, vertex_count / columns);
+    auto&& get_vertex = [&](size_t row, size_t column) {
+        return static_cast<unsigned_id_type>(1 + row * columns + column);
+    };
+    SyntheticGraph graph{};
+    graph.vertex_count = rows * columns;
+    for (size_t row = 0; row < rows; ++row) {
+        for (size_t column = 0; column < columns; ++column) {
+            if (column + 1 < columns) {
+                graph.edges.emplace_back(get_vertex(row, column), get_vertex(row, column + 1), static_cast<float>(random.Next(80, 120)), true);
+            }
+            if (row + 1 < rows) {
+                graph.edges.emplace_back(get_vertex(row, column), get_vertex(row + 1, column), static_cast<float>(random.Next(80, 120)), true);
+            }
+        }
+    }
+    return graph;
+}
+
+/**
+ * Random geometric graph - `vertex_count` points in a square with one point per 100x100 on average
+ * where points closer than `radius` are connected by twoway edges of their euclidean length.
+ * The default radius gives average degree of about 6. Only the largest component is kept.
+ */
+inline SyntheticGraph GenerateRandomGeometricGraph(size_t vertex_count, uint64_t seed, double radius = 138) {
+    SyntheticRandom random{seed};
+    double side = 100 * std::sqrt(static_cast<double>(vertex_count));
+    std::vector<double> xs(vertex_count + 1);
+    std::vector<double> ys(vertex_count + 1);
+    for (size_t v = 1; v <= vertex_count; ++v) {
+        xs[v] = random.Next(0, side);
+        ys[v] = random.Next(0, side);
+    }
+
+    // Points are bucketed to cells of the radius size so only neighbouring cells are compared.
+    size_t cells = std::max<size_t>(1, static_cast<size_t>(side / radius));
+    double cell_size = side / cells;
+    auto&& get_cell = [&](double coordinate) {
+        return std::min(cells - 1, static_cast<size_t>(coordinate / cell_size));
+    };
+    std::vector<std::vector<unsigned_id_type>> buckets(cells * cells);
+    for (size_t v = 1; v <= vertex_count; ++v) {
+        buckets[get_cell(ys[v]) * cells + get_cell(xs[v])].push_back(static_cast<unsigned_id_type>(v));
+    }
+
+    SyntheticGraph graph{};
+    graph.vertex_count = vertex_count;
+    for (size_t v = 1; v <= vertex_count; ++v) {
+        size_t row = get_cell(ys[v]);
+        size_t column = get_cell(xs[v]);
+        for (size_t r = row > 0 ? row - 1 : 0; r <= std::min(cells - 1, row + 1); ++r) {
+            for (size_t c = column > 0 ? column - 1 : 0; c <= std::min(cells - 1, column + 1); ++c) {
+                for (unsigned_id_type w : buckets[r * cells + c]) {
+                    double distance = std::hypot(xs[v] - xs[w], ys[v] - ys[w]);
+                    // Each pair is added once.
+                    if (w > v && distance < radius) {
+                        graph.edges.emplace_back(static_cast<unsigned_id_type>(v), w, static_cast<float>(std::max(distance, 1.0)), true);
+                    }
+                }
+            }
+        }
+    }
+    KeepLargestComponent(graph);
+    return graph;
+}
+
+/**
+ * Road-like graph of about `vertex_count` vertices - a grid where 15% of streets are missing,
+ * 10% are oneway and every 8th row and column is an arterial road which is twice as fast.
+ * Only the largest strongly connected component is kept.
+ */
+inline SyntheticGraph GenerateRoadLikeGraph(size_t vertex_count, uint64_t seed) {
+    static const size_t kArterialSpacing = 8;
+    SyntheticRandom random{seed};
+    size_t columns = std::max<size_t>(2, static_cast<size_t>(std::sqrt(static_cast<double>(vertex_count))));
+    size_t rows = std::max<size_t>(2, vertex_count / columns);
+    auto&& get_vertex = [&](size_t row, size_t column) {
+        return static_cast<unsigned_id_type>(1 + row * columns + column);
+    };
+    SyntheticGraph graph{};
+    graph.vertex_count = rows * columns;
+    auto&& add_street = [&](unsigned_id_type from, unsigned_id_type to, bool arterial) {
+        float length = static_cast<float>(random.Next(60, 140));
+        if (arterial) {
+            graph.edges.emplace_back(from, to, length / 2, true);
+            return;
+        }
+        if (random.NextBool(0.15)) {
+            return;
+        }
+        if (random.NextBool(0.1)) {
+            if (random.NextBool(0.5)) {
+                std::swap(from, to);
+            }
+            graph.edges.emplace_back(from, to, length, false);
+        } else {
+            graph.edges.emplace_back(from, to, length, true);
+        }
+    };
+    for (size_t row = 0; row < rows; ++row) {
+        for (size_t column = 0; column < columns; ++column) {
+            if (column + 1 < columns) {
+                add_street(get_vertex(row, column), get_vertex(row, column + 1), row % kArterialSpacing == 0);
+            }
+            if (row + 1 < rows) {
+                add_street(get_vertex(row, column), get_vertex(row + 1, column), column % kArterialSpacing == 0);
+            }
+        }
+    }
+    KeepLargestComponent(graph);
+    return graph;
+}
+
+inline SyntheticGraph GenerateGraph(GraphKind kind, size_t vertex_count, uint64_t seed) {
+    switch (kind) {
+        case GraphKind::kGrid:
+            return GenerateGridGraph(vertex_count, seed);
+        case GraphKind::kRandomGeometric:
+            return GenerateRandomGeometricGraph(vertex_count, seed);
+        default:
+            return GenerateRoadLikeGraph(vertex_count, seed);
+    }
+}
+
+}
+}
+#endif //ROUTING_MICROBENCH_SYNTHETIC_GRAPH_H
@@ -0,0 +1,86 @@
+#ifndef ROUTING_PREPROCESSING_CCH_PREPROCESSOR_H
+#define ROUTING_PREPROCESSING_CCH_PREPROCESSOR_H
+
+#include "routing/cch/nested_dissection.h"
+
+#include "routing/vertices/ch_vertex.h"
+#include "routing/edges/ch_edge.h"
+#include "routing/edge_ranges/vector_edge_range.h"
+#include "routing/adjacency_list_graph.h"
+#include "routing/table_names.h"
+#include "routing/edges/length_source.h"
+#include "routing/edge_factory.h"
+#include "routing/types.h"
+
+#include "routing/database/database_helper.h"
+#include "routing/database/db_graph.h"
+#include "routing/database/csv_convertor.h"
+
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace routing{
+namespace preprocessing{
+
+/**
+ * CCHPreprocessor computes the vertex ordering of Customizable Contraction Hierarchies by nested dissection
+ * of the base graph and saves it to the vertices table. The ordering does not depend on edge lengths
+ * so it is computed only once for all profiles.
+ */
+class CCHPreprocessor{
+    using Edge = CHEdge<NumberLengthSource>;
+public:
+    using Graph = AdjacencyListGraph<CHVertex<Edge, VectorEdgeRange<Edge>>, Edge>;
+
+    CCHPreprocessor(std::reference_wrapper<database::DatabaseHelper> d, TableNames* table_names)
+        : d_(d), table_names_(table_names) {}
+
+    Graph LoadGraph();
+
+    /**
+     * Set ordering ranks of graph vertices.
+     */
+    void RunPreprocessing(Graph& g);
+
+    void SaveGraph(Graph& g);
+
+private:
+    std::reference_wrapper<database::DatabaseHelper> d_;
+    TableNames* table_names_;
+};
+
+inline CCHPreprocessor::Graph CCHPreprocessor::LoadGraph() {
+    std::cout << "Load graph from " << table_names_->GetBaseTableName() << "." << std::endl;
+    Graph g{};
+    database::UnpreprocessedDbGraph unpreprocessed_db_graph{};
+    CHNumberEdgeFactory edge_factory{};
+    d_.get().LoadGraphEdges<Graph>(table_names_->GetBaseTableName(), g, &unpreprocessed_db_graph, edge_factory);
+    return g;
+}
+
+inline void CCHPreprocessor::RunPreprocessing(Graph& g) {
+    std::cout << "Vertices: " << g.GetVertexCount() << std::endl;
+    cch::NestedDissection nested_dissection{};
+    g.ForEachEdge([&](Edge& edge) {
+        nested_dissection.AddEdge(edge.get_from(), edge.get_to());
+    });
+    std::vector<unsigned_id_type> ordering_ranks = nested_dissection.ComputeOrdering();
+    g.ForEachVertex([&](Graph::Vertex& vertex) {
+        vertex.set_ordering_rank(ordering_ranks[vertex.get_uid()]);
+    });
+    std::cout << "Nested dissection done." << std::endl;
+}
+
+inline void CCHPreprocessor::SaveGraph(Graph& g) {
+    database::CHDbGraph ch_db_graph{};
+    std::string cch_vertex_table{table_names_->GetVerticesTable()};
+    d_.get().SaveVertices(cch_vertex_table, g, database::CHVertexConvertor<Graph::Vertex>{}, &ch_db_graph);
+    std::cout << "Vertices saved to " << cch_vertex_table << "." << std::endl;
+}
+
+
+
+}
+}
+#endif // ROUTING_PREPROCESSING_CCH_PREPROCESSOR_H
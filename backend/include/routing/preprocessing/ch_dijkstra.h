@@ -1,7 +1,6 @@
 #ifndef ROUTING_PREPROCESSING_CH_DIJKSTRA_H
 #define ROUTING_PREPROCESSING_CH_DIJKSTRA_H
 #include <vector>
-#include <queue>
 #include <limits>
 #include <algorithm>
 #include <cassert>
@@ -11,6 +10,8 @@
 #include "routing/exception.h"
 #include "routing/edges/basic_edge.h"
 #include "routing/vertices/basic_vertex.h"
+#include "routing/utility/priority_queue.h"
+#include "routing/utility/epoch_vector.h"
 #include "routing/types.h"
 
 #include "tsl/robin_map.h"
@@ -22,13 +23,16 @@ namespace preprocessing {
  * Implementation of dijkstra's algorithm modified for Contraction Hierarchies' local search.
  * There are lots of search limits or custom CH conditions. Especially function for one hop
  * backwards from target vertices of the search.
+ *
+ * @tparam Q Priority queue of vertices with decrease-key - utility::IndexedDaryHeap or utility::LazyBinaryHeap.
  */
-template <typename G>
+template <typename G, typename Q = utility::IndexedDaryHeap<>>
 class CHDijkstra {
 public:
     using Vertex = typename G::Vertex;
     using Edge = typename G::Edge;
     using Graph = G;
+    using PriorityQueue = Q;
 	using TargetVerticesMap = tsl::robin_map<unsigned_id_type, bool>;
 
     struct SearchRangeLimits {
@@ -68,19 +72,18 @@ public:
 	}
 private:
     struct VertexRoutingProperties;
-	struct PriorityQueueMember;
-	struct PriorityQueueMemberMinComparator;
-    using PriorityQueue = std::priority_queue<PriorityQueueMember, std::vector<PriorityQueueMember>, PriorityQueueMemberMinComparator>;
     G& g_;
 
 	/**
-	 * Stores all reached vertices from Run function. STL unordered map is not used,
-	 * since slows the entire preprocessing wrt performance and memory usage.
+	 * Stores all reached vertices from Run function. Hash maps are not used since the local search
+	 * is run very often and clearing the vector is constant.
 	 */
-	// using UnorderedMap = std::unordered_map<unsigned_id_type, VertexRoutingProperties>;
-	// using UnorderedMap = robin_hood::unordered_map<unsigned_id_type, VertexRoutingProperties>;
-	using UnorderedMap = tsl::robin_map<unsigned_id_type, VertexRoutingProperties>;
-    UnorderedMap touched_vertices_;
+	utility::EpochVector<VertexRoutingProperties> touched_vertices_;
+
+	/**
+	 * The queue is kept between searches since the local search is run for each contracted vertex.
+	 */
+	Q queue_;
 
     unsigned_id_type source_vertex_;
 	unsigned_id_type contracted_vertex_;
@@ -98,9 +101,14 @@ private:
         float cost;
         unsigned_id_type previous;
 
-		VertexRoutingProperties() : cost(std::numeric_limits<float>::max()), previous(0) {}
+		/**
+		 * Number of edges of the path with `cost`.
+		 */
+		size_t hop_count;
+
+		VertexRoutingProperties() : cost(std::numeric_limits<float>::max()), previous(0), hop_count(0) {}
 
-        VertexRoutingProperties(float c, unsigned_id_type p) : cost(c), previous(p) {}
+        VertexRoutingProperties(float c, unsigned_id_type p, size_t h) : cost(c), previous(p), hop_count(h) {}
 
         VertexRoutingProperties(const VertexRoutingProperties& other) = default;
         VertexRoutingProperties(VertexRoutingProperties&& other) = default;
@@ -109,74 +117,38 @@ private:
         ~VertexRoutingProperties() = default;
     };
 
-	/**
-	 * Struct for priority queue used in Run function.
-	 */
-	struct PriorityQueueMember {
-		float cost;
-		unsigned_id_type vertex_id;
-		size_t hop_count;
-
-		PriorityQueueMember(float c, unsigned_id_type v, size_t h) : cost(c), vertex_id(v), hop_count(h) {}
-
-		PriorityQueueMember(const PriorityQueueMember& other) = default;
-        PriorityQueueMember(PriorityQueueMember&& other) = default;
-        PriorityQueueMember& operator= (const PriorityQueueMember& other) = default;
-        PriorityQueueMember& operator= (PriorityQueueMember&& other) = default;
-        ~PriorityQueueMember() = default;
-
-		bool operator< (const PriorityQueueMember& other) const {
-            return cost < other.cost;
-        }
-
-        bool operator> (const PriorityQueueMember& other) const {
-            return cost > other.cost;
-        }
-	};
-
-    struct PriorityQueueMemberMinComparator {
-        bool operator() (const PriorityQueueMember& a , const PriorityQueueMember& b) const {
-            return a.cost > b.cost;
-        }
-    };
-
 	/**
 	 * Some vertices are always ingorned in the search - already contracted vertices, the to be contracted vertex.
 	 */
 	bool IgnoreNeighbour(const Vertex& neighbour);
 
-	void UpdateNeighbour(const PriorityQueueMember& min_member, const Edge& edge, PriorityQueue& q, const SearchRangeLimits& limits);
+	void UpdateNeighbour(unsigned_id_type vertex_id, const VertexRoutingProperties& vertex_routing_properties, const Edge& edge);
 };
 
-template< typename G>
-CHDijkstra<G>::CHDijkstra(G & g) : g_(g), touched_vertices_(1000), source_vertex_(0), contracted_vertex_(0), settled_vertices_(0) {}
+template <typename G, typename Q>
+CHDijkstra<G, Q>::CHDijkstra(G & g) : g_(g), touched_vertices_(), queue_(), source_vertex_(0), contracted_vertex_(0), settled_vertices_(0) {}
 
 
-template <typename G>
-bool CHDijkstra<G>::Run(unsigned_id_type source_vertex, unsigned_id_type contracted_vertex, const SearchRangeLimits& limits, TargetVerticesMap& target_vertices) {
+template <typename G, typename Q>
+bool CHDijkstra<G, Q>::Run(unsigned_id_type source_vertex, unsigned_id_type contracted_vertex, const SearchRangeLimits& limits, TargetVerticesMap& target_vertices) {
 	assert(source_vertex != contracted_vertex);
 	
-	touched_vertices_.clear();
+	touched_vertices_.Clear();
 	source_vertex_ = source_vertex;
 	settled_vertices_ = 0;
 	contracted_vertex_ = contracted_vertex;
-	touched_vertices_.insert_or_assign(source_vertex, VertexRoutingProperties{0, 0});
-	PriorityQueue q{};
-	q.emplace(0, source_vertex, 0);
-	size_t dead_members = 0;
+	touched_vertices_[source_vertex] = VertexRoutingProperties{0, 0, 0};
+	queue_.Clear();
+	queue_.Push(source_vertex, 0);
 	size_t target_vertices_found = 0;
-	while(!q.empty()) {
-		PriorityQueueMember min_member = q.top();
-		q.pop();
-		assert(touched_vertices_.contains(min_member.vertex_id));
-		assert(min_member.hop_count < limits.max_hop_count);
+	while(!queue_.Empty()) {
+		utility::QueueMember min_member = queue_.Pop();
+		assert(touched_vertices_.Contains(min_member.vertex_id));
 		auto&& vertex = g_.GetVertex(min_member.vertex_id);
 		VertexRoutingProperties vertex_routing_properties = touched_vertices_[min_member.vertex_id];
-		
-		// There might be more members in the `q` for one vertex - always use only the minimal one.
-		bool queue_member_is_dead = vertex_routing_properties.cost < min_member.cost;
-		if (queue_member_is_dead) {
-			++dead_members;
+
+		// The shortest path to the vertex has too many edges - it is not settled or searched from.
+		if (vertex_routing_properties.hop_count >= limits.max_hop_count) {
 			continue;
 		}
 		++settled_vertices_;
@@ -192,14 +164,14 @@ bool CHDijkstra<G>::Run(unsigned_id_type source_vertex, unsigned_id_type contrac
 			return true;
 		}
 		vertex.ForEachEdge([&](Edge& edge) {
-			UpdateNeighbour(min_member, edge, q, limits);
+			UpdateNeighbour(min_member.vertex_id, vertex_routing_properties, edge);
 		});
 	}
 	return false;
 }
 
-template <typename G>
-float CHDijkstra<G>::OneHopBackwardSearch(unsigned_id_type target_vertex_id) const {
+template <typename G, typename Q>
+float CHDijkstra<G, Q>::OneHopBackwardSearch(unsigned_id_type target_vertex_id) const {
 	assert(GetPathLength(contracted_vertex_) == std::numeric_limits<float>::max());
 	auto&& end_vertex = g_.GetVertex(target_vertex_id);
 
@@ -217,33 +189,29 @@ float CHDijkstra<G>::OneHopBackwardSearch(unsigned_id_type target_vertex_id) con
 	return min_path_length;
 }
 
-template <typename G>
-inline bool CHDijkstra<G>::IgnoreNeighbour(const Vertex& neighbour) {
+template <typename G, typename Q>
+inline bool CHDijkstra<G, Q>::IgnoreNeighbour(const Vertex& neighbour) {
 	return neighbour.IsContracted() || neighbour.get_uid() == contracted_vertex_;
 }
 
-template <typename G>
-void CHDijkstra<G>::UpdateNeighbour(const PriorityQueueMember& min_member, const Edge& edge, PriorityQueue& q, const SearchRangeLimits& limits) {
+template <typename G, typename Q>
+void CHDijkstra<G, Q>::UpdateNeighbour(unsigned_id_type vertex_id, const VertexRoutingProperties& vertex_routing_properties, const Edge& edge) {
 	unsigned_id_type neighbour_id = edge.get_to();
 	auto&& neighbour_routing_properties = touched_vertices_[neighbour_id];
-	float update_cost = min_member.cost + edge.get_length();
+	float update_cost = vertex_routing_properties.cost + edge.get_length();
 	if (update_cost < neighbour_routing_properties.cost && !IgnoreNeighbour(g_.GetVertex(neighbour_id)) ) {
 		neighbour_routing_properties.cost = update_cost;
-		neighbour_routing_properties.previous = min_member.vertex_id;
-		size_t update_hop_count = min_member.hop_count + 1;
-		if (update_hop_count < limits.max_hop_count) {
-			q.emplace(neighbour_routing_properties.cost, neighbour_id, update_hop_count);
-		}
+		neighbour_routing_properties.previous = vertex_id;
+		neighbour_routing_properties.hop_count = vertex_routing_properties.hop_count + 1;
+		// Vertices over the hop limit are queued too so that their cost in the queue is decreased
+		// if they are already there. They are skipped when they are popped.
+		queue_.Push(neighbour_id, update_cost);
 	}
 }
 
-template <typename G>
-float CHDijkstra<G>::GetPathLength(unsigned_id_type to) const {
-	auto&& it = touched_vertices_.find(to);
-	if (it != touched_vertices_.end()) {
-		return it->second.cost;
-	}
-	return std::numeric_limits<float>::max();
+template <typename G, typename Q>
+float CHDijkstra<G, Q>::GetPathLength(unsigned_id_type to) const {
+	return touched_vertices_.Get(to, VertexRoutingProperties{}).cost;
 }
 
 }
@@ -6,6 +6,8 @@
 
 #include "routing/vertices/ch_vertex.h"
 #include "routing/edge_ranges/vector_edge_range.h"
+#include "routing/edge_ranges/iterator_edge_range.h"
+#include "routing/ch_search_graph.h"
 #include "routing/adjacency_list_graph.h"
 #include "routing/bidirectional_graph.h"
 #include "routing/table_names.h"
@@ -18,7 +20,12 @@
 #include "routing/database/database_helper.h"
 #include "routing/database/csv_convertor.h"
 
+#include "routing/snapshot/ch_graph_snapshot.h"
+
 #include <functional>
+#include <chrono>
+#include <cstdint>
+#include <vector>
 
 namespace routing{
 namespace preprocessing{
@@ -28,47 +35,120 @@ namespace preprocessing{
  * preprocessing and saving new graph.
  */
 class CHPreprocessor{
-    using Edge = CHEdge<NumberLengthSource>;
 public:
+    using Edge = CHEdge<NumberLengthSource>;
     using Graph = BidirectionalGraph<AdjacencyListGraph<CHVertex<Edge, VectorEdgeRange<Edge>>, Edge>>;
+    using SearchGraph = CHSearchGraph<CHVertex<Edge, IteratorEdgeRange<Edge, std::vector<Edge>::iterator>>, Edge>;
 
     CHPreprocessor(std::reference_wrapper<database::DatabaseHelper> d, TableNames* table_names, ContractionParameters&& parameters)
-        : d_(d), table_names_(std::move(table_names)), parameters_(std::move(parameters)) {}
+        : d_(d), table_names_(std::move(table_names)), parameters_(std::move(parameters)),
+            preprocessing_id_(static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())) {}
 
     void RunPreprocessing(Graph& g);
 
+    /**
+     * Contract graph `g` without the database so that it does not have to be connected during the contraction.
+     */
+    static void RunPreprocessing(Graph& g, const ContractionParameters& parameters);
+
     Graph LoadGraph(profile::Profile& profile);
 
+    /**
+     * Load edges of the base graph so that graphs of multiple profiles can be created without the database.
+     */
+    static std::vector<Edge> LoadBaseEdges(database::DatabaseHelper& d, const std::string& base_graph_table);
+
+    /**
+     * Create graph from base edges with lengths of the profile.
+     */
+    static Graph CreateGraph(const std::vector<Edge>& base_edges, profile::Profile& profile);
+
+    /**
+     * Estimate memory in bytes that is needed to contract graph of one profile made from `base_edges`.
+     */
+    static size_t EstimateContractionMemory(const std::vector<Edge>& base_edges, size_t thread_count);
+
     void SaveGraph(Graph& g);
 
+    /**
+     * Create search graph from the preprocessed graph and save it as a binary snapshot to `path`
+     * so that the routing server can load it without the database. The snapshot is bound to the table
+     * saved by SaveGraph of the same preprocessor so it is not used once the table is preprocessed again.
+     */
+    void SaveSnapshot(Graph& g, const std::string& path);
+
 private:
     std::reference_wrapper<database::DatabaseHelper> d_;
     TableNames* table_names_;
     ContractionParameters parameters_;
 
-
+    /**
+     * Id of this preprocessing run stored with the saved table and snapshot.
+     */
+    uint64_t preprocessing_id_;
+
+    /**
+     * Edges are stored twice in the graph (forward and backward) and contraction roughly doubles their count.
+     */
+    static const size_t kContractedEdgeCopies = 4;
+
+    /**
+     * Each local search thread keeps properties of all vertices and vertex count is close to edge count.
+     */
+    static const size_t kSearchMemoryPerEdge = 48;
+
+    /**
+     * Collects loaded edges instead of a graph.
+     */
+    struct EdgeList {
+        std::vector<Edge> edges;
+
+        void AddEdge(Edge&& edge) {
+            edges.push_back(std::move(edge));
+        }
+    };
 };
 
- void CHPreprocessor::RunPreprocessing(Graph& g) {
+inline void CHPreprocessor::RunPreprocessing(Graph& g) {
+    RunPreprocessing(g, parameters_);
+}
+
+inline void CHPreprocessor::RunPreprocessing(Graph& g, const ContractionParameters& parameters) {
     std::cout << "Vertices: " << g.GetVertexCount() << std::endl;
     std::cout << "Edges before contraction: " << g.GetEdgeCount() << std::endl;
-    GraphContractor<Graph> c{g, parameters_, g.GetMaxEdgeId() + 1};
+    GraphContractor<Graph> c{g, parameters, g.GetMaxEdgeId() + 1};
     c.ContractGraph();
     std::cout << "Contraction done." << std::endl;
     std::cout << "Edges after contraction: " << g.GetEdgeCount() << std::endl;
 }
 
 CHPreprocessor::Graph CHPreprocessor::LoadGraph(profile::Profile& profile) {
-    std::cout << "Load graph from " << table_names_->GetBaseTableName() << "." << std::endl;
-    Graph g{};
+    return CreateGraph(LoadBaseEdges(d_.get(), table_names_->GetBaseTableName()), profile);
+}
+
+inline std::vector<CHPreprocessor::Edge> CHPreprocessor::LoadBaseEdges(database::DatabaseHelper& d, const std::string& base_graph_table) {
+    std::cout << "Load graph from " << base_graph_table << "." << std::endl;
+    EdgeList edge_list{};
     database::UnpreprocessedDbGraph unpreprocessed_db_graph{};
     CHNumberEdgeFactory edge_factory{};
-    d_.get().LoadGraphEdges<Graph>(table_names_->GetBaseTableName(), g, &unpreprocessed_db_graph, edge_factory);
+    d.LoadGraphEdges<EdgeList>(base_graph_table, edge_list, &unpreprocessed_db_graph, edge_factory);
+    return std::move(edge_list.edges);
+}
+
+inline CHPreprocessor::Graph CHPreprocessor::CreateGraph(const std::vector<Edge>& base_edges, profile::Profile& profile) {
+    Graph g{};
+    for (auto&& edge : base_edges) {
+        g.AddEdge(Edge{edge});
+    }
     std::cout << "Profile: " << profile.GetName() << std::endl;
     profile.Set(g);
     return g;
 }
 
+inline size_t CHPreprocessor::EstimateContractionMemory(const std::vector<Edge>& base_edges, size_t thread_count) {
+    return base_edges.size() * (kContractedEdgeCopies * sizeof(Edge) + sizeof(Graph::Vertex) + thread_count * kSearchMemoryPerEdge);
+}
+
 void CHPreprocessor::SaveGraph(Graph& g) {
     database::CHDbGraph ch_db_graph{};
     std::string ch_edges_table{table_names_->GetEdgesTable()};
@@ -79,6 +159,14 @@ void CHPreprocessor::SaveGraph(Graph& g) {
     std::cout << "Geography index created." << std::endl;
     d_.get().SaveVertices(ch_vertex_table, g, database::CHVertexConvertor<Graph::Vertex>{}, &ch_db_graph);
     std::cout << "Vertices saved to " << ch_vertex_table << "." << std::endl;
+    d_.get().SavePreprocessingId(ch_edges_table, preprocessing_id_);
+}
+
+void CHPreprocessor::SaveSnapshot(Graph& g, const std::string& path) {
+    SearchGraph search_graph{};
+    search_graph.Load(g);
+    snapshot::CHGraphSnapshot::Write(path, search_graph, table_names_->GetEdgesTable(), preprocessing_id_);
+    std::cout << "Snapshot saved to " << path << "." << std::endl;
 }
 
 
@@ -14,7 +14,7 @@ namespace preprocessing {
 
 class ContractionParameters {
 public:
-    ContractionParameters(size_t hc, int32_t edc, int32_t dnc, int32_t ssc);
+    ContractionParameters(size_t hc, int32_t edc, int32_t dnc, int32_t ssc, size_t tc = 1);
 
     size_t get_hop_count() const;
 
@@ -24,16 +24,22 @@ public:
 
     int32_t get_space_size_coefficient() const;
 
+    /**
+     * Number of threads that contract the graph. Vertices are contracted one by one if it is one.
+     */
+    size_t get_thread_count() const;
+
 private:
     size_t hop_count_;
     int32_t edge_difference_coefficient_;
     int32_t deleted_neighbours_coefficient_;
     int32_t space_size_coefficient_;
+    size_t thread_count_;
 };
 
-inline ContractionParameters::ContractionParameters(size_t hc, int32_t edc, int32_t dnc, int32_t ssc) :
+inline ContractionParameters::ContractionParameters(size_t hc, int32_t edc, int32_t dnc, int32_t ssc, size_t tc) :
     hop_count_(hc), edge_difference_coefficient_(edc),
-    deleted_neighbours_coefficient_(dnc), space_size_coefficient_(ssc) {}
+    deleted_neighbours_coefficient_(dnc), space_size_coefficient_(ssc), thread_count_(tc) {}
 
 inline size_t ContractionParameters::get_hop_count() const {
     return hop_count_;
@@ -51,6 +57,10 @@ inline int32_t ContractionParameters::get_space_size_coefficient() const {
     return space_size_coefficient_;
 }
 
+inline size_t ContractionParameters::get_thread_count() const {
+    return thread_count_;
+}
+
 
 }
 }
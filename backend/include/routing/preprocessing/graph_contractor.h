@@ -6,16 +6,26 @@
 #include "routing/preprocessing/contraction_parameters.h"
 #include "routing/preprocessing/shortcut_finder.h"
 #include "routing/types.h"
+#include "routing/utility/worker_threads.h"
 
 #include <vector>
 #include <set>
 #include <queue>
 #include <cassert>
+#include <functional>
+#include <algorithm>
+#include <iostream>
 namespace routing {
 namespace preprocessing {
 
 /**
  * GraphContractor contracts all vertices.
+ *
+ * Vertices are either contracted one by one in the order of their priorities (with lazy updates)
+ * or in rounds if more threads are set in contraction parameters. Each round contracts an independent set
+ * of vertices whose priorities are lower than priorities of all vertices at most two edges away.
+ * Shortcuts of the set are found concurrently and added to the graph in the order of vertex ids
+ * so the result does not depend on the number of threads.
  */
 template <typename Graph>
 class GraphContractor {
@@ -30,8 +40,21 @@ public:
     >;
     GraphContractor<Graph>(Graph& g, const ContractionParameters& parameters, unsigned_id_type free_edge_id);
 
+    /**
+     * Contract all vertices - in parallel if thread count of contraction parameters is higher than one.
+     */
     void ContractGraph();
 
+    /**
+     * Contract vertices one by one.
+     */
+    void ContractGraphSequentially();
+
+    /**
+     * Contract independent sets of vertices in rounds.
+     */
+    void ContractGraphInParallel(size_t thread_count);
+
     void ContractVertex(Vertex & vertex);
 
     /**
@@ -41,7 +64,18 @@ public:
 
     PriorityQueue CalculateContractionPriority();
 private:
+    /**
+     * Each thread of parallel contraction has its own searches.
+     */
+    struct ContractionWorker {
+        ShortcutFinder<Graph> shortcut_finder;
+        VertexMeasures<Graph> vertex_measures;
+
+        ContractionWorker(Graph& g, const ContractionParameters& parameters) : shortcut_finder(g, parameters), vertex_measures(g, parameters) {}
+    };
+
     Graph & g_;
+    ContractionParameters parameters_;
     ShortcutFinder<Graph> shortcut_finder_;
     VertexMeasures<Graph> vertex_measures_;
     unsigned_id_type free_edge_id_;
@@ -49,15 +83,49 @@ private:
 
     void AddShortcuts(std::vector<Edge>&& shortcuts);
 
+    /**
+     * Call f(worker, i) for all i in [0, count) - each worker is used by one thread.
+     */
+    void RunInParallel(std::vector<ContractionWorker>& workers, size_t count, const std::function<void(ContractionWorker&, size_t)>& f);
+
+    /**
+     * Select vertices that can be contracted in one round. Selected vertices are in the same order as in `vertices`.
+     */
+    std::vector<unsigned_id_type> FindIndependentVertices(std::vector<ContractionWorker>& workers, const std::vector<unsigned_id_type>& vertices,
+        const std::vector<float>& priorities);
+
+    /**
+     * Call f(neighbour_id) for each not contracted neighbour in both directions.
+     */
+    template <typename Function>
+    void ForEachNeighbour(Vertex& vertex, const Function& f);
+
+    /**
+     * Ties of priorities are broken by vertex ids.
+     */
+    static bool HasLowerPriority(unsigned_id_type a, unsigned_id_type b, const std::vector<float>& priorities) {
+        return priorities[a] < priorities[b] || (priorities[a] == priorities[b] && a < b);
+    }
+
     float CalculateOverlayGraphAverageDegree() const;
 };
 
 template <typename Graph>
 GraphContractor<Graph>::GraphContractor(Graph &g, const ContractionParameters& parameters, unsigned_id_type free_edge_id)
-    : g_(g), shortcut_finder_(g, parameters), vertex_measures_(g, parameters), free_edge_id_(free_edge_id), free_ordering_rank_(1) {}
+    : g_(g), parameters_(parameters), shortcut_finder_(g, parameters), vertex_measures_(g, parameters), free_edge_id_(free_edge_id),
+        free_ordering_rank_(1) {}
 
 template <typename Graph>
 void GraphContractor<Graph>::ContractGraph() {
+    if (parameters_.get_thread_count() > 1) {
+        ContractGraphInParallel(parameters_.get_thread_count());
+    } else {
+        ContractGraphSequentially();
+    }
+}
+
+template <typename Graph>
+void GraphContractor<Graph>::ContractGraphSequentially() {
     free_ordering_rank_ = 1;
     PriorityQueue q = CalculateContractionPriority();
     std::cout << "Contraction starting - queue completed." << std::endl;
@@ -75,6 +143,67 @@ void GraphContractor<Graph>::ContractGraph() {
 
 }
 
+template <typename Graph>
+void GraphContractor<Graph>::ContractGraphInParallel(size_t thread_count) {
+    free_ordering_rank_ = 1;
+    std::vector<ContractionWorker> workers{};
+    workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers.emplace_back(g_, parameters_);
+    }
+    std::vector<unsigned_id_type> remaining_vertices{};
+    g_.ForEachVertex([&](Vertex& vertex) {
+        if (!vertex.IsContracted()) {
+            remaining_vertices.push_back(vertex.get_uid());
+        }
+    });
+    std::vector<float> priorities(g_.GetMaxVertexId() + 1, 0);
+    RunInParallel(workers, remaining_vertices.size(), [&](ContractionWorker& worker, size_t i) {
+        unsigned_id_type vertex_id = remaining_vertices[i];
+        priorities[vertex_id] = worker.vertex_measures.CalculateContractionAttractivity(g_.GetVertex(vertex_id));
+    });
+    std::cout << "Contraction starting - priorities completed." << std::endl;
+
+    std::vector<std::vector<Edge>> shortcuts{};
+    std::vector<bool> updated(priorities.size(), false);
+    size_t round = 0;
+    while (!remaining_vertices.empty()) {
+        std::vector<unsigned_id_type> independent_vertices = FindIndependentVertices(workers, remaining_vertices, priorities);
+        shortcuts.assign(independent_vertices.size(), std::vector<Edge>{});
+        RunInParallel(workers, independent_vertices.size(), [&](ContractionWorker& worker, size_t i) {
+            shortcuts[i] = worker.shortcut_finder.FindShortcuts(g_.GetVertex(independent_vertices[i]));
+        });
+        for (size_t i = 0; i < independent_vertices.size(); ++i) {
+            AddShortcuts(std::move(shortcuts[i]));
+            g_.GetVertex(independent_vertices[i]).set_ordering_rank(++free_ordering_rank_);
+        }
+
+        // Priorities of neighbours change since they have new shortcuts and contracted neighbours.
+        std::vector<unsigned_id_type> neighbours{};
+        for (auto&& vertex_id : independent_vertices) {
+            ForEachNeighbour(g_.GetVertex(vertex_id), [&](unsigned_id_type neighbour_id) {
+                if (!updated[neighbour_id]) {
+                    updated[neighbour_id] = true;
+                    neighbours.push_back(neighbour_id);
+                }
+            });
+        }
+        RunInParallel(workers, neighbours.size(), [&](ContractionWorker& worker, size_t i) {
+            priorities[neighbours[i]] = worker.vertex_measures.CalculateContractionAttractivity(g_.GetVertex(neighbours[i]));
+        });
+        for (auto&& neighbour_id : neighbours) {
+            updated[neighbour_id] = false;
+        }
+
+        remaining_vertices.erase(std::remove_if(remaining_vertices.begin(), remaining_vertices.end(), [&](unsigned_id_type vertex_id) {
+            return g_.GetVertex(vertex_id).IsContracted();
+        }), remaining_vertices.end());
+        if (++round % 10 == 0) {
+            std::cout << "Round " << round << ": " << remaining_vertices.size() << " vertices left." << std::endl;
+        }
+    }
+}
+
 template <typename Graph>
 void GraphContractor<Graph>::ContractVertex(Vertex & vertex) {
     std::vector<Edge> shortcuts = shortcut_finder_.FindShortcuts(vertex);
@@ -139,6 +268,57 @@ void GraphContractor<Graph>::AddShortcuts(std::vector<Edge>&& shortcuts) {
 }
 
 
+template <typename Graph>
+void GraphContractor<Graph>::RunInParallel(std::vector<ContractionWorker>& workers, size_t count, const std::function<void(ContractionWorker&, size_t)>& f) {
+    utility::RunOnWorkerThreads(workers.size(), count, [&](size_t worker, size_t i) {
+        f(workers[worker], i);
+    });
+}
+
+template <typename Graph>
+std::vector<unsigned_id_type> GraphContractor<Graph>::FindIndependentVertices(std::vector<ContractionWorker>& workers,
+    const std::vector<unsigned_id_type>& vertices, const std::vector<float>& priorities) {
+    std::vector<char> independent(vertices.size(), 0);
+    RunInParallel(workers, vertices.size(), [&](ContractionWorker&, size_t i) {
+        unsigned_id_type vertex_id = vertices[i];
+        bool is_minimal = true;
+        ForEachNeighbour(g_.GetVertex(vertex_id), [&](unsigned_id_type neighbour_id) {
+            if (!is_minimal || HasLowerPriority(neighbour_id, vertex_id, priorities)) {
+                is_minimal = false;
+                return;
+            }
+            ForEachNeighbour(g_.GetVertex(neighbour_id), [&](unsigned_id_type second_neighbour_id) {
+                if (second_neighbour_id != vertex_id && HasLowerPriority(second_neighbour_id, vertex_id, priorities)) {
+                    is_minimal = false;
+                }
+            });
+        });
+        independent[i] = is_minimal;
+    });
+    std::vector<unsigned_id_type> independent_vertices{};
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        if (independent[i]) {
+            independent_vertices.push_back(vertices[i]);
+        }
+    }
+    return independent_vertices;
+}
+
+template <typename Graph>
+template <typename Function>
+void GraphContractor<Graph>::ForEachNeighbour(Vertex& vertex, const Function& f) {
+    vertex.ForEachEdge([&](Edge& edge) {
+        if (!g_.GetVertex(edge.get_to()).IsContracted()) {
+            f(edge.get_to());
+        }
+    });
+    vertex.ForEachBackwardEdge([&](Edge& backward_edge) {
+        if (!g_.GetVertex(backward_edge.get_to()).IsContracted()) {
+            f(backward_edge.get_to());
+        }
+    });
+}
+
 template <typename Graph>
 float GraphContractor<Graph>::CalculateOverlayGraphAverageDegree() const {
     size_t deg = 0;
@@ -0,0 +1,55 @@
+#ifndef ROUTING_PREPROCESSING_PROFILE_SCHEDULER_H
+#define ROUTING_PREPROCESSING_PROFILE_SCHEDULER_H
+
+#include "routing/utility/worker_threads.h"
+
+#include <functional>
+#include <algorithm>
+#include <cstddef>
+
+namespace routing {
+namespace preprocessing {
+
+/**
+ * ProfileScheduler preprocesses profiles of static mode concurrently.
+ *
+ * Each worker thread takes profiles one by one until all are preprocessed. The number of workers
+ * is limited by the thread count and by the memory budget - each worker holds one graph of a profile
+ * at a time.
+ */
+class ProfileScheduler {
+public:
+    /**
+     * @param thread_count Maximum number of profiles preprocessed at once.
+     * @param memory_budget Memory in bytes that all workers can use. Zero means that memory is not limited.
+     * @param profile_memory Estimated memory in bytes needed to preprocess one profile.
+     */
+    ProfileScheduler(size_t thread_count, size_t memory_budget, size_t profile_memory);
+
+    size_t GetWorkerCount() const {
+        return worker_count_;
+    }
+
+    /**
+     * Call f(worker_index, profile_index) for each profile. Calls with the same worker index are never concurrent.
+     * The first exception thrown by f stops workers from taking more profiles and is rethrown.
+     */
+    void Run(size_t profile_count, const std::function<void(size_t, size_t)>& f);
+
+private:
+    size_t worker_count_;
+};
+
+inline ProfileScheduler::ProfileScheduler(size_t thread_count, size_t memory_budget, size_t profile_memory) : worker_count_(std::max(thread_count, size_t{1})) {
+    if (memory_budget != 0 && profile_memory != 0) {
+        worker_count_ = std::max(std::min(worker_count_, memory_budget / profile_memory), size_t{1});
+    }
+}
+
+inline void ProfileScheduler::Run(size_t profile_count, const std::function<void(size_t, size_t)>& f) {
+    utility::RunOnWorkerThreads(worker_count_, profile_count, f);
+}
+
+}
+}
+#endif //ROUTING_PREPROCESSING_PROFILE_SCHEDULER_H
@@ -13,22 +13,33 @@
 #include "routing/utility/point.h"
 #include "routing/bidirectional_graph.h"
 #include "routing/query/bidirectional_dijkstra.h"
+#include "routing/query/many_to_many.h"
+#include "routing/query/one_to_all.h"
 #include "routing/query/endpoint_edges_creator.h"
 #include "routing/query/endpoint_algorithm_policy.h"
 #include "routing/query/edge_range_policy.h"
 #include "routing/edges/ch_edge.h"
 #include "routing/edge_ranges/vector_edge_range.h"
 #include "routing/vertices/ch_vertex.h"
+#include "routing/vertices/compact_ch_vertex.h"
 #include "routing/ch_search_graph.h"
+#include "routing/compact_ch_search_graph.h"
 #include "routing/routing_graph.h"
 #include "routing/edge_ranges/iterator_edge_range.h"
 #include "routing/edges/length_source.h"
 #include "routing/edge_factory.h"
+#include "routing/spatial/segment_index.h"
+#include "routing/snapshot/ch_graph_snapshot.h"
+#include "routing/cch/customizable_graph.h"
 #include "routing/types.h"
 
 #include "routing/table_names.h"
 
+#include "routing/profile/profile.h"
+
 #include <string>
+#include <vector>
+#include <limits>
 
 namespace routing {
 namespace query {
@@ -36,8 +47,8 @@ namespace query {
 /**
  * AlgorithmFactory for Dijkstra's algorithm.
  * Dijkstra has no preprocessing so it is always used with DynamicProfileMode.
- * That means that road graph edge lengths must be based on a profile so that
- * they can be swapped at moments notice by swapping the underlying profile.
+ * That means that road graph edge lengths must be based on a profile. The profile
+ * is given with each routing request and the search takes edge lengths from it.
  */
 class DijkstraFactory {
 public:
@@ -49,10 +60,13 @@ public:
     using DbGraph = database::UnpreprocessedDbGraph;
 
     using Graph = AdjacencyListGraph<Vertex, Edge>;
-    using Algorithm = Dijkstra<RoutingGraph<Graph>>;
+    using EdgeLength = ProfileEdgeLength;
+    using Algorithm = Dijkstra<RoutingGraph<Graph>, EdgeLength>;
+    using TableAlgorithm = ManyToManyDijkstra<RoutingGraph<Graph>, EdgeLength>;
+    using IsochroneAlgorithm = OneToAllDijkstra<Graph, EdgeLength>;
     using EndpointAlgorithmPolicy = EndpointAlgorithmPolicyDijkstra<RoutingGraph<Graph>, EdgeRangePolicyVector<Edge>>;
 
-    DijkstraFactory() : endpoint_edges_lengths_() {}
+    DijkstraFactory() {}
 
     /**
      * Load graph from database.
@@ -65,41 +79,45 @@ public:
         return g;
     }
 
-    EndpointEdgesCreator<EndpointEdgeFactory, Graph> CreateEndpointEdgesCreator(Graph& graph, database::DatabaseHelper& d, database::DbGraph* db_graph) {
-        return EndpointEdgesCreator<EndpointEdgeFactory, Graph>{graph, d, db_graph, EndpointEdgeFactory{&endpoint_edges_lengths_}};
+    /**
+     * Edge lengths of one routing request are given by its profile.
+     */
+    EdgeLength CreateEdgeLength(const profile::Profile& profile, unsigned_id_type max_vertex_id) {
+        return EdgeLength{profile, max_vertex_id};
     }
 
-    EndpointAlgorithmPolicy CreateEndpointAlgorithmPolicy(RoutingGraph<Graph>& routing_graph) {
-        return EndpointAlgorithmPolicy{routing_graph, EdgeRangePolicyVector<Edge>{}};
+    EndpointEdgesCreator<EndpointEdgeFactory, Graph, EdgeLength> CreateEndpointEdgesCreator(Graph& graph, const spatial::SegmentIndex& segment_index,
+        const EdgeLength& length) {
+        return EndpointEdgesCreator<EndpointEdgeFactory, Graph, EdgeLength>{graph, segment_index, EndpointEdgeFactory{}, length};
     }
 
-    DbGraph CreateDbGraph() {
-        return DbGraph{};
+    EndpointAlgorithmPolicy CreateEndpointAlgorithmPolicy(RoutingGraph<Graph>& routing_graph) {
+        return EndpointAlgorithmPolicy{routing_graph, EdgeRangePolicyVector<Edge>{}};
     }
-private:
-    EndpointEdgesLengths endpoint_edges_lengths_;
 };
 
 /**
  * AlgorithmFactory for Contraction Hierarchies algorithm use with StaticProfileMode.
  * It uses graphs whose lengths are set in stone. No profiles and their preference
  * indices that contain actual values need to be loaded to do routing.
- * It saves memory.
+ * It saves memory - the search graph is stored in compressed sparse row format.
  */
 class CHStaticFactory {
 public:
     using EdgeFactory = CHNumberEdgeFactory;
     using Edge = EdgeFactory::Edge;
     using EndpointEdgeFactory = NumberEndpointEdgeFactory<Edge>;
-    using EdgeIterator = std::vector<Edge>::iterator;
-    using EdgeRange = IteratorEdgeRange<Edge, EdgeIterator>;
-    using Vertex = CHVertex<Edge, EdgeRange>;
+    using EdgeRange = CompactEdgeRange<Edge>;
+    using Vertex = CompactCHVertex<Edge>;
     
     using TemporaryGraph = BidirectionalGraph<AdjacencyListGraph<CHVertex<Edge, VectorEdgeRange<Edge>>, Edge>>;
-    using Graph = CHSearchGraph<Vertex, Edge>;
+    using Graph = CompactCHSearchGraph<Edge>;
     using DbGraph = database::CHDbGraph;
-    using Algorithm = BidirectionalDijkstra<RoutingGraph<Graph>>;
-    using EndpointAlgorithmPolicy = EndpointAlgorithmPolicyContractionHierarchies<RoutingGraph<Graph>, EdgeRangePolicyVectorIterator<Edge>>;
+    using EdgeLength = routing::EdgeLength;
+    using Algorithm = BidirectionalDijkstra<RoutingGraph<Graph>, EdgeLength>;
+    using TableAlgorithm = ManyToManyContractionHierarchies<RoutingGraph<Graph>, EdgeLength>;
+    using IsochroneAlgorithm = Phast<Graph, EdgeLength>;
+    using EndpointAlgorithmPolicy = EndpointAlgorithmPolicyContractionHierarchies<RoutingGraph<Graph>, EdgeRangePolicyCompact<Edge>>;
 
     CHStaticFactory() {}
 
@@ -118,23 +136,36 @@ public:
         return search_graph;
     }
 
-    DbGraph CreateDbGraph() {
-        return DbGraph{};
+    /**
+     * Create search graph from its snapshot written by the preprocessor.
+     */
+    static Graph CreateGraph(const snapshot::CHGraphSnapshot& snapshot) {
+        Graph search_graph{};
+        search_graph.LoadSnapshot(snapshot);
+        return search_graph;
+    }
+
+    /**
+     * Edge lengths are stored in the graph which belongs to one profile.
+     */
+    EdgeLength CreateEdgeLength(const profile::Profile& profile, unsigned_id_type max_vertex_id) {
+        return EdgeLength{};
     }
 
-    EndpointEdgesCreator<EndpointEdgeFactory, Graph> CreateEndpointEdgesCreator(Graph& graph, database::DatabaseHelper& d, database::DbGraph* db_graph) {
-        return EndpointEdgesCreator<EndpointEdgeFactory, Graph>{graph, d, db_graph, EndpointEdgeFactory{}};
+    EndpointEdgesCreator<EndpointEdgeFactory, Graph, EdgeLength> CreateEndpointEdgesCreator(Graph& graph, const spatial::SegmentIndex& segment_index,
+        const EdgeLength& length) {
+        return EndpointEdgesCreator<EndpointEdgeFactory, Graph, EdgeLength>{graph, segment_index, EndpointEdgeFactory{}, length};
     }
 
     EndpointAlgorithmPolicy CreateEndpointAlgorithmPolicy(RoutingGraph<Graph>& routing_graph) {
-        return EndpointAlgorithmPolicy{routing_graph, EdgeRangePolicyVectorIterator<Edge>{}};
+        return EndpointAlgorithmPolicy{routing_graph, EdgeRangePolicyCompact<Edge>{}};
     }
 };
 
 /**
  * AlgorithmFactory for Contraction Hiearchies algorithm used with DynamicProfileMode.
- * That means that road graph edge lengths must be based on a profile so that
- * they can be swapped at moments notice by swapping the underlying profile.
+ * That means that road graph edge lengths must be based on a profile. The profile
+ * is given with each routing request and the search takes edge lengths from it.
  */
 class CHDynamicFactory {
 public:
@@ -148,10 +179,13 @@ public:
     using TemporaryGraph = BidirectionalGraph<AdjacencyListGraph<CHVertex<Edge, VectorEdgeRange<Edge>>, Edge>>;
     using Graph = CHSearchGraph<Vertex, Edge>;
     using DbGraph = database::CHDbGraph;
-    using Algorithm = BidirectionalDijkstra<RoutingGraph<Graph>>;
+    using EdgeLength = ProfileEdgeLength;
+    using Algorithm = BidirectionalDijkstra<RoutingGraph<Graph>, EdgeLength>;
+    using TableAlgorithm = ManyToManyContractionHierarchies<RoutingGraph<Graph>, EdgeLength>;
+    using IsochroneAlgorithm = Phast<Graph, EdgeLength>;
     using EndpointAlgorithmPolicy = EndpointAlgorithmPolicyContractionHierarchies<RoutingGraph<Graph>, EdgeRangePolicyVectorIterator<Edge>>;
 
-    CHDynamicFactory() : endpoint_edges_lengths_() {}
+    CHDynamicFactory() {}
 
     /**
      * Load graph from database and then create an immutable search graph with is more 
@@ -168,22 +202,100 @@ public:
         return search_graph;
     }
 
-    DbGraph CreateDbGraph() {
-        return DbGraph{};
+    /**
+     * Edge lengths of one routing request are given by its profile.
+     */
+    EdgeLength CreateEdgeLength(const profile::Profile& profile, unsigned_id_type max_vertex_id) {
+        return EdgeLength{profile, max_vertex_id};
     }
 
-    EndpointEdgesCreator<EndpointEdgeFactory, Graph> CreateEndpointEdgesCreator(Graph& graph, database::DatabaseHelper& d, database::DbGraph* db_graph) {
-        return EndpointEdgesCreator<EndpointEdgeFactory, Graph>{graph, d, db_graph, EndpointEdgeFactory{&endpoint_edges_lengths_}};
+    EndpointEdgesCreator<EndpointEdgeFactory, Graph, EdgeLength> CreateEndpointEdgesCreator(Graph& graph, const spatial::SegmentIndex& segment_index,
+        const EdgeLength& length) {
+        return EndpointEdgesCreator<EndpointEdgeFactory, Graph, EdgeLength>{graph, segment_index, EndpointEdgeFactory{}, length};
     }
 
     EndpointAlgorithmPolicy CreateEndpointAlgorithmPolicy(RoutingGraph<Graph>& routing_graph) {
         return EndpointAlgorithmPolicy{routing_graph, EdgeRangePolicyVectorIterator<Edge>{}};
     }
-private:
-    EndpointEdgesLengths endpoint_edges_lengths_;
 };
 
 
+/**
+ * AlgorithmFactory for Customizable Contraction Hierarchies used with CustomizableProfileMode.
+ * The base graph is contracted in the vertex ordering computed by the preprocessor which does not depend
+ * on any profile. Each profile then only customizes lengths of the contracted graph which takes much less time
+ * than CH preprocessing. The customized graph is a CH search graph with lengths of the profile set in stone
+ * so the query is the same as in CHStaticFactory.
+ */
+class CCHFactory {
+public:
+    using EdgeFactory = CHNumberEdgeFactory;
+    using Edge = EdgeFactory::Edge;
+    using EndpointEdgeFactory = NumberEndpointEdgeFactory<Edge>;
+    using EdgeRange = CompactEdgeRange<Edge>;
+    using Vertex = CompactCHVertex<Edge>;
+
+    using TemporaryGraph = AdjacencyListGraph<CHVertex<Edge, VectorEdgeRange<Edge>>, Edge>;
+    using Graph = CompactCHSearchGraph<Edge>;
+    using DbGraph = database::UnpreprocessedDbGraph;
+    using EdgeLength = routing::EdgeLength;
+    using Algorithm = BidirectionalDijkstra<RoutingGraph<Graph>, EdgeLength>;
+    using TableAlgorithm = ManyToManyContractionHierarchies<RoutingGraph<Graph>, EdgeLength>;
+    using IsochroneAlgorithm = Phast<Graph, EdgeLength>;
+    using EndpointAlgorithmPolicy = EndpointAlgorithmPolicyContractionHierarchies<RoutingGraph<Graph>, EdgeRangePolicyCompact<Edge>>;
+
+    CCHFactory() {}
+
+    /**
+     * Load base graph and its vertex ordering from database and contract it.
+     */
+    static cch::CustomizableGraph CreateCustomizableGraph(database::DatabaseHelper& d, TableNames* table_names) {
+        TemporaryGraph g{};
+        DbGraph db_graph{};
+        EdgeFactory edge_factory{};
+        d.LoadGraphEdges<TemporaryGraph>(table_names->GetEdgesTable(), g, &db_graph, edge_factory);
+        d.LoadAdditionalVertexProperties(table_names->GetVerticesTable(), g);
+        // Ids without vertices are ordered last.
+        std::vector<unsigned_id_type> ordering_ranks(g.GetMaxVertexId(), std::numeric_limits<unsigned_id_type>::max());
+        g.ForEachVertex([&](typename TemporaryGraph::Vertex& vertex) {
+            ordering_ranks[vertex.get_uid()] = vertex.get_ordering_rank();
+        });
+        // Twoway edges are in the graph in both directions.
+        std::vector<cch::CustomizableGraph::BaseEdge> edges{};
+        g.ForEachEdge([&](Edge& edge) {
+            if (!edge.IsTwoway() || edge.get_from() < edge.get_to()) {
+                edges.emplace_back(edge.get_uid(), edge.get_from(), edge.get_to(), edge.IsTwoway());
+            }
+        });
+        return cch::CustomizableGraph{ordering_ranks, edges};
+    }
+
+    /**
+     * Customize contracted graph with lengths of the profile and create its search graph.
+     */
+    static Graph CreateGraph(const cch::CustomizableGraph& customizable_graph, const profile::Profile& profile, size_t thread_count) {
+        auto&& metric = customizable_graph.Customize([&](unsigned_id_type uid) {
+            return profile.GetLength(uid);
+        }, thread_count);
+        return customizable_graph.CreateSearchGraph<Graph>(metric);
+    }
+
+    /**
+     * Edge lengths are stored in the graph which is customized for one profile.
+     */
+    EdgeLength CreateEdgeLength(const profile::Profile& profile, unsigned_id_type max_vertex_id) {
+        return EdgeLength{};
+    }
+
+    EndpointEdgesCreator<EndpointEdgeFactory, Graph, EdgeLength> CreateEndpointEdgesCreator(Graph& graph, const spatial::SegmentIndex& segment_index,
+        const EdgeLength& length) {
+        return EndpointEdgesCreator<EndpointEdgeFactory, Graph, EdgeLength>{graph, segment_index, EndpointEdgeFactory{}, length};
+    }
+
+    EndpointAlgorithmPolicy CreateEndpointAlgorithmPolicy(RoutingGraph<Graph>& routing_graph) {
+        return EndpointAlgorithmPolicy{routing_graph, EdgeRangePolicyCompact<Edge>{}};
+    }
+};
 
 
 
@@ -0,0 +1,36 @@
+#ifndef ROUTING_QUERY_ALTERNATIVE_ROUTE_PARAMETERS_H
+#define ROUTING_QUERY_ALTERNATIVE_ROUTE_PARAMETERS_H
+
+namespace routing{
+namespace query{
+
+/**
+ * AlternativeRouteParameters define which routes through a via vertex are admissible alternatives.
+ * All limits are relative to the length of the shortest route.
+ */
+struct AlternativeRouteParameters {
+    /**
+     * Alternative route is at most `max_stretch` times longer than the shortest route.
+     */
+    float max_stretch;
+
+    /**
+     * Alternative route shares edges of at most `max_sharing` length with the shortest route and better alternatives.
+     */
+    float max_sharing;
+
+    /**
+     * Subroute of the alternative route that spans `local_optimality` length before and after its via vertex
+     * has to be the shortest route between its ends so that the alternative route has no needless detours.
+     */
+    float local_optimality;
+
+    AlternativeRouteParameters() : max_stretch(1.25f), max_sharing(0.8f), local_optimality(0.25f) {}
+
+    AlternativeRouteParameters(float stretch, float sharing, float optimality)
+        : max_stretch(stretch), max_sharing(sharing), local_optimality(optimality) {}
+};
+
+}
+}
+#endif // ROUTING_QUERY_ALTERNATIVE_ROUTE_PARAMETERS_H
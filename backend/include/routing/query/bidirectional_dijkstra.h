@@ -2,19 +2,22 @@
 #define ROUTING_QUERY_BIDIRECTIONAL_DIJKSTRA_H
 
 #include "routing/edges/basic_edge.h"
+#include "routing/edges/length_source.h"
 #include "routing/algorithm.h"
 #include "routing/query/route_retriever.h"
+#include "routing/query/alternative_route_parameters.h"
+#include "routing/utility/priority_queue.h"
+#include "routing/utility/epoch_vector.h"
+#include "routing/utility/deadline.h"
 #include "routing/types.h"
 
-#include "tsl/robin_map.h"
-
 #include <vector>
-#include <set>
-#include <queue>
 #include <cassert>
 #include <limits>
 #include <memory>
 #include <functional>
+#include <algorithm>
+#include <unordered_set>
 
 namespace routing {
 namespace query {
@@ -25,20 +28,40 @@ namespace query {
  * 
  * The algorithm runs forward Dijkstra from a source and backward
  * Dijkstra from a target. So there are two priority queues etc.. 
+ * The search stops once the minimum of both queues is not lower than the length
+ * of the best path found so far since no later vertex can improve it.
+ *
+ * Stall-on-demand prunes vertices that are reached by a shorter path through
+ * a higher vertex of the same direction - their edges are not relaxed.
+ *
+ * Alternative routes reuse search spaces of both directions. Any vertex reached by both of them
+ * is a via vertex of a route - the forward search tree to it and the backward search tree from it.
+ * The search continues until longer routes than the allowed stretch cannot be found
+ * and admissible via routes are selected by their sharing with better routes and local optimality.
  * 
  * It does not change any properties of vertices or edge of graph
  * it runs on. Any information such as current costs of vertices is stored
  * inside this class.
+ *
+ * @tparam EL Provides edge lengths - EL{}(edge). It can be used to route with lengths that are
+ *      defined per search and not stored in the graph.
+ * @tparam Q Priority queue of vertices with decrease-key - utility::IndexedDaryHeap or utility::LazyBinaryHeap.
  */
-template <typename G>
+template <typename G, typename EL = EdgeLength, typename Q = utility::IndexedDaryHeap<>>
 class BidirectionalDijkstra {
 public:
     using Vertex = typename G::Vertex;
     using Edge = typename G::Edge;
-    using QueuePair = std::pair<float, Vertex*>;
+    using EdgeLength = EL;
+    using PriorityQueue = Q;
     using Graph = G;
+    struct Workspace;
 
-    BidirectionalDijkstra(G& g);
+    /**
+     * @param workspace Memory for the search that is reused by consecutive searches. The search
+     *      creates its own workspace if none is given.
+     */
+    BidirectionalDijkstra(G& g, const EL& length = EL{}, Workspace* workspace = nullptr);
 
     /**
      * Find the best route from `start_node` to `end_node`.
@@ -55,36 +78,70 @@ public:
      */
     std::vector<Edge> GetRoute();
 
-private:
-    struct VertexRoutingProperties;
-    struct PriorityQueueMember;
-    struct MinQueueComparator;
-    class Direction;
-    class ForwardDirection;
-    class BackwardDirection;
-    
     /**
-     * Graph where dijkstra's algorithm is used.
+     * Length of the best route found by the last search.
      */
-    G& g_;
-    using UnorderedMap = tsl::robin_map<unsigned_id_type, VertexRoutingProperties>;
-    UnorderedMap forward_touched_vertices_;
-    UnorderedMap backward_touched_vertices_;
-    unsigned_id_type settled_vertex_;
-    unsigned_id_type start_node_;
-    unsigned_id_type end_node_;
+    float GetRouteLength() const {
+        return route_length_;
+    }
 
-    using PriorityQueue = std::priority_queue<PriorityQueueMember, std::vector<PriorityQueueMember>, MinQueueComparator>;
+    /**
+     * Find the best route from `start_node` to `end_node` and continue the search so that both search spaces
+     * contain all via vertices of alternative routes admissible by `parameters`.
+     */
+    void RunAlternatives(unsigned_id_type start_node, unsigned_id_type end_node, const AlternativeRouteParameters& parameters);
 
-    PriorityQueueMember GetMin(PriorityQueue& a, PriorityQueue& b);
+    /**
+     * Get at most `max_count` alternative routes of the last `RunAlternatives` ordered by their length.
+     * The best route is not included.
+     */
+    std::vector<std::vector<Edge>> GetAlternativeRoutes(size_t max_count);
 
-    float GetSummedCosts(float forward_cost, float backward_cost);
+    /**
+     * Enable or disable stall-on-demand. It is enabled by default.
+     */
+    void SetStallOnDemand(bool stall_on_demand) {
+        stall_on_demand_ = stall_on_demand;
+    }
 
-    float GetMaxCost() const;
+    /**
+     * Number of vertices popped from the queues of both directions in the last search. Stalled vertices are included.
+     */
+    size_t GetSettledVertexCount() const {
+        return settled_vertex_count_;
+    }
+
+    /**
+     * Number of vertices whose edges were not relaxed in the last search due to stall-on-demand.
+     */
+    size_t GetStalledVertexCount() const {
+        return stalled_vertex_count_;
+    }
+
+    /**
+     * Number of edges scanned from settled vertices of both directions in the last search.
+     */
+    size_t GetRelaxedEdgeCount() const {
+        return relaxed_edge_count_;
+    }
 
     /**
-	 * Stores information from the search. It is memory & performance inefficient to store it in vertices
-	 * since a small portion of graph is searched. 
+     * Searches stop by TimeoutException when `deadline` expires. Null deadline is never checked.
+     */
+    void SetDeadline(const utility::Deadline* deadline) {
+        deadline_ = deadline;
+    }
+
+private:
+    struct VertexRoutingProperties;
+    struct PriorityQueueMember;
+    class Direction;
+    class ForwardDirection;
+    class BackwardDirection;
+
+    /**
+	 * Stores information from the search. It is not stored in vertices since the graph is shared
+	 * by concurrent searches.
 	 */
     struct VertexRoutingProperties {
         float cost;
@@ -100,125 +157,247 @@ private:
         VertexRoutingProperties& operator= (VertexRoutingProperties&& other) = default;
         ~VertexRoutingProperties() = default;
     };
-    
-    struct MinQueueComparator {
-        bool operator() (const PriorityQueueMember& a , const PriorityQueueMember& b) {
-            return a.cost_priority > b.cost_priority;
-        }
+
+    using TouchedVertices = utility::EpochVector<VertexRoutingProperties>;
+
+public:
+    /**
+     * Workspace holds properties of vertices touched by both directions in vectors addressed
+     * by vertex ids and priority queues of both directions. One workspace can be used
+     * by many searches one after another.
+     */
+    struct Workspace {
+        TouchedVertices forward_touched_vertices;
+        TouchedVertices backward_touched_vertices;
+        Q forward_queue;
+        Q backward_queue;
+
+        /**
+         * Vertices reached by both directions - candidate via vertices of alternative routes.
+         */
+        std::vector<unsigned_id_type> via_vertices;
+
+        /**
+         * Workspace of searches that check local optimality of alternative routes. It is created by the first check.
+         */
+        std::unique_ptr<Workspace> local_search_workspace;
     };
 
+private:
+    /**
+     * Graph where dijkstra's algorithm is used.
+     */
+    G& g_;
+    EL length_;
+    std::unique_ptr<Workspace> own_workspace_;
+    Workspace& workspace_;
+    TouchedVertices& forward_touched_vertices_;
+    TouchedVertices& backward_touched_vertices_;
+    Q& forward_queue_;
+    Q& backward_queue_;
+    unsigned_id_type settled_vertex_;
+    unsigned_id_type start_node_;
+    unsigned_id_type end_node_;
+    bool stall_on_demand_;
+    size_t settled_vertex_count_;
+    size_t stalled_vertex_count_;
+    size_t relaxed_edge_count_;
+    float route_length_;
+    AlternativeRouteParameters parameters_;
+    const utility::Deadline* deadline_;
+
+    /**
+     * Only this many via vertices are checked to bound the time of alternative routes when few of them are admissible.
+     */
+    static const size_t kMaxCheckedViaVertices = 32;
+
+    /**
+     * Relative tolerance of comparing lengths of routes that are summed in different order.
+     */
+    static constexpr float kLengthTolerance = 1e-4f;
+
+    /**
+     * Run the search until the minimum of both queues is not lower than `max_stretch` times the best route length.
+     *
+     * @param collect_via_vertices Store vertices reached by both directions in the workspace.
+     */
+    void Search(unsigned_id_type start_node, unsigned_id_type end_node, float max_stretch, bool collect_via_vertices);
+
+    /**
+     * Get the route through `via_vertex` formed by both search trees.
+     *
+     * @param via_position Set to the index of the first route edge after the via vertex.
+     */
+    std::vector<Edge> GetRouteVia(unsigned_id_type via_vertex, size_t& via_position);
+
+    /**
+     * Check that the subroute around the via vertex of `route` is the shortest route between its ends.
+     */
+    bool IsLocallyOptimal(const std::vector<Edge>& route, size_t via_position);
+
+    /**
+     * Add vertices of both search trees of the route through `via_vertex` to `vertices`.
+     * Their routes are the same as the route through `via_vertex`.
+     */
+    void AddTreeVertices(unsigned_id_type via_vertex, std::unordered_set<unsigned_id_type>& vertices);
+
+    /**
+     * Check whether `vertex` is reached with a lower cost through an edge from a higher vertex
+     * than its current cost in the direction.
+     */
+    bool IsStalled(Direction* direction, Vertex& vertex, float cost);
+
+    /**
+     * Pop the vertex with the minimal cost from the queues of both directions.
+     */
+    PriorityQueueMember GetMin(Direction& a, Direction& b);
+
+    float GetSummedCosts(float forward_cost, float backward_cost);
+
+    float GetMaxCost() const;
+
     struct PriorityQueueMember {
         float cost_priority;
         unsigned_id_type vertex_id;
         Direction* direction;
 
-        PriorityQueueMember() : cost_priority(std::numeric_limits<float>::max()), vertex_id(0), direction(nullptr) {}
-
         PriorityQueueMember(float c, unsigned_id_type v, Direction* dir) : cost_priority(c), vertex_id(v), direction(dir) {}
-
-        bool operator< (const PriorityQueueMember& other) {
-            return cost_priority < other.cost_priority;
-        }
-
-        bool operator> (const PriorityQueueMember& other) {
-            return cost_priority > other.cost_priority;
-        }
     };
 
     class Direction {
     public:
-        Direction(PriorityQueue& q, UnorderedMap& tv) : queue_(q), touched_vertices_(tv) {}
+        Direction(Q& q, TouchedVertices& tv) : queue_(q), touched_vertices_(tv) {}
         virtual ~Direction() = default;
 
         void SetRoutingProperties(unsigned_id_type vertex_id, float cost, unsigned_id_type previous) {
-            touched_vertices_.insert_or_assign(vertex_id, VertexRoutingProperties{cost, previous});
+            touched_vertices_[vertex_id] = VertexRoutingProperties{cost, previous};
         }
 
         VertexRoutingProperties& GetRoutingProperties(unsigned_id_type vertex_id) {
             return touched_vertices_[vertex_id];
         }
 
+        void Enqueue(float cost_priority, unsigned_id_type vertex_id) {
+            queue_.Push(vertex_id, cost_priority);
+        }
+
+        Q& GetQueue() {
+            return queue_;
+        }
+
         virtual void ForEachEdge(Vertex& vertex, const std::function<void(Edge&)>& f) = 0;
-        virtual void Enqueue(float cost_priority, unsigned_id_type vertex_id) = 0;
+
+        /**
+         * Edges of the vertex that are used by the opposite direction - they lead to the vertex in this direction.
+         */
+        virtual void ForEachOppositeEdge(Vertex& vertex, const std::function<void(Edge&)>& f) = 0;
     protected:
-        PriorityQueue& queue_;
-        UnorderedMap& touched_vertices_;
+        Q& queue_;
+        TouchedVertices& touched_vertices_;
     };
 
     class ForwardDirection : public Direction {
-        using Direction::queue_;
     public:
 
-        ForwardDirection(PriorityQueue& q, UnorderedMap& tv) : Direction(q, tv) {}
+        ForwardDirection(Q& q, TouchedVertices& tv) : Direction(q, tv) {}
 
         void ForEachEdge(Vertex& vertex, const std::function<void(Edge&)>& f) override {
             vertex.ForEachEdge(f);
         }
 
-        void Enqueue(float cost_priority, unsigned_id_type vertex_id) override {
-            queue_.emplace(cost_priority, vertex_id, this);
+        void ForEachOppositeEdge(Vertex& vertex, const std::function<void(Edge&)>& f) override {
+            vertex.ForEachBackwardEdge(f);
         }
 
     };
 
     class BackwardDirection : public Direction {
-        using Direction::queue_;
     public:
 
-        BackwardDirection(PriorityQueue& q, UnorderedMap& tv) : Direction(q, tv) {}
+        BackwardDirection(Q& q, TouchedVertices& tv) : Direction(q, tv) {}
 
         void ForEachEdge(Vertex& vertex, const std::function<void(Edge&)>& f) override {
             vertex.ForEachBackwardEdge(f);
         }
 
-        void Enqueue(float cost_priority, unsigned_id_type vertex_id) override {
-            queue_.emplace(cost_priority, vertex_id, this);
+        void ForEachOppositeEdge(Vertex& vertex, const std::function<void(Edge&)>& f) override {
+            vertex.ForEachEdge(f);
         }
 
     };
 };
 
-template <typename G>
-BidirectionalDijkstra<G>::BidirectionalDijkstra(G & g) : g_(g), forward_touched_vertices_(), backward_touched_vertices_(), settled_vertex_(0) {}
+template <typename G, typename EL, typename Q>
+BidirectionalDijkstra<G, EL, Q>::BidirectionalDijkstra(G & g, const EL& length, Workspace* workspace)
+    : g_(g), length_(length), own_workspace_(workspace ? nullptr : std::make_unique<Workspace>()), workspace_(workspace ? *workspace : *own_workspace_),
+        forward_touched_vertices_(workspace_.forward_touched_vertices), backward_touched_vertices_(workspace_.backward_touched_vertices),
+        forward_queue_(workspace_.forward_queue), backward_queue_(workspace_.backward_queue), settled_vertex_(0), start_node_(0), end_node_(0),
+        stall_on_demand_(true), settled_vertex_count_(0), stalled_vertex_count_(0), relaxed_edge_count_(0), route_length_(0), parameters_(), deadline_(nullptr) {}
+
+template <typename G, typename EL, typename Q>
+void BidirectionalDijkstra<G, EL, Q>::Run(unsigned_id_type start_node, unsigned_id_type end_node) {
+    Search(start_node, end_node, 1, false);
+}
 
-template <typename G>
-void BidirectionalDijkstra<G>::Run(unsigned_id_type start_node, unsigned_id_type end_node) {
+template <typename G, typename EL, typename Q>
+void BidirectionalDijkstra<G, EL, Q>::RunAlternatives(unsigned_id_type start_node, unsigned_id_type end_node, const AlternativeRouteParameters& parameters) {
+    parameters_ = parameters;
+    Search(start_node, end_node, std::max(parameters.max_stretch, 1.0f), true);
+}
+
+template <typename G, typename EL, typename Q>
+void BidirectionalDijkstra<G, EL, Q>::Search(unsigned_id_type start_node, unsigned_id_type end_node, float max_stretch, bool collect_via_vertices) {
     start_node_ = start_node;
     end_node_ = end_node;
-    forward_touched_vertices_.clear();
-    backward_touched_vertices_.clear();
-    PriorityQueue forward_queue;
-    PriorityQueue backward_queue;
-    ForwardDirection forward_direction{forward_queue, forward_touched_vertices_};
-    BackwardDirection backward_direction{backward_queue, backward_touched_vertices_};
-    forward_queue.emplace(0, start_node, &forward_direction);
-    backward_queue.emplace(0, end_node, &backward_direction);
-
-    forward_touched_vertices_.insert_or_assign(start_node, VertexRoutingProperties{0, 0});
-    backward_touched_vertices_.insert_or_assign(end_node, VertexRoutingProperties{0, 0});
+    forward_touched_vertices_.Clear();
+    backward_touched_vertices_.Clear();
+    forward_queue_.Clear();
+    backward_queue_.Clear();
+    workspace_.via_vertices.clear();
+    ForwardDirection forward_direction{forward_queue_, forward_touched_vertices_};
+    BackwardDirection backward_direction{backward_queue_, backward_touched_vertices_};
+    forward_direction.Enqueue(0, start_node);
+    backward_direction.Enqueue(0, end_node);
+
+    forward_touched_vertices_[start_node] = VertexRoutingProperties{0, 0};
+    backward_touched_vertices_[end_node] = VertexRoutingProperties{0, 0};
 
     float min_path_length = std::numeric_limits<float>::max();
-    
-    while (!forward_queue.empty() || !backward_queue.empty()) {
-        PriorityQueueMember min_member = GetMin(forward_queue, backward_queue);
+    settled_vertex_count_ = 0;
+    stalled_vertex_count_ = 0;
+    relaxed_edge_count_ = 0;
+
+    while (!forward_queue_.Empty() || !backward_queue_.Empty()) {
+        PriorityQueueMember min_member = GetMin(forward_direction, backward_direction);
+        if (min_member.cost_priority >= min_path_length * max_stretch) {
+            // The minimum of both queues cannot improve the best path (resp. be a part of an alternative path).
+            break;
+        }
         Vertex& vertex = g_.GetVertex(min_member.vertex_id);
         Direction* direction = min_member.direction;
         VertexRoutingProperties vertex_routing_properties = direction->GetRoutingProperties(vertex.get_uid());
-        bool queue_member_is_dead = vertex_routing_properties.cost < min_member.cost_priority;
-        if (queue_member_is_dead) {
-            continue; // The element already has lower cost - dead element in queue (was added multiple time with diff costs).
-        }
+        assert(vertex_routing_properties.cost == min_member.cost_priority);
+        ++settled_vertex_count_;
+        utility::Deadline::Check(deadline_, settled_vertex_count_);
         float path_length = GetSummedCosts(forward_touched_vertices_[vertex.get_uid()].cost, backward_touched_vertices_[vertex.get_uid()].cost);
         if (path_length < min_path_length) {
             min_path_length = path_length;
             settled_vertex_ = vertex.get_uid();
         }
-        // if vertex->backward_cost, vertex->forward_cost settled - update path length.
+        if (collect_via_vertices) {
+            // The other direction may reach the vertex later so only routes through it are compared at the end.
+            workspace_.via_vertices.push_back(vertex.get_uid());
+        }
+        if (stall_on_demand_ && IsStalled(direction, vertex, vertex_routing_properties.cost)) {
+            ++stalled_vertex_count_;
+            continue;
+        }
 
         direction->ForEachEdge(vertex, [&](Edge& edge) {
+            ++relaxed_edge_count_;
             unsigned_id_type neighbour_id = edge.get_to();
             Vertex& neighbour = g_.GetVertex(neighbour_id);
-            float new_cost = vertex_routing_properties.cost + edge.get_length();
+            float new_cost = vertex_routing_properties.cost + length_(edge);
             VertexRoutingProperties& neighbour_routing_properties = direction->GetRoutingProperties(neighbour_id);
             if (vertex.get_ordering_rank() < neighbour.get_ordering_rank() && new_cost < neighbour_routing_properties.cost) {
                 neighbour_routing_properties.cost = new_cost;
@@ -232,35 +411,156 @@ void BidirectionalDijkstra<G>::Run(unsigned_id_type start_node, unsigned_id_type
     if (min_path_length == std::numeric_limits<float>::max()) {
         throw RouteNotFoundException("Route from " + std::to_string(start_node) + " to " + std::to_string(end_node) + " could not be found");
     }
+    route_length_ = min_path_length;
+}
+
+template <typename G, typename EL, typename Q>
+std::vector<typename BidirectionalDijkstra<G, EL, Q>::Edge> BidirectionalDijkstra<G, EL, Q>::GetRoute() {
+    size_t via_position = 0;
+    return GetRouteVia(settled_vertex_, via_position);
+}
 
+template <typename G, typename EL, typename Q>
+std::vector<std::vector<typename BidirectionalDijkstra<G, EL, Q>::Edge>> BidirectionalDijkstra<G, EL, Q>::GetAlternativeRoutes(size_t max_count) {
+    auto&& via_vertices = workspace_.via_vertices;
+    // A vertex is collected once by each direction that settles it.
+    std::sort(via_vertices.begin(), via_vertices.end());
+    via_vertices.erase(std::unique(via_vertices.begin(), via_vertices.end()), via_vertices.end());
+    auto&& get_length = [&](unsigned_id_type vertex_id) {
+        return GetSummedCosts(forward_touched_vertices_[vertex_id].cost, backward_touched_vertices_[vertex_id].cost);
+    };
+    std::stable_sort(via_vertices.begin(), via_vertices.end(), [&](unsigned_id_type a, unsigned_id_type b) {
+        return get_length(a) < get_length(b);
+    });
+
+    std::unordered_set<unsigned_id_type> route_vertices{};
+    std::unordered_set<unsigned_id_type> route_edges{};
+    auto&& add_route = [&](unsigned_id_type via_vertex, const std::vector<Edge>& route) {
+        AddTreeVertices(via_vertex, route_vertices);
+        for (auto&& edge : route) {
+            route_edges.insert(edge.get_uid());
+        }
+    };
+    add_route(settled_vertex_, GetRoute());
+
+    std::vector<std::vector<Edge>> routes{};
+    float max_length = route_length_ * parameters_.max_stretch;
+    size_t checked_count = 0;
+    for (auto&& via_vertex : via_vertices) {
+        if (routes.size() >= max_count || get_length(via_vertex) > max_length) {
+            break;
+        }
+        if (route_vertices.find(via_vertex) != route_vertices.end()) {
+            continue;
+        }
+        if (++checked_count > kMaxCheckedViaVertices) {
+            break;
+        }
+        size_t via_position = 0;
+        std::vector<Edge> route = GetRouteVia(via_vertex, via_position);
+        float shared_length = 0;
+        for (auto&& edge : route) {
+            if (route_edges.find(edge.get_uid()) != route_edges.end()) {
+                shared_length += length_(edge);
+            }
+        }
+        if (shared_length > parameters_.max_sharing * route_length_ || !IsLocallyOptimal(route, via_position)) {
+            continue;
+        }
+        add_route(via_vertex, route);
+        routes.push_back(std::move(route));
+    }
+    return routes;
 }
 
-template <typename G>
-std::vector<typename BidirectionalDijkstra<G>::Edge> BidirectionalDijkstra<G>::GetRoute() {
-    RouteRetriever<G, UnorderedMap> r{g_};
-    typename RouteRetriever<G, UnorderedMap>::BiDijkstraForwardGraphInfo forward_routing_info{r, forward_touched_vertices_};
-    typename RouteRetriever<G, UnorderedMap>::BiDijkstraBackwardGraphInfo backward_routing_info{r, backward_touched_vertices_};
-    auto&& forward_route = r.GetRoute(&forward_routing_info, start_node_, settled_vertex_);
-    auto&& backward_route = r.GetRoute(&backward_routing_info, end_node_, settled_vertex_);
+template <typename G, typename EL, typename Q>
+std::vector<typename BidirectionalDijkstra<G, EL, Q>::Edge> BidirectionalDijkstra<G, EL, Q>::GetRouteVia(unsigned_id_type via_vertex, size_t& via_position) {
+    RouteRetriever<G, TouchedVertices> r{g_};
+    typename RouteRetriever<G, TouchedVertices>::BiDijkstraForwardGraphInfo forward_routing_info{r, forward_touched_vertices_};
+    typename RouteRetriever<G, TouchedVertices>::BiDijkstraBackwardGraphInfo backward_routing_info{r, backward_touched_vertices_};
+    auto&& forward_route = r.GetRoute(&forward_routing_info, start_node_, via_vertex);
+    auto&& backward_route = r.GetRoute(&backward_routing_info, end_node_, via_vertex);
+    via_position = forward_route.size();
     forward_route.insert(forward_route.end(), backward_route.rbegin(), backward_route.rend());
     return std::move(forward_route);
 }
 
-template <typename G>
-typename BidirectionalDijkstra<G>::PriorityQueueMember BidirectionalDijkstra<G>::GetMin(PriorityQueue& a, PriorityQueue& b) {
-    PriorityQueueMember atop = ((!a.empty()) ? a.top() : PriorityQueueMember{} );
-    PriorityQueueMember btop = ((!b.empty()) ? b.top() : PriorityQueueMember{} );
-    if (atop.cost_priority < btop.cost_priority) {
-        a.pop();
-        return atop;
+template <typename G, typename EL, typename Q>
+bool BidirectionalDijkstra<G, EL, Q>::IsLocallyOptimal(const std::vector<Edge>& route, size_t via_position) {
+    float max_length = parameters_.local_optimality * route_length_;
+    size_t begin = via_position;
+    float length = 0;
+    while (begin > 0 && length < max_length) {
+        --begin;
+        length += length_(route[begin]);
+    }
+    float before_length = length;
+    size_t end = via_position;
+    while (end < route.size() && length - before_length < max_length) {
+        length += length_(route[end]);
+        ++end;
+    }
+    if (begin == end) {
+        return true;
+    }
+    if (!workspace_.local_search_workspace) {
+        workspace_.local_search_workspace = std::make_unique<Workspace>();
+    }
+    // Twoway edges of the route can be stored in the opposite direction so route vertices are found by walking from the start.
+    std::vector<unsigned_id_type> vertices{start_node_};
+    vertices.reserve(route.size() + 1);
+    for (auto&& edge : route) {
+        vertices.push_back(edge.get_from() == vertices.back() ? edge.get_to() : edge.get_from());
+    }
+    BidirectionalDijkstra local_search{g_, length_, workspace_.local_search_workspace.get()};
+    local_search.SetDeadline(deadline_);
+    local_search.Run(vertices[begin], vertices[end]);
+    return length <= local_search.GetRouteLength() * (1 + kLengthTolerance);
+}
+
+template <typename G, typename EL, typename Q>
+void BidirectionalDijkstra<G, EL, Q>::AddTreeVertices(unsigned_id_type via_vertex, std::unordered_set<unsigned_id_type>& vertices) {
+    for (unsigned_id_type vertex_id = via_vertex; vertex_id != start_node_; vertex_id = forward_touched_vertices_[vertex_id].previous) {
+        vertices.insert(vertex_id);
+    }
+    for (unsigned_id_type vertex_id = via_vertex; vertex_id != end_node_; vertex_id = backward_touched_vertices_[vertex_id].previous) {
+        vertices.insert(vertex_id);
+    }
+}
+
+template <typename G, typename EL, typename Q>
+typename BidirectionalDijkstra<G, EL, Q>::PriorityQueueMember BidirectionalDijkstra<G, EL, Q>::GetMin(Direction& a, Direction& b) {
+    Q& a_queue = a.GetQueue();
+    Q& b_queue = b.GetQueue();
+    float a_cost = a_queue.Empty() ? GetMaxCost() : a_queue.Top().cost;
+    float b_cost = b_queue.Empty() ? GetMaxCost() : b_queue.Top().cost;
+    if (!a_queue.Empty() && (b_queue.Empty() || a_cost < b_cost)) {
+        utility::QueueMember member = a_queue.Pop();
+        return PriorityQueueMember{member.cost, member.vertex_id, &a};
     } else {
-        b.pop();
-        return btop;
+        utility::QueueMember member = b_queue.Pop();
+        return PriorityQueueMember{member.cost, member.vertex_id, &b};
     }
 }
 
-template <typename G>
-float BidirectionalDijkstra<G>::GetSummedCosts(float forward_cost, float backward_cost) {
+template <typename G, typename EL, typename Q>
+bool BidirectionalDijkstra<G, EL, Q>::IsStalled(Direction* direction, Vertex& vertex, float cost) {
+    bool stalled = false;
+    direction->ForEachOppositeEdge(vertex, [&](Edge& edge) {
+        unsigned_id_type neighbour_id = edge.get_to();
+        if (stalled || vertex.get_ordering_rank() >= g_.GetVertex(neighbour_id).get_ordering_rank()) {
+            return;
+        }
+        float neighbour_cost = direction->GetRoutingProperties(neighbour_id).cost;
+        if (neighbour_cost != GetMaxCost() && neighbour_cost + length_(edge) < cost) {
+            stalled = true;
+        }
+    });
+    return stalled;
+}
+
+template <typename G, typename EL, typename Q>
+float BidirectionalDijkstra<G, EL, Q>::GetSummedCosts(float forward_cost, float backward_cost) {
     float max = std::max(forward_cost, backward_cost);
     if (max != GetMaxCost()) { 
         return forward_cost + backward_cost;
@@ -269,8 +569,8 @@ float BidirectionalDijkstra<G>::GetSummedCosts(float forward_cost, float backwar
     }
 }
 
-template <typename G>
-inline float BidirectionalDijkstra<G>:: GetMaxCost() const {
+template <typename G, typename EL, typename Q>
+inline float BidirectionalDijkstra<G, EL, Q>:: GetMaxCost() const {
     return std::numeric_limits<float>::max();
 }
 
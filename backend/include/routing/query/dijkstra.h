@@ -2,15 +2,20 @@
 #define ROUTING_QUERY_DIJKSTRA_H
 #include "routing/edges/basic_edge.h"
 #include "routing/vertices/basic_vertex.h"
+#include "routing/edges/length_source.h"
 #include "routing/exception.h"
 #include "routing/types.h"
 #include "routing/query/route_retriever.h"
-
-#include "tsl/robin_map.h"
+#include "routing/query/alternative_route_parameters.h"
+#include "routing/utility/priority_queue.h"
+#include "routing/utility/epoch_vector.h"
+#include "routing/utility/deadline.h"
 
 #include <vector>
-#include <queue>
 #include <algorithm>
+#include <functional>
+#include <memory>
+#include <limits>
 
 namespace routing {
 namespace query {
@@ -21,19 +26,26 @@ namespace query {
  * It does not change any properties of vertices or edge of graph
  * it runs on. Any information such as current costs of vertices is stored
  * inside this class.
+ *
+ * @tparam EL Provides edge lengths - EL{}(edge). It can be used to route with lengths that are
+ *      defined per search and not stored in the graph.
+ * @tparam Q Priority queue of vertices with decrease-key - utility::IndexedDaryHeap or utility::LazyBinaryHeap.
  */
-template <typename G>
+template <typename G, typename EL = EdgeLength, typename Q = utility::IndexedDaryHeap<>>
 class Dijkstra {
 public:
     using Vertex = typename G::Vertex;
     using Edge = typename G::Edge;
-    /**
-     * Type of member in priority queue
-     */
-    using QueuePair = std::pair<float, unsigned_id_type>;
+    using EdgeLength = EL;
+    using PriorityQueue = Q;
     using Graph = G;
+    struct Workspace;
 
-    Dijkstra(G & g);
+    /**
+     * @param workspace Memory for the search that is reused by consecutive searches. The search
+     *      creates its own workspace if none is given.
+     */
+    Dijkstra(G & g, const EL& length = EL{}, Workspace* workspace = nullptr);
 
     /**
      * Find the best route from `start_node` to `end_node`.
@@ -58,21 +70,42 @@ public:
     bool Run(unsigned_id_type start_node, const std::function<bool(Vertex *)>& end_condition, const std::function<bool(Vertex*)>& ignore);
 
     float GetPathLength(unsigned_id_type to);
-private:
-    struct VertexRoutingProperties;
+
     /**
-     * Graph where dijkstra's algorithm is used.
+     * Number of vertices popped from the queue in the last search.
      */
-    G & g_;
-    using UnorderedMap = tsl::robin_map<unsigned_id_type, VertexRoutingProperties>;
-    UnorderedMap touched_vertices_;
+    size_t GetSettledVertexCount() const {
+        return settled_vertex_count_;
+    }
 
-    unsigned_id_type start_node_;
-    unsigned_id_type end_node_;
+    /**
+     * Number of edges scanned from settled vertices in the last search.
+     */
+    size_t GetRelaxedEdgeCount() const {
+        return relaxed_edge_count_;
+    }
+
+    /**
+     * Searches stop by TimeoutException when `deadline` expires. Null deadline is never checked.
+     */
+    void SetDeadline(const utility::Deadline* deadline) {
+        deadline_ = deadline;
+    }
+
+    /**
+     * Alternative routes are built from search spaces of both directions so unidirectional Dijkstra does not provide them.
+     */
+    void RunAlternatives(unsigned_id_type start_node, unsigned_id_type end_node, const AlternativeRouteParameters& parameters) {
+        throw NotImplementedException{"Alternative routes are provided only by Contraction Hierarchies."};
+    }
 
+    std::vector<std::vector<Edge>> GetAlternativeRoutes(size_t max_count) {
+        throw NotImplementedException{"Alternative routes are provided only by Contraction Hierarchies."};
+    }
+private:
     /**
-	 * Stores information from the search. It is memory & performance inefficient to store it in vertices
-	 * since a small portion of graph is searched.
+	 * Stores information from the search. It is not stored in vertices since the graph is shared
+	 * by concurrent searches.
 	 */
     struct VertexRoutingProperties {
         float cost;
@@ -89,88 +122,108 @@ private:
         ~VertexRoutingProperties() = default;
     };
 
-    void UpdateNeighbours(Vertex& v, VertexRoutingProperties& vertex_properties, std::set<QueuePair> & q, const std::function<bool(Vertex*)>& ignore);
+    using TouchedVertices = utility::EpochVector<VertexRoutingProperties>;
+
+public:
+    /**
+     * Workspace holds properties of touched vertices in vectors addressed by vertex ids
+     * and the priority queue. Both are cleared in constant time (resp. proportional to the queue size)
+     * so one workspace can be used by many searches one after another.
+     */
+    struct Workspace {
+        TouchedVertices touched_vertices;
+        Q queue;
+    };
+
+private:
+    /**
+     * Graph where dijkstra's algorithm is used.
+     */
+    G & g_;
+    EL length_;
+    std::unique_ptr<Workspace> own_workspace_;
+    Workspace& workspace_;
+    TouchedVertices& touched_vertices_;
+    Q& queue_;
+
+    unsigned_id_type start_node_;
+    unsigned_id_type end_node_;
+    size_t settled_vertex_count_;
+    size_t relaxed_edge_count_;
+    const utility::Deadline* deadline_;
+
+    void UpdateNeighbours(Vertex& v, const VertexRoutingProperties& vertex_properties, const std::function<bool(Vertex*)>& ignore);
 };
 
-template <typename G>
-Dijkstra<G>::Dijkstra(G & g) : g_(g), touched_vertices_(), start_node_(0), end_node_(0) {}
+template <typename G, typename EL, typename Q>
+Dijkstra<G, EL, Q>::Dijkstra(G & g, const EL& length, Workspace* workspace)
+    : g_(g), length_(length), own_workspace_(workspace ? nullptr : std::make_unique<Workspace>()), workspace_(workspace ? *workspace : *own_workspace_),
+        touched_vertices_(workspace_.touched_vertices), queue_(workspace_.queue), start_node_(0), end_node_(0), settled_vertex_count_(0), relaxed_edge_count_(0), deadline_(nullptr) {}
 
-template <typename G>
-void Dijkstra<G>::Run(unsigned_id_type start_node, unsigned_id_type end_node) {
+template <typename G, typename EL, typename Q>
+void Dijkstra<G, EL, Q>::Run(unsigned_id_type start_node, unsigned_id_type end_node) {
     start_node_ = start_node;
     end_node_ = end_node;
-    if (!Run(start_node, [=](Dijkstra<G>::Vertex* v) { return v->get_uid() == end_node; }, [](Dijkstra<G>::Vertex*) { return false; })) {
+    if (!Run(start_node, [=](Dijkstra<G, EL, Q>::Vertex* v) { return v->get_uid() == end_node; }, [](Dijkstra<G, EL, Q>::Vertex*) { return false; })) {
         throw RouteNotFoundException("Route from " + std::to_string(start_node) + " to " + std::to_string(end_node) + " could not be found");
     }
 }
 
-template <typename G>
-inline std::vector<typename Dijkstra<G>::Edge> Dijkstra<G>::GetRoute(unsigned_id_type end_node) {
-    RouteRetriever<G, UnorderedMap> r{g_};
-    typename RouteRetriever<G, UnorderedMap>::DijkstraGraphInfo graph_info{r, touched_vertices_};
+template <typename G, typename EL, typename Q>
+inline std::vector<typename Dijkstra<G, EL, Q>::Edge> Dijkstra<G, EL, Q>::GetRoute(unsigned_id_type end_node) {
+    RouteRetriever<G, TouchedVertices> r{g_};
+    typename RouteRetriever<G, TouchedVertices>::DijkstraGraphInfo graph_info{r, touched_vertices_};
     return r.GetRoute(&graph_info, start_node_, end_node);
 }
 
-template <typename G>
-inline std::vector<typename Dijkstra<G>::Edge> Dijkstra<G>::GetRoute() {
+template <typename G, typename EL, typename Q>
+inline std::vector<typename Dijkstra<G, EL, Q>::Edge> Dijkstra<G, EL, Q>::GetRoute() {
     return GetRoute(end_node_);
 }
 
-template <typename G>
-bool Dijkstra<G>::Run(unsigned_id_type start_node, const std::function<bool(Vertex *)>& end_condition, const std::function<bool(Vertex*)>& ignore) {
-    // Priority queue is implemented with Set of pairs of float(=cost) and Vertex*.
-    // This is the default possible implementation of std::pair.
-    // So pairs with the same cost can be in the set when they belong to different vertices.
-    /*
-    template <class T1, class T2>
-    bool operator<(const pair<T1, T2>& x, const pair<T1, T2>& y)
-    {
-        return x.first < y.first ||
-               (!(y.first < x.first) && x.second < y.second);
-    }
-    */
-    std::set<QueuePair> q;
+template <typename G, typename EL, typename Q>
+bool Dijkstra<G, EL, Q>::Run(unsigned_id_type start_node, const std::function<bool(Vertex *)>& end_condition, const std::function<bool(Vertex*)>& ignore) {
     start_node_ = start_node;
-    touched_vertices_.clear();
+    touched_vertices_.Clear();
+    queue_.Clear();
 
-    touched_vertices_.insert_or_assign(start_node, VertexRoutingProperties{0, 0});
-    q.insert(std::make_pair(0, start_node));
+    touched_vertices_[start_node] = VertexRoutingProperties{0, 0};
+    queue_.Push(start_node, 0);
+    settled_vertex_count_ = 0;
+    relaxed_edge_count_ = 0;
 
-    while (q.empty() == false) {
-        auto&& it = q.begin();
-        Vertex& v = g_.GetVertex(it->second);
-        q.erase(it);
+    while (!queue_.Empty()) {
+        Vertex& v = g_.GetVertex(queue_.Pop().vertex_id);
+        ++settled_vertex_count_;
+        utility::Deadline::Check(deadline_, settled_vertex_count_);
 
         if (end_condition(&v)) {
             return true;
         }
         VertexRoutingProperties vertex_properties = touched_vertices_[v.get_uid()];
-        UpdateNeighbours(v, vertex_properties, q, ignore);
+        UpdateNeighbours(v, vertex_properties, ignore);
     }
     return false;
 }
 
-template <typename G>
-float Dijkstra<G>::GetPathLength(unsigned_id_type to) {
+template <typename G, typename EL, typename Q>
+float Dijkstra<G, EL, Q>::GetPathLength(unsigned_id_type to) {
     return touched_vertices_[to].cost;
 }
 
-template <typename G>
-void Dijkstra<G>::UpdateNeighbours(Vertex& v, VertexRoutingProperties& vertex_properties, std::set<QueuePair>& q, const std::function<bool(Vertex*)>& ignore) {
+template <typename G, typename EL, typename Q>
+void Dijkstra<G, EL, Q>::UpdateNeighbours(Vertex& v, const VertexRoutingProperties& vertex_properties, const std::function<bool(Vertex*)>& ignore) {
     v.ForEachEdge([&](Edge & edge) {
+        ++relaxed_edge_count_;
         unsigned_id_type neighbour_id = edge.get_to();
         Vertex& neighbour = g_.GetVertex(neighbour_id);
         VertexRoutingProperties& neighbour_properties = touched_vertices_[neighbour_id];
-        float new_cost = vertex_properties.cost + edge.get_length();
+        float new_cost = vertex_properties.cost + length_(edge);
         if (!ignore(&neighbour) && neighbour_properties.cost > new_cost) {
-
-            // Only vertices with updated values are in priority queue.
-            if (neighbour_properties.cost != std::numeric_limits<float>::max()) {
-                q.erase(std::make_pair(neighbour_properties.cost, neighbour_id));
-            }
             neighbour_properties.cost = new_cost;
             neighbour_properties.previous = v.get_uid();
-            q.insert(std::make_pair(neighbour_properties.cost, neighbour_id));
+            // Inserts the neighbour or decreases its cost in the queue.
+            queue_.Push(neighbour_id, new_cost);
         }
     });
 }
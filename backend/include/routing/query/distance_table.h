@@ -0,0 +1,53 @@
+#ifndef ROUTING_QUERY_DISTANCE_TABLE_H
+#define ROUTING_QUERY_DISTANCE_TABLE_H
+
+#include <vector>
+#include <limits>
+#include <cstddef>
+#include <cassert>
+
+namespace routing{
+namespace query{
+
+/**
+ * DistanceTable is the result of a many-to-many request - lengths of the shortest routes
+ * from each source to each target. Routes are not unpacked so only their lengths are known.
+ */
+class DistanceTable {
+public:
+    /**
+     * @param distances Lengths of routes in row-major order - all targets of the first source go first.
+     *      Unreachable targets have `kUnreachable` length.
+     */
+    DistanceTable(size_t source_count, size_t target_count, std::vector<float>&& distances)
+        : source_count_(source_count), target_count_(target_count), distances_(std::move(distances)) {
+        assert(distances_.size() == source_count_ * target_count_);
+    }
+
+    static constexpr float kUnreachable = std::numeric_limits<float>::max();
+
+    size_t get_source_count() const {
+        return source_count_;
+    }
+
+    size_t get_target_count() const {
+        return target_count_;
+    }
+
+    float GetDistance(size_t source_index, size_t target_index) const {
+        return distances_[source_index * target_count_ + target_index];
+    }
+
+    bool IsReachable(size_t source_index, size_t target_index) const {
+        return GetDistance(source_index, target_index) != kUnreachable;
+    }
+
+private:
+    size_t source_count_;
+    size_t target_count_;
+    std::vector<float> distances_;
+};
+
+}
+}
+#endif // ROUTING_QUERY_DISTANCE_TABLE_H
@@ -3,10 +3,12 @@
 
 #include "routing/edge_ranges/iterator_edge_range.h"
 #include "routing/edge_ranges/vector_edge_range.h"
+#include "routing/edge_ranges/compact_edge_range.h"
 #include "routing/types.h"
 
 #include <iterator>
 #include <vector>
+#include <memory>
 
 namespace routing{
 namespace query{
@@ -43,6 +45,29 @@ public:
     }
 };
 
+/**
+ * EdgeRangePolicyCompact creates CompactEdgeRange from vector of edges.
+ */
+template <typename Edge>
+class EdgeRangePolicyCompact{
+public:
+
+    EdgeRangePolicyCompact() {}
+
+    CompactEdgeRange<Edge> CreateEdgeRange(std::vector<Edge>&& edges) {
+        auto&& compact_edges = std::make_unique<CompactEdges<Edge>>();
+        compact_edges->Reserve(edges.size());
+        for (auto&& edge : edges) {
+            compact_edges->AddEdge(edge);
+        }
+        edges_.push_back(std::move(compact_edges));
+        return CompactEdgeRange<Edge>{edges_.back().get(), 0, edges_.back()->GetEdgeCount()};
+    }
+
+private:
+    std::vector<std::unique_ptr<CompactEdges<Edge>>> edges_;
+};
+
 
 }
 }
@@ -2,11 +2,12 @@
 #define ROUTING_QUERY_ENPOINT_EDGES_CREATOR_H
 
 #include "routing/edges/basic_edge.h"
+#include "routing/edges/length_source.h"
 #include "routing/exception.h"
 #include "routing/types.h"
 
-#include "routing/database/database_helper.h"
-#include "routing/database/db_graph.h"
+#include "routing/spatial/geometry.h"
+#include "routing/spatial/segment_index.h"
 
 #include "routing/utility/comparison.h"
 
@@ -22,14 +23,16 @@ namespace query{
  * EndpointEdgesCreator handles creating edges from endpoint (defined by lat loncoordinates)
  * to closest intersection (ie vertex). 
  * 
- * It finds the geographically closest edge to the endpoint and splits it into two to 
- * create edges to endpoint vertex. It also creates geometries for these edges.
+ * It finds the geographically closest edge to the endpoint in the in-memory segment index
+ * and splits it into two to create edges to endpoint vertex. It also creates geometries for these edges.
+ *
+ * @tparam EL Provides lengths of graph edges which are split into endpoint edges.
  */
-template <typename EdgeFactory, typename Graph>
+template <typename EdgeFactory, typename Graph, typename EL = EdgeLength>
 class EndpointEdgesCreator {
 public:
     EndpointEdgesCreator();
-    EndpointEdgesCreator(Graph& graph, database::DatabaseHelper& d, database::DbGraph* db_graph, const EdgeFactory& edge_factory);
+    EndpointEdgesCreator(Graph& graph, const spatial::SegmentIndex& segment_index, const EdgeFactory& edge_factory, const EL& length = EL{});
 
     EndpointEdgesCreator(const EndpointEdgesCreator& other) = default;
     EndpointEdgesCreator(EndpointEdgesCreator&& other) = default;
@@ -45,29 +48,35 @@ public:
      * @return vector of new edges and their geometries.
      */
     std::pair<std::vector<typename EdgeFactory::Edge>, std::vector<std::pair<unsigned_id_type, std::string>>> CalculateEndpointEdges(
-        const std::string& table_name, unsigned_id_type endpoint_id, utility::Point p, unsigned_id_type free_edge_id);
+        unsigned_id_type endpoint_id, utility::Point p, unsigned_id_type free_edge_id);
+
+    /**
+     * Create edges of endpoint and their geometries from an already found split of its closest edge.
+     * It is used when the same point is an endpoint of more routes.
+     *
+     * @return vector of new edges and their geometries.
+     */
+    std::pair<std::vector<typename EdgeFactory::Edge>, std::vector<std::pair<unsigned_id_type, std::string>>> CalculateEndpointEdgesAndGeometries(
+        unsigned_id_type endpoint_id, const spatial::EdgeSplit& split, unsigned_id_type free_edge_id);
+
+    /**
+     * Create edges of endpoint from an already found split of its closest edge. No geometries are created
+     * so it is used when only lengths of routes are needed. The same split can be used for more endpoints.
+     *
+     * @return vector of new edges.
+     */
+    std::vector<typename EdgeFactory::Edge> CalculateEndpointEdges(unsigned_id_type endpoint_id, const spatial::EdgeSplit& split,
+        unsigned_id_type free_edge_id);
 
 private:
 
     std::reference_wrapper<Graph> graph_;
 
-    std::reference_wrapper<database::DatabaseHelper> d_;
-
-    database::DbGraph* db_graph_;
+    std::reference_wrapper<const spatial::SegmentIndex> segment_index_;
 
     EdgeFactory edge_factory_;
 
-    /**
-     * Indices to the output of the SQL query used to retrieve the closest edge, etc..
-     */
-    static const size_t kAdjEdgeFrom = 0;
-    static const size_t kAdjEdgeTo = 1;
-    static const size_t kClosestEdgeFrom = 2;
-    static const size_t kClosestEdgeTo = 3;
-    static const size_t kClosestEdgeUid = 4;
-    static const size_t kSegmentRelativeLength = 5;
-    static const size_t kSegmentGeometry = 6;
-    static const size_t kSegmentIntersectsAdjacent = 7;
+    EL length_;
 
     class EdgeInputData{
     public:
@@ -103,91 +112,85 @@ private:
     };
 
     /**
-     * Create new edges from segment and add them to `result_edges` vector.
+     * Create new edge from segment and add it to `result_edges` vector.
      *
-     * @param r Db row representing segment.
+     * @param segment Geometry of the segment.
+     * @param relative_length Length of the segment relative to the length of `closest_edge`.
      * @param result_edges Output value where new edges are added to.
-     * @param edge_id Edge id which is free to use as well as the +1 id.
+     * @param result_geometries Output value where geometries of new edges are added to.
      * @param endpoint_id Node id which is free to use and which is one endpoint of the segment.
      * @param intersection_id Id of original intersection that will serve as the other endpoint.
+     * @param free_edge_id Edge id which is free to use.
      */
-    void SaveEdge(database::DbRow& r, std::vector<typename EdgeFactory::Edge>& result_edges, std::vector<std::pair<unsigned_id_type, std::string>>& result_geometries,
-        typename Graph::Edge& closest_edge, unsigned_id_type endpoint_id, unsigned_id_type intersection_id, unsigned_id_type free_edge_id);
+    void SaveEdge(const std::vector<utility::Point>& segment, float relative_length, std::vector<typename EdgeFactory::Edge>& result_edges,
+        std::vector<std::pair<unsigned_id_type, std::string>>& result_geometries, const typename Graph::Edge& closest_edge,
+        unsigned_id_type endpoint_id, unsigned_id_type intersection_id, unsigned_id_type free_edge_id);
 
-    typename Graph::Edge& GetEdge(unsigned_id_type edge_id, unsigned_id_type edge_from, unsigned_id_type edge_to);
-};
+    /**
+     * Create new edge from `endpoint_id` to `intersection_id` whose length is `relative_length` of `closest_edge` length.
+     */
+    typename EdgeFactory::Edge CreateEdge(float relative_length, const typename Graph::Edge& closest_edge,
+        unsigned_id_type endpoint_id, unsigned_id_type intersection_id, unsigned_id_type free_edge_id);
 
-template <typename EdgeFactory, typename Graph>
-EndpointEdgesCreator<EdgeFactory, Graph>::EndpointEdgesCreator(Graph& graph, database::DatabaseHelper& d, database::DbGraph* db_graph, const EdgeFactory& edge_factory)
-            : graph_(std::ref(graph)), d_(std::ref(d)), db_graph_(db_graph), edge_factory_(edge_factory) {}
+    /**
+     * Copy of the graph edge - edges of compact graphs exist only while they are iterated.
+     */
+    typename Graph::Edge GetEdge(unsigned_id_type edge_id, unsigned_id_type edge_from, unsigned_id_type edge_to);
+};
 
-template <typename EdgeFactory, typename Graph>
-std::pair<std::vector<typename EdgeFactory::Edge>, std::vector<std::pair<unsigned_id_type, std::string>>> EndpointEdgesCreator<EdgeFactory, Graph>::CalculateEndpointEdges(
-        const std::string& table_name, unsigned_id_type endpoint_id, utility::Point p, unsigned_id_type free_edge_id) {
-    std::vector<database::DbRow> rows = d_.get().GetClosestSegments(p, table_name, db_graph_);
+template <typename EdgeFactory, typename Graph, typename EL>
+EndpointEdgesCreator<EdgeFactory, Graph, EL>::EndpointEdgesCreator(Graph& graph, const spatial::SegmentIndex& segment_index, const EdgeFactory& edge_factory,
+    const EL& length) : graph_(std::ref(graph)), segment_index_(std::cref(segment_index)), edge_factory_(edge_factory), length_(length) {}
 
-    // Endpoint has a closest edge that has no neighbours.
-    if (rows.size() == 0) {
-        throw RouteNotFoundException{"Route cannot be found - endpoint edge has no neighbours."};
-    }
+template <typename EdgeFactory, typename Graph, typename EL>
+std::pair<std::vector<typename EdgeFactory::Edge>, std::vector<std::pair<unsigned_id_type, std::string>>> EndpointEdgesCreator<EdgeFactory, Graph, EL>::CalculateEndpointEdges(
+        unsigned_id_type endpoint_id, utility::Point p, unsigned_id_type free_edge_id) {
+    return CalculateEndpointEdgesAndGeometries(endpoint_id, segment_index_.get().FindClosestEdge(p), free_edge_id);
+}
 
+template <typename EdgeFactory, typename Graph, typename EL>
+std::pair<std::vector<typename EdgeFactory::Edge>, std::vector<std::pair<unsigned_id_type, std::string>>> EndpointEdgesCreator<EdgeFactory, Graph, EL>::CalculateEndpointEdgesAndGeometries(
+        unsigned_id_type endpoint_id, const spatial::EdgeSplit& split, unsigned_id_type free_edge_id) {
+    auto&& closest_edge = GetEdge(split.uid, split.from, split.to);
 
     std::vector<typename EdgeFactory::Edge> result_edges{};
     std::vector<std::pair<unsigned_id_type, std::string>> result_geometries{};
 
-    unsigned_id_type segment_intersecting_adjacent_index = 0;
-    if (rows.size() > 1) {
-        segment_intersecting_adjacent_index = ((rows[0].get<bool>(kSegmentIntersectsAdjacent)) ? 0 : 1);
-    }
-
-    // Create edges from the segment that intersects adjacent edge from sql query.
-    auto&& segment_row = rows[segment_intersecting_adjacent_index];
-    unsigned_id_type adj_edge_from = segment_row.get<unsigned_id_type>(kAdjEdgeFrom);
-    unsigned_id_type adj_edge_to = segment_row.get<unsigned_id_type>(kAdjEdgeTo);
-    unsigned_id_type closest_edge_from = segment_row.get<unsigned_id_type>(kClosestEdgeFrom);
-    unsigned_id_type closest_edge_to = segment_row.get<unsigned_id_type>(kClosestEdgeTo);
-    unsigned_id_type closest_edge_uid = segment_row.get<unsigned_id_type>(kClosestEdgeUid);
-
-    // Determine the segment's endpoint uid (it is one of closest edge intersections)
-    // The other endpoint is newly created point (split point).
-    bool closest_edge_from_used = false;
-    unsigned_id_type adjacent_intersection = 0;
-    if (closest_edge_from == adj_edge_from || closest_edge_from ==  adj_edge_to) {
-        closest_edge_from_used = true;
-        adjacent_intersection = closest_edge_from;
-    } else {
-        adjacent_intersection = closest_edge_to; 
-    }
-    
-    auto&& closest_edge = GetEdge(closest_edge_uid, closest_edge_from, closest_edge_to);
-
-    SaveEdge(segment_row, result_edges, result_geometries, closest_edge, endpoint_id, adjacent_intersection, free_edge_id);
+    // Edge geometry leads from `from` intersection to `to` intersection so the segment
+    // before the split point touches `from` and the one after it touches `to`.
+    SaveEdge(split.from_segment, split.from_segment_relative_length, result_edges, result_geometries, closest_edge, endpoint_id, split.from, free_edge_id);
     ++free_edge_id;
+    SaveEdge(split.to_segment, 1 - split.from_segment_relative_length, result_edges, result_geometries, closest_edge, endpoint_id, split.to, free_edge_id);
+    return std::make_pair(result_edges, result_geometries);
+}
 
-    if (rows.size() == 1) {
-        return std::make_pair(result_edges, result_geometries);
-    }
-
-    // Create edges for the other segment.
-    unsigned_id_type other_segment_index = 1 - segment_intersecting_adjacent_index;
+template <typename EdgeFactory, typename Graph, typename EL>
+std::vector<typename EdgeFactory::Edge> EndpointEdgesCreator<EdgeFactory, Graph, EL>::CalculateEndpointEdges(unsigned_id_type endpoint_id,
+    const spatial::EdgeSplit& split, unsigned_id_type free_edge_id) {
+    auto&& closest_edge = GetEdge(split.uid, split.from, split.to);
+    std::vector<typename EdgeFactory::Edge> result_edges{};
+    result_edges.push_back(CreateEdge(split.from_segment_relative_length, closest_edge, endpoint_id, split.from, free_edge_id));
+    result_edges.push_back(CreateEdge(1 - split.from_segment_relative_length, closest_edge, endpoint_id, split.to, free_edge_id + 1));
+    return result_edges;
+}
 
-    unsigned_id_type other_intersection = ((closest_edge_from_used) ? closest_edge_to : closest_edge_from);
-    SaveEdge(rows[other_segment_index], result_edges, result_geometries, closest_edge, endpoint_id, other_intersection, free_edge_id);
-    ++free_edge_id;
-    return std::make_pair(result_edges, result_geometries);
+template <typename EdgeFactory, typename Graph, typename EL>
+void EndpointEdgesCreator<EdgeFactory, Graph, EL>::SaveEdge(const std::vector<utility::Point>& segment, float relative_length, std::vector<typename EdgeFactory::Edge>& result_edges,
+    std::vector<std::pair<unsigned_id_type, std::string>>& result_geometries, const typename Graph::Edge& closest_edge,
+    unsigned_id_type endpoint_id, unsigned_id_type intersection_id, unsigned_id_type free_edge_id) {
+    result_edges.push_back(CreateEdge(relative_length, closest_edge, endpoint_id, intersection_id, free_edge_id));
+    result_geometries.push_back(std::make_pair(free_edge_id, spatial::MakeGeoJsonLineString(segment)));
 }
 
-template <typename EdgeFactory, typename Graph>
-void EndpointEdgesCreator<EdgeFactory, Graph>::SaveEdge(database::DbRow& r, std::vector<typename EdgeFactory::Edge>& result_edges, std::vector<std::pair<unsigned_id_type, std::string>>& result_geometries,
-    typename Graph::Edge& closest_edge, unsigned_id_type endpoint_id, unsigned_id_type intersection_id, unsigned_id_type free_edge_id) {
-    float length = closest_edge.get_length() * r.get<float>(kSegmentRelativeLength);
-    std::string geometry = r.get<std::string>(kSegmentGeometry);
-    result_edges.push_back(edge_factory_.Create(EdgeInputData{free_edge_id, endpoint_id, intersection_id, length}));
-    result_geometries.push_back(std::make_pair(free_edge_id, geometry));
+template <typename EdgeFactory, typename Graph, typename EL>
+typename EdgeFactory::Edge EndpointEdgesCreator<EdgeFactory, Graph, EL>::CreateEdge(float relative_length, const typename Graph::Edge& closest_edge,
+    unsigned_id_type endpoint_id, unsigned_id_type intersection_id, unsigned_id_type free_edge_id) {
+    float length = length_(closest_edge) * relative_length;
+    return edge_factory_.Create(EdgeInputData{free_edge_id, endpoint_id, intersection_id, length});
 }
 
-template <typename EdgeFactory, typename Graph>
-typename Graph::Edge& EndpointEdgesCreator<EdgeFactory, Graph>::GetEdge(unsigned_id_type edge_id, unsigned_id_type edge_from, unsigned_id_type edge_to) {
+template <typename EdgeFactory, typename Graph, typename EL>
+typename Graph::Edge EndpointEdgesCreator<EdgeFactory, Graph, EL>::GetEdge(unsigned_id_type edge_id, unsigned_id_type edge_from, unsigned_id_type edge_to) {
     auto&& from_vertex = graph_.get().GetVertex(edge_from);
     for(auto&& edge : from_vertex.get_edges()) {
         if (edge_id == edge.get_uid()) {
@@ -6,6 +6,7 @@
 #include "routing/types.h"
 
 #include "routing/utility/point.h"
+#include "routing/spatial/segment_index.h"
 
 #include <utility>
 #include <string>
@@ -30,15 +31,35 @@ public:
     EndpointsCreator(EndpointAlgorithmPolicy&& gp, EndpointEdgesCreator&& eec) 
         : graph_policy_(std::move(gp)), endpoint_edges_creator_(std::move(eec)), free_endpoint_edge_id_(0), source_edges_geometries_(), target_edges_geometries_()  {}
 
-    void AddSourceEndpoint(const std::string& table_name, unsigned_id_type source_id, utility::Point source_location) {
-        auto&& [edges, geometries] = endpoint_edges_creator_.CalculateEndpointEdges(table_name, source_id, source_location, free_endpoint_edge_id_);
+    void AddSourceEndpoint(unsigned_id_type source_id, utility::Point source_location) {
+        auto&& [edges, geometries] = endpoint_edges_creator_.CalculateEndpointEdges(source_id, source_location, free_endpoint_edge_id_);
         free_endpoint_edge_id_ += edges.size();
         source_edges_geometries_ = std::move(geometries);
         graph_policy_.AddSource(std::move(edges), source_id);
     }
 
-    void AddTargetEndpoint(const std::string& table_name, unsigned_id_type target_id, utility::Point target_location) {
-        auto&& [edges, geometries] = endpoint_edges_creator_.CalculateEndpointEdges(table_name, target_id, target_location, free_endpoint_edge_id_);
+    void AddTargetEndpoint(unsigned_id_type target_id, utility::Point target_location) {
+        auto&& [edges, geometries] = endpoint_edges_creator_.CalculateEndpointEdges(target_id, target_location, free_endpoint_edge_id_);
+        free_endpoint_edge_id_ += edges.size();
+        target_edges_geometries_ = std::move(geometries);
+        graph_policy_.AddTarget(std::move(edges), target_id);
+    }
+
+    /**
+     * Add source endpoint whose closest edge is already split.
+     */
+    void AddSourceEndpoint(unsigned_id_type source_id, const spatial::EdgeSplit& split) {
+        auto&& [edges, geometries] = endpoint_edges_creator_.CalculateEndpointEdgesAndGeometries(source_id, split, free_endpoint_edge_id_);
+        free_endpoint_edge_id_ += edges.size();
+        source_edges_geometries_ = std::move(geometries);
+        graph_policy_.AddSource(std::move(edges), source_id);
+    }
+
+    /**
+     * Add target endpoint whose closest edge is already split.
+     */
+    void AddTargetEndpoint(unsigned_id_type target_id, const spatial::EdgeSplit& split) {
+        auto&& [edges, geometries] = endpoint_edges_creator_.CalculateEndpointEdgesAndGeometries(target_id, split, free_endpoint_edge_id_);
         free_endpoint_edge_id_ += edges.size();
         target_edges_geometries_ = std::move(geometries);
         graph_policy_.AddTarget(std::move(edges), target_id);
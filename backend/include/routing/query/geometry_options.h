@@ -0,0 +1,47 @@
+#ifndef ROUTING_QUERY_GEOMETRY_OPTIONS_H
+#define ROUTING_QUERY_GEOMETRY_OPTIONS_H
+
+namespace routing{
+namespace query{
+
+enum class GeometryFormat {
+    /**
+     * GeoJSON array of LineString geometries of route edges.
+     */
+    kGeoJson,
+
+    /**
+     * One encoded polyline of the whole route.
+     */
+    kPolyline
+};
+
+/**
+ * GeometryOptions define how route geometry is written.
+ */
+struct GeometryOptions {
+    GeometryFormat format;
+
+    /**
+     * Number of decimal digits of polyline coordinates.
+     */
+    int precision;
+
+    /**
+     * Douglas-Peucker tolerance in meters of polyline simplification. Polyline is not simplified if it is zero.
+     * GeoJSON geometries are never simplified.
+     */
+    double tolerance;
+
+    GeometryOptions() : format(GeometryFormat::kGeoJson), precision(5), tolerance(0) {}
+
+    GeometryOptions(GeometryFormat f, int p, double t) : format(f), precision(p), tolerance(t) {}
+
+    bool operator==(const GeometryOptions& other) const {
+        return format == other.format && precision == other.precision && tolerance == other.tolerance;
+    }
+};
+
+}
+}
+#endif // ROUTING_QUERY_GEOMETRY_OPTIONS_H
@@ -0,0 +1,314 @@
+#ifndef ROUTING_QUERY_MANY_TO_MANY_H
+#define ROUTING_QUERY_MANY_TO_MANY_H
+
+#include "routing/edges/basic_edge.h"
+#include "routing/edges/length_source.h"
+#include "routing/query/dijkstra.h"
+#include "routing/query/distance_table.h"
+#include "routing/utility/priority_queue.h"
+#include "routing/utility/epoch_vector.h"
+#include "routing/utility/deadline.h"
+#include "routing/types.h"
+
+#include <vector>
+#include <limits>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <unordered_set>
+
+namespace routing {
+namespace query {
+
+/**
+ * ManyToManyContractionHierarchies computes lengths of the shortest routes from all sources to all targets
+ * in a graph of Contraction Hierarchies (CHSearchGraph or compatible).
+ *
+ * Each target runs a backward search that only goes up in the hierarchy. Vertices that it settles
+ * get an entry in their bucket - the target and its cost. Then each source runs a forward upward search
+ * and scans buckets of vertices it settles. The shortest route meets at its highest vertex
+ * so its length is found in a bucket. That needs |sources| + |targets| searches instead of |sources| * |targets|.
+ *
+ * Both searches use stall-on-demand so that vertices reached by a shorter path through a higher vertex
+ * do not fill buckets. Routes are not unpacked.
+ *
+ * @tparam G Search graph whose vertices provide ForEachEdge and ForEachBackwardEdge.
+ * @tparam EL Provides lengths of edges.
+ */
+template <typename G, typename EL = EdgeLength, typename Q = utility::IndexedDaryHeap<>>
+class ManyToManyContractionHierarchies {
+public:
+    using Vertex = typename G::Vertex;
+    using Edge = typename G::Edge;
+    using EdgeLength = EL;
+    using PriorityQueue = Q;
+    using Graph = G;
+    struct Workspace;
+
+    /**
+     * @param workspace Memory for the searches that is reused by consecutive runs. The algorithm
+     *      creates its own workspace if none is given.
+     */
+    ManyToManyContractionHierarchies(G& g, const EL& length = EL{}, Workspace* workspace = nullptr);
+
+    /**
+     * Find lengths of the shortest routes from each source to each target.
+     */
+    void Run(const std::vector<unsigned_id_type>& sources, const std::vector<unsigned_id_type>& targets);
+
+    /**
+     * Searches stop by TimeoutException when `deadline` expires. Null deadline is never checked.
+     */
+    void SetDeadline(const utility::Deadline* deadline) {
+        deadline_ = deadline;
+    }
+
+    /**
+     * Lengths of the routes of the last run in row-major order. Unreachable targets have DistanceTable::kUnreachable length.
+     */
+    const std::vector<float>& GetDistances() const {
+        return distances_;
+    }
+
+    /**
+     * Number of vertices settled by all searches of the last run. Stalled vertices are included.
+     */
+    size_t GetSettledVertexCount() const {
+        return settled_vertex_count_;
+    }
+
+    /**
+     * Number of bucket entries created by backward searches of the last run.
+     */
+    size_t GetBucketEntryCount() const {
+        return workspace_.bucket_entries.size();
+    }
+
+private:
+    struct VertexCost {
+        float cost;
+
+        VertexCost() : cost(std::numeric_limits<float>::max()) {}
+    };
+
+    /**
+     * Target reached by a backward search in a vertex with `cost`.
+     */
+    struct BucketEntry {
+        unsigned_id_type vertex_id;
+        unsigned_id_type target_index;
+        float cost;
+    };
+
+    /**
+     * Bucket of a vertex is [begin, end) range in sorted bucket entries.
+     */
+    struct Bucket {
+        size_t begin;
+        size_t end;
+
+        Bucket() : begin(0), end(0) {}
+    };
+
+public:
+    /**
+     * Workspace holds costs of one search, its priority queue and buckets of vertices.
+     */
+    struct Workspace {
+        utility::EpochVector<VertexCost> costs;
+        Q queue;
+        utility::EpochVector<Bucket> buckets;
+        std::vector<BucketEntry> bucket_entries;
+    };
+
+private:
+    G& g_;
+    EL length_;
+    std::unique_ptr<Workspace> own_workspace_;
+    Workspace& workspace_;
+    std::vector<float> distances_;
+    size_t settled_vertex_count_;
+    const utility::Deadline* deadline_;
+
+    /**
+     * Run upward search from `start_node` and call `settle` with each vertex it settles that is not stalled.
+     *
+     * @param forward Forward search follows forward edges and backward search follows backward edges.
+     */
+    void Search(unsigned_id_type start_node, bool forward, const std::function<void(unsigned_id_type, float)>& settle);
+
+    /**
+     * Check whether `vertex` is reached with a lower cost than `cost` through an edge from a higher vertex.
+     */
+    bool IsStalled(Vertex& vertex, float cost, bool forward);
+};
+
+template <typename G, typename EL, typename Q>
+ManyToManyContractionHierarchies<G, EL, Q>::ManyToManyContractionHierarchies(G& g, const EL& length, Workspace* workspace)
+    : g_(g), length_(length), own_workspace_(workspace ? nullptr : std::make_unique<Workspace>()), workspace_(workspace ? *workspace : *own_workspace_),
+        distances_(), settled_vertex_count_(0), deadline_(nullptr) {}
+
+template <typename G, typename EL, typename Q>
+void ManyToManyContractionHierarchies<G, EL, Q>::Run(const std::vector<unsigned_id_type>& sources, const std::vector<unsigned_id_type>& targets) {
+    distances_.assign(sources.size() * targets.size(), DistanceTable::kUnreachable);
+    settled_vertex_count_ = 0;
+    auto&& bucket_entries = workspace_.bucket_entries;
+    auto&& buckets = workspace_.buckets;
+    bucket_entries.clear();
+    buckets.Clear();
+
+    for (size_t target_index = 0; target_index < targets.size(); ++target_index) {
+        Search(targets[target_index], false, [&](unsigned_id_type vertex_id, float cost) {
+            bucket_entries.push_back(BucketEntry{vertex_id, static_cast<unsigned_id_type>(target_index), cost});
+        });
+    }
+    std::sort(bucket_entries.begin(), bucket_entries.end(), [](const BucketEntry& a, const BucketEntry& b) {
+        return a.vertex_id < b.vertex_id;
+    });
+    for (size_t i = 0; i < bucket_entries.size(); ++i) {
+        Bucket& bucket = buckets[bucket_entries[i].vertex_id];
+        if (bucket.end == 0) {
+            bucket.begin = i;
+        }
+        bucket.end = i + 1;
+    }
+
+    for (size_t source_index = 0; source_index < sources.size(); ++source_index) {
+        float* source_distances = distances_.data() + source_index * targets.size();
+        Search(sources[source_index], true, [&](unsigned_id_type vertex_id, float cost) {
+            if (!buckets.Contains(vertex_id)) {
+                return;
+            }
+            const Bucket& bucket = buckets[vertex_id];
+            for (size_t i = bucket.begin; i < bucket.end; ++i) {
+                const BucketEntry& entry = bucket_entries[i];
+                float& distance = source_distances[entry.target_index];
+                distance = std::min(distance, cost + entry.cost);
+            }
+        });
+    }
+}
+
+template <typename G, typename EL, typename Q>
+void ManyToManyContractionHierarchies<G, EL, Q>::Search(unsigned_id_type start_node, bool forward, const std::function<void(unsigned_id_type, float)>& settle) {
+    auto&& costs = workspace_.costs;
+    auto&& queue = workspace_.queue;
+    costs.Clear();
+    queue.Clear();
+    costs[start_node].cost = 0;
+    queue.Push(start_node, 0);
+    while (!queue.Empty()) {
+        utility::QueueMember member = queue.Pop();
+        Vertex& vertex = g_.GetVertex(member.vertex_id);
+        ++settled_vertex_count_;
+        utility::Deadline::Check(deadline_, settled_vertex_count_);
+        if (IsStalled(vertex, member.cost, forward)) {
+            continue;
+        }
+        settle(member.vertex_id, member.cost);
+        auto&& relax = [&](Edge& edge) {
+            unsigned_id_type neighbour_id = edge.get_to();
+            float new_cost = member.cost + length_(edge);
+            VertexCost& neighbour_cost = costs[neighbour_id];
+            if (new_cost < neighbour_cost.cost) {
+                neighbour_cost.cost = new_cost;
+                queue.Push(neighbour_id, new_cost);
+            }
+        };
+        if (forward) {
+            vertex.ForEachEdge(relax);
+        } else {
+            vertex.ForEachBackwardEdge(relax);
+        }
+    }
+}
+
+template <typename G, typename EL, typename Q>
+bool ManyToManyContractionHierarchies<G, EL, Q>::IsStalled(Vertex& vertex, float cost, bool forward) {
+    auto&& costs = workspace_.costs;
+    bool stalled = false;
+    // Edges of the search graph lead to higher vertices so edges of the opposite direction lead from them.
+    auto&& check = [&](Edge& edge) {
+        float neighbour_cost = costs.Get(edge.get_to(), VertexCost{}).cost;
+        if (!stalled && neighbour_cost != std::numeric_limits<float>::max() && neighbour_cost + length_(edge) < cost) {
+            stalled = true;
+        }
+    };
+    if (forward) {
+        vertex.ForEachBackwardEdge(check);
+    } else {
+        vertex.ForEachEdge(check);
+    }
+    return stalled;
+}
+
+/**
+ * ManyToManyDijkstra computes lengths of the shortest routes from all sources to all targets
+ * by running Dijkstra's algorithm from each source until all targets are settled.
+ * It is used for graphs that are not preprocessed.
+ */
+template <typename G, typename EL = EdgeLength, typename Q = utility::IndexedDaryHeap<>>
+class ManyToManyDijkstra {
+public:
+    using Vertex = typename G::Vertex;
+    using Edge = typename G::Edge;
+    using EdgeLength = EL;
+    using PriorityQueue = Q;
+    using Graph = G;
+    using Workspace = typename Dijkstra<G, EL, Q>::Workspace;
+
+    ManyToManyDijkstra(G& g, const EL& length = EL{}, Workspace* workspace = nullptr)
+        : dijkstra_(g, length, workspace), distances_(), settled_vertex_count_(0) {}
+
+    /**
+     * Find lengths of the shortest routes from each source to each target.
+     */
+    void Run(const std::vector<unsigned_id_type>& sources, const std::vector<unsigned_id_type>& targets);
+
+    /**
+     * Searches stop by TimeoutException when `deadline` expires. Null deadline is never checked.
+     */
+    void SetDeadline(const utility::Deadline* deadline) {
+        dijkstra_.SetDeadline(deadline);
+    }
+
+    /**
+     * Lengths of the routes of the last run in row-major order. Unreachable targets have DistanceTable::kUnreachable length.
+     */
+    const std::vector<float>& GetDistances() const {
+        return distances_;
+    }
+
+    /**
+     * Number of vertices settled by all searches of the last run.
+     */
+    size_t GetSettledVertexCount() const {
+        return settled_vertex_count_;
+    }
+
+private:
+    Dijkstra<G, EL, Q> dijkstra_;
+    std::vector<float> distances_;
+    size_t settled_vertex_count_;
+};
+
+template <typename G, typename EL, typename Q>
+void ManyToManyDijkstra<G, EL, Q>::Run(const std::vector<unsigned_id_type>& sources, const std::vector<unsigned_id_type>& targets) {
+    distances_.assign(sources.size() * targets.size(), DistanceTable::kUnreachable);
+    settled_vertex_count_ = 0;
+    std::unordered_set<unsigned_id_type> target_ids{targets.begin(), targets.end()};
+    for (size_t source_index = 0; source_index < sources.size(); ++source_index) {
+        size_t unsettled_targets = target_ids.size();
+        dijkstra_.Run(sources[source_index], [&](Vertex* vertex) {
+            return target_ids.find(vertex->get_uid()) != target_ids.end() && --unsettled_targets == 0;
+        }, [](Vertex*) { return false; });
+        settled_vertex_count_ += dijkstra_.GetSettledVertexCount();
+        for (size_t target_index = 0; target_index < targets.size(); ++target_index) {
+            distances_[source_index * targets.size() + target_index] = dijkstra_.GetPathLength(targets[target_index]);
+        }
+    }
+}
+
+}
+}
+#endif //ROUTING_QUERY_MANY_TO_MANY_H
@@ -0,0 +1,104 @@
+#ifndef ROUTING_QUERY_MODE_LOADER_H
+#define ROUTING_QUERY_MODE_LOADER_H
+
+#include "routing/query/algorithm_factory.h"
+#include "routing/query/routing_mode.h"
+#include "routing/configuration_parser.h"
+#include "routing/constants.h"
+#include "routing/database/database_helper.h"
+#include "routing/profile/profile.h"
+#include "routing/table_names.h"
+#include "routing/exception.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace routing {
+namespace query {
+
+/**
+ * Mode loaders create a routing mode of one algorithm from the configuration. They are used
+ * by all tools that route so that each of them loads graphs and indices the same way.
+ * Each loader defines `Setup` - the AlgorithmFactory, `Mode` and static `Load`.
+ */
+struct DijkstraModeLoader {
+    using Setup = DijkstraFactory;
+    using Mode = DynamicProfileMode<DijkstraFactory>;
+
+    static std::shared_ptr<Mode> Load(Configuration& cfg, database::DatabaseHelper& d) {
+        cfg.profile_preferences.LoadIndices(d);
+        auto&& gen = cfg.profile_preferences.GetProfileGenerator();
+        profile::Profile profile = gen.GetFrontProfile();
+        return std::make_shared<Mode>(d, std::make_unique<DijkstraTableNames>(cfg.algorithm->base_graph_table), std::move(profile));
+    }
+};
+
+struct CHStaticModeLoader {
+    using Setup = CHStaticFactory;
+    using Mode = StaticProfileMode<CHStaticFactory>;
+
+    static std::shared_ptr<Mode> Load(Configuration& cfg, database::DatabaseHelper& d) {
+        auto&& gen = cfg.profile_preferences.GetProfileGenerator();
+        auto&& mode = std::make_shared<Mode>(cfg.algorithm->snapshot_directory);
+        cfg.profile_preferences.base_index->Load(d, cfg.profile_preferences.base_index_table);
+        for(auto&& profile : gen.Generate()) {
+            mode->AddRouter(d, std::make_unique<CHTableNames>(cfg.algorithm->base_graph_table, profile), profile);
+        }
+        return mode;
+    }
+};
+
+struct CHDynamicModeLoader {
+    using Setup = CHDynamicFactory;
+    using Mode = DynamicProfileMode<CHDynamicFactory>;
+
+    static std::shared_ptr<Mode> Load(Configuration& cfg, database::DatabaseHelper& d) {
+        auto&& gen = cfg.profile_preferences.GetProfileGenerator();
+        profile::Profile profile = gen.GetFrontProfile();
+        std::unique_ptr<TableNames> table_names = std::make_unique<CHTableNames>(cfg.algorithm->base_graph_table, profile);
+        cfg.profile_preferences.LoadIndices(d, table_names->GetIndexTablePrefix());
+        return std::make_shared<Mode>(d, std::move(table_names), std::move(profile));
+    }
+};
+
+struct CCHModeLoader {
+    using Setup = CCHFactory;
+    using Mode = CustomizableProfileMode<CCHFactory>;
+
+    static std::shared_ptr<Mode> Load(Configuration& cfg, database::DatabaseHelper& d) {
+        cfg.profile_preferences.LoadIndices(d);
+        auto&& gen = cfg.profile_preferences.GetProfileGenerator();
+        profile::Profile profile = gen.GetFrontProfile();
+        CCHConfig* cch_config = static_cast<CCHConfig*>(cfg.algorithm.get());
+        return std::make_shared<Mode>(d, std::make_unique<CCHTableNames>(cfg.algorithm->base_graph_table), std::move(profile),
+            cch_config->threads, cch_config->cached_profiles);
+    }
+};
+
+/**
+ * Call `visitor` with the mode loader of the configured algorithm and mode, e.g. `visitor(CCHModeLoader{})`.
+ * The visitor is usually a generic lambda so that it is instantiated for each loader.
+ *
+ * @throw InvalidArgumentException if the algorithm does not support the mode.
+ */
+template <typename Visitor>
+void VisitModeLoader(const AlgorithmConfig& algorithm, Visitor&& visitor) {
+    const std::string& name = algorithm.name;
+    const std::string& mode = algorithm.mode;
+    if (name == Constants::AlgorithmNames::kDijkstra && mode == Constants::ModeNames::kDynamicProfile) {
+        visitor(DijkstraModeLoader{});
+    } else if (name == Constants::AlgorithmNames::kContractionHierarchies && mode == Constants::ModeNames::kStaticProfile) {
+        visitor(CHStaticModeLoader{});
+    } else if (name == Constants::AlgorithmNames::kContractionHierarchies && mode == Constants::ModeNames::kDynamicProfile) {
+        visitor(CHDynamicModeLoader{});
+    } else if (name == Constants::AlgorithmNames::kCustomizableContractionHierarchies && mode == Constants::ModeNames::kDynamicProfile) {
+        visitor(CCHModeLoader{});
+    } else {
+        throw InvalidArgumentException{"No such mode= " + mode + " with given algorithm " + name + " was found"};
+    }
+}
+
+}
+}
+#endif //ROUTING_QUERY_MODE_LOADER_H
@@ -0,0 +1,376 @@
+#ifndef ROUTING_QUERY_ONE_TO_ALL_H
+#define ROUTING_QUERY_ONE_TO_ALL_H
+
+#include "routing/edges/basic_edge.h"
+#include "routing/edges/length_source.h"
+#include "routing/utility/priority_queue.h"
+#include "routing/utility/epoch_vector.h"
+#include "routing/utility/deadline.h"
+#include "routing/types.h"
+
+#include <vector>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <numeric>
+
+namespace routing {
+namespace query {
+
+/**
+ * Phast computes costs from sources to all vertices of a Contraction Hierarchies search graph
+ * (PHAST - PHAst Shortest-path Trees).
+ *
+ * Each source runs a forward search that only goes up in the hierarchy. Then all vertices are swept
+ * from the highest ordering rank to the lowest one and each vertex takes the minimum over its downward
+ * edges from higher vertices whose costs are already final. The sweep visits vertices in a fixed order and
+ * writes costs sequentially so it is much faster than Dijkstra over the whole graph.
+ *
+ * Costs of all sources of one run are stored next to each other for each vertex. The sweep reads
+ * each edge once for all sources and the loop over sources is vectorized by the compiler.
+ *
+ * @tparam G Search graph with vertex ids from 0 to GetVertexCount() - 1, e.g. CHSearchGraph.
+ * @tparam EL Provides lengths of edges.
+ */
+template <typename G, typename EL = EdgeLength, typename Q = utility::IndexedDaryHeap<>>
+class Phast {
+public:
+    using Vertex = typename G::Vertex;
+    using Edge = typename G::Edge;
+    using EdgeLength = EL;
+    using PriorityQueue = Q;
+    using Graph = G;
+    struct Workspace;
+
+    /**
+     * @param workspace Memory for the searches that is reused by consecutive runs. It must be used only with one graph
+     *      since it keeps the order of the graph vertices. The algorithm creates its own workspace if none is given.
+     */
+    Phast(G& g, const EL& length = EL{}, Workspace* workspace = nullptr);
+
+    /**
+     * Compute costs from sources which are vertices of the graph.
+     *
+     * @param max_cost Costs greater than `max_cost` are not needed - such vertices are unreachable.
+     */
+    void Run(const std::vector<unsigned_id_type>& sources, float max_cost = std::numeric_limits<float>::max());
+
+    /**
+     * Compute costs from sources which are not in the graph, e.g. points on edges. Each source is given by
+     * its edges to vertices of the graph.
+     *
+     * @param max_cost Costs greater than `max_cost` are not needed - such vertices are unreachable.
+     */
+    void Run(const std::vector<std::vector<Edge>>& source_edges, float max_cost = std::numeric_limits<float>::max());
+
+    /**
+     * Searches and the sweep stop by TimeoutException when `deadline` expires. Null deadline is never checked.
+     */
+    void SetDeadline(const utility::Deadline* deadline) {
+        deadline_ = deadline;
+    }
+
+    /**
+     * Cost of the shortest route from the source to the vertex or `kUnreachable` if it is greater than the maximum cost.
+     */
+    float GetCost(size_t source_index, unsigned_id_type vertex_id) const;
+
+    static constexpr float kUnreachable = std::numeric_limits<float>::max();
+
+private:
+    using Seeds = std::vector<std::pair<unsigned_id_type, float>>;
+
+public:
+    /**
+     * Workspace holds the order of vertices in the sweep, costs of all sources and the priority queue of upward searches.
+     */
+    struct Workspace {
+        /**
+         * Vertex ids ordered from the highest ordering rank.
+         */
+        std::vector<unsigned_id_type> sweep_order;
+
+        /**
+         * Index of each vertex in `sweep_order`.
+         */
+        std::vector<unsigned_id_type> positions;
+
+        /**
+         * Costs of vertex at position p are [p * source_count, (p + 1) * source_count).
+         */
+        std::vector<float> costs;
+        Q queue;
+    };
+
+private:
+    G& g_;
+    EL length_;
+    std::unique_ptr<Workspace> own_workspace_;
+    Workspace& workspace_;
+    size_t source_count_;
+    float max_cost_;
+    const utility::Deadline* deadline_;
+
+    void PrepareSweepOrder();
+
+    void Run(const std::vector<Seeds>& seeds, float max_cost);
+
+    /**
+     * Search upward from the seeds and store costs of the source in its lane of the costs.
+     */
+    void SearchUpward(size_t source_index, const Seeds& seeds);
+
+    void Sweep();
+};
+
+template <typename G, typename EL, typename Q>
+Phast<G, EL, Q>::Phast(G& g, const EL& length, Workspace* workspace)
+    : g_(g), length_(length), own_workspace_(workspace ? nullptr : std::make_unique<Workspace>()), workspace_(workspace ? *workspace : *own_workspace_),
+        source_count_(0), max_cost_(kUnreachable), deadline_(nullptr) {}
+
+template <typename G, typename EL, typename Q>
+void Phast<G, EL, Q>::Run(const std::vector<unsigned_id_type>& sources, float max_cost) {
+    std::vector<Seeds> seeds{};
+    for (auto&& source : sources) {
+        seeds.push_back(Seeds{std::make_pair(source, 0.0f)});
+    }
+    Run(seeds, max_cost);
+}
+
+template <typename G, typename EL, typename Q>
+void Phast<G, EL, Q>::Run(const std::vector<std::vector<Edge>>& source_edges, float max_cost) {
+    std::vector<Seeds> seeds{};
+    for (auto&& edges : source_edges) {
+        Seeds source_seeds{};
+        for (auto&& edge : edges) {
+            source_seeds.emplace_back(edge.get_to(), length_(edge));
+        }
+        seeds.push_back(std::move(source_seeds));
+    }
+    Run(seeds, max_cost);
+}
+
+template <typename G, typename EL, typename Q>
+float Phast<G, EL, Q>::GetCost(size_t source_index, unsigned_id_type vertex_id) const {
+    if (vertex_id >= workspace_.positions.size()) {
+        return kUnreachable;
+    }
+    float cost = workspace_.costs[workspace_.positions[vertex_id] * source_count_ + source_index];
+    return cost <= max_cost_ ? cost : kUnreachable;
+}
+
+template <typename G, typename EL, typename Q>
+void Phast<G, EL, Q>::Run(const std::vector<Seeds>& seeds, float max_cost) {
+    PrepareSweepOrder();
+    source_count_ = seeds.size();
+    max_cost_ = max_cost;
+    workspace_.costs.assign(workspace_.sweep_order.size() * source_count_, kUnreachable);
+    for (size_t source_index = 0; source_index < seeds.size(); ++source_index) {
+        SearchUpward(source_index, seeds[source_index]);
+    }
+    Sweep();
+}
+
+template <typename G, typename EL, typename Q>
+void Phast<G, EL, Q>::PrepareSweepOrder() {
+    auto&& order = workspace_.sweep_order;
+    if (order.size() == g_.GetVertexCount()) {
+        return;
+    }
+    order.resize(g_.GetVertexCount());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](unsigned_id_type a, unsigned_id_type b) {
+        return g_.GetVertex(a).get_ordering_rank() > g_.GetVertex(b).get_ordering_rank();
+    });
+    workspace_.positions.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        workspace_.positions[order[i]] = static_cast<unsigned_id_type>(i);
+    }
+}
+
+template <typename G, typename EL, typename Q>
+void Phast<G, EL, Q>::SearchUpward(size_t source_index, const Seeds& seeds) {
+    auto&& queue = workspace_.queue;
+    auto&& positions = workspace_.positions;
+    float* costs = workspace_.costs.data();
+    queue.Clear();
+    for (auto&& [vertex_id, cost] : seeds) {
+        float& vertex_cost = costs[positions[vertex_id] * source_count_ + source_index];
+        if (cost < vertex_cost) {
+            vertex_cost = cost;
+            queue.Push(vertex_id, cost);
+        }
+    }
+    size_t settled_vertex_count = 0;
+    while (!queue.Empty()) {
+        utility::QueueMember member = queue.Pop();
+        // Routes through a vertex are at least as long as its upward cost.
+        if (member.cost > max_cost_) {
+            break;
+        }
+        utility::Deadline::Check(deadline_, ++settled_vertex_count);
+        g_.GetVertex(member.vertex_id).ForEachEdge([&](Edge& edge) {
+            unsigned_id_type neighbour_id = edge.get_to();
+            float new_cost = member.cost + length_(edge);
+            float& neighbour_cost = costs[positions[neighbour_id] * source_count_ + source_index];
+            if (new_cost < neighbour_cost) {
+                neighbour_cost = new_cost;
+                queue.Push(neighbour_id, new_cost);
+            }
+        });
+    }
+}
+
+template <typename G, typename EL, typename Q>
+void Phast<G, EL, Q>::Sweep() {
+    auto&& order = workspace_.sweep_order;
+    auto&& positions = workspace_.positions;
+    float* costs = workspace_.costs.data();
+    size_t source_count = source_count_;
+    for (size_t position = 0; position < order.size(); ++position) {
+        utility::Deadline::Check(deadline_, position + 1);
+        float* vertex_costs = costs + position * source_count;
+        // Backward edges of a vertex lead from higher vertices - they are already swept.
+        g_.GetVertex(order[position]).ForEachBackwardEdge([&](Edge& edge) {
+            const float* neighbour_costs = costs + static_cast<size_t>(positions[edge.get_to()]) * source_count;
+            float length = length_(edge);
+            for (size_t i = 0; i < source_count; ++i) {
+                vertex_costs[i] = std::min(vertex_costs[i], neighbour_costs[i] + length);
+            }
+        });
+    }
+}
+
+/**
+ * OneToAllDijkstra computes costs from sources to all vertices within a maximum cost by Dijkstra's algorithm.
+ * It is used for graphs that are not preprocessed and has the same interface as Phast.
+ */
+template <typename G, typename EL = EdgeLength, typename Q = utility::IndexedDaryHeap<>>
+class OneToAllDijkstra {
+public:
+    using Vertex = typename G::Vertex;
+    using Edge = typename G::Edge;
+    using EdgeLength = EL;
+    using PriorityQueue = Q;
+    using Graph = G;
+    struct Workspace;
+
+    OneToAllDijkstra(G& g, const EL& length = EL{}, Workspace* workspace = nullptr)
+        : g_(g), length_(length), own_workspace_(workspace ? nullptr : std::make_unique<Workspace>()), workspace_(workspace ? *workspace : *own_workspace_),
+            source_count_(0), max_cost_(kUnreachable), deadline_(nullptr) {}
+
+    void Run(const std::vector<unsigned_id_type>& sources, float max_cost = std::numeric_limits<float>::max());
+
+    void Run(const std::vector<std::vector<Edge>>& source_edges, float max_cost = std::numeric_limits<float>::max());
+
+    /**
+     * Searches stop by TimeoutException when `deadline` expires. Null deadline is never checked.
+     */
+    void SetDeadline(const utility::Deadline* deadline) {
+        deadline_ = deadline;
+    }
+
+    /**
+     * Cost of the shortest route from the source to the vertex or `kUnreachable` if it is greater than the maximum cost.
+     */
+    float GetCost(size_t source_index, unsigned_id_type vertex_id) const {
+        float cost = workspace_.costs[source_index].Get(vertex_id, VertexCost{}).cost;
+        return cost <= max_cost_ ? cost : kUnreachable;
+    }
+
+    static constexpr float kUnreachable = std::numeric_limits<float>::max();
+
+private:
+    using Seeds = std::vector<std::pair<unsigned_id_type, float>>;
+
+    struct VertexCost {
+        float cost;
+
+        VertexCost() : cost(std::numeric_limits<float>::max()) {}
+    };
+
+public:
+    /**
+     * Workspace holds costs of each source and the priority queue.
+     */
+    struct Workspace {
+        std::vector<utility::EpochVector<VertexCost>> costs;
+        Q queue;
+    };
+
+private:
+    G& g_;
+    EL length_;
+    std::unique_ptr<Workspace> own_workspace_;
+    Workspace& workspace_;
+    size_t source_count_;
+    float max_cost_;
+    const utility::Deadline* deadline_;
+
+    void Run(const std::vector<Seeds>& seeds, float max_cost);
+};
+
+template <typename G, typename EL, typename Q>
+void OneToAllDijkstra<G, EL, Q>::Run(const std::vector<unsigned_id_type>& sources, float max_cost) {
+    std::vector<Seeds> seeds{};
+    for (auto&& source : sources) {
+        seeds.push_back(Seeds{std::make_pair(source, 0.0f)});
+    }
+    Run(seeds, max_cost);
+}
+
+template <typename G, typename EL, typename Q>
+void OneToAllDijkstra<G, EL, Q>::Run(const std::vector<std::vector<Edge>>& source_edges, float max_cost) {
+    std::vector<Seeds> seeds{};
+    for (auto&& edges : source_edges) {
+        Seeds source_seeds{};
+        for (auto&& edge : edges) {
+            source_seeds.emplace_back(edge.get_to(), length_(edge));
+        }
+        seeds.push_back(std::move(source_seeds));
+    }
+    Run(seeds, max_cost);
+}
+
+template <typename G, typename EL, typename Q>
+void OneToAllDijkstra<G, EL, Q>::Run(const std::vector<Seeds>& seeds, float max_cost) {
+    source_count_ = seeds.size();
+    max_cost_ = max_cost;
+    if (workspace_.costs.size() < source_count_) {
+        workspace_.costs.resize(source_count_);
+    }
+    auto&& queue = workspace_.queue;
+    size_t settled_vertex_count = 0;
+    for (size_t source_index = 0; source_index < seeds.size(); ++source_index) {
+        auto&& costs = workspace_.costs[source_index];
+        costs.Clear();
+        queue.Clear();
+        for (auto&& [vertex_id, cost] : seeds[source_index]) {
+            if (cost < costs[vertex_id].cost) {
+                costs[vertex_id].cost = cost;
+                queue.Push(vertex_id, cost);
+            }
+        }
+        while (!queue.Empty()) {
+            utility::QueueMember member = queue.Pop();
+            if (member.cost > max_cost_) {
+                break;
+            }
+            utility::Deadline::Check(deadline_, ++settled_vertex_count);
+            g_.GetVertex(member.vertex_id).ForEachEdge([&](Edge& edge) {
+                unsigned_id_type neighbour_id = edge.get_to();
+                float new_cost = member.cost + length_(edge);
+                VertexCost& neighbour_cost = costs[neighbour_id];
+                if (new_cost < neighbour_cost.cost) {
+                    neighbour_cost.cost = new_cost;
+                    queue.Push(neighbour_id, new_cost);
+                }
+            });
+        }
+    }
+}
+
+}
+}
+#endif //ROUTING_QUERY_ONE_TO_ALL_H
@@ -3,35 +3,83 @@
 
 #include "routing/edges/basic_edge.h"
 #include "routing/types.h"
+#include "routing/query/geometry_options.h"
+#include "routing/spatial/polyline.h"
 
 #include "routing/profile/preference_index.h"
 
 #include <vector>
 #include <string>
+#include <iterator>
+#include <optional>
+#include <cassert>
+#include <cstddef>
 
 namespace routing{
 namespace query{
 
 /**
- * 
+ * Route is the result of a routing request - edges of the found route and its geometry.
+ * Route through waypoints consists of more legs - each leg is a route between two consecutive waypoints.
  */
 template <typename Edge>
 class Route {
 public:
 
-    Route(std::vector<Edge>&& e, std::string&& g);
+    /**
+     * @param el Summed length of the first and the last edge of the route. These edges are temporary endpoint
+     *      edges which can be used only during the routing request.
+     * @param gf Format of the geometry `g`.
+     */
+    Route(std::vector<Edge>&& e, std::string&& g, float el, GeometryFormat gf = GeometryFormat::kGeoJson);
 
     const std::string& get_geometry() const;
 
+    GeometryFormat get_geometry_format() const {
+        return geometry_format_;
+    }
+
     float GetLength(profile::PreferenceIndex* index) const;
 
+    size_t GetLegCount() const {
+        return leg_ends_.size();
+    }
+
+    /**
+     * Memory used by the route in bytes.
+     */
+    size_t GetMemoryUsage() const {
+        return sizeof(Route) + edges_.capacity() * sizeof(Edge) + geometry_.capacity() + leg_ends_.capacity() * sizeof(size_t);
+    }
+
+    /**
+     * Add legs of `route` after legs of this route. The route has to start where this route ends
+     * and its geometry has to be in the same format.
+     */
+    void Append(Route&& route);
+
 private:
     std::vector<Edge> edges_;
     std::string geometry_;
+    float endpoint_edges_length_;
+    GeometryFormat geometry_format_;
+
+    /**
+     * Index of the edge after the last edge of each leg. The first and the last edge of each leg are endpoint edges.
+     */
+    std::vector<size_t> leg_ends_;
+
+    /**
+     * Last point of polyline geometry. It is decoded once and then kept by `Append` so that appending legs
+     * does not decode the joined geometry again.
+     */
+    std::optional<spatial::PolylinePoint> polyline_end_;
 };
 
 template <typename Edge>
-Route<Edge>::Route(std::vector<Edge>&& e, std::string&& g) : edges_(std::move(e)), geometry_(std::move(g)) {}
+Route<Edge>::Route(std::vector<Edge>&& e, std::string&& g, float el, GeometryFormat gf)
+    : edges_(std::move(e)), geometry_(std::move(g)), endpoint_edges_length_(el), geometry_format_(gf), leg_ends_({edges_.size()}),
+    polyline_end_() {}
 
 template <typename Edge>
 const std::string& Route<Edge>::get_geometry() const {
@@ -41,22 +89,44 @@ const std::string& Route<Edge>::get_geometry() const {
 
 template <typename Edge>
 float Route<Edge>::GetLength(profile::PreferenceIndex* index) const {
-    assert(edges_.size() >= 2);
-
-    auto it = edges_.begin();
-    float length = it->get_length();
-    ++it;
-
-    auto end_it = edges_.end();
-    --end_it;
-    length += end_it->get_length();
-
-    for(; it != end_it; ++it) {
-        length += index->GetOriginal(it->get_uid());
+    float length = endpoint_edges_length_;
+    size_t leg_begin = 0;
+    for (auto&& leg_end : leg_ends_) {
+        assert(leg_end - leg_begin >= 2);
+        // Endpoint edges are skipped - their lengths are in `endpoint_edges_length_`.
+        for (size_t i = leg_begin + 1; i + 1 < leg_end; ++i) {
+            length += index->GetOriginal(edges_[i].get_uid());
+        }
+        leg_begin = leg_end;
     }
     return length;
 }
 
+template <typename Edge>
+void Route<Edge>::Append(Route&& route) {
+    size_t offset = edges_.size();
+    edges_.insert(edges_.end(), std::make_move_iterator(route.edges_.begin()), std::make_move_iterator(route.edges_.end()));
+    for (auto&& leg_end : route.leg_ends_) {
+        leg_ends_.push_back(offset + leg_end);
+    }
+    endpoint_edges_length_ += route.endpoint_edges_length_;
+    if (geometry_format_ == GeometryFormat::kPolyline) {
+        if (!polyline_end_) {
+            polyline_end_ = spatial::DecodePolylineEnd(geometry_);
+        }
+        if (!route.geometry_.empty()) {
+            spatial::PolylinePoint next_end = route.polyline_end_ ? *route.polyline_end_ : spatial::DecodePolylineEnd(route.geometry_);
+            spatial::AppendPolyline(geometry_, *polyline_end_, route.geometry_);
+            polyline_end_ = next_end;
+        }
+        return;
+    }
+    // Both geometries are GeoJSON arrays of edge geometries so they are merged to one array.
+    geometry_.pop_back();
+    geometry_ += ",";
+    geometry_.append(route.geometry_, 1, std::string::npos);
+}
+
 
 }
 }
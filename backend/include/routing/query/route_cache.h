@@ -0,0 +1,63 @@
+#ifndef ROUTING_QUERY_ROUTE_CACHE_H
+#define ROUTING_QUERY_ROUTE_CACHE_H
+
+#include "routing/query/route.h"
+#include "routing/query/geometry_options.h"
+#include "routing/spatial/segment_index.h"
+#include "routing/utility/lru_cache.h"
+#include "routing/types.h"
+
+#include <string>
+#include <functional>
+#include <cstddef>
+
+namespace routing{
+namespace query{
+
+/**
+ * RouteCacheKey identifies a route by its profile, snapped endpoints and format of its geometry. Points that are snapped
+ * to the same place of the same edge have the same route so the key does not contain coordinates.
+ */
+struct RouteCacheKey {
+    std::string profile;
+    unsigned_id_type source_edge;
+    float source_offset;
+    unsigned_id_type target_edge;
+    float target_offset;
+    GeometryOptions geometry;
+
+    RouteCacheKey(const std::string& p, const spatial::EdgeSplit& source, const spatial::EdgeSplit& target, const GeometryOptions& g)
+        : profile(p), source_edge(source.uid), source_offset(source.from_segment_relative_length),
+            target_edge(target.uid), target_offset(target.from_segment_relative_length), geometry(g) {}
+
+    bool operator==(const RouteCacheKey& other) const {
+        return source_edge == other.source_edge && target_edge == other.target_edge && source_offset == other.source_offset
+            && target_offset == other.target_offset && geometry == other.geometry && profile == other.profile;
+    }
+};
+
+struct RouteCacheKeyHash {
+    size_t operator()(const RouteCacheKey& key) const {
+        size_t hash = std::hash<std::string>{}(key.profile);
+        auto&& combine = [&](size_t value) {
+            hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        };
+        combine(std::hash<unsigned_id_type>{}(key.source_edge));
+        combine(std::hash<float>{}(key.source_offset));
+        combine(std::hash<unsigned_id_type>{}(key.target_edge));
+        combine(std::hash<float>{}(key.target_offset));
+        combine(std::hash<int>{}(static_cast<int>(key.geometry.format) * 32 + key.geometry.precision));
+        combine(std::hash<double>{}(key.geometry.tolerance));
+        return hash;
+    }
+};
+
+/**
+ * Finished routes - their edges, geometries and lengths of endpoint edges.
+ */
+template <typename Edge>
+using RouteCache = utility::ShardedLruCache<RouteCacheKey, Route<Edge>, RouteCacheKeyHash>;
+
+}
+}
+#endif // ROUTING_QUERY_ROUTE_CACHE_H
@@ -39,9 +39,12 @@ public:
             return touched_vertices_[vertex.get_uid()].previous;
         }
 
-        virtual Edge& FindEdge(Vertex& vertex, unsigned_id_type target_vertex_id) = 0;
+        /**
+         * Edges are returned by value since edges of compact graphs exist only while they are iterated.
+         */
+        virtual Edge FindEdge(Vertex& vertex, unsigned_id_type target_vertex_id) = 0;
 
-        virtual Edge& FindBackwardEdge(Vertex& vertex, unsigned_id_type target_vertex_id) = 0;
+        virtual Edge FindBackwardEdge(Vertex& vertex, unsigned_id_type target_vertex_id) = 0;
 
         virtual void AddEdge(std::vector<Edge>& route, Edge&& edge) = 0;
     protected:
@@ -54,13 +57,13 @@ public:
     public:
         BiDijkstraForwardGraphInfo(RouteRetriever& retriever, VertexRoutingProperties& tv) : GraphInfo(retriever, tv) {}
 
-        Edge& FindEdge(Vertex& vertex, unsigned_id_type target_vertex_id) override {
+        Edge FindEdge(Vertex& vertex, unsigned_id_type target_vertex_id) override {
             return vertex.FindEdge([=](const Edge& e) {
                 return e.get_to() == target_vertex_id;
             });
         }
 
-        Edge& FindBackwardEdge(Vertex& vertex, unsigned_id_type target_vertex_id) override {
+        Edge FindBackwardEdge(Vertex& vertex, unsigned_id_type target_vertex_id) override {
             return vertex.FindBackwardEdge([=](const Edge& e) {
                 return e.get_to() == target_vertex_id;
             });
@@ -81,13 +84,13 @@ public:
     public:
         BiDijkstraBackwardGraphInfo(RouteRetriever& retriever, VertexRoutingProperties& tv) : GraphInfo(retriever, tv) {}
 
-        Edge& FindEdge(Vertex& vertex, unsigned_id_type target_vertex_id) override {
+        Edge FindEdge(Vertex& vertex, unsigned_id_type target_vertex_id) override {
             return vertex.FindBackwardEdge([=](const Edge& e) {
                 return e.get_to() == target_vertex_id;
             });
         }
 
-        Edge& FindBackwardEdge(Vertex& vertex, unsigned_id_type target_vertex_id) override {
+        Edge FindBackwardEdge(Vertex& vertex, unsigned_id_type target_vertex_id) override {
             return vertex.FindEdge([=](const Edge& e) {
                 return e.get_to() == target_vertex_id;
             });
@@ -108,13 +111,13 @@ public:
     public:
         DijkstraGraphInfo(RouteRetriever& retriever, VertexRoutingProperties& tv) : GraphInfo(retriever, tv) {}
 
-        Edge& FindEdge(Vertex& vertex, unsigned_id_type target_vertex_id) override {
+        Edge FindEdge(Vertex& vertex, unsigned_id_type target_vertex_id) override {
             return vertex.FindEdge([=](const Edge& e) {
                 return e.get_to() == target_vertex_id;
             });
         }
 
-        Edge& FindBackwardEdge(Vertex& vertex, unsigned_id_type target_vertex_id) override {
+        Edge FindBackwardEdge(Vertex& vertex, unsigned_id_type target_vertex_id) override {
             throw NotImplementedException{"DijkstraGraphInfo FindBackwardEdge not implemented - no other reverse edges!"};
         }
 
@@ -131,7 +134,7 @@ private:
 
     std::vector<Edge> UnpackShortcut(GraphInfo* graph_info, Edge&& shortcut);
 
-    Edge& GetUnderlyingEdge(GraphInfo* graph_info, unsigned_id_type source_vertex_id, unsigned_id_type target_vertex_id, bool normal_edge);
+    Edge GetUnderlyingEdge(GraphInfo* graph_info, unsigned_id_type source_vertex_id, unsigned_id_type target_vertex_id, bool normal_edge);
 
     unsigned_id_type GetPreviousDefaultValue() const;
 };
@@ -202,7 +205,7 @@ std::vector<typename RouteRetriever<Graph, VertexRoutingProperties>::Edge> Route
 }
 
 template <typename Graph, typename VertexRoutingProperties>
-inline typename RouteRetriever<Graph, VertexRoutingProperties>::Edge& RouteRetriever<Graph, VertexRoutingProperties>::GetUnderlyingEdge(
+inline typename RouteRetriever<Graph, VertexRoutingProperties>::Edge RouteRetriever<Graph, VertexRoutingProperties>::GetUnderlyingEdge(
     GraphInfo* graph_info, unsigned_id_type source_vertex_id, unsigned_id_type target_vertex_id, bool normal_edge) {
     if (normal_edge) {
         return graph_info->FindEdge(g_.GetVertex(source_vertex_id), target_vertex_id);
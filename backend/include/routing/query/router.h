@@ -20,6 +20,18 @@
 #include "routing/query/endpoint_edges_creator.h"
 #include "routing/query/endpoints_creator.h"
 #include "routing/query/route.h"
+#include "routing/query/route_cache.h"
+#include "routing/query/router_metrics.h"
+#include "routing/query/distance_table.h"
+#include "routing/query/alternative_route_parameters.h"
+#include "routing/query/geometry_options.h"
+#include "routing/spatial/segment_index.h"
+#include "routing/spatial/polyline.h"
+#include "routing/profile/profile.h"
+#include "routing/utility/object_pool.h"
+#include "routing/utility/thread_pool.h"
+#include "routing/utility/metrics.h"
+#include "routing/utility/deadline.h"
 #include "routing/types.h"
 
 #include "routing/database/db_graph.h"
@@ -30,6 +42,8 @@
 #include <utility>
 #include <vector>
 #include <chrono>
+#include <map>
+#include <optional>
 
 namespace routing {
 namespace query {
@@ -45,15 +59,33 @@ template <typename AlgorithmFactory>
 class Router {
     using EC = EndpointsCreator<
                 typename AlgorithmFactory::EndpointAlgorithmPolicy,
-                EndpointEdgesCreator<typename AlgorithmFactory::EndpointEdgeFactory, typename AlgorithmFactory::Graph>
+                EndpointEdgesCreator<typename AlgorithmFactory::EndpointEdgeFactory, typename AlgorithmFactory::Graph, typename AlgorithmFactory::EdgeLength>
             >;
+    using WorkspacePool = utility::ObjectPool<typename AlgorithmFactory::Algorithm::Workspace>;
+    using IsochroneWorkspacePool = utility::ObjectPool<typename AlgorithmFactory::IsochroneAlgorithm::Workspace>;
 public:
-    Router() : alg_factory_(), base_graph_(), table_names_(), base_graph_max_vertex_id_(), base_graph_max_edge_id_() {}
+    using RouteCache = query::RouteCache<typename AlgorithmFactory::Algorithm::Edge>;
 
-    Router(const AlgorithmFactory& af, typename AlgorithmFactory::Graph&& graph, std::unique_ptr<TableNames>&& table_names) 
-        : alg_factory_(af), base_graph_(std::move(graph)), table_names_(std::move(table_names)),
+    Router() : alg_factory_(), base_graph_(), table_names_(), segment_index_(), workspaces_(std::make_unique<WorkspacePool>()),
+        isochrone_workspaces_(std::make_unique<IsochroneWorkspacePool>()), route_cache_(std::make_shared<RouteCache>(kDefaultRouteCacheCapacity)),
+        metrics_(std::make_shared<RouterMetrics>()), base_graph_max_vertex_id_(), base_graph_max_edge_id_() {}
+
+    /**
+     * @param segment_index Spatial index of base graph edges that is used to find endpoint edges. Its geometry store provides
+     *      route geometries. It can be shared among routers whose graphs are made from the same base graph.
+     */
+    Router(const AlgorithmFactory& af, typename AlgorithmFactory::Graph&& graph, std::unique_ptr<TableNames>&& table_names,
+        const std::shared_ptr<const spatial::SegmentIndex>& segment_index) 
+        : alg_factory_(af), base_graph_(std::move(graph)), table_names_(std::move(table_names)), segment_index_(segment_index),
+            workspaces_(std::make_unique<WorkspacePool>()), isochrone_workspaces_(std::make_unique<IsochroneWorkspacePool>()),
+            route_cache_(std::make_shared<RouteCache>(kDefaultRouteCacheCapacity)), metrics_(std::make_shared<RouterMetrics>()),
             base_graph_max_vertex_id_(base_graph_.GetMaxVertexId()), base_graph_max_edge_id_(base_graph_.GetMaxEdgeId()) {}
 
+    /**
+     * Memory budget of cached routes in bytes if it is not set.
+     */
+    static const size_t kDefaultRouteCacheCapacity = 64 * 1024 * 1024;
+
     Router(Router&& other)= default;
     Router(const Router& other) = delete;
     Router& operator=(Router&& other) = default;
@@ -61,51 +93,443 @@ public:
     ~Router() = default;
 
     /**
-     * Calculate the shortest path between two points speficied by lat and lon in the member graph. 
+     * Calculate the shortest path between two points speficied by lat and lon in the member graph.
+     * The router is not changed so routes can be calculated concurrently.
+     *
+     * @param profile Profile of the request. Algorithms whose edge lengths are not stored in the graph
+     *      take them from the profile.
+     * @param geometry Format of the route geometry.
+     * @param deadline The search stops by TimeoutException when it expires. Null deadline never expires.
+     */
+    Route<typename AlgorithmFactory::Algorithm::Edge> CalculateShortestRoute(utility::Point source, utility::Point target, const profile::Profile& profile,
+        const GeometryOptions& geometry = GeometryOptions{}, const utility::Deadline* deadline = nullptr);
+
+    /**
+     * Calculate the shortest route that visits `waypoints` in their order. Each waypoint is snapped once
+     * and serves as the target of one leg and the source of the next one. Legs are calculated on `pool` in parallel
+     * and joined to one route. All legs share `deadline`.
+     */
+    Route<typename AlgorithmFactory::Algorithm::Edge> CalculateWaypointRoute(const std::vector<utility::Point>& waypoints,
+        const profile::Profile& profile, utility::ThreadPool& pool, const GeometryOptions& geometry = GeometryOptions{},
+        const utility::Deadline* deadline = nullptr);
+
+    /**
+     * Calculate the shortest route and at most `max_count` alternative routes between two points in one search.
+     * Alternative routes are ordered by their length after the shortest route.
+     *
+     * @param parameters Limits of admissible alternative routes.
+     */
+    std::vector<Route<typename AlgorithmFactory::Algorithm::Edge>> CalculateAlternativeRoutes(utility::Point source, utility::Point target,
+        const profile::Profile& profile, size_t max_count, const AlternativeRouteParameters& parameters = AlternativeRouteParameters{},
+        const GeometryOptions& geometry = GeometryOptions{}, const utility::Deadline* deadline = nullptr);
+
+    /**
+     * Calculate lengths of the shortest routes from each source to each target. Each distinct coordinate
+     * is snapped to the graph once and routes are not unpacked. Routes between the same coordinates have zero length.
+     * The router is not changed so tables can be calculated concurrently.
+     *
+     * @param deadline The searches stop by TimeoutException when it expires. Null deadline never expires.
+     */
+    DistanceTable CalculateDistanceTable(const std::vector<utility::Point>& sources, const std::vector<utility::Point>& targets,
+        const profile::Profile& profile, const utility::Deadline* deadline = nullptr);
+
+    /**
+     * Find edges that are reachable from any of `sources` by a route not longer than `max_cost` - an edge is reachable
+     * if one of its vertices is.
+     *
+     * @param deadline The search stops by TimeoutException when it expires. Null deadline never expires.
+     * @return GeoJSON array of geometries of reachable edges.
+     */
+    std::string CalculateIsochrone(const std::vector<utility::Point>& sources, float max_cost, const profile::Profile& profile,
+        const utility::Deadline* deadline = nullptr);
+
+    /**
+     * Replace the route cache by an empty one with memory budget `capacity` in bytes. Zero capacity disables the cache.
+     * It must not be called concurrently with routing requests.
+     */
+    void SetRouteCacheCapacity(size_t capacity) {
+        route_cache_ = std::make_shared<RouteCache>(capacity);
+    }
+
+    /**
+     * Replace the route cache, e.g. by one shared by more routers. Keys of cached routes contain their profile
+     * so routers of different profiles can share a cache. It must not be called concurrently with routing requests.
      */
-    Route<typename AlgorithmFactory::Algorithm::Edge> CalculateShortestRoute(database::DatabaseHelper& d, utility::Point source, utility::Point target);
+    void SetRouteCache(const std::shared_ptr<RouteCache>& route_cache) {
+        route_cache_ = route_cache;
+    }
+
+    RouteCache& GetRouteCache() {
+        return *route_cache_;
+    }
+
+    /**
+     * Replace metrics of route calculations, e.g. by ones shared by more routers.
+     * It must not be called concurrently with routing requests.
+     */
+    void SetMetrics(const std::shared_ptr<RouterMetrics>& metrics) {
+        metrics_ = metrics;
+    }
+
+    RouterMetrics& GetMetrics() {
+        return *metrics_;
+    }
 
 
 private:
     AlgorithmFactory alg_factory_;
     typename AlgorithmFactory::Graph base_graph_;
     std::unique_ptr<TableNames> table_names_;
+    std::shared_ptr<const spatial::SegmentIndex> segment_index_;
+
+    /**
+     * Workspaces of the routing algorithm. Each concurrent request takes one so the number of workspaces
+     * is the maximum number of concurrent requests.
+     */
+    std::unique_ptr<WorkspacePool> workspaces_;
+
+    /**
+     * Workspaces of the isochrone algorithm. They keep the order of graph vertices so they are not shared with other routers.
+     */
+    std::unique_ptr<IsochroneWorkspacePool> isochrone_workspaces_;
+
+    /**
+     * Routes between snapped endpoints. The cache may be shared with routers of other profiles of the same base graph.
+     */
+    std::shared_ptr<RouteCache> route_cache_;
+    std::shared_ptr<RouterMetrics> metrics_;
     unsigned_id_type base_graph_max_vertex_id_;
     unsigned_id_type base_graph_max_edge_id_;
+
+    /**
+     * Used to reserve memory for route geometry.
+     */
+    static const size_t kEstimatedEdgeGeoJsonSize = 160;
     
-    std::string GetRouteGeometry(database::DatabaseHelper& d, EC& endpoints_creator,
-        const std::vector<typename AlgorithmFactory::Algorithm::Edge>& route);
+    /**
+     * Create geometry of the route in the format of `geometry`. Endpoints of the route are split `source` and `target` edges.
+     */
+    std::string GetRouteGeometry(EC& endpoints_creator, const std::vector<typename AlgorithmFactory::Algorithm::Edge>& route,
+        const spatial::EdgeSplit& source, const spatial::EdgeSplit& target, const GeometryOptions& geometry);
+
+    /**
+     * Create GeoJSON array of geometries of all route edges. Endpoint edges' geometries are in `endpoints_creator`,
+     * others are written directly from the geometry store.
+     */
+    std::string GetRouteGeoJson(EC& endpoints_creator, const std::vector<typename AlgorithmFactory::Algorithm::Edge>& route);
+
+    /**
+     * Create encoded polyline of the route simplified with tolerance of `geometry`. Edge geometries are joined
+     * to one line in the direction of the route.
+     */
+    std::string GetRoutePolyline(const std::vector<typename AlgorithmFactory::Algorithm::Edge>& route,
+        const spatial::EdgeSplit& source, const spatial::EdgeSplit& target, const GeometryOptions& geometry);
+
+    /**
+     * Calculate the shortest route between endpoints whose closest edges are split by `source` and `target`
+     * or take it from the route cache. Routes of searches stopped by `deadline` are not cached.
+     */
+    Route<typename AlgorithmFactory::Algorithm::Edge> CalculateLeg(const spatial::EdgeSplit& source, const spatial::EdgeSplit& target,
+        const profile::Profile& profile, const GeometryOptions& geometry, const utility::Deadline* deadline);
+
+    /**
+     * Create the result route of `route` edges with its geometry.
+     */
+    Route<typename AlgorithmFactory::Algorithm::Edge> CreateRoute(EC& endpoints_creator, std::vector<typename AlgorithmFactory::Algorithm::Edge>&& route,
+        const typename AlgorithmFactory::EdgeLength& length, const spatial::EdgeSplit& source, const spatial::EdgeSplit& target,
+        const GeometryOptions& geometry);
 };
 
 template <typename AlgorithmFactory>
-Route<typename AlgorithmFactory::Algorithm::Edge> Router<AlgorithmFactory>::CalculateShortestRoute(database::DatabaseHelper& d, utility::Point source, utility::Point target) {
+Route<typename AlgorithmFactory::Algorithm::Edge> Router<AlgorithmFactory>::CalculateShortestRoute(utility::Point source, utility::Point target,
+    const profile::Profile& profile, const GeometryOptions& geometry, const utility::Deadline* deadline) {
     if (source.lat_ == target.lat_ && source.lon_ == target.lon_) {
         throw RouteNotFoundException("Start and end point are the same.");
     }
-    
+    utility::Stopwatch stopwatch{};
+    auto&& source_split = segment_index_->FindClosestEdge(source);
+    auto&& target_split = segment_index_->FindClosestEdge(target);
+    metrics_->snapping.Observe(stopwatch.Lap());
+    return CalculateLeg(source_split, target_split, profile, geometry, deadline);
+}
+
+template <typename AlgorithmFactory>
+Route<typename AlgorithmFactory::Algorithm::Edge> Router<AlgorithmFactory>::CalculateWaypointRoute(const std::vector<utility::Point>& waypoints,
+    const profile::Profile& profile, utility::ThreadPool& pool, const GeometryOptions& geometry, const utility::Deadline* deadline) {
+    if (waypoints.size() < 2) {
+        throw InvalidArgumentException("Route needs at least two waypoints.");
+    }
+    for (size_t i = 0; i + 1 < waypoints.size(); ++i) {
+        if (waypoints[i].lat_ == waypoints[i + 1].lat_ && waypoints[i].lon_ == waypoints[i + 1].lon_) {
+            throw RouteNotFoundException("Waypoints " + std::to_string(i) + " and " + std::to_string(i + 1) + " are the same.");
+        }
+    }
+    utility::Stopwatch stopwatch{};
+    std::vector<spatial::EdgeSplit> splits(waypoints.size());
+    pool.ParallelFor(waypoints.size(), [&](size_t i) {
+        splits[i] = segment_index_->FindClosestEdge(waypoints[i]);
+    });
+    metrics_->snapping.Observe(stopwatch.Lap());
+    std::vector<std::optional<Route<typename AlgorithmFactory::Algorithm::Edge>>> legs(waypoints.size() - 1);
+    pool.ParallelFor(legs.size(), [&](size_t i) {
+        legs[i].emplace(CalculateLeg(splits[i], splits[i + 1], profile, geometry, deadline));
+    });
+    Route<typename AlgorithmFactory::Algorithm::Edge> route = std::move(*legs.front());
+    for (size_t i = 1; i < legs.size(); ++i) {
+        route.Append(std::move(*legs[i]));
+    }
+    return route;
+}
+
+template <typename AlgorithmFactory>
+Route<typename AlgorithmFactory::Algorithm::Edge> Router<AlgorithmFactory>::CalculateLeg(const spatial::EdgeSplit& source, const spatial::EdgeSplit& target,
+    const profile::Profile& profile, const GeometryOptions& geometry, const utility::Deadline* deadline) {
+    RouteCacheKey key{profile.GetName(), source, target, geometry};
+    auto&& cached_route = route_cache_->Get(key);
+    if (cached_route) {
+        metrics_->route_cache_hits.Increment();
+        return *cached_route;
+    }
+    metrics_->route_cache_misses.Increment();
+    utility::Stopwatch stopwatch{};
+
+    RoutingGraph<typename AlgorithmFactory::Graph> routing_graph{base_graph_};
+    auto&& length = alg_factory_.CreateEdgeLength(profile, base_graph_max_vertex_id_);
+
+    EC endpoints_creator{
+        alg_factory_.CreateEndpointAlgorithmPolicy(routing_graph),
+        alg_factory_.CreateEndpointEdgesCreator(base_graph_, *segment_index_, length)
+    };
+    unsigned_id_type source_vertex_id = base_graph_max_vertex_id_ + 1;
+    unsigned_id_type target_vertex_id = base_graph_max_vertex_id_ + 2;
+    endpoints_creator.AddSourceEndpoint(source_vertex_id, source);
+    endpoints_creator.AddTargetEndpoint(target_vertex_id, target);
+    metrics_->endpoints.Observe(stopwatch.Lap());
+
+    auto&& workspace = workspaces_->Acquire();
+    Algorithm<typename AlgorithmFactory::Algorithm> alg{routing_graph, length, workspace.get()};
+    alg.SetDeadline(deadline);
+    alg.Run(source_vertex_id, target_vertex_id);
+    metrics_->search.Observe(stopwatch.Lap());
+    metrics_->settled_vertices.Observe(alg.GetSettledVertexCount());
+
+    auto&& edges = alg.GetRoute();
+    metrics_->unpacking.Observe(stopwatch.Lap());
+    auto&& route = std::make_shared<const Route<typename AlgorithmFactory::Algorithm::Edge>>(CreateRoute(endpoints_creator, std::move(edges), length,
+        source, target, geometry));
+    route_cache_->Put(key, route, route->GetMemoryUsage());
+    return *route;
+}
+
+template <typename AlgorithmFactory>
+std::vector<Route<typename AlgorithmFactory::Algorithm::Edge>> Router<AlgorithmFactory>::CalculateAlternativeRoutes(utility::Point source,
+    utility::Point target, const profile::Profile& profile, size_t max_count, const AlternativeRouteParameters& parameters,
+    const GeometryOptions& geometry, const utility::Deadline* deadline) {
+    if (source.lat_ == target.lat_ && source.lon_ == target.lon_) {
+        throw RouteNotFoundException("Start and end point are the same.");
+    }
+
     RoutingGraph<typename AlgorithmFactory::Graph> routing_graph{base_graph_};
-    auto&& db_graph = alg_factory_.CreateDbGraph();
+    auto&& length = alg_factory_.CreateEdgeLength(profile, base_graph_max_vertex_id_);
 
     EC endpoints_creator{
         alg_factory_.CreateEndpointAlgorithmPolicy(routing_graph),
-        alg_factory_.CreateEndpointEdgesCreator(base_graph_, d, &db_graph)
+        alg_factory_.CreateEndpointEdgesCreator(base_graph_, *segment_index_, length)
     };
     unsigned_id_type source_vertex_id = base_graph_max_vertex_id_ + 1;
     unsigned_id_type target_vertex_id = base_graph_max_vertex_id_ + 2;
-    endpoints_creator.AddSourceEndpoint(table_names_->GetEdgesTable(), source_vertex_id, source);
-    endpoints_creator.AddTargetEndpoint(table_names_->GetEdgesTable(), target_vertex_id, target);
+    auto&& source_split = segment_index_->FindClosestEdge(source);
+    auto&& target_split = segment_index_->FindClosestEdge(target);
+    endpoints_creator.AddSourceEndpoint(source_vertex_id, source_split);
+    endpoints_creator.AddTargetEndpoint(target_vertex_id, target_split);
 
-    Algorithm<typename AlgorithmFactory::Algorithm> alg{routing_graph};
-    alg.Run(source_vertex_id, target_vertex_id);            
+    auto&& workspace = workspaces_->Acquire();
+    Algorithm<typename AlgorithmFactory::Algorithm> alg{routing_graph, length, workspace.get()};
+    alg.SetDeadline(deadline);
+    alg.RunAlternatives(source_vertex_id, target_vertex_id, parameters);
 
-    std::vector<typename AlgorithmFactory::Algorithm::Edge> route = alg.GetRoute();
-    auto&& geom = GetRouteGeometry(d, endpoints_creator, route);
-    return Route<typename AlgorithmFactory::Algorithm::Edge>{std::move(route), std::move(geom)};
+    std::vector<Route<typename AlgorithmFactory::Algorithm::Edge>> routes{};
+    routes.push_back(CreateRoute(endpoints_creator, alg.GetRoute(), length, source_split, target_split, geometry));
+    for (auto&& route : alg.GetAlternativeRoutes(max_count)) {
+        routes.push_back(CreateRoute(endpoints_creator, std::move(route), length, source_split, target_split, geometry));
+    }
+    return routes;
 }
 
 template <typename AlgorithmFactory>
-std::string Router<AlgorithmFactory>::GetRouteGeometry(database::DatabaseHelper& d, EC& endpoints_creator,
-    const std::vector<typename AlgorithmFactory::Algorithm::Edge>& route) {
+DistanceTable Router<AlgorithmFactory>::CalculateDistanceTable(const std::vector<utility::Point>& sources, const std::vector<utility::Point>& targets,
+    const profile::Profile& profile, const utility::Deadline* deadline) {
+    using Coordinates = std::pair<float, float>;
+    RoutingGraph<typename AlgorithmFactory::Graph> routing_graph{base_graph_};
+    auto&& length = alg_factory_.CreateEdgeLength(profile, base_graph_max_vertex_id_);
+    auto&& endpoint_policy = alg_factory_.CreateEndpointAlgorithmPolicy(routing_graph);
+    auto&& endpoint_edges_creator = alg_factory_.CreateEndpointEdgesCreator(base_graph_, *segment_index_, length);
+
+    std::map<Coordinates, spatial::EdgeSplit> splits{};
+    unsigned_id_type free_vertex_id = base_graph_max_vertex_id_ + 1;
+    unsigned_id_type free_edge_id = 0;
+    // Source and target endpoints need different vertices but a coordinate that is used more times is snapped only once.
+    auto&& add_endpoints = [&](const std::vector<utility::Point>& points, bool source) {
+        std::map<Coordinates, unsigned_id_type> endpoint_ids{};
+        std::vector<unsigned_id_type> ids{};
+        ids.reserve(points.size());
+        for (auto&& point : points) {
+            Coordinates coordinates{point.lon_, point.lat_};
+            auto&& it = endpoint_ids.find(coordinates);
+            if (it != endpoint_ids.end()) {
+                ids.push_back(it->second);
+                continue;
+            }
+            auto&& split = splits.find(coordinates);
+            if (split == splits.end()) {
+                split = splits.emplace(coordinates, segment_index_->FindClosestEdge(point)).first;
+            }
+            unsigned_id_type endpoint_id = free_vertex_id++;
+            auto&& edges = endpoint_edges_creator.CalculateEndpointEdges(endpoint_id, split->second, free_edge_id);
+            free_edge_id += edges.size();
+            if (source) {
+                endpoint_policy.AddSource(std::move(edges), endpoint_id);
+            } else {
+                endpoint_policy.AddTarget(std::move(edges), endpoint_id);
+            }
+            endpoint_ids.emplace(coordinates, endpoint_id);
+            ids.push_back(endpoint_id);
+        }
+        return ids;
+    };
+    std::vector<unsigned_id_type> source_ids = add_endpoints(sources, true);
+    std::vector<unsigned_id_type> target_ids = add_endpoints(targets, false);
+
+    typename AlgorithmFactory::TableAlgorithm alg{routing_graph, length};
+    alg.SetDeadline(deadline);
+    alg.Run(source_ids, target_ids);
+    std::vector<float> distances = alg.GetDistances();
+    for (size_t i = 0; i < sources.size(); ++i) {
+        for (size_t j = 0; j < targets.size(); ++j) {
+            if (sources[i].lon_ == targets[j].lon_ && sources[i].lat_ == targets[j].lat_) {
+                distances[i * targets.size() + j] = 0;
+            }
+        }
+    }
+    return DistanceTable{sources.size(), targets.size(), std::move(distances)};
+}
+
+template <typename AlgorithmFactory>
+std::string Router<AlgorithmFactory>::CalculateIsochrone(const std::vector<utility::Point>& sources, float max_cost, const profile::Profile& profile,
+    const utility::Deadline* deadline) {
+    auto&& length = alg_factory_.CreateEdgeLength(profile, base_graph_max_vertex_id_);
+    auto&& endpoint_edges_creator = alg_factory_.CreateEndpointEdgesCreator(base_graph_, *segment_index_, length);
+    std::vector<std::vector<typename AlgorithmFactory::Graph::Edge>> source_edges{};
+    for (auto&& source : sources) {
+        // Sources are not added to the graph - the algorithm starts from the ends of their edges.
+        source_edges.push_back(endpoint_edges_creator.CalculateEndpointEdges(base_graph_max_vertex_id_ + 1, segment_index_->FindClosestEdge(source), 0));
+    }
+
+    auto&& workspace = isochrone_workspaces_->Acquire();
+    typename AlgorithmFactory::IsochroneAlgorithm alg{base_graph_, length, workspace.get()};
+    alg.SetDeadline(deadline);
+    alg.Run(source_edges, max_cost);
+    auto&& is_reachable = [&](unsigned_id_type vertex_id) {
+        for (size_t i = 0; i < sources.size(); ++i) {
+            if (alg.GetCost(i, vertex_id) != AlgorithmFactory::IsochroneAlgorithm::kUnreachable) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto&& geometry_store = segment_index_->GetGeometryStore();
+    std::string geometries{};
+    geometries += "[";
+    segment_index_->ForEachEdge([&](unsigned_id_type uid, unsigned_id_type from, unsigned_id_type to) {
+        if (is_reachable(from) || is_reachable(to)) {
+            geometry_store.AppendGeoJson(geometries, uid);
+            geometries += ",";
+        }
+    });
+    if (geometries.back() == ',') {
+        geometries.pop_back();
+    }
+    geometries += "]";
+    return geometries;
+}
+
+template <typename AlgorithmFactory>
+Route<typename AlgorithmFactory::Algorithm::Edge> Router<AlgorithmFactory>::CreateRoute(EC& endpoints_creator,
+    std::vector<typename AlgorithmFactory::Algorithm::Edge>&& route, const typename AlgorithmFactory::EdgeLength& length,
+    const spatial::EdgeSplit& source, const spatial::EdgeSplit& target, const GeometryOptions& geometry) {
+    utility::Stopwatch stopwatch{};
+    auto&& geom = GetRouteGeometry(endpoints_creator, route, source, target, geometry);
+    metrics_->geometry.Observe(stopwatch.Lap());
+    // Endpoint edges exist only during this call so their lengths are computed now.
+    float endpoint_edges_length = length(route.front()) + length(route.back());
+    return Route<typename AlgorithmFactory::Algorithm::Edge>{std::move(route), std::move(geom), endpoint_edges_length, geometry.format};
+}
+
+template <typename AlgorithmFactory>
+std::string Router<AlgorithmFactory>::GetRouteGeometry(EC& endpoints_creator, const std::vector<typename AlgorithmFactory::Algorithm::Edge>& route,
+    const spatial::EdgeSplit& source, const spatial::EdgeSplit& target, const GeometryOptions& geometry) {
+    if (geometry.format == GeometryFormat::kPolyline) {
+        return GetRoutePolyline(route, source, target, geometry);
+    }
+    return GetRouteGeoJson(endpoints_creator, route);
+}
+
+template <typename AlgorithmFactory>
+std::string Router<AlgorithmFactory>::GetRoutePolyline(const std::vector<typename AlgorithmFactory::Algorithm::Edge>& route,
+    const spatial::EdgeSplit& source, const spatial::EdgeSplit& target, const GeometryOptions& geometry) {
+    std::vector<utility::Point> points{};
+    auto&& append = [&points](auto begin, auto end) {
+        if (begin == end) {
+            return;
+        }
+        // Edges share their end points.
+        if (!points.empty() && points.back().lon_ == begin->lon_ && points.back().lat_ == begin->lat_) {
+            ++begin;
+        }
+        points.insert(points.end(), begin, end);
+    };
+    // Endpoint edges lead from the split point to one of the intersections of the split edge. The segment
+    // from `from` intersection ends at the split point and the segment to `to` intersection starts there.
+    auto&& touches = [](const typename AlgorithmFactory::Algorithm::Edge& edge, unsigned_id_type vertex) {
+        return edge.get_from() == vertex || edge.get_to() == vertex;
+    };
+    if (touches(route.front(), source.from)) {
+        append(source.from_segment.rbegin(), source.from_segment.rend());
+    } else {
+        append(source.to_segment.begin(), source.to_segment.end());
+    }
+
+    // Stored geometries of twoway edges need not lead in the direction of the route. Route edges lead
+    // in its direction so a geometry is reversed if it starts at the vertex the route edge leads to.
+    auto&& geometry_store = segment_index_->GetGeometryStore();
+    std::vector<utility::Point> edge_points{};
+    for (size_t i = 1; i + 1 < route.size(); ++i) {
+        edge_points.clear();
+        geometry_store.ForEachPoint(route[i].get_uid(), [&edge_points](const utility::Point& point) {
+            edge_points.push_back(point);
+        });
+        unsigned_id_type geometry_start = segment_index_->GetGeometryStart(route[i].get_uid());
+        if (geometry_start == route[i].get_to() && geometry_start != route[i].get_from()) {
+            append(edge_points.rbegin(), edge_points.rend());
+        } else {
+            append(edge_points.begin(), edge_points.end());
+        }
+    }
+
+    if (touches(route.back(), target.from)) {
+        append(target.from_segment.begin(), target.from_segment.end());
+    } else {
+        append(target.to_segment.rbegin(), target.to_segment.rend());
+    }
+    if (geometry.tolerance > 0) {
+        points = spatial::SimplifyLine(points, geometry.tolerance);
+    }
+    return spatial::EncodePolyline(points, geometry.precision);
+}
+
+template <typename AlgorithmFactory>
+std::string Router<AlgorithmFactory>::GetRouteGeoJson(EC& endpoints_creator, const std::vector<typename AlgorithmFactory::Algorithm::Edge>& route) {
     auto&& route_begin = route.cbegin();
     auto&& route_end = route.cend();
     --route_end;
@@ -114,15 +538,27 @@ std::string Router<AlgorithmFactory>::GetRouteGeometry(database::DatabaseHelper&
     ++route_begin;
     // The first and the last edge geometries already retrieved so
     // inc route_begin and dec route_end was done.
-    auto&& geojson_array = d.GetRouteCoordinates<typename AlgorithmFactory::Algorithm::Edge>(route_begin, route_end, table_names_->GetEdgesTable());
-
-    std::string final_array = "[" + first_edge_geometry + "," + geojson_array + last_edge_geometry + "]";
+    auto&& geometry_store = segment_index_->GetGeometryStore();
+    std::string final_array{};
+    final_array.reserve(first_edge_geometry.size() + last_edge_geometry.size() + (route.size() - 2) * kEstimatedEdgeGeoJsonSize);
+    final_array += "[";
+    final_array += first_edge_geometry;
+    final_array += ",";
+    for (auto&& it = route_begin; it != route_end; ++it) {
+        if (geometry_store.Contains(it->get_uid())) {
+            geometry_store.AppendGeoJson(final_array, it->get_uid());
+            final_array += ",";
+        } else {
+            std::cout << it->get_uid() << " not found in edge geometries but is part of routing result." << std::endl;
+        }
+    }
+    final_array += last_edge_geometry;
+    final_array += "]";
     return final_array;
 }
 
 
 
-
 }
 }
 #endif //ROUTING_QUERY_ROUTER_H
\ No newline at end of file
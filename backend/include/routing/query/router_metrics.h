@@ -0,0 +1,71 @@
+#ifndef ROUTING_QUERY_ROUTER_METRICS_H
+#define ROUTING_QUERY_ROUTER_METRICS_H
+
+#include "routing/utility/metrics.h"
+
+#include <ostream>
+
+namespace routing {
+namespace query {
+
+/**
+ * RouterMetrics measures stages of route calculations. Routers of one routing mode share it
+ * so that metrics are not lost when a router is replaced.
+ */
+struct RouterMetrics {
+    /**
+     * Finding the closest edge of each point.
+     */
+    utility::Histogram snapping;
+
+    /**
+     * Creating endpoint edges and adding them to the routing graph.
+     */
+    utility::Histogram endpoints;
+
+    /**
+     * Running the search algorithm.
+     */
+    utility::Histogram search;
+
+    /**
+     * Retrieving route edges from the search and unpacking shortcuts.
+     */
+    utility::Histogram unpacking;
+
+    /**
+     * Writing GeoJSON geometry of the route.
+     */
+    utility::Histogram geometry;
+
+    utility::Histogram settled_vertices;
+    utility::Counter route_cache_hits;
+    utility::Counter route_cache_misses;
+
+    RouterMetrics() : snapping(utility::LatencyBuckets()), endpoints(utility::LatencyBuckets()), search(utility::LatencyBuckets()),
+        unpacking(utility::LatencyBuckets()), geometry(utility::LatencyBuckets()),
+        settled_vertices({10, 100, 1000, 10000, 100000, 1000000, 10000000}), route_cache_hits(), route_cache_misses() {}
+
+    /**
+     * Write all metrics in Prometheus text format.
+     */
+    void Write(std::ostream& out) const {
+        utility::PrometheusWriter writer{out};
+        writer.WriteHeader("routing_stage_duration_seconds", "Duration of stages of route calculations.", "histogram");
+        writer.WriteHistogram("routing_stage_duration_seconds", "stage=\"snapping\"", snapping);
+        writer.WriteHistogram("routing_stage_duration_seconds", "stage=\"endpoints\"", endpoints);
+        writer.WriteHistogram("routing_stage_duration_seconds", "stage=\"search\"", search);
+        writer.WriteHistogram("routing_stage_duration_seconds", "stage=\"unpacking\"", unpacking);
+        writer.WriteHistogram("routing_stage_duration_seconds", "stage=\"geometry\"", geometry);
+        writer.WriteHeader("routing_settled_vertices", "Vertices settled by one search.", "histogram");
+        writer.WriteHistogram("routing_settled_vertices", "", settled_vertices);
+        writer.WriteHeader("routing_route_cache_hits_total", "Routes taken from the route cache.", "counter");
+        writer.WriteCounter("routing_route_cache_hits_total", "", route_cache_hits);
+        writer.WriteHeader("routing_route_cache_misses_total", "Routes that were not in the route cache.", "counter");
+        writer.WriteCounter("routing_route_cache_misses_total", "", route_cache_misses);
+    }
+};
+
+}
+}
+#endif //ROUTING_QUERY_ROUTER_METRICS_H
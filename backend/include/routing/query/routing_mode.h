@@ -13,9 +13,40 @@
 
 #include "routing/database/database_helper.h"
 
+#include "routing/spatial/edge_geometry_store.h"
+#include "routing/spatial/segment_index.h"
+
+#include "routing/snapshot/ch_graph_snapshot.h"
+
+#include "routing/cch/customizable_graph.h"
+
+#include <memory>
+#include <string>
+#include <list>
+#include <mutex>
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <unordered_map>
+
 namespace routing{
 namespace query{
 
+/**
+ * Load geometries of all edges in the base graph table and create their spatial index. Graphs made
+ * from the base graph (preprocessed or not) contain all its edges so the index can be shared by their routers.
+ */
+inline std::shared_ptr<const spatial::SegmentIndex> CreateSegmentIndex(database::DatabaseHelper& d, const std::string& base_graph_table) {
+    auto&& geometry_store = std::make_shared<spatial::EdgeGeometryStore>();
+    auto&& segment_index = std::make_shared<spatial::SegmentIndex>(geometry_store);
+    d.LoadEdgeGeometries(base_graph_table, [&](unsigned_id_type uid, unsigned_id_type from, unsigned_id_type to, std::vector<utility::Point>&& geometry) {
+        geometry_store->AddEdge(uid, geometry);
+        segment_index->AddEdge(uid, from, to);
+    });
+    segment_index->Build();
+    return segment_index;
+}
+
 /**
  * StaticProfileMode provides routing based on preferences.
  * It stores multiple Router classes that provide routing based on a profile.
@@ -26,21 +57,60 @@ namespace query{
  */
 template<typename AlgorithmStaticFactory>
 class StaticProfileMode{
+    using RouteCache = typename Router<AlgorithmStaticFactory>::RouteCache;
 public:
-    StaticProfileMode()
-        : routers_(), profile_() {
+    /**
+     * @param snapshot_directory Directory with graph snapshots created by the preprocessor. If it is empty,
+     *      graphs are always loaded from the database.
+     */
+    StaticProfileMode(const std::string& snapshot_directory = std::string{})
+        : routers_(), profile_(), segment_index_(), snapshot_directory_(snapshot_directory),
+            route_cache_(std::make_shared<RouteCache>(Router<AlgorithmStaticFactory>::kDefaultRouteCacheCapacity)), metrics_(std::make_shared<RouterMetrics>()) {
     }
 
     /**
-     * Add Router class which contains a graph. The graph is loaded from database table table_names.
+     * Add Router class which contains a graph. The graph is loaded from its snapshot if there is one
+     * or from database table table_names otherwise.
      * The edge lengths in the table must be the same as the ones that argument profile provides so
      * that each Router class is matched to a correct profile.
      */
     void AddRouter(database::DatabaseHelper& d, std::unique_ptr<TableNames>&& table_names, const profile::Profile& profile) {
         profile_ = profile;
-        auto&& g = AlgorithmStaticFactory::CreateGraph(d, table_names.get());
-        std::cout << " Loading " << table_names->GetEdgesTable() << std::endl;
-        routers_.emplace(profile.GetName(), Router<AlgorithmStaticFactory>{AlgorithmStaticFactory{}, std::move(g), std::move(table_names)});
+        if (!segment_index_) {
+            segment_index_ = CreateSegmentIndex(d, table_names->GetBaseTableName());
+        }
+        auto&& g = CreateGraph(d, table_names.get());
+        auto&& router = std::make_shared<Router<AlgorithmStaticFactory>>(AlgorithmStaticFactory{}, std::move(g), std::move(table_names), segment_index_);
+        router->SetRouteCache(route_cache_);
+        router->SetMetrics(metrics_);
+        routers_.emplace(profile.GetName(), router);
+    }
+
+    /**
+     * Set memory budget of the route cache in bytes. Routers of all profiles share one cache so it is the budget of the mode.
+     */
+    void SetRouteCacheCapacity(size_t capacity) {
+        route_cache_ = std::make_shared<RouteCache>(capacity);
+        for (auto&& [name, router] : routers_) {
+            router->SetRouteCache(route_cache_);
+        }
+    }
+
+    /**
+     * Metrics of route calculations of all routers.
+     */
+    RouterMetrics& GetMetrics() {
+        return *metrics_;
+    }
+
+    /**
+     * Replace metrics of all routers, e.g. by metrics of a replaced mode. It must not be called concurrently with requests.
+     */
+    void SetMetrics(const std::shared_ptr<RouterMetrics>& metrics) {
+        metrics_ = metrics;
+        for (auto&& [name, router] : routers_) {
+            router->SetMetrics(metrics);
+        }
     }
 
     profile::Profile& GetDefaultProfile() {
@@ -50,7 +120,7 @@ public:
     /**
      * Retrieve previously registered Router class corresponding to the given profile.
      */
-    Router<AlgorithmStaticFactory>& GetRouter(profile::Profile&& profile) {
+    std::shared_ptr<Router<AlgorithmStaticFactory>> GetRouter(const profile::Profile& profile) {
         auto it = routers_.find(profile.GetName());
         if (it != routers_.end()) {
             return it->second;
@@ -59,16 +129,49 @@ public:
         }
     }
 private:
-    std::unordered_map<std::string, Router<AlgorithmStaticFactory>> routers_;
+    std::unordered_map<std::string, std::shared_ptr<Router<AlgorithmStaticFactory>>> routers_;
     profile::Profile profile_;
+
+    /**
+     * All graphs are made from the same base graph so they share one spatial index.
+     */
+    std::shared_ptr<const spatial::SegmentIndex> segment_index_;
+
+    std::string snapshot_directory_;
+
+    /**
+     * Routes of all routers. Keys of cached routes contain their profile.
+     */
+    std::shared_ptr<RouteCache> route_cache_;
+    std::shared_ptr<RouterMetrics> metrics_;
+
+    /**
+     * Load graph from its snapshot. If the snapshot is missing, invalid or it was not created by the preprocessing
+     * run that saved the table, fall back to the database.
+     */
+    typename AlgorithmStaticFactory::Graph CreateGraph(database::DatabaseHelper& d, TableNames* table_names) {
+        if (!snapshot_directory_.empty()) {
+            std::string path = snapshot::CHGraphSnapshot::GetPath(snapshot_directory_, table_names->GetEdgesTable());
+            try {
+                snapshot::CHGraphSnapshot graph_snapshot{path};
+                graph_snapshot.CheckSource(table_names->GetEdgesTable(), d.LoadPreprocessingId(table_names->GetEdgesTable()));
+                std::cout << " Loading " << path << std::endl;
+                return AlgorithmStaticFactory::CreateGraph(graph_snapshot);
+            } catch (const SnapshotException& e) {
+                std::cout << e.what() << " Graph is loaded from the database." << std::endl;
+            }
+        }
+        std::cout << " Loading " << table_names->GetEdgesTable() << std::endl;
+        return AlgorithmStaticFactory::CreateGraph(d, table_names);
+    }
 };
 
 /**
  * DynamicProfileMode provides routig based on preferences.
  * It contains one Router class which contains a graph whose edge lengths are defined
- * by a profile stored in DynamicProfileMode. Routing for a profile can be done by
- * retrieving stored Router instance and swapping the profile with the stored to be the base
- * for the edge lengths of the graph in the Router instance.
+ * by a profile. The profile is not stored in the graph - each routing request passes its own profile
+ * to the Router instance and the search takes edge lengths from it. Therefore, requests with different
+ * profiles can be routed concurrently.
  * 
  * @tparam AlgorithmDynamicFactory Defines which routing algorithm is used in the stored Router instance.
  */
@@ -76,33 +179,192 @@ template<typename AlgorithmDynamicFactory>
 class DynamicProfileMode{
 public:
     /**
-     * Creates a graph from table_names table whose lengths are provided by a dynamic source - in this case the argument profile. 
-     * Router instance is then created containing the graph and stored.
+     * Creates a graph from table_names table whose lengths are provided by a dynamic source - in this case the argument profile
+     * which is used only as the default profile. Router instance is then created containing the graph and stored.
      */
     DynamicProfileMode(database::DatabaseHelper& d, std::unique_ptr<TableNames>&& table_names, profile::Profile&& profile)
         : router_(), profile_envelope_(std::move(profile)) {
         typename AlgorithmDynamicFactory::Graph g = AlgorithmDynamicFactory::CreateGraph(d, table_names.get(), &profile_envelope_);
         std::cout << "Loading " << table_names->GetEdgesTable() << std::endl;
-        router_ = std::move(Router<AlgorithmDynamicFactory>{AlgorithmDynamicFactory{}, std::move(g), std::move(table_names)});
+        auto&& segment_index = CreateSegmentIndex(d, table_names->GetBaseTableName());
+        router_ = std::make_shared<Router<AlgorithmDynamicFactory>>(AlgorithmDynamicFactory{}, std::move(g), std::move(table_names), segment_index);
     }
 
     profile::Profile& GetDefaultProfile() {
         return profile_envelope_.get_profile();
     }
 
-    Router<AlgorithmDynamicFactory>& GetRouter(profile::Profile&& profile) {
-        profile_envelope_.SwitchProfile(std::move(profile));
+    /**
+     * Set memory budget of the route cache in bytes. Routes of all profiles share it.
+     */
+    void SetRouteCacheCapacity(size_t capacity) {
+        router_->SetRouteCacheCapacity(capacity);
+    }
+
+    RouterMetrics& GetMetrics() {
+        return router_->GetMetrics();
+    }
+
+    void SetMetrics(const std::shared_ptr<RouterMetrics>& metrics) {
+        router_->SetMetrics(metrics);
+    }
+
+    /**
+     * Retrieve the Router instance. The profile is passed to the router with each request.
+     */
+    std::shared_ptr<Router<AlgorithmDynamicFactory>> GetRouter(const profile::Profile& profile) {
         return router_;
     }
 private:
-    Router<AlgorithmDynamicFactory> router_;
+    std::shared_ptr<Router<AlgorithmDynamicFactory>> router_;
     /**
-     * Contains a profile which defines edge lengths for routing in Router router_.
+     * Contains the default profile. Graph edges reference it but routing requests
+     * take edge lengths from their own profiles.
      */
     ProfileEnvelope profile_envelope_;
 };
 
+/**
+ * CustomizableProfileMode provides routing based on preferences with graphs that are customized for
+ * each profile when it is first requested. The metric independent contracted graph is created once
+ * and each profile only computes its own edge lengths of it.
+ *
+ * Routers of recently used profiles are cached. The least recently used router is removed when the cache is full.
+ * Routers are shared with requests that use them so a removed router lives until its last request finishes.
+ *
+ * @tparam AlgorithmCustomizableFactory Defines which routing algorithm is used in Router classes and how the graph is customized.
+ */
+template<typename AlgorithmCustomizableFactory>
+class CustomizableProfileMode{
+    using RouteCache = typename Router<AlgorithmCustomizableFactory>::RouteCache;
+public:
+    /**
+     * Contract the graph from table_names tables and customize it for the default profile right away.
+     *
+     * @param thread_count Number of threads that customize the graph for a new profile.
+     * @param cached_profiles Maximum number of customized graphs kept in memory.
+     */
+    CustomizableProfileMode(database::DatabaseHelper& d, std::unique_ptr<TableNames>&& table_names, profile::Profile&& profile,
+        size_t thread_count, size_t cached_profiles)
+        : customizable_graph_(), segment_index_(), table_names_(std::move(table_names)), profile_(std::move(profile)),
+            thread_count_(thread_count), cached_profiles_(std::max(cached_profiles, static_cast<size_t>(1))),
+            route_cache_(std::make_shared<RouteCache>(Router<AlgorithmCustomizableFactory>::kDefaultRouteCacheCapacity)), metrics_(std::make_shared<RouterMetrics>()), mutex_(), routers_(), recently_used_() {
+        std::cout << "Loading " << table_names_->GetEdgesTable() << std::endl;
+        customizable_graph_ = AlgorithmCustomizableFactory::CreateCustomizableGraph(d, table_names_.get());
+        std::cout << "Contracted graph has " << customizable_graph_.GetArcCount() << " arcs, " << customizable_graph_.GetTriangleCount()
+            << " triangles and " << customizable_graph_.GetLevelCount() << " levels." << std::endl;
+        segment_index_ = CreateSegmentIndex(d, table_names_->GetBaseTableName());
+        GetRouter(profile_);
+    }
+
+    profile::Profile& GetDefaultProfile() {
+        return profile_;
+    }
+
+    /**
+     * Set memory budget of the route cache in bytes. Customized routers of all profiles share one cache
+     * so it is the budget of the mode.
+     */
+    void SetRouteCacheCapacity(size_t capacity) {
+        std::lock_guard<std::mutex> lock{mutex_};
+        route_cache_ = std::make_shared<RouteCache>(capacity);
+        for (auto&& [name, cached_router] : routers_) {
+            cached_router.router->SetRouteCache(route_cache_);
+        }
+    }
+
+    /**
+     * Metrics of route calculations of all routers including the removed ones.
+     */
+    RouterMetrics& GetMetrics() {
+        return *metrics_;
+    }
+
+    /**
+     * Replace metrics of cached routers and routers customized later. It must not be called concurrently with requests.
+     */
+    void SetMetrics(const std::shared_ptr<RouterMetrics>& metrics) {
+        std::lock_guard<std::mutex> lock{mutex_};
+        metrics_ = metrics;
+        for (auto&& [name, cached_router] : routers_) {
+            cached_router.router->SetMetrics(metrics);
+        }
+    }
+
+    /**
+     * Retrieve Router class of the profile. If the profile is not cached, the graph is customized for it
+     * without blocking requests of other profiles. When two requests customize the same profile
+     * at once, the router of the one that finishes first is kept.
+     */
+    std::shared_ptr<Router<AlgorithmCustomizableFactory>> GetRouter(const profile::Profile& profile) {
+        std::string name = profile.GetName();
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            auto&& it = routers_.find(name);
+            if (it != routers_.end()) {
+                recently_used_.splice(recently_used_.begin(), recently_used_, it->second.position);
+                return it->second.router;
+            }
+        }
+        auto&& start = std::chrono::steady_clock::now();
+        auto&& g = AlgorithmCustomizableFactory::CreateGraph(customizable_graph_, profile, thread_count_);
+        auto&& router = std::make_shared<Router<AlgorithmCustomizableFactory>>(AlgorithmCustomizableFactory{}, std::move(g),
+            std::make_unique<CCHTableNames>(table_names_->GetBaseTableName()), segment_index_);
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            router->SetRouteCache(route_cache_);
+            router->SetMetrics(metrics_);
+        }
+        auto&& duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        std::cout << "Profile " << name << " customized in " << duration.count() << " ms." << std::endl;
+
+        std::lock_guard<std::mutex> lock{mutex_};
+        auto&& it = routers_.find(name);
+        if (it != routers_.end()) {
+            return it->second.router;
+        }
+        recently_used_.push_front(name);
+        routers_.emplace(name, CachedRouter{router, recently_used_.begin()});
+        if (routers_.size() > cached_profiles_) {
+            routers_.erase(recently_used_.back());
+            recently_used_.pop_back();
+        }
+        return router;
+    }
+private:
+    struct CachedRouter {
+        std::shared_ptr<Router<AlgorithmCustomizableFactory>> router;
+
+        /**
+         * Position of the profile in the list of recently used profiles.
+         */
+        std::list<std::string>::iterator position;
+    };
+
+    cch::CustomizableGraph customizable_graph_;
+    std::shared_ptr<const spatial::SegmentIndex> segment_index_;
+    std::unique_ptr<TableNames> table_names_;
+    profile::Profile profile_;
+    size_t thread_count_;
+    size_t cached_profiles_;
+
+    /**
+     * Routes of all routers including the removed ones. Keys of cached routes contain their profile.
+     */
+    std::shared_ptr<RouteCache> route_cache_;
+    std::shared_ptr<RouterMetrics> metrics_;
+
+    /**
+     * Guards the cache of routers.
+     */
+    std::mutex mutex_;
+    std::unordered_map<std::string, CachedRouter> routers_;
 
+    /**
+     * Names of cached profiles from the most recently used one.
+     */
+    std::list<std::string> recently_used_;
+};
 
 
 }
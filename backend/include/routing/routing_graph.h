@@ -7,6 +7,8 @@
 #include "routing/exception.h"
 #include "routing/types.h"
 
+#include "tsl/robin_map.h"
+
 #include <unordered_map>
 #include <vector>
 #include <utility>
@@ -25,6 +27,7 @@ namespace routing {
  * However, they are instead stored in this instance and the underlying graph is uncahnged.
  * 
  * This is useful for adding temporary vertices and their edges.
+ * If more vertices with the same id are added, the last one is used.
  */
 template <typename Graph>
 class RoutingGraph {
@@ -39,24 +42,43 @@ public:
     Vertex& GetVertex(unsigned_id_type id);
 
 private:
+    /**
+     * Routes have a few additional vertices which are found faster by scanning them than by hashing.
+     * Distance tables add vertices for each of their endpoints so they are looked up in `additional_vertex_indices_`.
+     */
+    static const size_t kMaxScannedVertices = 8;
+
     Graph& g_;
     std::vector<Vertex> additional_vertices_;
+
+    /**
+     * Indices of additional vertices in `additional_vertices_` by their ids.
+     */
+    tsl::robin_map<unsigned_id_type, size_t> additional_vertex_indices_;
 };
 
 template <typename Graph>
-RoutingGraph<Graph>::RoutingGraph(Graph& g) : g_(g) {}
+RoutingGraph<Graph>::RoutingGraph(Graph& g) : g_(g), additional_vertices_(), additional_vertex_indices_() {}
 
 template <typename Graph>
 void RoutingGraph<Graph>::AddVertex(Vertex&& vertex) {
+    additional_vertex_indices_[vertex.get_uid()] = additional_vertices_.size();
     additional_vertices_.push_back(std::move(vertex));
 }
 
 template <typename Graph>
 inline typename Graph::Vertex& RoutingGraph<Graph>::GetVertex(unsigned_id_type id) {
-    for(auto&& vertex : additional_vertices_) {
-        if (vertex.get_uid() == id) {
-            return vertex;
+    if (additional_vertices_.size() <= kMaxScannedVertices) {
+        for (auto&& it = additional_vertices_.rbegin(); it != additional_vertices_.rend(); ++it) {
+            if (it->get_uid() == id) {
+                return *it;
+            }
         }
+        return g_.GetVertex(id);
+    }
+    auto&& it = additional_vertex_indices_.find(id);
+    if (it != additional_vertex_indices_.end()) {
+        return additional_vertices_[it->second];
     }
     return g_.GetVertex(id);
 }
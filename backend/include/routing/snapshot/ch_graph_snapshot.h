@@ -0,0 +1,241 @@
+#ifndef ROUTING_SNAPSHOT_CH_GRAPH_SNAPSHOT_H
+#define ROUTING_SNAPSHOT_CH_GRAPH_SNAPSHOT_H
+
+#include "routing/snapshot/mapped_file.h"
+#include "routing/exception.h"
+#include "routing/types.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+namespace routing {
+namespace snapshot {
+
+/**
+ * Header at the beginning of a snapshot file. All sections are aligned to 8 bytes
+ * and written in the native byte order.
+ */
+struct CHGraphSnapshotHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t edge_record_size;
+    uint64_t vertex_count;
+    uint64_t edge_count;
+    uint64_t file_size;
+    uint64_t first_edges_offset;
+    uint64_t ordering_ranks_offset;
+    uint64_t edges_offset;
+    uint64_t first_edges_checksum;
+    uint64_t ordering_ranks_checksum;
+    uint64_t edges_checksum;
+
+    /**
+     * Name of the table the graph was saved to by the same preprocessing run (null terminated).
+     */
+    char source_table[64];
+
+    /**
+     * Id of the preprocessing run that created the graph. The run stores it to the table as well
+     * so that a snapshot of an older run is not used with a table of a newer one.
+     */
+    uint64_t preprocessing_id;
+
+    /**
+     * Checksum of all previous header fields.
+     */
+    uint64_t header_checksum;
+};
+
+/**
+ * Edge record of a snapshot. Type is the value of BasicEdge::EdgeType.
+ */
+struct CHGraphSnapshotEdge {
+    unsigned_id_type uid;
+    unsigned_id_type from;
+    unsigned_id_type to;
+    unsigned_id_type contracted_vertex;
+    float length;
+    uint8_t type;
+    uint8_t padding[3];
+};
+
+static_assert(std::is_trivially_copyable<CHGraphSnapshotHeader>::value, "Snapshot header must be trivially copyable.");
+static_assert(std::is_trivially_copyable<CHGraphSnapshotEdge>::value, "Snapshot edge must be trivially copyable.");
+static_assert(sizeof(CHGraphSnapshotEdge) % 8 == 0, "Snapshot edge must keep the edges section aligned.");
+
+/**
+ * CHGraphSnapshot is a binary image of CHSearchGraph written by the preprocessor so that
+ * the routing server does not need to load preprocessed graphs from the database.
+ *
+ * The file contains a header and three sections:
+ *  - first edges - for each vertex id the index of its first edge (vertex_count + 1 values),
+ *  - ordering ranks - ordering rank of each vertex,
+ *  - edges - edges sorted by the vertex they belong to.
+ * Each section is protected by its own checksum and the header is versioned so that
+ * an outdated or damaged snapshot is rejected instead of being loaded.
+ *
+ * Reading maps the file to memory and validates it. The sections can then be read
+ * directly from the mapping.
+ */
+class CHGraphSnapshot {
+public:
+    static constexpr uint64_t kMagic = 0x50414e5348434752; // "RGCHSNAP"
+    static constexpr uint32_t kVersion = 2;
+    static inline const std::string kFileExtension = ".chsnap";
+
+    /**
+     * Map snapshot from `path` and validate it.
+     *
+     * @throws SnapshotException if the file cannot be mapped, has different version or its content is damaged.
+     */
+    CHGraphSnapshot(const std::string& path);
+
+    /**
+     * Write search graph to `path`. The graph must provide vertices in the order of their ids
+     * (holes included) as CHSearchGraph does. The snapshot is written to a temporary file which
+     * replaces `path` only when it is complete so that a running server never sees a partial file.
+     *
+     * @param source_table Table the same graph is saved to in the database.
+     * @param preprocessing_id Id of the preprocessing run stored with the table.
+     * @throws SnapshotException if the file cannot be written or the table name is too long.
+     */
+    template <typename Graph>
+    static void Write(const std::string& path, Graph& search_graph, const std::string& source_table, uint64_t preprocessing_id);
+
+    /**
+     * Path of a snapshot of a graph stored in `edges_table` in `directory`.
+     */
+    static std::string GetPath(const std::string& directory, const std::string& edges_table);
+
+    size_t GetVertexCount() const {
+        return header_->vertex_count;
+    }
+
+    std::string GetSourceTable() const {
+        return std::string{header_->source_table};
+    }
+
+    uint64_t GetPreprocessingId() const {
+        return header_->preprocessing_id;
+    }
+
+    /**
+     * Check that the snapshot was created together with `source_table` by the run `preprocessing_id`.
+     *
+     * @throws SnapshotException if the snapshot belongs to another table or preprocessing run.
+     */
+    void CheckSource(const std::string& source_table, uint64_t preprocessing_id) const;
+
+    size_t GetEdgeCount() const {
+        return header_->edge_count;
+    }
+
+    /**
+     * Edges of vertex with id i are [GetFirstEdges()[i], GetFirstEdges()[i + 1]).
+     */
+    const uint64_t* GetFirstEdges() const {
+        return reinterpret_cast<const uint64_t*>(file_.GetData() + header_->first_edges_offset);
+    }
+
+    const uint32_t* GetOrderingRanks() const {
+        return reinterpret_cast<const uint32_t*>(file_.GetData() + header_->ordering_ranks_offset);
+    }
+
+    const CHGraphSnapshotEdge* GetEdges() const {
+        return reinterpret_cast<const CHGraphSnapshotEdge*>(file_.GetData() + header_->edges_offset);
+    }
+
+    /**
+     * 64-bit FNV-1a hash computed over 8-byte words (the tail is processed by bytes).
+     */
+    static uint64_t Checksum(const void* data, size_t size);
+
+private:
+    MappedFile file_;
+    const CHGraphSnapshotHeader* header_;
+
+    void Validate(const std::string& path) const;
+
+    static uint64_t Align(uint64_t offset) {
+        return (offset + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    /**
+     * Write `size` bytes of `data` followed by zero padding to the next aligned offset.
+     */
+    static void WriteSection(std::ofstream& output, const void* data, size_t size);
+};
+
+template <typename Graph>
+void CHGraphSnapshot::Write(const std::string& path, Graph& search_graph, const std::string& source_table, uint64_t preprocessing_id) {
+    if (source_table.size() >= sizeof(CHGraphSnapshotHeader::source_table)) {
+        throw SnapshotException{"Table name " + source_table + " is too long for a snapshot."};
+    }
+    std::vector<uint64_t> first_edges{};
+    std::vector<uint32_t> ordering_ranks{};
+    std::vector<CHGraphSnapshotEdge> edges{};
+    first_edges.reserve(search_graph.GetVertexCount() + 1);
+    ordering_ranks.reserve(search_graph.GetVertexCount());
+    search_graph.ForEachVertex([&](typename Graph::Vertex& vertex) {
+        first_edges.push_back(edges.size());
+        ordering_ranks.push_back(vertex.get_ordering_rank());
+        for (auto&& edge : vertex.get_edges()) {
+            CHGraphSnapshotEdge record{};
+            record.uid = edge.get_uid();
+            record.from = edge.get_from();
+            record.to = edge.get_to();
+            record.contracted_vertex = edge.get_contracted_vertex();
+            record.length = edge.get_length();
+            record.type = static_cast<uint8_t>(edge.IsTwoway() ? Graph::Edge::EdgeType::twoway :
+                (edge.IsBackward() ? Graph::Edge::EdgeType::backward : Graph::Edge::EdgeType::forward));
+            edges.push_back(record);
+        }
+    });
+    first_edges.push_back(edges.size());
+
+    CHGraphSnapshotHeader header{};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.edge_record_size = sizeof(CHGraphSnapshotEdge);
+    header.vertex_count = ordering_ranks.size();
+    header.edge_count = edges.size();
+    header.first_edges_offset = Align(sizeof(CHGraphSnapshotHeader));
+    header.ordering_ranks_offset = Align(header.first_edges_offset + first_edges.size() * sizeof(uint64_t));
+    header.edges_offset = Align(header.ordering_ranks_offset + ordering_ranks.size() * sizeof(uint32_t));
+    header.file_size = header.edges_offset + edges.size() * sizeof(CHGraphSnapshotEdge);
+    header.first_edges_checksum = Checksum(first_edges.data(), first_edges.size() * sizeof(uint64_t));
+    header.ordering_ranks_checksum = Checksum(ordering_ranks.data(), ordering_ranks.size() * sizeof(uint32_t));
+    header.edges_checksum = Checksum(edges.data(), edges.size() * sizeof(CHGraphSnapshotEdge));
+    std::memcpy(header.source_table, source_table.c_str(), source_table.size() + 1);
+    header.preprocessing_id = preprocessing_id;
+    header.header_checksum = Checksum(&header, offsetof(CHGraphSnapshotHeader, header_checksum));
+
+    std::string temporary_path = path + ".tmp";
+    {
+        std::ofstream output{temporary_path, std::ios::binary | std::ios::trunc};
+        if (!output) {
+            throw SnapshotException{"Snapshot " + temporary_path + " cannot be created."};
+        }
+        WriteSection(output, &header, sizeof(CHGraphSnapshotHeader));
+        WriteSection(output, first_edges.data(), first_edges.size() * sizeof(uint64_t));
+        WriteSection(output, ordering_ranks.data(), ordering_ranks.size() * sizeof(uint32_t));
+        WriteSection(output, edges.data(), edges.size() * sizeof(CHGraphSnapshotEdge));
+        output.flush();
+        if (!output) {
+            throw SnapshotException{"Snapshot " + temporary_path + " cannot be written."};
+        }
+    }
+    if (std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+        throw SnapshotException{"Snapshot " + temporary_path + " cannot be renamed to " + path + "."};
+    }
+}
+
+}
+}
+#endif //ROUTING_SNAPSHOT_CH_GRAPH_SNAPSHOT_H
@@ -0,0 +1,45 @@
+#ifndef ROUTING_SNAPSHOT_MAPPED_FILE_H
+#define ROUTING_SNAPSHOT_MAPPED_FILE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace routing {
+namespace snapshot {
+
+/**
+ * MappedFile maps a whole file read-only to memory. The mapping is released
+ * when the object is destroyed.
+ */
+class MappedFile {
+public:
+    /**
+     * @throws SnapshotException if the file cannot be opened or mapped.
+     */
+    MappedFile(const std::string& path);
+
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile& operator=(MappedFile&& other);
+    ~MappedFile();
+
+    const uint8_t* GetData() const {
+        return data_;
+    }
+
+    size_t GetSize() const {
+        return size_;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+
+    void Unmap();
+};
+
+}
+}
+#endif //ROUTING_SNAPSHOT_MAPPED_FILE_H
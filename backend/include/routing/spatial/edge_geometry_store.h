@@ -0,0 +1,117 @@
+#ifndef ROUTING_SPATIAL_EDGE_GEOMETRY_STORE_H
+#define ROUTING_SPATIAL_EDGE_GEOMETRY_STORE_H
+
+#include "routing/utility/point.h"
+#include "routing/types.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace routing {
+namespace spatial {
+
+/**
+ * EdgeGeometryStore keeps geometries of graph edges in memory so that route geometries
+ * do not need to be retrieved from the database.
+ *
+ * Coordinates are stored as fixed-point numbers (1e-6 degree precision). The first point of
+ * each geometry is stored as is and the following points are stored as differences from
+ * the previous point. All numbers are zigzag varint encoded in one contiguous buffer.
+ * Geometry of an edge is found by its uid in an offset array so uids should be dense.
+ */
+class EdgeGeometryStore {
+public:
+    EdgeGeometryStore();
+
+    EdgeGeometryStore(const EdgeGeometryStore& other) = delete;
+    EdgeGeometryStore(EdgeGeometryStore&& other) = default;
+    EdgeGeometryStore& operator=(const EdgeGeometryStore& other) = delete;
+    EdgeGeometryStore& operator=(EdgeGeometryStore&& other) = default;
+    ~EdgeGeometryStore() = default;
+
+    /**
+     * Add geometry of an edge. Edges must be added in increasing order of their uids.
+     *
+     * @throws InvalidArgumentException if uid is not greater than the uid of the previously added edge.
+     */
+    void AddEdge(unsigned_id_type uid, const std::vector<utility::Point>& geometry);
+
+    /**
+     * Check whether a geometry of edge with `uid` is stored.
+     */
+    bool Contains(unsigned_id_type uid) const;
+
+    /**
+     * Call f(utility::Point) for each point of the geometry of the edge with `uid`.
+     */
+    template <typename Function>
+    void ForEachPoint(unsigned_id_type uid, const Function& f) const;
+
+    std::vector<utility::Point> GetGeometry(unsigned_id_type uid) const;
+
+    /**
+     * Append geometry of the edge with `uid` to `output` as GeoJSON LineString.
+     * The coordinates are written directly from the fixed-point representation.
+     */
+    void AppendGeoJson(std::string& output, unsigned_id_type uid) const;
+
+    size_t GetPointCount() const {
+        return point_count_;
+    }
+
+private:
+    static constexpr double kPrecision = 1e6;
+
+    /**
+     * Geometry of edge with uid i is in data_[offsets_[i], offsets_[i + 1]).
+     */
+    std::vector<uint64_t> offsets_;
+    std::vector<uint8_t> data_;
+    size_t point_count_;
+
+    void Encode(int32_t value);
+
+    static int32_t Decode(const uint8_t*& it);
+
+    static utility::Point ToPoint(int32_t lon, int32_t lat);
+
+    static void AppendFixedPoint(std::string& output, int32_t value);
+};
+
+template <typename Function>
+void EdgeGeometryStore::ForEachPoint(unsigned_id_type uid, const Function& f) const {
+    if (!Contains(uid)) {
+        return;
+    }
+    const uint8_t* it = data_.data() + offsets_[uid];
+    const uint8_t* end = data_.data() + offsets_[uid + 1];
+    int32_t lon = 0;
+    int32_t lat = 0;
+    while (it != end) {
+        lon += Decode(it);
+        lat += Decode(it);
+        f(ToPoint(lon, lat));
+    }
+}
+
+inline int32_t EdgeGeometryStore::Decode(const uint8_t*& it) {
+    uint32_t zigzag = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        byte = *it++;
+        zigzag |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return static_cast<int32_t>(zigzag >> 1) ^ -static_cast<int32_t>(zigzag & 1);
+}
+
+inline utility::Point EdgeGeometryStore::ToPoint(int32_t lon, int32_t lat) {
+    return utility::Point{static_cast<float>(lon / kPrecision), static_cast<float>(lat / kPrecision)};
+}
+
+}
+}
+#endif //ROUTING_SPATIAL_EDGE_GEOMETRY_STORE_H
@@ -0,0 +1,42 @@
+#ifndef ROUTING_SPATIAL_GEOMETRY_H
+#define ROUTING_SPATIAL_GEOMETRY_H
+
+#include "routing/utility/point.h"
+
+#include <string>
+#include <vector>
+
+namespace routing {
+namespace spatial {
+
+/**
+ * Mean Earth radius in meters.
+ */
+inline constexpr double kEarthRadius = 6371008.8;
+
+/**
+ * Parse a linestring in WKT format (LINESTRING(X Y, X Y, ...)) as returned by ST_AsText.
+ *
+ * @return Points of the linestring in the original order.
+ */
+std::vector<utility::Point> ParseWktLineString(const std::string& wkt);
+
+/**
+ * Append a GeoJSON LineString geometry made of points in [begin, end) to `output`.
+ * The format corresponds to the output of ST_AsGeoJSON.
+ */
+void AppendGeoJsonLineString(std::string& output, const utility::Point* begin, const utility::Point* end);
+
+/**
+ * Create a GeoJSON LineString geometry from `points`.
+ */
+std::string MakeGeoJsonLineString(const std::vector<utility::Point>& points);
+
+/**
+ * Calculate distance in meters between two points using haversine formula.
+ */
+double CalculateDistance(const utility::Point& a, const utility::Point& b);
+
+}
+}
+#endif //ROUTING_SPATIAL_GEOMETRY_H
@@ -0,0 +1,64 @@
+#ifndef ROUTING_SPATIAL_POLYLINE_H
+#define ROUTING_SPATIAL_POLYLINE_H
+
+#include "routing/utility/point.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace routing {
+namespace spatial {
+
+/**
+ * Simplify line by Douglas-Peucker algorithm. Points whose distance from the simplified line
+ * is at most `tolerance` meters are removed. The first and the last point are always kept.
+ *
+ * @param tolerance Tolerance in meters. Line is not simplified if it is not positive.
+ */
+std::vector<utility::Point> SimplifyLine(const std::vector<utility::Point>& points, double tolerance);
+
+/**
+ * Append `points` encoded in Encoded Polyline Algorithm Format to `output`. Latitude precedes longitude
+ * and coordinates are rounded to `precision` decimal digits (5 is the common default, 6 is used by OSRM-like clients).
+ */
+void AppendEncodedPolyline(std::string& output, const std::vector<utility::Point>& points, int precision);
+
+std::string EncodePolyline(const std::vector<utility::Point>& points, int precision);
+
+/**
+ * Point of an encoded polyline - coordinates multiplied by 10^precision and rounded.
+ */
+struct PolylinePoint {
+    int64_t lat;
+    int64_t lon;
+};
+
+/**
+ * Last point of encoded `polyline`. The whole polyline is decoded. Empty polyline ends at zero point.
+ */
+PolylinePoint DecodePolylineEnd(const std::string& polyline);
+
+/**
+ * Join encoded polyline `next` that starts where `polyline` ends to `polyline`. `end` is the last point of `polyline`
+ * so that only the first point of `next` is decoded and encoded again - the shared point is written once.
+ * Both polylines must have the same precision.
+ */
+void AppendPolyline(std::string& polyline, const PolylinePoint& end, const std::string& next);
+
+/**
+ * Decode polyline encoded by `EncodePolyline` with the same `precision`.
+ *
+ * @throws ParseException if the polyline ends in the middle of a point.
+ */
+std::vector<utility::Point> DecodePolyline(const std::string& polyline, int precision);
+
+/**
+ * Tolerance in meters that corresponds to one pixel of a web map at `zoom` level. Simplification
+ * with this tolerance does not change the route on a map of that zoom.
+ */
+double GetZoomTolerance(double zoom);
+
+}
+}
+#endif //ROUTING_SPATIAL_POLYLINE_H
@@ -0,0 +1,172 @@
+#ifndef ROUTING_SPATIAL_SEGMENT_INDEX_H
+#define ROUTING_SPATIAL_SEGMENT_INDEX_H
+
+#include "routing/spatial/edge_geometry_store.h"
+#include "routing/utility/point.h"
+#include "routing/types.h"
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace routing {
+namespace spatial {
+
+/**
+ * EdgeSplit is the result of snapping a location to its closest graph edge.
+ * The edge is split at its point closest to the location into two segments.
+ * One of them leads to `from` intersection of the edge and the other one
+ * to `to` intersection of the edge.
+ */
+struct EdgeSplit {
+    unsigned_id_type uid;
+    unsigned_id_type from;
+    unsigned_id_type to;
+
+    /**
+     * Geometry of the segment from `from` intersection to the split point.
+     */
+    std::vector<utility::Point> from_segment;
+
+    /**
+     * Geometry of the segment from the split point to `to` intersection.
+     */
+    std::vector<utility::Point> to_segment;
+
+    /**
+     * Length of `from_segment` relative to the length of the whole edge (from 0 to 1).
+     * The relative length of `to_segment` is the rest.
+     */
+    float from_segment_relative_length;
+};
+
+/**
+ * SegmentIndex is an in-memory spatial index of edge geometries. It is used to find the closest
+ * edge to an arbitrary location (endpoint of a route) without querying the database.
+ *
+ * Edges are added first and then the index is built. The index is a uniform grid
+ * over edge segments (pairs of consecutive points of edge geometries) stored
+ * in one array sorted by cells. Geometries themselves are read from EdgeGeometryStore.
+ * Distances are measured in a local equirectangular projection which is precise enough for snapping.
+ */
+class SegmentIndex {
+public:
+    SegmentIndex(const std::shared_ptr<const EdgeGeometryStore>& geometry_store);
+
+    SegmentIndex(const SegmentIndex& other) = delete;
+    SegmentIndex(SegmentIndex&& other) = default;
+    SegmentIndex& operator=(const SegmentIndex& other) = delete;
+    SegmentIndex& operator=(SegmentIndex&& other) = default;
+    ~SegmentIndex() = default;
+
+    /**
+     * Add an edge whose geometry (stored in the geometry store) leads from `from` intersection to `to` intersection.
+     * Index has to be built again (see `Build`) after adding edges.
+     */
+    void AddEdge(unsigned_id_type uid, unsigned_id_type from, unsigned_id_type to);
+
+    /**
+     * Build grid of the index from all added edges.
+     */
+    void Build();
+
+    /**
+     * Find the closest edge to `location` and split it at the location on the edge
+     * that is the closest to `location`.
+     *
+     * @throws RouteNotFoundException if the index contains no edges.
+     */
+    EdgeSplit FindClosestEdge(utility::Point location) const;
+
+    size_t GetEdgeCount() const {
+        return uids_.size();
+    }
+
+    /**
+     * Call f(uid, from, to) for each edge in the index.
+     */
+    template <typename Function>
+    void ForEachEdge(const Function& f) const {
+        for (size_t i = 0; i < uids_.size(); ++i) {
+            f(uids_[i], from_[i], to_[i]);
+        }
+    }
+
+    /**
+     * Intersection where the stored geometry of the edge with `uid` starts. Zero if the edge is not in the built index.
+     */
+    unsigned_id_type GetGeometryStart(unsigned_id_type uid) const;
+
+    const EdgeGeometryStore& GetGeometryStore() const {
+        return *geometry_store_;
+    }
+
+private:
+    struct ProjectedPoint {
+        double x;
+        double y;
+    };
+
+    /**
+     * Segment is identified by index of its edge in uids_ and by index of its first point in the edge geometry.
+     */
+    struct Segment {
+        uint32_t edge;
+        uint32_t first_point;
+    };
+
+    std::shared_ptr<const EdgeGeometryStore> geometry_store_;
+
+    std::vector<unsigned_id_type> uids_;
+    std::vector<unsigned_id_type> from_;
+    std::vector<unsigned_id_type> to_;
+
+    /**
+     * Index of the edge with uid i in uids_. Uids are dense as in the geometry store so they index a vector.
+     */
+    std::vector<uint32_t> uid_edges_;
+
+    /**
+     * Cosine of the latitude the projection is made for.
+     */
+    double reference_cos_;
+    double min_x_;
+    double min_y_;
+    double cell_size_;
+    size_t column_count_;
+    size_t row_count_;
+
+    /**
+     * Segments of cell i are in cell_segments_[cell_offsets_[i], cell_offsets_[i + 1]).
+     */
+    std::vector<uint32_t> cell_offsets_;
+    std::vector<Segment> cell_segments_;
+
+    ProjectedPoint Project(const utility::Point& p) const;
+
+    utility::Point Unproject(const ProjectedPoint& p) const;
+
+    size_t GetColumn(double x) const;
+
+    size_t GetRow(double y) const;
+
+    /**
+     * Call f(column, row) for each cell in the grid whose Chebyshev distance from the cell
+     * (column, row) is exactly `radius`.
+     */
+    template <typename Function>
+    void ForEachCellInRing(size_t column, size_t row, size_t radius, const Function& f) const;
+
+    /**
+     * Call f(edge, first_point, a, b) for each segment a-b of each edge.
+     */
+    template <typename Function>
+    void ForEachSegment(const Function& f) const;
+
+    EdgeSplit SplitEdge(const Segment& segment, const ProjectedPoint& split_point) const;
+};
+
+}
+}
+#endif //ROUTING_SPATIAL_SEGMENT_INDEX_H
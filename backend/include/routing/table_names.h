@@ -87,6 +87,38 @@ private:
     std::string index_table_prefix_;
 };
 
+/**
+ * Customizable Contraction Hierarchies use edges of the base graph. Only the vertex ordering
+ * is computed by the preprocessor and the same ordering is used for all profiles.
+ */
+class CCHTableNames : public TableNames{
+public:
+    CCHTableNames(const std::string& base_graph_table)
+        : base_graph_table_(base_graph_table),
+            vertices_table_(Constants::AlgorithmNames::kCustomizableContractionHierarchies + base_graph_table + "vertices_"), index_table_prefix_() {}
+
+    const std::string& GetBaseTableName() const override {
+        return base_graph_table_;
+    }
+
+    const std::string& GetEdgesTable() const override {
+        return base_graph_table_;
+    }
+
+    const std::string& GetVerticesTable() const override {
+        return vertices_table_;
+    }
+
+    const std::string& GetIndexTablePrefix() const override {
+        return index_table_prefix_;
+    }
+
+private:
+    std::string base_graph_table_;
+    std::string vertices_table_;
+    std::string index_table_prefix_;
+};
+
 
 
 }
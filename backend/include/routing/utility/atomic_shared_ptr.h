@@ -0,0 +1,41 @@
+#ifndef ROUTING_UTILITY_ATOMIC_SHARED_PTR_H
+#define ROUTING_UTILITY_ATOMIC_SHARED_PTR_H
+
+#include <memory>
+
+namespace routing {
+namespace utility {
+
+/**
+ * AtomicSharedPtr publishes a shared value that can be replaced while other threads read it.
+ * Readers load their own reference so a replaced value lives until its last reader releases it
+ * (read-copy-update) and readers never wait for a replacement to be built.
+ */
+template <typename T>
+class AtomicSharedPtr {
+public:
+    AtomicSharedPtr(const std::shared_ptr<T>& value) : value_(value) {}
+
+    AtomicSharedPtr(std::shared_ptr<T>&& value) : value_(std::move(value)) {}
+
+    AtomicSharedPtr(const AtomicSharedPtr& other) = delete;
+    AtomicSharedPtr& operator=(const AtomicSharedPtr& other) = delete;
+
+    std::shared_ptr<T> Load() const {
+        return std::atomic_load(&value_);
+    }
+
+    /**
+     * Publish `value` and return the previous one.
+     */
+    std::shared_ptr<T> Exchange(const std::shared_ptr<T>& value) {
+        return std::atomic_exchange(&value_, value);
+    }
+
+private:
+    std::shared_ptr<T> value_;
+};
+
+}
+}
+#endif //ROUTING_UTILITY_ATOMIC_SHARED_PTR_H
@@ -0,0 +1,70 @@
+#ifndef ROUTING_UTILITY_BACKGROUND_TASK_H
+#define ROUTING_UTILITY_BACKGROUND_TASK_H
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+namespace routing {
+namespace utility {
+
+/**
+ * BackgroundTask runs a long task on its own thread, e.g. reloading graphs. At most one run
+ * of the task is in progress - it is not started again until the previous run finishes.
+ */
+class BackgroundTask {
+public:
+    /**
+     * @param task Task that is run on each start. It must not throw.
+     */
+    BackgroundTask(std::function<void()>&& task) : task_(std::move(task)), mutex_(), thread_(), running_(false) {}
+
+    BackgroundTask(const BackgroundTask& other) = delete;
+    BackgroundTask& operator=(const BackgroundTask& other) = delete;
+
+    /**
+     * Wait for the running task.
+     */
+    ~BackgroundTask() {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    /**
+     * Start the task in the background unless it is running.
+     *
+     * @return True if the task was started.
+     */
+    bool Start() {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (running_) {
+            return false;
+        }
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        running_ = true;
+        thread_ = std::thread{[this]() {
+            task_();
+            running_ = false;
+        }};
+        return true;
+    }
+
+    bool IsRunning() const {
+        return running_;
+    }
+
+private:
+    std::function<void()> task_;
+    std::mutex mutex_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+};
+
+}
+}
+#endif //ROUTING_UTILITY_BACKGROUND_TASK_H
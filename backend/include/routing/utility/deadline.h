@@ -0,0 +1,75 @@
+#ifndef ROUTING_UTILITY_DEADLINE_H
+#define ROUTING_UTILITY_DEADLINE_H
+
+#include "routing/exception.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+namespace routing {
+namespace utility {
+
+/**
+ * Deadline bounds the time of one request. A search checks it regularly and stops by TimeoutException
+ * when the deadline expires or the request is cancelled from another thread.
+ */
+class Deadline {
+public:
+    /**
+     * Number of settled vertices between two checks of a search. Reading the clock at each vertex would slow searches down.
+     */
+    static constexpr size_t kCheckInterval = 1024;
+
+    /**
+     * Deadline that never expires. It can still be cancelled.
+     */
+    Deadline() : expiration_(std::chrono::steady_clock::time_point::max()), cancelled_(false) {}
+
+    /**
+     * @param timeout Time from now until the deadline expires. Zero timeout never expires.
+     */
+    Deadline(std::chrono::milliseconds timeout)
+        : expiration_(timeout.count() > 0 ? std::chrono::steady_clock::now() + timeout : std::chrono::steady_clock::time_point::max()),
+        cancelled_(false) {}
+
+    Deadline(const Deadline& other) = delete;
+    Deadline& operator=(const Deadline& other) = delete;
+
+    /**
+     * Stop all searches that check the deadline. It can be called concurrently with them.
+     */
+    void Cancel() {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    bool IsExpired() const {
+        return cancelled_.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= expiration_;
+    }
+
+    /**
+     * @throw TimeoutException if the deadline expired.
+     */
+    void Check() const {
+        if (IsExpired()) {
+            throw TimeoutException{cancelled_.load(std::memory_order_relaxed) ? "Request was cancelled." : "Request deadline exceeded."};
+        }
+    }
+
+    /**
+     * Check the deadline if `settled_vertex_count` is a multiple of the check interval. Null deadline is never checked.
+     */
+    static void Check(const Deadline* deadline, size_t settled_vertex_count) {
+        if (deadline && settled_vertex_count % kCheckInterval == 0) {
+            deadline->Check();
+        }
+    }
+
+private:
+    std::chrono::steady_clock::time_point expiration_;
+    std::atomic<bool> cancelled_;
+};
+
+}
+}
+#endif //ROUTING_UTILITY_DEADLINE_H
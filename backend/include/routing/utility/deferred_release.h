@@ -0,0 +1,70 @@
+#ifndef ROUTING_UTILITY_DEFERRED_RELEASE_H
+#define ROUTING_UTILITY_DEFERRED_RELEASE_H
+
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+namespace routing {
+namespace utility {
+
+/**
+ * DeferredRelease owns a value and shares it by a reference whose last release does not free the value -
+ * it only signals the owner. The owner frees the value on its own thread once the shared reference and all its
+ * copies are released, so threads that use the value, e.g. requests, never pay for freeing it.
+ */
+template <typename T>
+class DeferredRelease {
+public:
+    DeferredRelease(std::shared_ptr<T>&& value) : value_(std::move(value)), signal_(std::make_shared<Signal>()), shared_(false) {}
+
+    DeferredRelease(const DeferredRelease& other) = delete;
+    DeferredRelease& operator=(const DeferredRelease& other) = delete;
+
+    /**
+     * Wait until the shared reference is released and free the value on this thread.
+     */
+    ~DeferredRelease() {
+        if (shared_) {
+            signal_->Wait();
+        }
+    }
+
+    /**
+     * Reference to the value whose last copy only signals the owner. It can be created once.
+     */
+    std::shared_ptr<T> Share() {
+        shared_ = true;
+        return std::shared_ptr<T>{value_.get(), [signal = signal_](T*) { signal->Notify(); }};
+    }
+
+private:
+    class Signal {
+    public:
+        Signal() : mutex_(), released_condition_(), released_(false) {}
+
+        void Notify() {
+            std::lock_guard<std::mutex> lock{mutex_};
+            released_ = true;
+            released_condition_.notify_all();
+        }
+
+        void Wait() {
+            std::unique_lock<std::mutex> lock{mutex_};
+            released_condition_.wait(lock, [this]() { return released_; });
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable released_condition_;
+        bool released_;
+    };
+
+    std::shared_ptr<T> value_;
+    std::shared_ptr<Signal> signal_;
+    bool shared_;
+};
+
+}
+}
+#endif //ROUTING_UTILITY_DEFERRED_RELEASE_H
@@ -0,0 +1,84 @@
+#ifndef ROUTING_UTILITY_EPOCH_VECTOR_H
+#define ROUTING_UTILITY_EPOCH_VECTOR_H
+
+#include "routing/types.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace routing {
+namespace utility {
+
+/**
+ * EpochVector stores values of vertices of one search in a vector addressed by vertex id.
+ *
+ * Each value is stamped with the epoch it was written in. Values with an older stamp
+ * are treated as default values so `Clear` only starts a new epoch and does not touch
+ * the vectors. The vectors grow when a vertex with a higher id is accessed.
+ *
+ * It replaces hash maps of touched vertices in searches - accessing a vertex that
+ * was not touched yet gives a default value like operator[] of a map.
+ */
+template <typename T>
+class EpochVector {
+public:
+    EpochVector() : values_(), epochs_(), epoch_(1) {}
+
+    /**
+     * Reserve memory for vertices with ids lower than `size`.
+     */
+    void Reserve(size_t size) {
+        if (size > values_.size()) {
+            values_.resize(size);
+            epochs_.resize(size, 0);
+        }
+    }
+
+    /**
+     * Make all values default.
+     */
+    void Clear() {
+        ++epoch_;
+        if (epoch_ == 0) {
+            // Stamps from the previous wrap around could be equal to new epochs.
+            std::fill(epochs_.begin(), epochs_.end(), 0);
+            epoch_ = 1;
+        }
+    }
+
+    bool Contains(unsigned_id_type vertex_id) const {
+        return vertex_id < epochs_.size() && epochs_[vertex_id] == epoch_;
+    }
+
+    /**
+     * Value of a vertex. Default value is set to the vertex if it was not touched in the current epoch.
+     */
+    T& operator[](unsigned_id_type vertex_id) {
+        if (vertex_id >= values_.size()) {
+            Reserve(std::max(static_cast<size_t>(vertex_id) + 1, 2 * values_.size()));
+        }
+        if (epochs_[vertex_id] != epoch_) {
+            values_[vertex_id] = T{};
+            epochs_[vertex_id] = epoch_;
+        }
+        return values_[vertex_id];
+    }
+
+    /**
+     * Value of a vertex or `default_value` if it was not touched in the current epoch.
+     */
+    const T& Get(unsigned_id_type vertex_id, const T& default_value) const {
+        return Contains(vertex_id) ? values_[vertex_id] : default_value;
+    }
+
+private:
+    std::vector<T> values_;
+    std::vector<std::uint32_t> epochs_;
+    std::uint32_t epoch_;
+};
+
+}
+}
+#endif //ROUTING_UTILITY_EPOCH_VECTOR_H
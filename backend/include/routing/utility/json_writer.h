@@ -0,0 +1,134 @@
+#ifndef ROUTING_UTILITY_JSON_WRITER_H
+#define ROUTING_UTILITY_JSON_WRITER_H
+
+#include <string>
+#include <cstdio>
+#include <cstddef>
+
+namespace routing {
+namespace utility {
+
+/**
+ * JsonWriter appends JSON to a string without building an intermediate document. Large strings
+ * like route geometries are escaped straight into the output so that they are copied only once.
+ * Commas between values are inserted automatically.
+ */
+class JsonWriter {
+public:
+    JsonWriter(std::string& out) : out_(out), need_comma_(false) {}
+
+    /**
+     * Size of `value` after escaping without enclosing quotes. It can be used to reserve the output at once.
+     */
+    static size_t GetEscapedSize(const std::string& value);
+
+    void Reserve(size_t size) {
+        out_.reserve(out_.size() + size);
+    }
+
+    void BeginObject() {
+        WriteComma();
+        out_ += '{';
+        need_comma_ = false;
+    }
+
+    void EndObject() {
+        out_ += '}';
+        need_comma_ = true;
+    }
+
+    void BeginArray() {
+        WriteComma();
+        out_ += '[';
+        need_comma_ = false;
+    }
+
+    void EndArray() {
+        out_ += ']';
+        need_comma_ = true;
+    }
+
+    /**
+     * Write key of the next value of an object. Keys are not escaped.
+     */
+    void Key(const char* key) {
+        WriteComma();
+        out_ += '"';
+        out_ += key;
+        out_ += "\":";
+        need_comma_ = false;
+    }
+
+    void String(const std::string& value);
+
+    void Number(double value);
+
+    void Null() {
+        WriteComma();
+        out_ += "null";
+        need_comma_ = true;
+    }
+
+private:
+    std::string& out_;
+    bool need_comma_;
+
+    void WriteComma() {
+        if (need_comma_) {
+            out_ += ',';
+        }
+    }
+
+    static bool NeedsEscape(char c) {
+        return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    }
+};
+
+inline size_t JsonWriter::GetEscapedSize(const std::string& value) {
+    size_t size = value.size();
+    for (char c : value) {
+        if (NeedsEscape(c)) {
+            // Control characters are written as \u00XX, others as a backslash and the character.
+            size += (c == '"' || c == '\\') ? 1 : 5;
+        }
+    }
+    return size;
+}
+
+inline void JsonWriter::String(const std::string& value) {
+    WriteComma();
+    out_ += '"';
+    size_t unescaped_begin = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+        char c = value[i];
+        if (!NeedsEscape(c)) {
+            continue;
+        }
+        // Runs of characters that need no escaping are appended at once.
+        out_.append(value, unescaped_begin, i - unescaped_begin);
+        if (c == '"' || c == '\\') {
+            out_ += '\\';
+            out_ += c;
+        } else {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+            out_ += escaped;
+        }
+        unescaped_begin = i + 1;
+    }
+    out_.append(value, unescaped_begin, std::string::npos);
+    out_ += '"';
+    need_comma_ = true;
+}
+
+inline void JsonWriter::Number(double value) {
+    WriteComma();
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.9g", value);
+    out_ += number;
+    need_comma_ = true;
+}
+
+}
+}
+#endif //ROUTING_UTILITY_JSON_WRITER_H
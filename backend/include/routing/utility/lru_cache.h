@@ -0,0 +1,189 @@
+#ifndef ROUTING_UTILITY_LRU_CACHE_H
+#define ROUTING_UTILITY_LRU_CACHE_H
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <cstddef>
+
+namespace routing {
+namespace utility {
+
+/**
+ * ShardedLruCache is a concurrent cache with a memory budget that removes the least recently used values
+ * when it is full. Keys are split to shards by their hash and each shard has its own lock and budget
+ * so that concurrent requests with different keys rarely wait for each other.
+ *
+ * Values are shared and immutable - a value removed from the cache lives until its last user releases it.
+ *
+ * @tparam Hash Hash of keys that is used both for selecting shards and inside shards.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedLruCache {
+public:
+    /**
+     * @param capacity Memory budget in bytes of all values. Cache with zero capacity stores nothing.
+     * @param shard_count Number of independently locked parts of the cache.
+     */
+    ShardedLruCache(size_t capacity, size_t shard_count = kDefaultShardCount);
+
+    ShardedLruCache(const ShardedLruCache& other) = delete;
+    ShardedLruCache& operator=(const ShardedLruCache& other) = delete;
+
+    static const size_t kDefaultShardCount = 16;
+
+    /**
+     * Get the value of `key` and mark it as the most recently used one.
+     *
+     * @return The value or nullptr if it is not cached.
+     */
+    std::shared_ptr<const Value> Get(const Key& key);
+
+    /**
+     * Insert or replace the value of `key`. Least recently used values of its shard are removed until the shard
+     * fits its budget. Values larger than the budget of a shard are not cached.
+     *
+     * @param size Memory used by the value in bytes.
+     */
+    void Put(const Key& key, const std::shared_ptr<const Value>& value, size_t size);
+
+    /**
+     * Remove all values. Counters are kept.
+     */
+    void Clear();
+
+    size_t get_capacity() const {
+        return capacity_;
+    }
+
+    size_t GetHitCount() const {
+        return hit_count_;
+    }
+
+    size_t GetMissCount() const {
+        return miss_count_;
+    }
+
+    /**
+     * Memory used by cached values in bytes.
+     */
+    size_t GetSize();
+
+    size_t GetEntryCount();
+
+private:
+    struct Entry {
+        Key key;
+        std::shared_ptr<const Value> value;
+        size_t size;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+
+        /**
+         * Entries from the most recently used one.
+         */
+        std::list<Entry> entries;
+        std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> positions;
+        size_t size;
+
+        Shard() : mutex(), entries(), positions(), size(0) {}
+    };
+
+    size_t capacity_;
+    size_t shard_capacity_;
+    std::vector<Shard> shards_;
+    std::atomic<size_t> hit_count_;
+    std::atomic<size_t> miss_count_;
+
+    Shard& GetShard(const Key& key) {
+        return shards_[Hash{}(key) % shards_.size()];
+    }
+};
+
+template <typename Key, typename Value, typename Hash>
+ShardedLruCache<Key, Value, Hash>::ShardedLruCache(size_t capacity, size_t shard_count)
+    : capacity_(capacity), shard_capacity_(capacity / std::max(shard_count, static_cast<size_t>(1))),
+        shards_(std::max(shard_count, static_cast<size_t>(1))), hit_count_(0), miss_count_(0) {}
+
+template <typename Key, typename Value, typename Hash>
+std::shared_ptr<const Value> ShardedLruCache<Key, Value, Hash>::Get(const Key& key) {
+    if (shard_capacity_ == 0) {
+        ++miss_count_;
+        return nullptr;
+    }
+    Shard& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock{shard.mutex};
+    auto&& it = shard.positions.find(key);
+    if (it == shard.positions.end()) {
+        ++miss_count_;
+        return nullptr;
+    }
+    ++hit_count_;
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    return it->second->value;
+}
+
+template <typename Key, typename Value, typename Hash>
+void ShardedLruCache<Key, Value, Hash>::Put(const Key& key, const std::shared_ptr<const Value>& value, size_t size) {
+    if (shard_capacity_ == 0 || size > shard_capacity_) {
+        return;
+    }
+    Shard& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock{shard.mutex};
+    auto&& it = shard.positions.find(key);
+    if (it != shard.positions.end()) {
+        shard.size -= it->second->size;
+        shard.entries.erase(it->second);
+        shard.positions.erase(it);
+    }
+    shard.entries.push_front(Entry{key, value, size});
+    shard.positions.emplace(key, shard.entries.begin());
+    shard.size += size;
+    while (shard.size > shard_capacity_) {
+        Entry& last = shard.entries.back();
+        shard.size -= last.size;
+        shard.positions.erase(last.key);
+        shard.entries.pop_back();
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+void ShardedLruCache<Key, Value, Hash>::Clear() {
+    for (auto&& shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard.mutex};
+        shard.positions.clear();
+        shard.entries.clear();
+        shard.size = 0;
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+size_t ShardedLruCache<Key, Value, Hash>::GetSize() {
+    size_t size = 0;
+    for (auto&& shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard.mutex};
+        size += shard.size;
+    }
+    return size;
+}
+
+template <typename Key, typename Value, typename Hash>
+size_t ShardedLruCache<Key, Value, Hash>::GetEntryCount() {
+    size_t count = 0;
+    for (auto&& shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard.mutex};
+        count += shard.entries.size();
+    }
+    return count;
+}
+
+}
+}
+#endif //ROUTING_UTILITY_LRU_CACHE_H
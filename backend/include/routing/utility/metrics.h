@@ -0,0 +1,186 @@
+#ifndef ROUTING_UTILITY_METRICS_H
+#define ROUTING_UTILITY_METRICS_H
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <ostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+namespace routing {
+namespace utility {
+
+/**
+ * Counter is a monotonic count of events. It can be incremented concurrently without locks.
+ */
+class Counter {
+public:
+    Counter() : value_(0) {}
+
+    Counter(const Counter& other) = delete;
+    Counter& operator=(const Counter& other) = delete;
+
+    void Increment(uint64_t value = 1) {
+        value_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t Get() const {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value_;
+};
+
+/**
+ * Histogram counts observed values in buckets with fixed upper bounds and sums them.
+ * Values can be observed concurrently without locks.
+ */
+class Histogram {
+public:
+    /**
+     * @param bounds Increasing upper bounds of buckets. Values above the last bound are in an implicit +Inf bucket.
+     */
+    Histogram(const std::vector<double>& bounds);
+
+    Histogram(const Histogram& other) = delete;
+    Histogram& operator=(const Histogram& other) = delete;
+
+    void Observe(double value);
+
+    const std::vector<double>& get_bounds() const {
+        return bounds_;
+    }
+
+    /**
+     * Number of observed values that are not greater than the bound of bucket `i`. Bucket `bounds.size()` is +Inf.
+     */
+    uint64_t GetCumulativeCount(size_t i) const;
+
+    uint64_t GetCount() const {
+        return GetCumulativeCount(bounds_.size());
+    }
+
+    double GetSum() const {
+        return sum_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<double> bounds_;
+
+    /**
+     * Observed values of each bucket - not cumulative.
+     */
+    std::vector<std::atomic<uint64_t>> counts_;
+    std::atomic<double> sum_;
+};
+
+/**
+ * Bucket bounds in seconds suitable for durations of parts of a request.
+ */
+inline std::vector<double> LatencyBuckets() {
+    return {0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+}
+
+/**
+ * Stopwatch measures durations of consecutive parts of a computation.
+ */
+class Stopwatch {
+public:
+    Stopwatch() : last_(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @return Seconds since the last lap or creation of the stopwatch.
+     */
+    double Lap() {
+        auto&& now = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed = now - last_;
+        last_ = now;
+        return elapsed.count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point last_;
+};
+
+/**
+ * PrometheusWriter writes metrics in Prometheus text exposition format.
+ * Each metric family starts with `WriteHeader` followed by its samples.
+ */
+class PrometheusWriter {
+public:
+    PrometheusWriter(std::ostream& out) : out_(out) {}
+
+    /**
+     * @param type Prometheus type of the family - counter, gauge or histogram.
+     */
+    void WriteHeader(const std::string& name, const std::string& help, const std::string& type) {
+        out_ << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+    }
+
+    /**
+     * @param labels Labels of the sample without braces, e.g. `stage="search"`. Empty if there are none.
+     */
+    void WriteCounter(const std::string& name, const std::string& labels, const Counter& counter) {
+        WriteSample(name, labels, counter.Get());
+    }
+
+    void WriteGauge(const std::string& name, const std::string& labels, double value) {
+        WriteSample(name, labels, value);
+    }
+
+    void WriteHistogram(const std::string& name, const std::string& labels, const Histogram& histogram);
+
+private:
+    std::ostream& out_;
+
+    template <typename Value>
+    void WriteSample(const std::string& name, const std::string& labels, Value value) {
+        out_ << name;
+        if (!labels.empty()) {
+            out_ << "{" << labels << "}";
+        }
+        out_ << " " << value << "\n";
+    }
+};
+
+inline Histogram::Histogram(const std::vector<double>& bounds)
+    : bounds_(bounds), counts_(bounds.size() + 1), sum_(0) {}
+
+inline void Histogram::Observe(double value) {
+    size_t bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+    counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+    double sum = sum_.load(std::memory_order_relaxed);
+    while (!sum_.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {}
+}
+
+inline uint64_t Histogram::GetCumulativeCount(size_t i) const {
+    uint64_t count = 0;
+    for (size_t b = 0; b <= i && b < counts_.size(); ++b) {
+        count += counts_[b].load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+inline void PrometheusWriter::WriteHistogram(const std::string& name, const std::string& labels, const Histogram& histogram) {
+    std::string separator = labels.empty() ? "" : ",";
+    auto&& bounds = histogram.get_bounds();
+    for (size_t i = 0; i <= bounds.size(); ++i) {
+        out_ << name << "_bucket{" << labels << separator << "le=\"";
+        if (i < bounds.size()) {
+            out_ << bounds[i];
+        } else {
+            out_ << "+Inf";
+        }
+        out_ << "\"} " << histogram.GetCumulativeCount(i) << "\n";
+    }
+    WriteSample(name + "_sum", labels, histogram.GetSum());
+    WriteSample(name + "_count", labels, histogram.GetCount());
+}
+
+}
+}
+#endif //ROUTING_UTILITY_METRICS_H
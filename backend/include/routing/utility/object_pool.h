@@ -0,0 +1,78 @@
+#ifndef ROUTING_UTILITY_OBJECT_POOL_H
+#define ROUTING_UTILITY_OBJECT_POOL_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+
+namespace routing {
+namespace utility {
+
+/**
+ * ObjectPool keeps objects that are expensive to create (e.g. search workspaces) so that
+ * they can be reused by later requests. Each object is used by one thread at a time - it is
+ * taken out of the pool by `Acquire` and returned when the handle is destroyed.
+ *
+ * The pool must outlive all handles it gave out.
+ */
+template <typename T>
+class ObjectPool {
+    class Returner;
+public:
+    using Handle = std::unique_ptr<T, Returner>;
+
+    ObjectPool() : mutex_(), objects_() {}
+
+    /**
+     * Take an object from the pool or create a new one if the pool is empty.
+     */
+    Handle Acquire() {
+        std::unique_ptr<T> object{};
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (!objects_.empty()) {
+                object = std::move(objects_.back());
+                objects_.pop_back();
+            }
+        }
+        if (!object) {
+            object = std::make_unique<T>();
+        }
+        return Handle{object.release(), Returner{this}};
+    }
+
+    size_t GetSize() {
+        std::lock_guard<std::mutex> lock{mutex_};
+        return objects_.size();
+    }
+
+private:
+    class Returner {
+    public:
+        Returner() : pool_(nullptr) {}
+
+        Returner(ObjectPool* pool) : pool_(pool) {}
+
+        void operator()(T* object) const {
+            if (pool_) {
+                pool_->Return(std::unique_ptr<T>{object});
+            } else {
+                delete object;
+            }
+        }
+    private:
+        ObjectPool* pool_;
+    };
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<T>> objects_;
+
+    void Return(std::unique_ptr<T>&& object) {
+        std::lock_guard<std::mutex> lock{mutex_};
+        objects_.push_back(std::move(object));
+    }
+};
+
+}
+}
+#endif //ROUTING_UTILITY_OBJECT_POOL_H
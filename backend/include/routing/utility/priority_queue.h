@@ -0,0 +1,246 @@
+#ifndef ROUTING_UTILITY_PRIORITY_QUEUE_H
+#define ROUTING_UTILITY_PRIORITY_QUEUE_H
+
+#include "routing/types.h"
+
+#include "tsl/robin_map.h"
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+
+namespace routing {
+namespace utility {
+
+/**
+ * Member of a priority queue of vertices - id of a vertex and its cost.
+ */
+struct QueueMember {
+    float cost;
+    unsigned_id_type vertex_id;
+
+    QueueMember() : cost(std::numeric_limits<float>::max()), vertex_id(0) {}
+
+    QueueMember(float c, unsigned_id_type v) : cost(c), vertex_id(v) {}
+};
+
+/**
+ * IndexedDaryHeap is a min priority queue of vertices with decrease-key.
+ *
+ * Position of each vertex in the heap is stored in a vector addressed by vertex id
+ * so vertices have to be dense numbers. The vector only grows and is reused by all
+ * searches that use the same heap - `Clear` is proportional to the number of vertices
+ * left in the heap.
+ *
+ * @tparam Arity Number of children of each node. Four children make the heap shallower than
+ *      a binary heap while all children of a node still share a cache line.
+ */
+template <size_t Arity = 4>
+class IndexedDaryHeap {
+public:
+    IndexedDaryHeap() : heap_(), positions_() {}
+
+    bool Empty() const {
+        return heap_.empty();
+    }
+
+    size_t Size() const {
+        return heap_.size();
+    }
+
+    void Clear();
+
+    bool Contains(unsigned_id_type vertex_id) const {
+        return vertex_id < positions_.size() && positions_[vertex_id] != kNotInHeap;
+    }
+
+    /**
+     * Insert vertex to the queue or decrease its cost if it is already there.
+     * Cost of a vertex in the queue must not increase.
+     */
+    void Push(unsigned_id_type vertex_id, float cost);
+
+    const QueueMember& Top() const {
+        assert(!Empty());
+        return heap_.front();
+    }
+
+    QueueMember Pop();
+
+private:
+    static constexpr size_t kNotInHeap = std::numeric_limits<size_t>::max();
+
+    std::vector<QueueMember> heap_;
+
+    /**
+     * Index of each vertex in `heap_` or kNotInHeap.
+     */
+    std::vector<size_t> positions_;
+
+    void SiftUp(size_t position);
+
+    void SiftDown(size_t position);
+
+    void Place(const QueueMember& member, size_t position) {
+        heap_[position] = member;
+        positions_[member.vertex_id] = position;
+    }
+};
+
+template <size_t Arity>
+void IndexedDaryHeap<Arity>::Clear() {
+    for (auto&& member : heap_) {
+        positions_[member.vertex_id] = kNotInHeap;
+    }
+    heap_.clear();
+}
+
+template <size_t Arity>
+void IndexedDaryHeap<Arity>::Push(unsigned_id_type vertex_id, float cost) {
+    if (vertex_id >= positions_.size()) {
+        positions_.resize(std::max(static_cast<size_t>(vertex_id) + 1, 2 * positions_.size()), kNotInHeap);
+    }
+    size_t position = positions_[vertex_id];
+    if (position == kNotInHeap) {
+        heap_.emplace_back(cost, vertex_id);
+        position = heap_.size() - 1;
+        positions_[vertex_id] = position;
+    } else {
+        assert(cost <= heap_[position].cost);
+        heap_[position].cost = cost;
+    }
+    SiftUp(position);
+}
+
+template <size_t Arity>
+QueueMember IndexedDaryHeap<Arity>::Pop() {
+    assert(!Empty());
+    QueueMember top = heap_.front();
+    positions_[top.vertex_id] = kNotInHeap;
+    QueueMember last = heap_.back();
+    heap_.pop_back();
+    if (!heap_.empty()) {
+        Place(last, 0);
+        SiftDown(0);
+    }
+    return top;
+}
+
+template <size_t Arity>
+void IndexedDaryHeap<Arity>::SiftUp(size_t position) {
+    QueueMember member = heap_[position];
+    while (position > 0) {
+        size_t parent = (position - 1) / Arity;
+        if (heap_[parent].cost <= member.cost) {
+            break;
+        }
+        Place(heap_[parent], position);
+        position = parent;
+    }
+    Place(member, position);
+}
+
+template <size_t Arity>
+void IndexedDaryHeap<Arity>::SiftDown(size_t position) {
+    QueueMember member = heap_[position];
+    size_t size = heap_.size();
+    while (true) {
+        size_t first_child = Arity * position + 1;
+        if (first_child >= size) {
+            break;
+        }
+        size_t last_child = std::min(first_child + Arity, size);
+        size_t min_child = first_child;
+        for (size_t child = first_child + 1; child < last_child; ++child) {
+            if (heap_[child].cost < heap_[min_child].cost) {
+                min_child = child;
+            }
+        }
+        if (member.cost <= heap_[min_child].cost) {
+            break;
+        }
+        Place(heap_[min_child], position);
+        position = min_child;
+    }
+    Place(member, position);
+}
+
+/**
+ * LazyBinaryHeap is a min priority queue of vertices without decrease-key.
+ *
+ * Pushing a vertex with a lower cost adds a new member to std::priority_queue and
+ * the old members are skipped when they get to the top of the queue. It has the same
+ * interface as IndexedDaryHeap so that they can be swapped (and benchmarked) in search algorithms.
+ */
+class LazyBinaryHeap {
+public:
+    LazyBinaryHeap() : queue_(), costs_() {}
+
+    bool Empty() {
+        RemoveDeadMembers();
+        return queue_.empty();
+    }
+
+    size_t Size() const {
+        return costs_.size();
+    }
+
+    void Clear() {
+        queue_ = PriorityQueue{};
+        costs_.clear();
+    }
+
+    bool Contains(unsigned_id_type vertex_id) const {
+        return costs_.contains(vertex_id);
+    }
+
+    void Push(unsigned_id_type vertex_id, float cost) {
+        costs_.insert_or_assign(vertex_id, cost);
+        queue_.emplace(cost, vertex_id);
+    }
+
+    const QueueMember& Top() {
+        RemoveDeadMembers();
+        assert(!queue_.empty());
+        return queue_.top();
+    }
+
+    QueueMember Pop() {
+        QueueMember top = Top();
+        queue_.pop();
+        costs_.erase(top.vertex_id);
+        return top;
+    }
+
+private:
+    struct MinQueueComparator {
+        bool operator() (const QueueMember& a , const QueueMember& b) const {
+            return a.cost > b.cost;
+        }
+    };
+
+    using PriorityQueue = std::priority_queue<QueueMember, std::vector<QueueMember>, MinQueueComparator>;
+    PriorityQueue queue_;
+
+    /**
+     * Current costs of vertices in the queue. Members with different costs are dead.
+     */
+    tsl::robin_map<unsigned_id_type, float> costs_;
+
+    void RemoveDeadMembers() {
+        while (!queue_.empty()) {
+            auto&& it = costs_.find(queue_.top().vertex_id);
+            if (it != costs_.end() && it->second == queue_.top().cost) {
+                return;
+            }
+            queue_.pop();
+        }
+    }
+};
+
+}
+}
+#endif //ROUTING_UTILITY_PRIORITY_QUEUE_H
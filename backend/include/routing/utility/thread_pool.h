@@ -0,0 +1,160 @@
+#ifndef ROUTING_UTILITY_THREAD_POOL_H
+#define ROUTING_UTILITY_THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <cstddef>
+
+namespace routing {
+namespace utility {
+
+/**
+ * ThreadPool keeps worker threads that run independent tasks of requests, e.g. routes of one batch request.
+ * Threads are created once so requests do not pay for creating them.
+ *
+ * Any number of threads can use the pool at once - their tasks are queued and taken by free workers.
+ * Tasks can call `ParallelFor` too since the caller never waits for queued tasks that have not started.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param thread_count Number of worker threads. The thread that calls `ParallelFor` works too.
+     */
+    ThreadPool(size_t thread_count);
+
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    /**
+     * Finish the queued tasks and stop workers.
+     */
+    ~ThreadPool();
+
+    size_t GetThreadCount() const {
+        return threads_.size();
+    }
+
+    /**
+     * Call f(i) for each i from 0 to `count` - 1 on workers and the calling thread and wait until all calls finish.
+     * The first exception thrown by f stops remaining calls and is rethrown.
+     */
+    void ParallelFor(size_t count, const std::function<void(size_t)>& f);
+
+private:
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable task_added_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopped_;
+
+    void Work();
+};
+
+inline ThreadPool::ThreadPool(size_t thread_count) : threads_(), mutex_(), task_added_(), tasks_(), stopped_(false) {
+    threads_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads_.emplace_back([this]() {
+            Work();
+        });
+    }
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopped_ = true;
+    }
+    task_added_.notify_all();
+    for (auto&& thread : threads_) {
+        thread.join();
+    }
+}
+
+inline void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& f) {
+    struct Job {
+        std::atomic<size_t> next;
+        size_t running;
+        std::exception_ptr exception;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto&& job = std::make_shared<Job>();
+    job->next = 0;
+    job->running = 0;
+    // Calls are taken one by one so that expensive calls do not block the rest.
+    auto&& run = [job, count, &f]() {
+        try {
+            for (size_t i = job->next++; i < count; i = job->next++) {
+                f(i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock{job->mutex};
+            if (!job->exception) {
+                job->exception = std::current_exception();
+            }
+            job->next = count;
+        }
+    };
+    auto&& help = [job, count, run]() {
+        {
+            // All calls may be taken before the helper starts - then `f` may not exist anymore.
+            std::lock_guard<std::mutex> lock{job->mutex};
+            if (job->next >= count) {
+                return;
+            }
+            ++job->running;
+        }
+        run();
+        std::lock_guard<std::mutex> lock{job->mutex};
+        if (--job->running == 0) {
+            job->finished.notify_one();
+        }
+    };
+    size_t helper_count = count > 0 ? std::min(threads_.size(), count - 1) : 0;
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        for (size_t i = 0; i < helper_count; ++i) {
+            tasks_.emplace_back(help);
+        }
+    }
+    task_added_.notify_all();
+    run();
+    // Only helpers that already run calls are waited for.
+    std::unique_lock<std::mutex> lock{job->mutex};
+    job->finished.wait(lock, [&]() {
+        return job->running == 0;
+    });
+    if (job->exception) {
+        std::rethrow_exception(job->exception);
+    }
+}
+
+inline void ThreadPool::Work() {
+    while (true) {
+        std::function<void()> task{};
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            task_added_.wait(lock, [&]() {
+                return stopped_ || !tasks_.empty();
+            });
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+}
+}
+#endif //ROUTING_UTILITY_THREAD_POOL_H
@@ -0,0 +1,62 @@
+#ifndef ROUTING_UTILITY_WORKER_THREADS_H
+#define ROUTING_UTILITY_WORKER_THREADS_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <functional>
+#include <algorithm>
+#include <cstddef>
+
+namespace routing {
+namespace utility {
+
+/**
+ * Call f(worker_index, i) for all i in [0, count) on at most `worker_count` new threads that take indices one by one.
+ * Calls with the same worker index are never concurrent, so each worker can own its state, e.g. a search workspace.
+ * A single worker runs on the calling thread.
+ *
+ * Unlike ThreadPool it is meant for long preprocessing tasks whose workers need their own state.
+ * The first exception thrown by f stops workers from taking more indices and is rethrown.
+ */
+inline void RunOnWorkerThreads(size_t worker_count, size_t count, const std::function<void(size_t, size_t)>& f) {
+    worker_count = std::min(worker_count, count);
+    if (worker_count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            f(0, i);
+        }
+        return;
+    }
+    std::atomic<size_t> next_index{0};
+    std::exception_ptr exception{};
+    std::mutex exception_mutex{};
+    std::vector<std::thread> threads{};
+    threads.reserve(worker_count);
+    for (size_t w = 0; w < worker_count; ++w) {
+        threads.emplace_back([&, w]() {
+            try {
+                for (size_t i = next_index++; i < count; i = next_index++) {
+                    f(w, i);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock{exception_mutex};
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+                next_index = count;
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+}
+}
+#endif //ROUTING_UTILITY_WORKER_THREADS_H
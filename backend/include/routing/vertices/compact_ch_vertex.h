@@ -0,0 +1,119 @@
+#ifndef ROUTING_VERTICES_COMPACT_CH_VERTEX_H
+#define ROUTING_VERTICES_COMPACT_CH_VERTEX_H
+
+#include "routing/edge_ranges/compact_edge_range.h"
+#include "routing/exception.h"
+#include "routing/types.h"
+
+#include <limits>
+#include <functional>
+
+namespace routing {
+
+/**
+ * Vertex of CompactCHSearchGraph. Its edges are in CompactEdges and are created
+ * only when they are iterated so edges are given to functions by value.
+ */
+template <typename Edge>
+class CompactCHVertex {
+public:
+    using EdgeRange = CompactEdgeRange<Edge>;
+
+    CompactCHVertex() : edges_(), uid_(0), ordering_rank_(0) {}
+
+    CompactCHVertex(unsigned_id_type uid, EdgeRange&& edges, unsigned_id_type ordering_rank)
+        : edges_(std::move(edges)), uid_(uid), ordering_rank_(ordering_rank) {}
+
+    inline unsigned_id_type get_uid() const {
+        return uid_;
+    }
+
+    inline unsigned_id_type get_ordering_rank() const {
+        return ordering_rank_;
+    }
+
+    inline typename EdgeRange::View get_edges() const {
+        return edges_.GetView(uid_);
+    }
+
+    void ForEachEdge(const std::function<void(Edge&)>& f) const;
+
+    void ForEachBackwardEdge(const std::function<void(Edge&)>& f) const;
+
+    /**
+     * Find the shortest forward edge that satisfies `f`.
+     */
+    Edge FindEdge(const std::function<bool(const Edge&)>& f) const;
+
+    /**
+     * Find the shortest backward edge that satisfies `f`.
+     */
+    Edge FindBackwardEdge(const std::function<bool(const Edge&)>& f) const;
+
+private:
+    EdgeRange edges_;
+    unsigned_id_type uid_;
+    unsigned_id_type ordering_rank_;
+};
+
+template <typename Edge>
+void CompactCHVertex<Edge>::ForEachEdge(const std::function<void(Edge&)>& f) const {
+    auto&& edges = edges_.get_edges();
+    for (size_t i = edges_.begin(); i < edges_.end(); ++i) {
+        if (edges.IsForward(i)) {
+            Edge edge = edges.CreateEdge(i, uid_);
+            f(edge);
+        }
+    }
+}
+
+template <typename Edge>
+void CompactCHVertex<Edge>::ForEachBackwardEdge(const std::function<void(Edge&)>& f) const {
+    auto&& edges = edges_.get_edges();
+    for (size_t i = edges_.begin(); i < edges_.end(); ++i) {
+        if (edges.IsBackward(i)) {
+            Edge edge = edges.CreateEdge(i, uid_);
+            f(edge);
+        }
+    }
+}
+
+template <typename Edge>
+Edge CompactCHVertex<Edge>::FindEdge(const std::function<bool(const Edge&)>& f) const {
+    float min_length = std::numeric_limits<float>::max();
+    Edge result{};
+    bool found = false;
+    ForEachEdge([&](Edge& e) {
+        if (f(e) && e.get_length() < min_length) {
+            min_length = e.get_length();
+            result = e;
+            found = true;
+        }
+    });
+    if (!found) {
+        throw EdgeNotFoundException("Forward edge not found ");
+    }
+    return result;
+}
+
+template <typename Edge>
+Edge CompactCHVertex<Edge>::FindBackwardEdge(const std::function<bool(const Edge&)>& f) const {
+    float min_length = std::numeric_limits<float>::max();
+    Edge result{};
+    bool found = false;
+    ForEachBackwardEdge([&](Edge& e) {
+        if (f(e) && e.get_length() < min_length) {
+            min_length = e.get_length();
+            result = e;
+            found = true;
+        }
+    });
+    if (!found) {
+        throw EdgeNotFoundException("Backward edge not found ");
+    }
+    return result;
+}
+
+}
+
+#endif //ROUTING_VERTICES_COMPACT_CH_VERTEX_H
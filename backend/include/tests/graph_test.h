@@ -187,4 +187,40 @@ void TestBidirectedSearchGraph(G& graph) {
 }
 
 
+/**
+ * Grid of `rows` x `columns` vertices whose rows are twoway streets and columns are oneway streets
+ * with alternating directions. Vertex in `row` and `column` has id 1 + row * columns + column.
+ * Edges get consecutive uids from `first_uid` and lengths from 1 to 13 given by their uids.
+ *
+ * @param add_edge Called as add_edge(uid, from, to, length, twoway) for each edge.
+ * @return Uid following the uid of the last edge.
+ */
+template <typename AddEdge>
+routing::unsigned_id_type TestOnewayGrid(routing::unsigned_id_type rows, routing::unsigned_id_type columns, routing::unsigned_id_type first_uid,
+        const AddEdge& add_edge) {
+        routing::unsigned_id_type uid = first_uid;
+        auto&& get_vertex = [=](routing::unsigned_id_type row, routing::unsigned_id_type column) {
+                return 1 + row * columns + column;
+        };
+        auto&& add = [&](routing::unsigned_id_type from, routing::unsigned_id_type to, bool twoway) {
+                add_edge(uid, from, to, static_cast<float>(1 + (uid * 7919) % 13), twoway);
+                ++uid;
+        };
+        for (routing::unsigned_id_type row = 0; row < rows; ++row) {
+                for (routing::unsigned_id_type column = 0; column < columns; ++column) {
+                        if (column + 1 < columns) {
+                                add(get_vertex(row, column), get_vertex(row, column + 1), true);
+                        }
+                        if (row + 1 < rows) {
+                                if (column % 2 == 0) {
+                                        add(get_vertex(row, column), get_vertex(row + 1, column), false);
+                                } else {
+                                        add(get_vertex(row + 1, column), get_vertex(row, column), false);
+                                }
+                        }
+                }
+        }
+        return uid;
+}
+
 #endif // TESTS_GRAPH_TEST_H
@@ -0,0 +1,172 @@
+#include "routing/bench/http_client.h"
+
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <cctype>
+#include <cstdio>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+namespace routing {
+namespace bench {
+
+/**
+ * Thrown when the kept-alive connection was closed by the server before the response started.
+ * The request can be sent again over a new connection.
+ */
+class ConnectionClosed : public std::runtime_error {
+public:
+    ConnectionClosed() : std::runtime_error("Connection closed by the server.") {}
+};
+
+HttpClient::HttpClient(const std::string& host, int port) : host_(host), port_(port), socket_(-1) {}
+
+HttpClient::~HttpClient() {
+    Close();
+}
+
+int HttpClient::Get(const std::string& target, std::string& body) {
+    std::string request = "GET " + target + " HTTP/1.1\r\nHost: " + host_ + "\r\nConnection: keep-alive\r\n\r\n";
+    for (size_t attempt = 0; ; ++attempt) {
+        if (socket_ < 0) {
+            Connect();
+        }
+        try {
+            if (!Send(request)) {
+                throw ConnectionClosed{};
+            }
+            std::string buffer{};
+            size_t header_end = std::string::npos;
+            while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                size_t size = buffer.size();
+                ReadAtLeast(buffer, size + 1);
+                if (buffer.size() == size) {
+                    throw ConnectionClosed{};
+                }
+            }
+            std::string headers = buffer.substr(0, header_end);
+            int status = 0;
+            if (std::sscanf(headers.c_str(), "HTTP/%*s %d", &status) != 1) {
+                throw std::runtime_error("Malformed HTTP response.");
+            }
+            std::string lower_headers = headers;
+            for (auto&& c : lower_headers) {
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            size_t length_position = lower_headers.find("\r\ncontent-length:");
+            size_t body_begin = header_end + 4;
+            if (length_position != std::string::npos) {
+                size_t length = std::stoul(headers.substr(length_position + std::strlen("\r\ncontent-length:")));
+                ReadAtLeast(buffer, body_begin + length);
+                if (buffer.size() < body_begin + length) {
+                    throw std::runtime_error("Response body is shorter than its content length.");
+                }
+                body = buffer.substr(body_begin, length);
+            } else {
+                // Without content length the body ends with the connection.
+                size_t size = 0;
+                do {
+                    size = buffer.size();
+                    ReadAtLeast(buffer, size + 1);
+                } while (buffer.size() > size);
+                body = buffer.substr(body_begin);
+                Close();
+            }
+            if (lower_headers.find("\r\nconnection: close") != std::string::npos) {
+                Close();
+            }
+            return status;
+        } catch (const ConnectionClosed&) {
+            Close();
+            // The server may close an idle kept-alive connection so the request is sent once more.
+            if (attempt > 0) {
+                throw;
+            }
+        }
+    }
+}
+
+std::string HttpClient::UrlEncode(const std::string& value) {
+    static const char* kHex = "0123456789ABCDEF";
+    std::string encoded{};
+    encoded.reserve(value.size() * 3);
+    for (char c : value) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (std::isalnum(u) || c == '-' || c == '_' || c == '.' || c == '~') {
+            encoded += c;
+        } else {
+            encoded += '%';
+            encoded += kHex[u >> 4];
+            encoded += kHex[u & 15];
+        }
+    }
+    return encoded;
+}
+
+void HttpClient::Connect() {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    int error = getaddrinfo(host_.c_str(), std::to_string(port_).c_str(), &hints, &addresses);
+    if (error != 0) {
+        throw std::runtime_error("Cannot resolve " + host_ + ": " + gai_strerror(error));
+    }
+    for (addrinfo* address = addresses; address; address = address->ai_next) {
+        int s = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (s < 0) {
+            continue;
+        }
+        if (connect(s, address->ai_addr, address->ai_addrlen) == 0) {
+            // Requests are small and latency is measured so they must not wait for more data.
+            int flag = 1;
+            setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+            socket_ = s;
+            break;
+        }
+        close(s);
+    }
+    freeaddrinfo(addresses);
+    if (socket_ < 0) {
+        throw std::runtime_error("Cannot connect to " + host_ + ":" + std::to_string(port_) + ".");
+    }
+}
+
+void HttpClient::Close() {
+    if (socket_ >= 0) {
+        close(socket_);
+        socket_ = -1;
+    }
+}
+
+bool HttpClient::Send(const std::string& request) {
+    size_t sent = 0;
+    while (sent < request.size()) {
+        ssize_t n = send(socket_, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void HttpClient::ReadAtLeast(std::string& buffer, size_t size) {
+    char chunk[16384];
+    while (buffer.size() < size) {
+        ssize_t n = recv(socket_, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            return;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+}
+
+}
+}
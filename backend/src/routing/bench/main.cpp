@@ -0,0 +1,305 @@
+#include "routing/bench/workload.h"
+#include "routing/bench/bench_report.h"
+#include "routing/bench/http_client.h"
+#include "routing/query/mode_loader.h"
+#include "routing/query/router_metrics.h"
+#include "routing/configuration_parser.h"
+#include "routing/profile/profile.h"
+#include "routing/utility/point.h"
+#include "routing/utility/metrics.h"
+#include "routing/utility/deadline.h"
+#include "routing/exception.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+
+using namespace routing;
+using namespace bench;
+
+/**
+ * Query function of one worker thread. It throws if the query fails.
+ */
+using RunQuery = std::function<void(const BenchQuery&)>;
+
+/**
+ * Creates query function of a worker thread so that each thread can have its own state, e.g. a connection.
+ */
+using CreateWorker = std::function<RunQuery()>;
+
+static const char* kUsage =
+    "Arguments:\n"
+    "  --config PATH          Route in-process with graphs loaded by the configuration of the routing server.\n"
+    "  --server HOST:PORT     Send requests to a running routing server instead.\n"
+    "  --workload PATH        Replay workload with lines source_lon,source_lat,target_lon,target_lat,preferences.\n"
+    "  --generate COUNT       Generate workload of COUNT random queries instead.\n"
+    "  --bbox MIN_LON,MIN_LAT,MAX_LON,MAX_LAT  Area of generated endpoints.\n"
+    "  --seed N               Seed of the generated workload, 1 by default.\n"
+    "  --profile PREFERENCES  Preferences of generated queries, e.g. green:1|peak_distance:0.5. It can be repeated.\n"
+    "  --save-workload PATH   Write the workload so that it can be replayed.\n"
+    "  --concurrency N        Number of threads that send queries, 1 by default.\n"
+    "  --warmup N             Queries run before measuring, 0 by default.\n"
+    "  --format csv|json      Format of the report, csv by default.\n"
+    "  --output PATH          File of the report, standard output by default.\n"
+    "  --label NAME           Name of the run in the report.\n";
+
+/**
+ * Parse `--name value` arguments. Options that can be repeated keep all their values.
+ */
+static std::map<std::string, std::vector<std::string>> ParseArguments(int argc, const char** argv);
+
+/**
+ * Get the last value of option `name` or `default_value` if it is not given.
+ */
+static std::string GetOption(const std::map<std::string, std::vector<std::string>>& options, const std::string& name,
+    const std::string& default_value = "");
+
+static std::vector<BenchQuery> CreateWorkload(const std::map<std::string, std::vector<std::string>>& options);
+
+/**
+ * Run `warmup` queries on one thread and then all queries on `concurrency` threads. Each thread takes the next query
+ * of the workload until all are done.
+ *
+ * @param on_measure_start Called between the warm-up and the measured run, e.g. to take a snapshot of metrics.
+ */
+static BenchResult RunWorkload(const std::vector<BenchQuery>& queries, size_t concurrency, size_t warmup, const CreateWorker& create_worker,
+    const std::function<void()>& on_measure_start, std::string&& label);
+
+/**
+ * Load routing mode of the configuration and calculate routes of the workload by its routers.
+ */
+static BenchResult RunInProcess(const std::string& config_path, const std::vector<BenchQuery>& queries, size_t concurrency, size_t warmup,
+    std::string&& label);
+
+/**
+ * Send the workload to /route of a running routing server. Stages are taken from its /metrics.
+ */
+static BenchResult RunAgainstServer(const std::string& address, const std::vector<BenchQuery>& queries, size_t concurrency, size_t warmup,
+    std::string&& label);
+
+int main(int argc, const char** argv) {
+    std::map<std::string, std::vector<std::string>> options{};
+    try {
+        options = ParseArguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cout << e.what() << "\n" << kUsage;
+        return 1;
+    }
+    std::string config_path = GetOption(options, "config");
+    std::string server = GetOption(options, "server");
+    if (config_path.empty() == server.empty()) {
+        std::cout << "Either --config or --server must be given.\n" << kUsage;
+        return 1;
+    }
+    auto&& queries = CreateWorkload(options);
+    std::string save_path = GetOption(options, "save-workload");
+    if (!save_path.empty()) {
+        std::ofstream out{save_path};
+        WriteWorkload(out, queries);
+    }
+    size_t concurrency = std::max(std::stoul(GetOption(options, "concurrency", "1")), 1UL);
+    size_t warmup = std::stoul(GetOption(options, "warmup", "0"));
+    std::string label = GetOption(options, "label");
+    std::cerr << "Running " << queries.size() << " queries on " << concurrency << " threads." << std::endl;
+    BenchResult result = config_path.empty() ? RunAgainstServer(server, queries, concurrency, warmup, std::move(label))
+        : RunInProcess(config_path, queries, concurrency, warmup, std::move(label));
+
+    std::string output_path = GetOption(options, "output");
+    std::ofstream file{};
+    if (!output_path.empty()) {
+        file.open(output_path);
+    }
+    std::ostream& out = output_path.empty() ? std::cout : file;
+    if (GetOption(options, "format", "csv") == "json") {
+        WriteJson(out, result);
+    } else {
+        WriteCsv(out, result);
+    }
+    return 0;
+}
+
+static std::map<std::string, std::vector<std::string>> ParseArguments(int argc, const char** argv) {
+    std::map<std::string, std::vector<std::string>> options{};
+    for (int i = 1; i < argc; i += 2) {
+        std::string name = argv[i];
+        if (name.compare(0, 2, "--") != 0 || i + 1 >= argc) {
+            throw InvalidArgumentException{"Invalid argument " + name + "."};
+        }
+        options[name.substr(2)].push_back(argv[i + 1]);
+    }
+    return options;
+}
+
+static std::string GetOption(const std::map<std::string, std::vector<std::string>>& options, const std::string& name,
+    const std::string& default_value) {
+    auto&& it = options.find(name);
+    return it == options.end() ? default_value : it->second.back();
+}
+
+static std::vector<BenchQuery> CreateWorkload(const std::map<std::string, std::vector<std::string>>& options) {
+    std::string workload_path = GetOption(options, "workload");
+    if (!workload_path.empty()) {
+        std::ifstream in{workload_path};
+        if (!in) {
+            throw InvalidArgumentException{"Workload " + workload_path + " cannot be opened."};
+        }
+        return ReadWorkload(in);
+    }
+    std::string bbox = GetOption(options, "bbox");
+    std::vector<float> corners{};
+    std::istringstream in{bbox};
+    std::string corner{};
+    while (std::getline(in, corner, ',')) {
+        corners.push_back(std::stof(corner));
+    }
+    if (corners.size() != 4) {
+        throw InvalidArgumentException{"Generated workload needs --bbox MIN_LON,MIN_LAT,MAX_LON,MAX_LAT."};
+    }
+    std::vector<Preferences> profiles{};
+    auto&& profile_options = options.find("profile");
+    if (profile_options != options.end()) {
+        for (auto&& preferences : profile_options->second) {
+            profiles.push_back(ParsePreferences(preferences));
+        }
+    }
+    return GenerateWorkload(utility::Point{corners[0], corners[1]}, utility::Point{corners[2], corners[3]},
+        std::stoul(GetOption(options, "generate", "1000")), profiles, std::stoull(GetOption(options, "seed", "1")));
+}
+
+static BenchResult RunWorkload(const std::vector<BenchQuery>& queries, size_t concurrency, size_t warmup, const CreateWorker& create_worker,
+    const std::function<void()>& on_measure_start, std::string&& label) {
+    {
+        RunQuery run_query = create_worker();
+        for (size_t i = 0; i < warmup && i < queries.size(); ++i) {
+            try {
+                run_query(queries[i]);
+            } catch (const std::exception&) {}
+        }
+    }
+    on_measure_start();
+
+    std::atomic<size_t> next_query{0};
+    std::vector<std::vector<double>> latencies(concurrency);
+    std::vector<size_t> errors(concurrency, 0);
+    std::vector<std::thread> threads{};
+    auto&& start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < concurrency; ++t) {
+        threads.emplace_back([&, t]() {
+            RunQuery run_query = create_worker();
+            for (size_t i = next_query++; i < queries.size(); i = next_query++) {
+                utility::Stopwatch stopwatch{};
+                try {
+                    run_query(queries[i]);
+                    latencies[t].push_back(stopwatch.Lap());
+                } catch (const std::exception&) {
+                    ++errors[t];
+                }
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - start;
+
+    std::vector<double> all_latencies{};
+    size_t error_count = 0;
+    for (size_t t = 0; t < concurrency; ++t) {
+        all_latencies.insert(all_latencies.end(), latencies[t].begin(), latencies[t].end());
+        error_count += errors[t];
+    }
+    return BenchResult{std::move(label), concurrency, std::move(all_latencies), error_count, wall_time.count(), StageTotals{}};
+}
+
+static BenchResult RunInProcess(const std::string& config_path, const std::vector<BenchQuery>& queries, size_t concurrency, size_t warmup,
+    std::string&& label) {
+    ConfigurationParser parser{config_path};
+    auto&& cfg = parser.Parse();
+    auto&& connection_pool = cfg.database.CreateConnectionPool(1);
+    auto&& connection = connection_pool->Acquire();
+    if (label.empty()) {
+        label = cfg.algorithm->name + "_" + cfg.algorithm->mode;
+    }
+    std::unique_ptr<BenchResult> result{};
+    query::VisitModeLoader(*cfg.algorithm, [&](auto loader) {
+        using Loader = decltype(loader);
+        auto&& mode = Loader::Load(cfg, *connection);
+        connection.Release();
+        // The mode is set up as in the routing server.
+        auto&& metrics = std::make_shared<query::RouterMetrics>();
+        mode->SetRouteCacheCapacity(cfg.server.route_cache_size * 1024 * 1024);
+        mode->SetMetrics(metrics);
+        std::chrono::milliseconds request_timeout{cfg.server.request_timeout};
+        auto&& create_worker = [&]() -> RunQuery {
+            return [&](const BenchQuery& query) {
+                auto&& default_profile = mode->GetDefaultProfile();
+                profile::Profile profile{default_profile.GetBaseIndex()};
+                for (auto&& preference : query.preferences) {
+                    profile.AddIndex(default_profile.GetIndex(preference.first), preference.second);
+                }
+                utility::Deadline deadline{request_timeout};
+                auto&& router = mode->GetRouter(profile);
+                router->CalculateShortestRoute(query.source, query.target, profile, query::GeometryOptions{}, &deadline);
+            };
+        };
+        StageTotals before{};
+        result = std::make_unique<BenchResult>(RunWorkload(queries, concurrency, warmup, create_worker, [&]() {
+            before = GetStageTotals(*metrics);
+        }, std::move(label)));
+        result->stages = SubtractStageTotals(GetStageTotals(*metrics), before);
+    });
+    return std::move(*result);
+}
+
+static BenchResult RunAgainstServer(const std::string& address, const std::vector<BenchQuery>& queries, size_t concurrency, size_t warmup,
+    std::string&& label) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos) {
+        throw InvalidArgumentException{"Server address must be HOST:PORT."};
+    }
+    std::string host = address.substr(0, colon);
+    int port = std::stoi(address.substr(colon + 1));
+    if (label.empty()) {
+        label = address;
+    }
+    // Stage metrics of the server are totals since its start so the run is the difference of two snapshots.
+    // Requests of other clients during the run are included.
+    HttpClient metrics_client{host, port};
+    auto&& get_stage_totals = [&]() {
+        std::string body{};
+        if (metrics_client.Get("/metrics", body) != 200) {
+            return StageTotals{};
+        }
+        return ParseStageTotals(body);
+    };
+    auto&& create_worker = [&]() -> RunQuery {
+        auto&& client = std::make_shared<HttpClient>(host, port);
+        return [client](const BenchQuery& query) {
+            std::string coordinates = "[{\"lon\":" + std::to_string(query.source.lon_) + ",\"lat\":" + std::to_string(query.source.lat_) + "},"
+                + "{\"lon\":" + std::to_string(query.target.lon_) + ",\"lat\":" + std::to_string(query.target.lat_) + "}]";
+            std::string target = "/route?coordinates=" + HttpClient::UrlEncode(coordinates)
+                + "&profile=" + HttpClient::UrlEncode(WriteProfileJson(query.preferences));
+            std::string body{};
+            int status = client->Get(target, body);
+            if (status != 200 || body.find("\"ok\":\"true\"") == std::string::npos) {
+                throw std::runtime_error("Route request failed with status " + std::to_string(status) + ".");
+            }
+        };
+    };
+    StageTotals before{};
+    BenchResult result = RunWorkload(queries, concurrency, warmup, create_worker, [&]() {
+        before = get_stage_totals();
+    }, std::move(label));
+    result.stages = SubtractStageTotals(get_stage_totals(), before);
+    return result;
+}
@@ -0,0 +1,273 @@
+#include "routing/cch/customizable_graph.h"
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+
+using namespace std;
+namespace routing {
+namespace cch {
+
+namespace {
+
+/**
+ * Number of vertices a thread takes at once when a level is customized.
+ */
+constexpr size_t kVerticesPerTask = 64;
+
+/**
+ * Barrier blocks threads until all of them reach it. It can be used repeatedly.
+ */
+class Barrier {
+public:
+    Barrier(size_t thread_count) : mutex_(), condition_(), thread_count_(thread_count), waiting_(0), generation_(0) {}
+
+    void Wait() {
+        unique_lock<mutex> lock{mutex_};
+        size_t generation = generation_;
+        if (++waiting_ == thread_count_) {
+            waiting_ = 0;
+            ++generation_;
+            condition_.notify_all();
+        } else {
+            condition_.wait(lock, [&]() { return generation != generation_; });
+        }
+    }
+
+private:
+    mutex mutex_;
+    condition_variable condition_;
+    size_t thread_count_;
+    size_t waiting_;
+    size_t generation_;
+};
+
+}
+
+CustomizableGraph::CustomizableGraph() : ordering_ranks_(), first_arcs_(), arc_heads_(), first_edges_(), edges_(), first_triangles_(), triangles_(),
+    first_level_vertices_(), level_vertices_(), max_edge_id_(0) {}
+
+CustomizableGraph::CustomizableGraph(const vector<unsigned_id_type>& ordering_ranks, const vector<BaseEdge>& edges) : CustomizableGraph() {
+    size_t vertex_count = ordering_ranks.size();
+    for (auto&& edge : edges) {
+        vertex_count = max(vertex_count, static_cast<size_t>(max(edge.from, edge.to)) + 1);
+        max_edge_id_ = max(max_edge_id_, edge.uid);
+    }
+
+    // Ranks are made unique so that each pair of neighbours is one arc.
+    vector<unsigned_id_type> order(vertex_count);
+    iota(order.begin(), order.end(), 0);
+    auto&& get_rank = [&](unsigned_id_type vertex) {
+        return vertex < ordering_ranks.size() ? ordering_ranks[vertex] : numeric_limits<unsigned_id_type>::max();
+    };
+    sort(order.begin(), order.end(), [&](unsigned_id_type a, unsigned_id_type b) {
+        return get_rank(a) < get_rank(b) || (get_rank(a) == get_rank(b) && a < b);
+    });
+    ordering_ranks_.assign(vertex_count, 0);
+    for (size_t i = 0; i < vertex_count; ++i) {
+        ordering_ranks_[order[i]] = i;
+    }
+    auto&& is_lower = [&](unsigned_id_type a, unsigned_id_type b) {
+        return ordering_ranks_[a] < ordering_ranks_[b];
+    };
+
+    // Contraction of a vertex connects all its upper neighbours. It is enough to connect its lowest
+    // upper neighbour to the other ones - the rest is done when the lowest neighbour is contracted.
+    vector<vector<unsigned_id_type>> upper_neighbours(vertex_count);
+    for (auto&& edge : edges) {
+        if (edge.from != edge.to) {
+            unsigned_id_type lower = is_lower(edge.from, edge.to) ? edge.from : edge.to;
+            upper_neighbours[lower].push_back(lower == edge.from ? edge.to : edge.from);
+        }
+    }
+    for (auto&& vertex : order) {
+        auto&& neighbours = upper_neighbours[vertex];
+        sort(neighbours.begin(), neighbours.end(), is_lower);
+        neighbours.erase(unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        if (neighbours.size() > 1) {
+            auto&& lowest_neighbours = upper_neighbours[neighbours.front()];
+            lowest_neighbours.insert(lowest_neighbours.end(), neighbours.begin() + 1, neighbours.end());
+        }
+    }
+
+    first_arcs_.assign(vertex_count + 1, 0);
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        first_arcs_[vertex + 1] = first_arcs_[vertex] + upper_neighbours[vertex].size();
+    }
+    arc_heads_.reserve(first_arcs_[vertex_count]);
+    for (auto&& neighbours : upper_neighbours) {
+        arc_heads_.insert(arc_heads_.end(), neighbours.begin(), neighbours.end());
+        vector<unsigned_id_type>{}.swap(neighbours);
+    }
+
+    // Base edges are stored at their lower vertices.
+    first_edges_.assign(vertex_count + 1, 0);
+    for (auto&& edge : edges) {
+        if (edge.from != edge.to) {
+            ++first_edges_[(is_lower(edge.from, edge.to) ? edge.from : edge.to) + 1];
+        }
+    }
+    partial_sum(first_edges_.begin(), first_edges_.end(), first_edges_.begin());
+    edges_.resize(first_edges_[vertex_count]);
+    vector<size_t> edge_positions{first_edges_.begin(), first_edges_.end() - 1};
+    for (auto&& edge : edges) {
+        if (edge.from != edge.to) {
+            bool forward = is_lower(edge.from, edge.to);
+            unsigned_id_type lower = forward ? edge.from : edge.to;
+            unsigned_id_type upper = forward ? edge.to : edge.from;
+            edges_[edge_positions[lower]++] = StoredEdge{edge.uid, upper, FindArc(lower, upper), forward || edge.twoway, !forward || edge.twoway};
+        }
+    }
+
+    // Lower triangles of arcs of u are given by pairs of arcs (v, u), (v, w) where u has lower rank than w.
+    first_triangles_.assign(vertex_count + 1, 0);
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        size_t arc_count = first_arcs_[vertex + 1] - first_arcs_[vertex];
+        for (size_t i = 0; i < arc_count; ++i) {
+            first_triangles_[arc_heads_[first_arcs_[vertex] + i] + 1] += arc_count - 1 - i;
+        }
+    }
+    partial_sum(first_triangles_.begin(), first_triangles_.end(), first_triangles_.begin());
+    triangles_.resize(first_triangles_[vertex_count]);
+    vector<size_t> triangle_positions{first_triangles_.begin(), first_triangles_.end() - 1};
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        for (size_t lower_arc = first_arcs_[vertex]; lower_arc < first_arcs_[vertex + 1]; ++lower_arc) {
+            unsigned_id_type u = arc_heads_[lower_arc];
+            for (size_t intermediate_arc = lower_arc + 1; intermediate_arc < first_arcs_[vertex + 1]; ++intermediate_arc) {
+                triangles_[triangle_positions[u]++] = Triangle{FindArc(u, arc_heads_[intermediate_arc]), static_cast<unsigned_id_type>(lower_arc),
+                    static_cast<unsigned_id_type>(intermediate_arc), static_cast<unsigned_id_type>(vertex)};
+            }
+        }
+    }
+
+    // Vertex level is higher than levels of all its lower neighbours.
+    vector<unsigned_id_type> levels(vertex_count, 0);
+    unsigned_id_type max_level = 0;
+    for (auto&& vertex : order) {
+        max_level = max(max_level, levels[vertex]);
+        for (size_t arc = first_arcs_[vertex]; arc < first_arcs_[vertex + 1]; ++arc) {
+            levels[arc_heads_[arc]] = max(levels[arc_heads_[arc]], levels[vertex] + 1);
+        }
+    }
+    first_level_vertices_.assign(static_cast<size_t>(max_level) + 2, 0);
+    for (auto&& level : levels) {
+        ++first_level_vertices_[level + 1];
+    }
+    partial_sum(first_level_vertices_.begin(), first_level_vertices_.end(), first_level_vertices_.begin());
+    level_vertices_.resize(vertex_count);
+    vector<size_t> level_positions{first_level_vertices_.begin(), first_level_vertices_.end() - 1};
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        level_vertices_[level_positions[levels[vertex]]++] = vertex;
+    }
+}
+
+CustomizableGraph::Metric CustomizableGraph::Customize(const function<float(unsigned_id_type)>& edge_length, size_t thread_count) const {
+    Metric metric{};
+    metric.forward_lengths.assign(GetArcCount(), numeric_limits<float>::infinity());
+    metric.backward_lengths.assign(GetArcCount(), numeric_limits<float>::infinity());
+    metric.forward_middle_vertices.assign(GetArcCount(), kNoMiddleVertex);
+    metric.backward_middle_vertices.assign(GetArcCount(), kNoMiddleVertex);
+    metric.base_edge_lengths.assign(edges_.size(), 0);
+
+    thread_count = max(thread_count, static_cast<size_t>(1));
+    size_t level_count = GetLevelCount();
+    if (thread_count == 1) {
+        for (auto&& vertex : level_vertices_) {
+            CustomizeVertex(vertex, edge_length, metric);
+        }
+        return metric;
+    }
+
+    // Vertices of one level are taken by threads in small tasks. No thread starts the next level
+    // before the current one is finished.
+    unique_ptr<atomic<size_t>[]> next_tasks{new atomic<size_t>[level_count]()};
+    Barrier barrier{thread_count};
+    exception_ptr error{};
+    mutex error_mutex{};
+    atomic<bool> failed{false};
+    auto&& customize_levels = [&]() {
+        for (size_t level = 0; level < level_count; ++level) {
+            size_t level_begin = first_level_vertices_[level];
+            size_t level_end = first_level_vertices_[level + 1];
+            while (!failed) {
+                size_t task_begin = level_begin + next_tasks[level].fetch_add(kVerticesPerTask);
+                if (task_begin >= level_end) {
+                    break;
+                }
+                size_t task_end = min(task_begin + kVerticesPerTask, level_end);
+                try {
+                    for (size_t i = task_begin; i < task_end; ++i) {
+                        CustomizeVertex(level_vertices_[i], edge_length, metric);
+                    }
+                } catch (...) {
+                    // Other threads still wait at barriers so the thread must not leave.
+                    lock_guard<mutex> lock{error_mutex};
+                    if (!error) {
+                        error = current_exception();
+                    }
+                    failed = true;
+                }
+            }
+            barrier.Wait();
+        }
+    };
+    vector<thread> threads{};
+    for (size_t i = 1; i < thread_count; ++i) {
+        threads.emplace_back(customize_levels);
+    }
+    customize_levels();
+    for (auto&& t : threads) {
+        t.join();
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+    return metric;
+}
+
+unsigned_id_type CustomizableGraph::FindArc(unsigned_id_type tail, unsigned_id_type head) const {
+    auto&& begin = arc_heads_.begin() + first_arcs_[tail];
+    auto&& end = arc_heads_.begin() + first_arcs_[tail + 1];
+    auto&& it = lower_bound(begin, end, head, [&](unsigned_id_type a, unsigned_id_type b) {
+        return ordering_ranks_[a] < ordering_ranks_[b];
+    });
+    // Arcs always exist since the contracted graph is chordal.
+    return static_cast<unsigned_id_type>(it - arc_heads_.begin());
+}
+
+void CustomizableGraph::CustomizeVertex(unsigned_id_type vertex, const function<float(unsigned_id_type)>& edge_length, Metric& metric) const {
+    for (size_t i = first_edges_[vertex]; i < first_edges_[vertex + 1]; ++i) {
+        const StoredEdge& edge = edges_[i];
+        float length = edge_length(edge.uid);
+        metric.base_edge_lengths[i] = length;
+        if (edge.forward && length < metric.forward_lengths[edge.arc]) {
+            metric.forward_lengths[edge.arc] = length;
+        }
+        if (edge.backward && length < metric.backward_lengths[edge.arc]) {
+            metric.backward_lengths[edge.arc] = length;
+        }
+    }
+    // Arcs of lower vertices of the triangles are already customized.
+    for (size_t i = first_triangles_[vertex]; i < first_triangles_[vertex + 1]; ++i) {
+        const Triangle& triangle = triangles_[i];
+        float forward_length = metric.backward_lengths[triangle.lower_arc] + metric.forward_lengths[triangle.intermediate_arc];
+        if (forward_length < metric.forward_lengths[triangle.upper_arc]) {
+            metric.forward_lengths[triangle.upper_arc] = forward_length;
+            metric.forward_middle_vertices[triangle.upper_arc] = triangle.lowest_vertex;
+        }
+        float backward_length = metric.backward_lengths[triangle.intermediate_arc] + metric.forward_lengths[triangle.lower_arc];
+        if (backward_length < metric.backward_lengths[triangle.upper_arc]) {
+            metric.backward_lengths[triangle.upper_arc] = backward_length;
+            metric.backward_middle_vertices[triangle.upper_arc] = triangle.lowest_vertex;
+        }
+    }
+}
+
+}
+}
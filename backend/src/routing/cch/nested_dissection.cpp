@@ -0,0 +1,212 @@
+#include "routing/cch/nested_dissection.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+namespace routing {
+namespace cch {
+
+namespace {
+
+/**
+ * Parts with at most this number of vertices are ordered without further dissection.
+ */
+constexpr size_t kMinPartSize = 2;
+
+/**
+ * Each of the two parts made by a separator must contain at least this fraction of vertices
+ * if such separator exists.
+ */
+constexpr double kMinPartFraction = 0.25;
+
+}
+
+NestedDissection::NestedDissection() : edges_(), vertex_count_(0), first_neighbour_(), neighbours_(), stamps_(), stamp_(0), levels_() {}
+
+void NestedDissection::AddEdge(unsigned_id_type from, unsigned_id_type to) {
+    if (from == to) {
+        return;
+    }
+    edges_.emplace_back(from, to);
+    vertex_count_ = max(vertex_count_, static_cast<size_t>(max(from, to)) + 1);
+}
+
+vector<unsigned_id_type> NestedDissection::ComputeOrdering() {
+    BuildAdjacency();
+    stamps_.assign(vertex_count_, 0);
+    stamp_ = 0;
+    levels_.assign(vertex_count_, 0);
+    vector<unsigned_id_type> ranks(vertex_count_, 0);
+
+    vector<unsigned_id_type> all_vertices(vertex_count_);
+    for (size_t i = 0; i < vertex_count_; ++i) {
+        all_vertices[i] = static_cast<unsigned_id_type>(i);
+    }
+    // Parts are processed from a stack instead of recursion so that deep dissections cannot overflow the call stack.
+    vector<Part> parts{};
+    parts.emplace_back(move(all_vertices), 0);
+    while (!parts.empty()) {
+        Part part = move(parts.back());
+        parts.pop_back();
+        if (part.vertices.size() <= kMinPartSize) {
+            for (size_t i = 0; i < part.vertices.size(); ++i) {
+                ranks[part.vertices[i]] = part.rank_begin + i;
+            }
+            continue;
+        }
+        auto&& components = FindComponents(part.vertices);
+        if (components.size() > 1) {
+            unsigned_id_type rank_begin = part.rank_begin;
+            for (auto&& component : components) {
+                unsigned_id_type size = component.size();
+                parts.emplace_back(move(component), rank_begin);
+                rank_begin += size;
+            }
+            continue;
+        }
+        Dissect(move(part), ranks, parts);
+    }
+    return ranks;
+}
+
+void NestedDissection::BuildAdjacency() {
+    first_neighbour_.assign(vertex_count_ + 1, 0);
+    for (auto&& edge : edges_) {
+        ++first_neighbour_[edge.first + 1];
+        ++first_neighbour_[edge.second + 1];
+    }
+    for (size_t i = 0; i < vertex_count_; ++i) {
+        first_neighbour_[i + 1] += first_neighbour_[i];
+    }
+    neighbours_.assign(first_neighbour_[vertex_count_], 0);
+    vector<size_t> positions{first_neighbour_.begin(), first_neighbour_.end() - 1};
+    for (auto&& edge : edges_) {
+        neighbours_[positions[edge.first]++] = edge.second;
+        neighbours_[positions[edge.second]++] = edge.first;
+    }
+}
+
+void NestedDissection::Mark(const vector<unsigned_id_type>& vertices) {
+    // Searches set stamp_ + 1 to visited vertices so the next marking must skip it.
+    stamp_ += 2;
+    for (auto&& vertex : vertices) {
+        stamps_[vertex] = stamp_;
+    }
+}
+
+vector<unsigned_id_type> NestedDissection::Search(unsigned_id_type source, unsigned_id_type visited_stamp) {
+    vector<unsigned_id_type> order{};
+    order.push_back(source);
+    stamps_[source] = visited_stamp;
+    levels_[source] = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        unsigned_id_type vertex = order[i];
+        for (size_t j = first_neighbour_[vertex]; j < first_neighbour_[vertex + 1]; ++j) {
+            unsigned_id_type neighbour = neighbours_[j];
+            if (stamps_[neighbour] == stamp_) {
+                stamps_[neighbour] = visited_stamp;
+                levels_[neighbour] = levels_[vertex] + 1;
+                order.push_back(neighbour);
+            }
+        }
+    }
+    return order;
+}
+
+vector<vector<unsigned_id_type>> NestedDissection::FindComponents(const vector<unsigned_id_type>& vertices) {
+    Mark(vertices);
+    vector<vector<unsigned_id_type>> components{};
+    for (auto&& vertex : vertices) {
+        if (stamps_[vertex] == stamp_) {
+            components.push_back(Search(vertex, stamp_ + 1));
+        }
+    }
+    return components;
+}
+
+void NestedDissection::Dissect(Part&& part, vector<unsigned_id_type>& ranks, vector<Part>& parts) {
+    // The last vertex found by a search is far from its source. Searching again from it
+    // gives levels that go across the whole part.
+    Mark(part.vertices);
+    unsigned_id_type peripheral_vertex = Search(part.vertices.front(), stamp_ + 1).back();
+    Mark(part.vertices);
+    vector<unsigned_id_type> order = Search(peripheral_vertex, stamp_ + 1);
+    unsigned_id_type visited_stamp = stamp_ + 1;
+
+    size_t size = order.size();
+    unsigned_id_type max_level = levels_[order.back()];
+    if (max_level < 2) {
+        // There is no level that would separate two other levels.
+        for (size_t i = 0; i < size; ++i) {
+            ranks[order[i]] = part.rank_begin + i;
+        }
+        return;
+    }
+
+    vector<size_t> level_sizes(max_level + 1, 0);
+    for (auto&& vertex : order) {
+        ++level_sizes[levels_[vertex]];
+    }
+    size_t min_part_size = static_cast<size_t>(size * kMinPartFraction);
+    unsigned_id_type separator_level = 0;
+    size_t below = level_sizes[0];
+    size_t best_separator_size = numeric_limits<size_t>::max();
+    size_t best_imbalance = numeric_limits<size_t>::max();
+    unsigned_id_type median_level = 0;
+    for (unsigned_id_type level = 1; level < max_level; ++level) {
+        size_t above = size - below - level_sizes[level];
+        size_t imbalance = below > above ? below - above : above - below;
+        if (below < size / 2 && size / 2 <= below + level_sizes[level]) {
+            median_level = level;
+        }
+        if (min(below, above) >= min_part_size &&
+            (level_sizes[level] < best_separator_size || (level_sizes[level] == best_separator_size && imbalance < best_imbalance))) {
+            separator_level = level;
+            best_separator_size = level_sizes[level];
+            best_imbalance = imbalance;
+        }
+        below += level_sizes[level];
+    }
+    if (separator_level == 0) {
+        separator_level = median_level == 0 ? max_level / 2 : median_level;
+    }
+
+    // Vertices of the separator level without neighbours in the next level do not separate anything.
+    vector<unsigned_id_type> lower_part{};
+    vector<unsigned_id_type> upper_part{};
+    vector<unsigned_id_type> separator{};
+    for (auto&& vertex : order) {
+        unsigned_id_type level = levels_[vertex];
+        if (level < separator_level) {
+            lower_part.push_back(vertex);
+        } else if (level > separator_level) {
+            upper_part.push_back(vertex);
+        } else {
+            bool separates = false;
+            for (size_t j = first_neighbour_[vertex]; j < first_neighbour_[vertex + 1]; ++j) {
+                unsigned_id_type neighbour = neighbours_[j];
+                if (stamps_[neighbour] == visited_stamp && levels_[neighbour] == separator_level + 1) {
+                    separates = true;
+                    break;
+                }
+            }
+            if (separates) {
+                separator.push_back(vertex);
+            } else {
+                lower_part.push_back(vertex);
+            }
+        }
+    }
+
+    unsigned_id_type separator_rank_begin = part.rank_begin + lower_part.size() + upper_part.size();
+    for (size_t i = 0; i < separator.size(); ++i) {
+        ranks[separator[i]] = separator_rank_begin + i;
+    }
+    unsigned_id_type upper_rank_begin = part.rank_begin + lower_part.size();
+    parts.emplace_back(move(lower_part), part.rank_begin);
+    parts.emplace_back(move(upper_part), upper_rank_begin);
+}
+
+}
+}
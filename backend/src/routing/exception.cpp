@@ -87,5 +87,26 @@ const char* InvalidArgumentException::what() const _GLIBCXX_TXN_SAFE_DYN _GLIBCX
     return message_.c_str();
 }
 
+SnapshotException::SnapshotException() : message_("Invalid graph snapshot.") {}
+
+SnapshotException::SnapshotException(const string & message) : message_(message) {}
+
+SnapshotException::SnapshotException(std::string && message) : message_(move(message)) {}
+
+const char* SnapshotException::what() const _GLIBCXX_TXN_SAFE_DYN _GLIBCXX_NOTHROW {
+    return message_.c_str();
+}
+
+
+TimeoutException::TimeoutException() : message_("Request deadline exceeded.") {}
+
+TimeoutException::TimeoutException(const string & message) : message_(message) {}
+
+TimeoutException::TimeoutException(std::string && message) : message_(move(message)) {}
+
+const char* TimeoutException::what() const _GLIBCXX_TXN_SAFE_DYN _GLIBCXX_NOTHROW {
+    return message_.c_str();
+}
+
 
 }
\ No newline at end of file
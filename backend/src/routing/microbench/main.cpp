@@ -0,0 +1,94 @@
+#include "routing/microbench/microbench.h"
+#include "routing/microbench/synthetic_graph.h"
+#include "routing/exception.h"
+
+#include <benchmark/benchmark.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <exception>
+
+using namespace routing;
+using namespace microbench;
+
+static const char* kUsage =
+    "Graph arguments (all other arguments are passed to Google Benchmark, e.g. --benchmark_filter=CHQuery):\n"
+    "  --graph_kinds=LIST     Comma separated grid, random_geometric and road_like. All kinds by default.\n"
+    "  --graph_sizes=LIST     Comma separated approximate vertex counts, 10000,100000 by default.\n"
+    "  --graph_seed=N         Seed of generated graphs and queries, 1 by default.\n"
+    "  --contraction_threads=N  Threads that contract graphs for the query benchmarks, all hardware threads by default.\n"
+    "Contraction prints its progress to standard output so machine readable results should be written\n"
+    "to a file, e.g. --benchmark_out=results.json.\n";
+
+static std::vector<std::string> Split(const std::string& text) {
+    std::vector<std::string> parts{};
+    std::istringstream in{text};
+    std::string part{};
+    while (std::getline(in, part, ',')) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+/**
+ * Read graph arguments and remove them from `argv` so that Google Benchmark does not reject them.
+ */
+static MicrobenchOptions ParseOptions(int& argc, char** argv) {
+    MicrobenchOptions options{{GraphKind::kGrid, GraphKind::kRandomGeometric, GraphKind::kRoadLike}, {10000, 100000}, 1,
+        std::max(std::thread::hardware_concurrency(), 1U)};
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument{argv[i]};
+        size_t separator = argument.find('=');
+        std::string name = argument.substr(0, separator);
+        std::string value = separator == std::string::npos ? "" : argument.substr(separator + 1);
+        if (name == "--graph_kinds") {
+            options.graph_kinds.clear();
+            for (auto&& kind : Split(value)) {
+                options.graph_kinds.push_back(ParseGraphKind(kind));
+            }
+        } else if (name == "--graph_sizes") {
+            options.graph_sizes.clear();
+            for (auto&& size : Split(value)) {
+                options.graph_sizes.push_back(std::stoul(size));
+            }
+        } else if (name == "--graph_seed") {
+            options.seed = std::stoull(value);
+        } else if (name == "--contraction_threads") {
+            options.contraction_threads = std::max<size_t>(std::stoul(value), 1);
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    return options;
+}
+
+int main(int argc, char** argv) {
+    MicrobenchOptions options{};
+    try {
+        options = ParseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl << kUsage;
+        return 1;
+    }
+    GraphCache cache{options};
+    RegisterQueryBenchmarks(cache);
+    RegisterPreprocessingBenchmarks(cache);
+    RegisterProfileBenchmarks(cache);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        std::cerr << kUsage;
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "routing/microbench/microbench.h"
+#include "routing/preprocessing/ch_dijkstra.h"
+#include "routing/preprocessing/shortcut_finder.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+namespace routing {
+namespace microbench {
+
+using benchmark::Counter;
+
+/**
+ * Number of random vertices whose contraction kernels the benchmarks cycle through.
+ */
+static const size_t kContractedVertexCount = 1000;
+
+/**
+ * One local search of contraction - from a backward neighbour of the contracted vertex
+ * to its forward neighbours without passing through it.
+ */
+struct WitnessSearch {
+    unsigned_id_type source;
+    unsigned_id_type contracted;
+    float max_cost;
+    preprocessing::CHDijkstra<CHGraph>::TargetVerticesMap targets;
+};
+
+static std::vector<unsigned_id_type> GetContractedVertices(GraphCache& cache, GraphKind kind, size_t size) {
+    SyntheticRandom random{cache.get_options().seed};
+    size_t vertex_count = cache.GetSyntheticGraph(kind, size).vertex_count;
+    std::vector<unsigned_id_type> vertices{};
+    for (size_t i = 0; i < kContractedVertexCount; ++i) {
+        vertices.push_back(static_cast<unsigned_id_type>(1 + random.NextUnit() * vertex_count));
+    }
+    return vertices;
+}
+
+/**
+ * Witness searches are prepared the same way as ShortcutFinder does it so that only CHDijkstra::Run is measured.
+ */
+static std::vector<WitnessSearch> GetWitnessSearches(GraphCache& cache, GraphKind kind, size_t size) {
+    auto&& g = cache.GetUncontractedGraph(kind, size);
+    std::vector<WitnessSearch> searches{};
+    for (unsigned_id_type vertex_id : GetContractedVertices(cache, kind, size)) {
+        auto&& vertex = g.GetVertex(vertex_id);
+        unsigned_id_type source = 0;
+        float source_length = 0;
+        vertex.ForEachBackwardEdge([&](CHGraphEdge& edge) {
+            source = edge.get_to();
+            source_length = edge.get_length();
+        });
+        WitnessSearch search{source, vertex_id, 0, {}};
+        float max_length = 0;
+        vertex.ForEachEdge([&](CHGraphEdge& edge) {
+            if (edge.get_to() != source) {
+                search.targets.emplace(edge.get_to(), false);
+                max_length = std::max(max_length, edge.get_length());
+            }
+        });
+        if (source != 0 && !search.targets.empty()) {
+            search.max_cost = source_length + max_length;
+            searches.push_back(std::move(search));
+        }
+    }
+    return searches;
+}
+
+static void BenchmarkWitnessSearch(benchmark::State& state, GraphCache& cache, GraphKind kind, size_t size) {
+    auto&& g = cache.GetUncontractedGraph(kind, size);
+    auto&& searches = GetWitnessSearches(cache, kind, size);
+    preprocessing::CHDijkstra<CHGraph> dijkstra{g};
+    preprocessing::CHDijkstra<CHGraph>::SearchRangeLimits limits{0, cache.get_options().GetContractionParameters().get_hop_count() - 1};
+    size_t i = 0;
+    double settled = 0;
+    for (auto _ : state) {
+        auto&& search = searches[i++ % searches.size()];
+        limits.max_cost = search.max_cost;
+        benchmark::DoNotOptimize(dijkstra.Run(search.source, search.contracted, limits, search.targets));
+        settled += dijkstra.GetSearchSpaceSize();
+        // Run marks found targets so they are reset for the next search of the same vertex.
+        for (auto&& it = search.targets.begin(); it != search.targets.end(); ++it) {
+            it.value() = false;
+        }
+    }
+    state.counters["settled_vertices"] = Counter{settled, Counter::kAvgIterations};
+}
+
+static void BenchmarkFindShortcuts(benchmark::State& state, GraphCache& cache, GraphKind kind, size_t size) {
+    auto&& g = cache.GetUncontractedGraph(kind, size);
+    auto&& vertices = GetContractedVertices(cache, kind, size);
+    preprocessing::ShortcutFinder<CHGraph> finder{g, cache.get_options().GetContractionParameters()};
+    size_t i = 0;
+    double shortcuts = 0;
+    for (auto _ : state) {
+        auto&& found = finder.FindShortcuts(g.GetVertex(vertices[i++ % vertices.size()]));
+        shortcuts += found.size();
+        benchmark::DoNotOptimize(found.data());
+    }
+    state.counters["shortcuts"] = Counter{shortcuts, Counter::kAvgIterations};
+}
+
+void RegisterPreprocessingBenchmarks(GraphCache& cache) {
+    auto&& options = cache.get_options();
+    for (auto&& kind : options.graph_kinds) {
+        for (auto&& size : options.graph_sizes) {
+            std::string suffix = "/" + GetGraphKindName(kind) + "/" + std::to_string(size);
+            benchmark::RegisterBenchmark(("CHWitnessSearch" + suffix).c_str(), [&cache, kind, size](benchmark::State& state) {
+                BenchmarkWitnessSearch(state, cache, kind, size);
+            });
+            benchmark::RegisterBenchmark(("FindShortcuts" + suffix).c_str(), [&cache, kind, size](benchmark::State& state) {
+                BenchmarkFindShortcuts(state, cache, kind, size);
+            });
+        }
+    }
+}
+
+}
+}
@@ -0,0 +1,81 @@
+#include "routing/microbench/microbench.h"
+#include "routing/profile/profile.h"
+#include "routing/profile/preference_index.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <memory>
+#include <string>
+
+namespace routing {
+namespace microbench {
+
+/**
+ * Preference index with random values in memory instead of a database table.
+ */
+class SyntheticIndex : public profile::PreferenceIndex {
+public:
+    SyntheticIndex(const std::string& name, size_t edge_count, uint64_t seed) : name_(name), values_(edge_count + 1) {
+        SyntheticRandom random{seed};
+        for (auto&& value : values_) {
+            value = static_cast<float>(random.NextUnit());
+        }
+    }
+
+    void Load(database::DatabaseHelper& d, const std::string& index_table) override {}
+
+    void Create(database::DatabaseHelper& d, const std::vector<std::pair<unsigned_id_type, float>>& index_values, const std::string& index_table) const override {}
+
+    float Get(unsigned_id_type uid) const override {
+        return values_[uid];
+    }
+
+    float GetOriginal(unsigned_id_type uid) const override {
+        return values_[uid];
+    }
+
+    const std::string& GetName() const override {
+        return name_;
+    }
+
+private:
+    std::string name_;
+    std::vector<float> values_;
+
+    void Normalize() override {}
+};
+
+/**
+ * The argument is the number of preference indices in the profile. Importances alternate in sign
+ * so that inverted indices are measured as well.
+ */
+static void BenchmarkProfileGetLength(benchmark::State& state, GraphCache& cache, GraphKind kind, size_t size) {
+    size_t edge_count = cache.GetSyntheticGraph(kind, size).edges.size();
+    uint64_t seed = cache.get_options().seed;
+    profile::Profile profile{std::make_shared<SyntheticIndex>("length", edge_count, seed)};
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        float importance = i % 2 == 0 ? 1.0f / (i + 1) : -1.0f / (i + 1);
+        profile.AddIndex(std::make_shared<SyntheticIndex>("index" + std::to_string(i), edge_count, seed + i + 1), importance);
+    }
+    unsigned_id_type uid = 0;
+    for (auto _ : state) {
+        uid = uid == edge_count ? 1 : uid + 1;
+        benchmark::DoNotOptimize(profile.GetLength(uid));
+    }
+}
+
+void RegisterProfileBenchmarks(GraphCache& cache) {
+    auto&& options = cache.get_options();
+    for (auto&& kind : options.graph_kinds) {
+        for (auto&& size : options.graph_sizes) {
+            std::string suffix = "/" + GetGraphKindName(kind) + "/" + std::to_string(size);
+            benchmark::RegisterBenchmark(("ProfileGetLength" + suffix).c_str(), [&cache, kind, size](benchmark::State& state) {
+                BenchmarkProfileGetLength(state, cache, kind, size);
+            })->ArgName("indices")->DenseRange(0, 3);
+        }
+    }
+}
+
+}
+}
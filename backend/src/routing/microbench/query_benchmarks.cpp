@@ -0,0 +1,104 @@
+#include "routing/microbench/microbench.h"
+#include "routing/query/dijkstra.h"
+#include "routing/query/bidirectional_dijkstra.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <memory>
+#include <string>
+
+namespace routing {
+namespace microbench {
+
+using benchmark::Counter;
+
+/**
+ * Number of searches whose routes are unpacked over and over in the unpacking benchmark.
+ * Each search keeps its own workspace so it cannot be large.
+ */
+static const size_t kUnpackedRouteCount = 16;
+
+static void BenchmarkDijkstra(benchmark::State& state, GraphCache& cache, GraphKind kind, size_t size) {
+    auto&& g = cache.GetBaseGraph(kind, size);
+    auto&& queries = cache.GetQueries(kind, size);
+    query::Dijkstra<BaseGraph> dijkstra{g};
+    size_t i = 0;
+    double settled = 0;
+    double relaxed = 0;
+    for (auto _ : state) {
+        auto&& [source, target] = queries[i++ % queries.size()];
+        dijkstra.Run(source, target);
+        benchmark::DoNotOptimize(dijkstra.GetPathLength(target));
+        settled += dijkstra.GetSettledVertexCount();
+        relaxed += dijkstra.GetRelaxedEdgeCount();
+    }
+    state.counters["settled_vertices"] = Counter{settled, Counter::kAvgIterations};
+    state.counters["relaxations"] = Counter{relaxed, Counter::kAvgIterations};
+}
+
+static void BenchmarkCHQuery(benchmark::State& state, GraphCache& cache, GraphKind kind, size_t size) {
+    auto&& g = cache.GetSearchGraph(kind, size);
+    auto&& queries = cache.GetQueries(kind, size);
+    query::BidirectionalDijkstra<SearchGraph> search{g};
+    search.SetStallOnDemand(state.range(0) != 0);
+    size_t i = 0;
+    double settled = 0;
+    double stalled = 0;
+    double relaxed = 0;
+    for (auto _ : state) {
+        auto&& [source, target] = queries[i++ % queries.size()];
+        search.Run(source, target);
+        settled += search.GetSettledVertexCount();
+        stalled += search.GetStalledVertexCount();
+        relaxed += search.GetRelaxedEdgeCount();
+    }
+    state.counters["settled_vertices"] = Counter{settled, Counter::kAvgIterations};
+    state.counters["stalled_vertices"] = Counter{stalled, Counter::kAvgIterations};
+    state.counters["relaxations"] = Counter{relaxed, Counter::kAvgIterations};
+}
+
+/**
+ * Route retrieval of finished searches - the packed route is backtracked and its shortcuts
+ * are unpacked by RouteRetriever::UnpackShortcut. Searches are run before the measurement.
+ */
+static void BenchmarkCHUnpack(benchmark::State& state, GraphCache& cache, GraphKind kind, size_t size) {
+    using Search = query::BidirectionalDijkstra<SearchGraph>;
+    auto&& g = cache.GetSearchGraph(kind, size);
+    auto&& queries = cache.GetQueries(kind, size);
+    std::vector<std::unique_ptr<Search>> searches{};
+    for (size_t i = 0; i < kUnpackedRouteCount && i < queries.size(); ++i) {
+        searches.push_back(std::make_unique<Search>(g));
+        searches.back()->Run(queries[i].first, queries[i].second);
+    }
+    size_t i = 0;
+    double route_edges = 0;
+    for (auto _ : state) {
+        auto&& route = searches[i++ % searches.size()]->GetRoute();
+        route_edges += route.size();
+        benchmark::DoNotOptimize(route.data());
+    }
+    state.counters["route_edges"] = Counter{route_edges, Counter::kAvgIterations};
+}
+
+void RegisterQueryBenchmarks(GraphCache& cache) {
+    auto&& options = cache.get_options();
+    for (auto&& kind : options.graph_kinds) {
+        for (auto&& size : options.graph_sizes) {
+            std::string suffix = "/" + GetGraphKindName(kind) + "/" + std::to_string(size);
+            benchmark::RegisterBenchmark(("Dijkstra" + suffix).c_str(), [&cache, kind, size](benchmark::State& state) {
+                BenchmarkDijkstra(state, cache, kind, size);
+            })->Unit(benchmark::kMicrosecond);
+            // The argument enables stall-on-demand.
+            benchmark::RegisterBenchmark(("CHQuery" + suffix).c_str(), [&cache, kind, size](benchmark::State& state) {
+                BenchmarkCHQuery(state, cache, kind, size);
+            })->ArgName("stall_on_demand")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+            benchmark::RegisterBenchmark(("CHUnpack" + suffix).c_str(), [&cache, kind, size](benchmark::State& state) {
+                BenchmarkCHUnpack(state, cache, kind, size);
+            })->Unit(benchmark::kMicrosecond);
+        }
+    }
+}
+
+}
+}
@@ -6,8 +6,10 @@
 #include "routing/constants.h"
 
 #include "routing/preprocessing/ch_preprocessor.h"
+#include "routing/preprocessing/cch_preprocessor.h"
 #include "routing/preprocessing/contraction_parameters.h"
 #include "routing/preprocessing/index_extender.h"
+#include "routing/preprocessing/profile_scheduler.h"
 
 #include "routing/profile/profile_generator.h"
 #include "routing/profile/profile.h"
@@ -18,8 +20,11 @@
 
 #include "routing/database/database_helper.h"
 
+#include "routing/snapshot/ch_graph_snapshot.h"
+
 #include "toml11/toml.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <vector>
 #include <tuple>
@@ -33,6 +38,7 @@ using namespace routing;
 using namespace database;
 using namespace preprocessing;
 using namespace profile;
+using namespace snapshot;
 
 /**
  * Main entrypoint for any algorithm preprocessing.
@@ -114,43 +120,100 @@ static void RunAlgorithmPreprocessing(const std::string& config_path) {
     }
 }
 
-static void CHPreprocessing(DatabaseHelper&d, Configuration& cfg, Profile& profile) {
+static ContractionParameters GetContractionParameters(Configuration& cfg) {
     CHConfig* ch_config = static_cast<CHConfig*>(cfg.algorithm.get());
-    ContractionParameters parameters{
+    return ContractionParameters{
         ch_config->hop_count,
         ch_config->edge_difference_coefficient,
         ch_config->deleted_neighbours_coefficient,
-        ch_config->space_size_coefficient
+        ch_config->space_size_coefficient,
+        ch_config->threads
     };
+}
+
+/**
+ * Contract graph of the profile created from already loaded base edges. The database is not used.
+ */
+static CHPreprocessor::Graph ContractProfileGraph(Configuration& cfg, Profile& profile, const std::vector<CHPreprocessor::Edge>& base_edges) {
+    CHPreprocessor::Graph graph = CHPreprocessor::CreateGraph(base_edges, profile);
+    CHPreprocessor::RunPreprocessing(graph, GetContractionParameters(cfg));
+    return graph;
+}
+
+/**
+ * Save contracted graph of the profile to the database and to a snapshot if configured.
+ */
+static void SaveProfileGraph(DatabaseHelper&d, Configuration& cfg, Profile& profile, CHPreprocessor::Graph& graph) {
     CHTableNames table_names{cfg.algorithm->base_graph_table, profile};
-    CHPreprocessor preprocessor{d, &table_names, std::move(parameters)};
-    auto&& graph = preprocessor.LoadGraph(profile);
-    preprocessor.RunPreprocessing(graph);
+    CHPreprocessor preprocessor{d, &table_names, GetContractionParameters(cfg)};
     if (cfg.algorithm->mode == Constants::ModeNames::kDynamicProfile) {
         ExtendProfileIndices<CHPreprocessor::Graph>(cfg, graph, profile, &table_names, d);
     }
     preprocessor.SaveGraph(graph);
+    if (cfg.algorithm->mode == Constants::ModeNames::kStaticProfile && !cfg.algorithm->snapshot_directory.empty()) {
+        preprocessor.SaveSnapshot(graph, CHGraphSnapshot::GetPath(cfg.algorithm->snapshot_directory, table_names.GetEdgesTable()));
+    }
+}
+
+static void CHPreprocessing(DatabaseHelper&d, Configuration& cfg, Profile& profile) {
+    auto&& graph = ContractProfileGraph(cfg, profile, CHPreprocessor::LoadBaseEdges(d, cfg.algorithm->base_graph_table));
+    SaveProfileGraph(d, cfg, profile, graph);
+}
+
+/**
+ * The base graph is loaded only once and graphs of profiles are created from it. Profiles are contracted
+ * concurrently if configured - each worker leases its own database connection from a pool since connections
+ * cannot be shared between threads.
+ */
+static void StaticCHPreprocessing(DatabaseHelper& d, Configuration& cfg, std::vector<Profile>& profiles) {
+    CHConfig* ch_config = static_cast<CHConfig*>(cfg.algorithm.get());
+    auto&& base_edges = CHPreprocessor::LoadBaseEdges(d, cfg.algorithm->base_graph_table);
+    ProfileScheduler scheduler{
+        ch_config->profile_threads,
+        ch_config->memory_budget,
+        CHPreprocessor::EstimateContractionMemory(base_edges, ch_config->threads)
+    };
+    size_t worker_count = std::min(scheduler.GetWorkerCount(), profiles.size());
+    std::cout << "Preprocess " << profiles.size() << " profiles with " << worker_count << " workers." << std::endl;
+    auto&& connection_pool = cfg.database.CreateConnectionPool(worker_count);
+    scheduler.Run(profiles.size(), [&](size_t worker, size_t profile_index) {
+        auto&& graph = ContractProfileGraph(cfg, profiles[profile_index], base_edges);
+        // Contraction of one profile takes long so the connection is leased only once the graph is contracted.
+        auto&& connection = connection_pool->Acquire();
+        SaveProfileGraph(*connection, cfg, profiles[profile_index], graph);
+    });
+}
+
+/**
+ * The vertex ordering of CCH is the same for all profiles so the profile is not used.
+ */
+static void CCHPreprocessing(DatabaseHelper&d, Configuration& cfg, Profile& profile) {
+    CCHTableNames table_names{cfg.algorithm->base_graph_table};
+    CCHPreprocessor preprocessor{d, &table_names};
+    auto&& graph = preprocessor.LoadGraph();
+    preprocessor.RunPreprocessing(graph);
+    preprocessor.SaveGraph(graph);
 }
 
 static void StaticModePreprocessing(DatabaseHelper& d, Configuration& cfg) {
-    std::unordered_map<std::string, std::function<void(DatabaseHelper&, Configuration&, Profile&)>> algorithms{
-        {Constants::AlgorithmNames::kContractionHierarchies, CHPreprocessing}
+    std::unordered_map<std::string, std::function<void(DatabaseHelper&, Configuration&, std::vector<Profile>&)>> algorithms{
+        {Constants::AlgorithmNames::kContractionHierarchies, StaticCHPreprocessing}
     };
     cfg.profile_preferences.LoadIndices(d);
     auto&& gen = cfg.profile_preferences.GetProfileGenerator();
-    for(auto&& profile : gen.Generate()) {
-        auto it = algorithms.find(cfg.algorithm->name);
-        if (it != algorithms.end()) {
-            it->second(d, cfg, profile);
-        } else {
-            throw InvalidArgumentException{"There is no preprocessing for algorithm " + cfg.algorithm->name + "."};
-        }
+    auto it = algorithms.find(cfg.algorithm->name);
+    if (it != algorithms.end()) {
+        std::vector<Profile> profiles = gen.Generate();
+        it->second(d, cfg, profiles);
+    } else {
+        throw InvalidArgumentException{"There is no preprocessing for algorithm " + cfg.algorithm->name + "."};
     }
 }
 
 static void DynamicModePreprocessing(DatabaseHelper& d, Configuration& cfg) {
     std::unordered_map<std::string, std::function<void(DatabaseHelper&, Configuration&, Profile&)>> algorithms{
-        {Constants::AlgorithmNames::kContractionHierarchies, CHPreprocessing}
+        {Constants::AlgorithmNames::kContractionHierarchies, CHPreprocessing},
+        {Constants::AlgorithmNames::kCustomizableContractionHierarchies, CCHPreprocessing}
     };
     cfg.profile_preferences.LoadIndices(d);
     auto&& gen = cfg.profile_preferences.GetProfileGenerator();
@@ -3,6 +3,7 @@
 #include "routing/utility/point.h"
 #include "routing/query/router.h"
 #include "routing/query/routing_mode.h"
+#include "routing/query/mode_loader.h"
 #include "routing/configuration_parser.h"
 #include "routing/profile/profile_generator.h"
 #include "routing/profile/profile.h"
@@ -11,6 +12,17 @@
 #include "routing/profile/physical_length_index.h"
 #include "routing/table_names.h"
 #include "routing/database/database_helper.h"
+#include "routing/database/connection_pool.h"
+#include "routing/utility/thread_pool.h"
+#include "routing/utility/metrics.h"
+#include "routing/utility/json_writer.h"
+#include "routing/utility/atomic_shared_ptr.h"
+#include "routing/utility/deferred_release.h"
+#include "routing/utility/background_task.h"
+#include "routing/utility/deadline.h"
+#include "routing/query/geometry_options.h"
+#include "routing/spatial/polyline.h"
+#include "routing/exception.h"
 #include "routing/types.h"
 
 #include <ostream>
@@ -20,6 +32,13 @@
 #include <memory>
 #include <chrono>
 #include <functional>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <signal.h>
 
 using namespace routing;
 using namespace profile;
@@ -31,11 +50,73 @@ using namespace database;
  */
 static Profile ParseProfile(const crow::json::rvalue& p, Profile& default_profile);
 
+/**
+ * Parse array of coordinates like [{"lon": 14.4, "lat": 50.1}].
+ */
+static std::vector<utility::Point> ParseCoordinates(const crow::json::rvalue& coordinates);
+
+/**
+ * Parse optional geometry parameters of a routing request - `format` (geojson or polyline), `precision`
+ * of polyline coordinates and either `zoom` of the map or `tolerance` in meters that simplify the polyline.
+ */
+static GeometryOptions ParseGeometryOptions(const crow::query_string& params);
+
+/**
+ * Calculate route through all `coordinates` in their order and write response object with it to `writer`. Legs between
+ * consecutive coordinates are calculated on `pool`. Searches stop by TimeoutException when `deadline` expires.
+ */
+template <typename Mode>
+static void CalculateRoute(Mode& mode, const crow::json::rvalue& coordinates, const crow::json::rvalue& profile, utility::ThreadPool& pool,
+    const GeometryOptions& geometry, const utility::Deadline& deadline, utility::JsonWriter& writer);
+
+/**
+ * Calculate route and at most `max_count` alternative routes between the two `coordinates` and write response
+ * object with them to `writer`.
+ *
+ * @throw InvalidArgumentException if there are not exactly two coordinates.
+ */
+template <typename Mode>
+static void CalculateAlternativeRoutes(Mode& mode, const crow::json::rvalue& coordinates, const crow::json::rvalue& profile, size_t max_count,
+    const GeometryOptions& geometry, const utility::Deadline& deadline, utility::JsonWriter& writer);
+
+/**
+ * Write `route` and `length` members of a route response. Geometry is a GeoJSON array that is sent as a string.
+ */
+template <typename Route>
+static void WriteRoute(const Route& route, profile::PreferenceIndex* base_index, utility::JsonWriter& writer);
+
+/**
+ * Create JSON response from the `body` that is already serialized.
+ */
+static crow::response CreateJsonResponse(std::string&& body);
+
+/**
+ * Create response of a request that was stopped by its deadline. The `response` gets the error.
+ */
+static crow::response CreateTimeoutResponse(crow::json::wvalue& response, const TimeoutException& e);
+
+/**
+ * Check whether the request sends `admin_token` in X-Admin-Token header. No request is admitted if the token is empty.
+ */
+static bool IsAdminRequest(const crow::request& req, const std::string& admin_token);
+
+/**
+ * Create a new mode of the reparsed configuration `cfg` by `create_mode` with a connection from `connection_pool`.
+ * Indices and graphs are loaded to new objects so that the current mode can serve requests meanwhile.
+ */
+template <typename Mode, typename CreateMode>
+static std::shared_ptr<Mode> ReloadMode(Configuration& cfg, DatabaseConnectionPool& connection_pool, const CreateMode& create_mode);
+
 /**
  * Run routing server with the selected Profile mode. This methods never returns.
+ *
+ * @param initial_mode The server takes the only reference to it so that it is freed once it is replaced by a reload.
+ * @param create_mode Create the mode again with reloaded graphs from the reparsed configuration. It is called
+ *      in the background on reload requests.
  */
 template <typename Setup, typename Mode>
-static void RunServer(Configuration& cfg, Mode& mode, const std::string& config_path);
+static void RunServer(Configuration& cfg, std::shared_ptr<Mode>&& initial_mode, const std::function<std::shared_ptr<Mode>(Configuration&)>& create_mode,
+    const std::string& config_path);
 
 int main(int argc, const char ** argv) {
     if (argc != 2) {
@@ -43,60 +124,40 @@ int main(int argc, const char ** argv) {
         return 1;
     }
     std::string config_path = argv[1];
+    // SIGHUP reloads graphs. It is blocked before any thread starts so that all threads inherit the mask
+    // and only the server's signal thread receives it.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
     ConfigurationParser parser{config_path};
     auto&& cfg = parser.Parse();
-    DatabaseHelper d{cfg.database.name, cfg.database.user, cfg.database.password, cfg.database.host, cfg.database.port};
-    
-
-    std::unordered_map<std::string, std::function<void()>> run_options{
-            {
-                Constants::AlgorithmNames::kDijkstra + Constants::ModeNames::kDynamicProfile,
-                [&](){
-                    cfg.profile_preferences.LoadIndices(d);
-                    auto&& gen = cfg.profile_preferences.GetProfileGenerator();
-                    Profile profile = gen.GetFrontProfile();
-                    DynamicProfileMode<DijkstraFactory> m{d, std::make_unique<DijkstraTableNames>(cfg.algorithm->base_graph_table), std::move(profile)};
-                    std::cout << Constants::AlgorithmNames::kDijkstra + Constants::ModeNames::kDynamicProfile << " run mode" << std::endl;
-                    d.DisconnectIfOpen();
-                    RunServer<DijkstraFactory, DynamicProfileMode<DijkstraFactory>>(cfg, m, config_path);
-                }
-            },
-            {
-                Constants::AlgorithmNames::kContractionHierarchies + Constants::ModeNames::kStaticProfile,
-                [&](){
-                    auto&& gen = cfg.profile_preferences.GetProfileGenerator();
-                    std::cout << Constants::AlgorithmNames::kContractionHierarchies + Constants::ModeNames::kStaticProfile << " run mode" << std::endl;
-                    StaticProfileMode<CHStaticFactory> m{};
-                    cfg.profile_preferences.base_index->Load(d, cfg.profile_preferences.base_index_table);
-                    for(auto&& profile : gen.Generate()) {
-                        m.AddRouter(d, std::make_unique<CHTableNames>(cfg.algorithm->base_graph_table, profile), profile);
-                    }
-                    d.DisconnectIfOpen();
-                    RunServer<CHStaticFactory, StaticProfileMode<CHStaticFactory>>(cfg, m, config_path);
-                }
-            },
-            {
-                Constants::AlgorithmNames::kContractionHierarchies + Constants::ModeNames::kDynamicProfile,
-                [&](){
-                    auto&& gen = cfg.profile_preferences.GetProfileGenerator();
-                    Profile profile = gen.GetFrontProfile();
-                    std::unique_ptr<TableNames> table_names = std::make_unique<CHTableNames>(cfg.algorithm->base_graph_table, profile);
-                    cfg.profile_preferences.LoadIndices(d, table_names->GetIndexTablePrefix());
-                    std::cout << Constants::AlgorithmNames::kContractionHierarchies + Constants::ModeNames::kDynamicProfile << " run mode" << std::endl;
-                    DynamicProfileMode<CHDynamicFactory> m{d, std::move(table_names), std::move(profile)};
-                    d.DisconnectIfOpen();
-                    RunServer<CHDynamicFactory, DynamicProfileMode<CHDynamicFactory>>(cfg, m, config_path);
-                }
-            }
-    };
+    // The pool lives as long as the server. Routing requests are answered from memory
+    // so connections are only leased to load graphs and indices.
+    auto&& connection_pool = cfg.database.CreateConnectionPool();
+    auto&& connection = connection_pool->Acquire();
+    DatabaseHelper& d = *connection;
 
-    auto run_server = run_options.find(cfg.algorithm->name + cfg.algorithm->mode);
-    if (run_server != run_options.end()) {
-        std::cout << cfg.algorithm->mode << std::endl;
-        run_server->second();
-    } else {
-        throw InvalidArgumentException{"No such mode= " + cfg.algorithm->mode + " with given algorithm " + cfg.algorithm->name + " was found"};
-    }
+    query::VisitModeLoader(*cfg.algorithm, [&](auto loader) {
+        using Loader = decltype(loader);
+        using Mode = typename Loader::Mode;
+        std::cout << cfg.algorithm->name + cfg.algorithm->mode << " run mode" << std::endl;
+        std::shared_ptr<Mode> m = Loader::Load(cfg, d);
+        connection.Release();
+        connection_pool->CloseIdle();
+        RunServer<typename Loader::Setup, Mode>(cfg, std::move(m), [&](Configuration& reloaded_cfg) {
+            return ReloadMode<Mode>(reloaded_cfg, *connection_pool, &Loader::Load);
+        }, config_path);
+    });
+}
+
+template <typename Mode, typename CreateMode>
+static std::shared_ptr<Mode> ReloadMode(Configuration& cfg, DatabaseConnectionPool& connection_pool, const CreateMode& create_mode) {
+    auto&& connection = connection_pool.Acquire();
+    std::shared_ptr<Mode> mode = create_mode(cfg, *connection);
+    connection.Release();
+    connection_pool.CloseIdle();
+    return mode;
 }
 
 static Profile ParseProfile(const crow::json::rvalue& p, Profile& default_profile) {
@@ -110,12 +171,213 @@ static Profile ParseProfile(const crow::json::rvalue& p, Profile& default_profil
     return profile;
 }
 
+static std::vector<utility::Point> ParseCoordinates(const crow::json::rvalue& coordinates) {
+    std::vector<utility::Point> points{};
+    points.reserve(coordinates.size());
+    for (auto it = coordinates.begin(); it != coordinates.end(); ++it) {
+        points.emplace_back(static_cast<float>((*it)["lon"].d()), static_cast<float>((*it)["lat"].d()));
+    }
+    return points;
+}
+
+static GeometryOptions ParseGeometryOptions(const crow::query_string& params) {
+    GeometryOptions geometry{};
+    char* format = params.get("format");
+    if (!format || std::string{format} == "geojson") {
+        return geometry;
+    }
+    if (std::string{format} != "polyline") {
+        throw InvalidArgumentException{"Unknown geometry format " + std::string{format} + "."};
+    }
+    geometry.format = GeometryFormat::kPolyline;
+    char* precision = params.get("precision");
+    if (precision) {
+        geometry.precision = std::stoi(precision);
+        if (geometry.precision < 1 || geometry.precision > 7) {
+            throw InvalidArgumentException{"Polyline precision must be from 1 to 7."};
+        }
+    }
+    char* zoom = params.get("zoom");
+    char* tolerance = params.get("tolerance");
+    if (tolerance) {
+        geometry.tolerance = std::max(0.0, std::stod(tolerance));
+    } else if (zoom) {
+        geometry.tolerance = spatial::GetZoomTolerance(std::stod(zoom));
+    }
+    return geometry;
+}
+
+template <typename Route>
+static void WriteRoute(const Route& route, profile::PreferenceIndex* base_index, utility::JsonWriter& writer) {
+    writer.Key("route");
+    writer.String(route.get_geometry());
+    writer.Key("length");
+    writer.Number(route.GetLength(base_index));
+}
+
+static crow::response CreateJsonResponse(std::string&& body) {
+    crow::response response{std::move(body)};
+    response.set_header("Content-Type", "application/json");
+    return response;
+}
+
+static bool IsAdminRequest(const crow::request& req, const std::string& admin_token) {
+    if (admin_token.empty()) {
+        return false;
+    }
+    const std::string& token = req.get_header_value("X-Admin-Token");
+    // Every character is compared so that the time of the comparison does not reveal the token.
+    unsigned char difference = token.size() == admin_token.size() ? 0 : 1;
+    for (size_t i = 0; i < admin_token.size(); ++i) {
+        difference |= static_cast<unsigned char>(admin_token[i] ^ (i < token.size() ? token[i] : 0));
+    }
+    return difference == 0;
+}
+
+static crow::response CreateTimeoutResponse(crow::json::wvalue& response, const TimeoutException& e) {
+    std::cout << e.what() << std::endl;
+    response["error"] = e.what();
+    response["ok"] = "false";
+    crow::response timeout_response{response};
+    timeout_response.code = 503;
+    return timeout_response;
+}
+
+template <typename Mode>
+static void CalculateRoute(Mode& mode, const crow::json::rvalue& coordinates, const crow::json::rvalue& profile_preferences, utility::ThreadPool& pool,
+    const GeometryOptions& geometry, const utility::Deadline& deadline, utility::JsonWriter& writer) {
+    Profile profile = ParseProfile(profile_preferences, mode.GetDefaultProfile());
+    std::vector<utility::Point> waypoints = ParseCoordinates(coordinates);
+    auto&& router = mode.GetRouter(profile);
+    auto&& route = waypoints.size() == 2 ? router->CalculateShortestRoute(waypoints[0], waypoints[1], profile, geometry, &deadline)
+        : router->CalculateWaypointRoute(waypoints, profile, pool, geometry, &deadline);
+    // Geometry is the bulk of the response so the output is allocated once for it.
+    writer.Reserve(utility::JsonWriter::GetEscapedSize(route.get_geometry()) + 64);
+    writer.BeginObject();
+    WriteRoute(route, mode.GetDefaultProfile().GetBaseIndex().get(), writer);
+    writer.Key("ok");
+    writer.String("true");
+    writer.EndObject();
+}
+
+template <typename Mode>
+static void CalculateAlternativeRoutes(Mode& mode, const crow::json::rvalue& coordinates, const crow::json::rvalue& profile_preferences, size_t max_count,
+    const GeometryOptions& geometry, const utility::Deadline& deadline, utility::JsonWriter& writer) {
+    if (coordinates.size() != 2) {
+        throw InvalidArgumentException{"Alternative routes need exactly two coordinates."};
+    }
+    Profile profile = ParseProfile(profile_preferences, mode.GetDefaultProfile());
+    utility::Point source{static_cast<float>(coordinates[0]["lon"].d()), static_cast<float>(coordinates[0]["lat"].d())};
+    utility::Point target{static_cast<float>(coordinates[1]["lon"].d()), static_cast<float>(coordinates[1]["lat"].d())};
+    auto&& router = mode.GetRouter(profile);
+    auto&& routes = router->CalculateAlternativeRoutes(source, target, profile, max_count, AlternativeRouteParameters{}, geometry, &deadline);
+    auto&& base_index = mode.GetDefaultProfile().GetBaseIndex().get();
+    size_t size = 64;
+    for (auto&& route : routes) {
+        size += utility::JsonWriter::GetEscapedSize(route.get_geometry()) + 64;
+    }
+    writer.Reserve(size);
+    writer.BeginObject();
+    WriteRoute(routes.front(), base_index, writer);
+    writer.Key("alternatives");
+    writer.BeginArray();
+    for (size_t i = 1; i < routes.size(); ++i) {
+        writer.BeginObject();
+        WriteRoute(routes[i], base_index, writer);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.Key("ok");
+    writer.String("true");
+    writer.EndObject();
+}
 
 template <typename Setup, typename Mode>
-static void RunServer(Configuration& cfg, Mode& mode, const std::string& config_path) {
+static void RunServer(Configuration& cfg, std::shared_ptr<Mode>&& initial_mode, const std::function<std::shared_ptr<Mode>(Configuration&)>& create_mode,
+    const std::string& config_path) {
     crow::SimpleApp app;
+    // Routes of batches and legs of routes through waypoints are calculated on the pool. The request thread works too.
+    utility::ThreadPool worker_pool{cfg.server.batch_threads > 0 ? cfg.server.batch_threads - 1 : 0};
+    // Stages of route calculations are measured by routers, whole requests here. Metrics are kept when graphs are reloaded.
+    auto&& metrics = std::make_shared<RouterMetrics>();
+    utility::Histogram route_request_duration{utility::LatencyBuckets()};
+    utility::Counter route_request_errors{};
+    utility::Counter route_request_timeouts{};
+    // A search that cannot find a route, e.g. between disconnected parts of the graph, can explore the whole graph.
+    // Each request gets a deadline so that such searches do not hold workers for long.
+    std::atomic<std::chrono::milliseconds> request_timeout{std::chrono::milliseconds{cfg.server.request_timeout}};
+    // Settings of a mode are taken from the configuration it was created from. Threads of the worker pool
+    // are started once so `batch_threads` is not reloaded.
+    auto&& prepare_mode = [&](Mode& mode, const ServerConfig& server) {
+        mode.SetRouteCacheCapacity(server.route_cache_size * 1024 * 1024);
+        mode.SetMetrics(metrics);
+    };
+    prepare_mode(*initial_mode, cfg.server);
+
+    // Each request loads the current mode once and uses it until it finishes, so reloaded graphs
+    // replace the old ones without blocking requests and requests in progress keep the old ones.
+    // Requests only share the mode - it is owned and freed by the reload task so that no request pays for freeing it.
+    auto&& owned_mode = std::make_unique<utility::DeferredRelease<Mode>>(std::move(initial_mode));
+    utility::AtomicSharedPtr<Mode> current_mode{owned_mode->Share()};
+    auto&& reload = std::make_shared<utility::BackgroundTask>([&]() {
+        try {
+            std::cout << "Reloading graphs." << std::endl;
+            auto&& start = std::chrono::steady_clock::now();
+            ConfigurationParser parser{config_path};
+            auto&& reloaded_cfg = parser.Parse();
+            std::shared_ptr<Mode> mode = create_mode(reloaded_cfg);
+            prepare_mode(*mode, reloaded_cfg.server);
+            std::unique_ptr<utility::DeferredRelease<Mode>> old_mode = std::move(owned_mode);
+            owned_mode = std::make_unique<utility::DeferredRelease<Mode>>(std::move(mode));
+            current_mode.Exchange(owned_mode->Share());
+            request_timeout = std::chrono::milliseconds{reloaded_cfg.server.request_timeout};
+            auto&& duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            std::cout << "Graphs reloaded in " << duration.count() << " ms." << std::endl;
+            // Wait for requests that still use the old mode and free it on this thread.
+            old_mode.reset();
+        } catch (const std::exception& e) {
+            std::cout << "Reload failed, old graphs are kept: " << e.what() << std::endl;
+        }
+    });
+    // SIGHUP is blocked in all threads by main so that this thread receives it.
+    std::thread{[weak_reload = std::weak_ptr<utility::BackgroundTask>{reload}]() {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGHUP);
+        int signal = 0;
+        while (sigwait(&signals, &signal) == 0) {
+            if (auto&& task = weak_reload.lock()) {
+                task->Start();
+            }
+        }
+    }}.detach();
+
+    // Reload graphs and indices in the background, e.g. after the preprocessor created new ones. The same can be done by SIGHUP.
+    // A reload doubles memory of the graphs for its duration so only clients with the configured admin token can start it.
+    // The token is read at start - reloads do not change it.
+    std::string admin_token = cfg.server.admin_token;
+    CROW_ROUTE(app, "/admin/reload").methods("POST"_method)([&](const crow::request& req) {
+            crow::json::wvalue response;
+            if (!IsAdminRequest(req, admin_token)) {
+                response["error"] = admin_token.empty() ? "Admin endpoints are disabled." : "Invalid admin token.";
+                response["ok"] = "false";
+                crow::response forbidden_response{response};
+                forbidden_response.code = 403;
+                return forbidden_response;
+            }
+            response["started"] = reload->Start() ? "true" : "false";
+            response["ok"] = "true";
+            return crow::response{response};
+    });
+
+    // Parameter `coordinates` are waypoints of the route - the first one is its start and the last one its end.
+    // Route geometry is escaped straight into the response body - the response is not built as crow::json::wvalue.
+    // Optional `format=polyline` returns the route as one encoded polyline that can be simplified by `zoom` or `tolerance`.
     CROW_ROUTE(app, "/route")([&](const crow::request& req) {
+            auto&& mode = current_mode.Load();
             crow::json::wvalue response;
+            utility::Stopwatch stopwatch{};
+            utility::Deadline deadline{request_timeout.load()};
             try {
                 char* coor = req.url_params.get("coordinates");
                 if (!coor) {
@@ -125,25 +387,188 @@ static void RunServer(Configuration& cfg, Mode& mode, const std::string& config_
                 if (!prof) {
                     response["error"] = "No profile query parameter.";
                 }
-                auto&& coordinates = crow::json::load(coor);
-                Profile profile = ParseProfile(crow::json::load(prof), mode.GetDefaultProfile());
-                utility::Point source{static_cast<float>(coordinates[0]["lon"].d()), static_cast<float>(coordinates[0]["lat"].d())};
-                utility::Point target{static_cast<float>(coordinates[1]["lon"].d()), static_cast<float>(coordinates[1]["lat"].d())};
                 std::cout << req.url_params << std::endl;
-                auto&& router = mode.GetRouter(std::move(profile));
-                DatabaseHelper d{cfg.database.name, cfg.database.user, cfg.database.password, cfg.database.host, cfg.database.port};
-                auto&& route = router.CalculateShortestRoute(d, source, target);
-                response["route"] = route.get_geometry();
-                response["length"] = route.GetLength(mode.GetDefaultProfile().GetBaseIndex().get());
+                GeometryOptions geometry = ParseGeometryOptions(req.url_params);
+                std::string body{};
+                utility::JsonWriter writer{body};
+                // Optional `alternatives` is the maximum number of alternative routes that are found by the same search.
+                char* alternatives = req.url_params.get("alternatives");
+                if (alternatives && std::stoul(alternatives) > 0) {
+                    CalculateAlternativeRoutes(*mode, crow::json::load(coor), crow::json::load(prof), std::stoul(alternatives), geometry, deadline,
+                        writer);
+                } else {
+                    CalculateRoute(*mode, crow::json::load(coor), crow::json::load(prof), worker_pool, geometry, deadline, writer);
+                }
+                route_request_duration.Observe(stopwatch.Lap());
+                return CreateJsonResponse(std::move(body));
+            } catch(const TimeoutException& e) {
+                route_request_timeouts.Increment();
+                route_request_duration.Observe(stopwatch.Lap());
+                return CreateTimeoutResponse(response, e);
+            } catch(const InvalidArgumentException& e) {
+                response["error"] = e.what();
+                response["ok"] = "false";
+                route_request_errors.Increment();
+            } catch(const std::exception& e){
+                std::cout << e.what() << std::endl;
+                response["ok"] = "false";
+                route_request_errors.Increment();
+            }
+            route_request_duration.Observe(stopwatch.Lap());
+            return crow::response{response};
+    });
+
+
+    // Request body is {"sources": [{"lon": , "lat": }, ...], "targets": [...], "profile": [...]}. Coordinates are
+    // in the body since thousands of them do not fit in a url.
+    CROW_ROUTE(app, "/table").methods("POST"_method)([&](const crow::request& req) {
+            auto&& mode = current_mode.Load();
+            crow::json::wvalue response;
+            utility::Deadline deadline{request_timeout.load()};
+            try {
+                auto&& body = crow::json::load(req.body);
+                if (!body || !body.has("sources") || !body.has("targets") || !body.has("profile")) {
+                    response["error"] = "Body must contain sources, targets and profile.";
+                    response["ok"] = "false";
+                    return crow::response{response};
+                }
+                Profile profile = ParseProfile(body["profile"], mode->GetDefaultProfile());
+                std::vector<utility::Point> sources = ParseCoordinates(body["sources"]);
+                std::vector<utility::Point> targets = ParseCoordinates(body["targets"]);
+                auto&& start = std::chrono::steady_clock::now();
+                auto&& router = mode->GetRouter(profile);
+                auto&& table = router->CalculateDistanceTable(sources, targets, profile, &deadline);
+                // Tables have millions of cells so rows are written straight into the body, ~12 chars per distance.
+                std::string response_body{};
+                utility::JsonWriter writer{response_body};
+                writer.Reserve(table.get_source_count() * (table.get_target_count() * 12 + 2) + 64);
+                writer.BeginObject();
+                writer.Key("distances");
+                writer.BeginArray();
+                for (size_t i = 0; i < table.get_source_count(); ++i) {
+                    writer.BeginArray();
+                    for (size_t j = 0; j < table.get_target_count(); ++j) {
+                        // Unreachable targets are null.
+                        if (table.IsReachable(i, j)) {
+                            writer.Number(table.GetDistance(i, j));
+                        } else {
+                            writer.Null();
+                        }
+                    }
+                    writer.EndArray();
+                }
+                writer.EndArray();
+                writer.Key("ok");
+                writer.String("true");
+                writer.EndObject();
+                auto&& duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+                std::cout << "Table " << sources.size() << "x" << targets.size() << " calculated in " << duration.count() << " ms." << std::endl;
+                return CreateJsonResponse(std::move(response_body));
+            } catch(const TimeoutException& e) {
+                return CreateTimeoutResponse(response, e);
+            } catch(const std::exception& e){
+                std::cout << e.what() << std::endl;
+                response["ok"] = "false";
+            }
+            return crow::response{response};
+    });
+
+    // Parameters are `coordinates` of sources, `profile` and `max_cost`. Response contains geometries of edges
+    // reachable from any source by routes not longer than `max_cost` in the profile lengths.
+    CROW_ROUTE(app, "/isochrone")([&](const crow::request& req) {
+            auto&& mode = current_mode.Load();
+            crow::json::wvalue response;
+            utility::Deadline deadline{request_timeout.load()};
+            try {
+                char* coor = req.url_params.get("coordinates");
+                char* prof = req.url_params.get("profile");
+                char* max_cost = req.url_params.get("max_cost");
+                if (!coor || !prof || !max_cost) {
+                    response["error"] = "Query parameters coordinates, profile and max_cost are required.";
+                    response["ok"] = "false";
+                    return crow::response{response};
+                }
+                Profile profile = ParseProfile(crow::json::load(prof), mode->GetDefaultProfile());
+                std::vector<utility::Point> sources = ParseCoordinates(crow::json::load(coor));
+                auto&& start = std::chrono::steady_clock::now();
+                auto&& router = mode->GetRouter(profile);
+                response["edges"] = router->CalculateIsochrone(sources, std::stof(max_cost), profile, &deadline);
                 response["ok"] = "true";
-                
+                auto&& duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+                std::cout << "Isochrone calculated in " << duration.count() << " ms." << std::endl;
+            } catch(const TimeoutException& e) {
+                return CreateTimeoutResponse(response, e);
             } catch(const std::exception& e){
                 std::cout << e.what() << std::endl;
                 response["ok"] = "false";
             }
-            return response;
+            return crow::response{response};
     });
 
+    // Request body is {"routes": [{"coordinates": [...], "profile": [...]}, ...]} with items like `/route` parameters.
+    // Routes are calculated in parallel and written in the order of the items. A failed item does not fail the others.
+    CROW_ROUTE(app, "/route/batch").methods("POST"_method)([&](const crow::request& req) {
+            auto&& body = crow::json::load(req.body);
+            if (!body || !body.has("routes")) {
+                crow::json::wvalue response;
+                response["error"] = "Body must contain routes.";
+                response["ok"] = "false";
+                return crow::response{response};
+            }
+            auto&& items = body["routes"];
+            auto&& mode = current_mode.Load();
+            std::vector<std::string> results(items.size());
+            auto&& start = std::chrono::steady_clock::now();
+            // One deadline bounds the whole batch. Items that start or still run after it expires report timeout.
+            utility::Deadline deadline{request_timeout.load()};
+            // Routers are shared and each concurrent search takes its own workspace from the router.
+            worker_pool.ParallelFor(items.size(), [&](size_t i) {
+                try {
+                    deadline.Check();
+                    utility::JsonWriter writer{results[i]};
+                    CalculateRoute(*mode, items[i]["coordinates"], items[i]["profile"], worker_pool, GeometryOptions{}, deadline, writer);
+                } catch(const TimeoutException& e) {
+                    std::cout << e.what() << std::endl;
+                    results[i] = "{\"error\":\"timeout\",\"ok\":\"false\"}";
+                } catch(const std::exception& e) {
+                    std::cout << e.what() << std::endl;
+                    results[i] = "{\"ok\":\"false\"}";
+                }
+            });
+            auto&& duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            std::cout << "Batch of " << results.size() << " routes calculated in " << duration.count() << " ms." << std::endl;
+            size_t size = 0;
+            for (auto&& result : results) {
+                size += result.size() + 1;
+            }
+            std::string response_body{};
+            response_body.reserve(size + 32);
+            response_body += "{\"ok\":\"true\",\"routes\":[";
+            for (size_t i = 0; i < results.size(); ++i) {
+                if (i > 0) {
+                    response_body += ",";
+                }
+                response_body += results[i];
+            }
+            response_body += "]}";
+            return CreateJsonResponse(std::move(response_body));
+    });
+
+    // Metrics in Prometheus text format.
+    CROW_ROUTE(app, "/metrics")([&]() {
+            std::ostringstream out{};
+            utility::PrometheusWriter writer{out};
+            writer.WriteHeader("routing_route_request_duration_seconds", "Duration of /route requests.", "histogram");
+            writer.WriteHistogram("routing_route_request_duration_seconds", "", route_request_duration);
+            writer.WriteHeader("routing_route_request_errors_total", "Failed /route requests.", "counter");
+            writer.WriteCounter("routing_route_request_errors_total", "", route_request_errors);
+            writer.WriteHeader("routing_route_request_timeouts_total", "/route requests stopped by their deadline.", "counter");
+            writer.WriteCounter("routing_route_request_timeouts_total", "", route_request_timeouts);
+            metrics->Write(out);
+            crow::response response{out.str()};
+            response.set_header("Content-Type", "text/plain; version=0.0.4");
+            return response;
+    });
 
     CROW_ROUTE(app, "/profile_preferences")([&](const crow::request& req) {
             crow::json::wvalue response;
@@ -165,12 +590,8 @@ static void RunServer(Configuration& cfg, Mode& mode, const std::string& config_
             return response;
     });
 
-    // In dynamic profile, the profile of the road graph is changed; threfore,
-    // only singlethreaded server is possible.
-    if (cfg.algorithm->mode == Constants::ModeNames::kDynamicProfile) {
-        app.port(18080).concurrency(1).run();
-    } else {
-        app.port(18080).multithreaded().run();
-    }
+    // Routers are not changed by requests (profiles are passed per request) so requests
+    // can be handled concurrently in all modes.
+    app.port(18080).multithreaded().run();
 }
 
@@ -0,0 +1,103 @@
+#include "routing/snapshot/ch_graph_snapshot.h"
+#include "routing/exception.h"
+
+#include <cstring>
+
+using namespace std;
+namespace routing {
+namespace snapshot {
+
+namespace {
+
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+}
+
+CHGraphSnapshot::CHGraphSnapshot(const string& path) : file_(path), header_(nullptr) {
+    if (file_.GetSize() < sizeof(CHGraphSnapshotHeader)) {
+        throw SnapshotException{"Snapshot " + path + " is too small."};
+    }
+    header_ = reinterpret_cast<const CHGraphSnapshotHeader*>(file_.GetData());
+    Validate(path);
+}
+
+string CHGraphSnapshot::GetPath(const string& directory, const string& edges_table) {
+    if (directory.empty() || directory.back() == '/') {
+        return directory + edges_table + kFileExtension;
+    }
+    return directory + "/" + edges_table + kFileExtension;
+}
+
+void CHGraphSnapshot::CheckSource(const string& source_table, uint64_t preprocessing_id) const {
+    if (GetSourceTable() != source_table || GetPreprocessingId() != preprocessing_id) {
+        throw SnapshotException{"Snapshot of table " + GetSourceTable() + " from preprocessing " + to_string(GetPreprocessingId()) +
+            " does not match table " + source_table + " from preprocessing " + to_string(preprocessing_id) + "."};
+    }
+}
+
+uint64_t CHGraphSnapshot::Checksum(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = kFnvOffsetBasis;
+    size_t word_count = size / sizeof(uint64_t);
+    for (size_t i = 0; i < word_count; ++i) {
+        uint64_t word;
+        memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+        hash = (hash ^ word) * kFnvPrime;
+    }
+    for (size_t i = word_count * sizeof(uint64_t); i < size; ++i) {
+        hash = (hash ^ bytes[i]) * kFnvPrime;
+    }
+    return hash;
+}
+
+void CHGraphSnapshot::Validate(const string& path) const {
+    const CHGraphSnapshotHeader& header = *header_;
+    if (header.magic != kMagic) {
+        throw SnapshotException{"File " + path + " is not a graph snapshot."};
+    }
+    if (header.version != kVersion) {
+        throw SnapshotException{"Snapshot " + path + " has version " + to_string(header.version) +
+            " but version " + to_string(kVersion) + " is required."};
+    }
+    if (header.header_checksum != Checksum(&header, offsetof(CHGraphSnapshotHeader, header_checksum))) {
+        throw SnapshotException{"Snapshot " + path + " has damaged header."};
+    }
+    if (header.edge_record_size != sizeof(CHGraphSnapshotEdge) || header.file_size != file_.GetSize()) {
+        throw SnapshotException{"Snapshot " + path + " has invalid size."};
+    }
+    if (memchr(header.source_table, '\0', sizeof(header.source_table)) == nullptr) {
+        throw SnapshotException{"Snapshot " + path + " has invalid source table."};
+    }
+    auto&& check_section = [&](uint64_t offset, uint64_t size, uint64_t checksum, const std::string& name) {
+        if (offset % 8 != 0 || offset < sizeof(CHGraphSnapshotHeader) || offset > header.file_size || size > header.file_size - offset) {
+            throw SnapshotException{"Snapshot " + path + " has invalid " + name + " section."};
+        }
+        if (checksum != Checksum(file_.GetData() + offset, size)) {
+            throw SnapshotException{"Snapshot " + path + " has damaged " + name + " section."};
+        }
+    };
+    check_section(header.first_edges_offset, (header.vertex_count + 1) * sizeof(uint64_t), header.first_edges_checksum, "first edges");
+    check_section(header.ordering_ranks_offset, header.vertex_count * sizeof(uint32_t), header.ordering_ranks_checksum, "ordering ranks");
+    check_section(header.edges_offset, header.edge_count * sizeof(CHGraphSnapshotEdge), header.edges_checksum, "edges");
+
+    // Edge ranges are turned into iterators so they must stay inside of the edges section.
+    const uint64_t* first_edges = GetFirstEdges();
+    if (first_edges[0] != 0 || first_edges[header.vertex_count] != header.edge_count) {
+        throw SnapshotException{"Snapshot " + path + " has invalid edge ranges."};
+    }
+    for (size_t i = 0; i < header.vertex_count; ++i) {
+        if (first_edges[i] > first_edges[i + 1]) {
+            throw SnapshotException{"Snapshot " + path + " has invalid edge ranges."};
+        }
+    }
+}
+
+void CHGraphSnapshot::WriteSection(ofstream& output, const void* data, size_t size) {
+    static const char padding[8] = {};
+    output.write(static_cast<const char*>(data), size);
+    output.write(padding, Align(size) - size);
+}
+
+}
+}
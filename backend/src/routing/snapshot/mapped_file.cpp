@@ -0,0 +1,74 @@
+#include "routing/snapshot/mapped_file.h"
+#include "routing/exception.h"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+namespace routing {
+namespace snapshot {
+
+MappedFile::MappedFile(const string& path) : data_(nullptr), size_(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw SnapshotException{"Snapshot " + path + " cannot be opened: " + strerror(errno)};
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1) {
+        int error = errno;
+        close(fd);
+        throw SnapshotException{"Snapshot " + path + " cannot be read: " + strerror(error)};
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ == 0) {
+        close(fd);
+        throw SnapshotException{"Snapshot " + path + " is empty."};
+    }
+    void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    int error = errno;
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw SnapshotException{"Snapshot " + path + " cannot be mapped: " + strerror(error)};
+    }
+    // The whole file is read right away so let the kernel read ahead.
+    madvise(data, size_, MADV_WILLNEED);
+    data_ = static_cast<const uint8_t*>(data);
+}
+
+MappedFile::MappedFile(MappedFile&& other) : data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+    if (this != &other) {
+        Unmap();
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    Unmap();
+}
+
+void MappedFile::Unmap() {
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+}
+}
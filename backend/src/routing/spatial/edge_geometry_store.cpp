@@ -0,0 +1,95 @@
+#include "routing/spatial/edge_geometry_store.h"
+#include "routing/exception.h"
+
+#include <cmath>
+
+using namespace std;
+namespace routing {
+namespace spatial {
+
+EdgeGeometryStore::EdgeGeometryStore() : offsets_{0}, data_(), point_count_(0) {}
+
+void EdgeGeometryStore::AddEdge(unsigned_id_type uid, const vector<utility::Point>& geometry) {
+    if (uid + 1 < offsets_.size()) {
+        throw InvalidArgumentException{"Edge geometries must be added in increasing order of uids - uid " + to_string(uid) + " is out of order."};
+    }
+    // Edges with uids that were skipped have empty geometries.
+    offsets_.resize(uid + 1, data_.size());
+    int32_t previous_lon = 0;
+    int32_t previous_lat = 0;
+    for (auto&& p : geometry) {
+        int32_t lon = static_cast<int32_t>(lround(p.lon_ * kPrecision));
+        int32_t lat = static_cast<int32_t>(lround(p.lat_ * kPrecision));
+        Encode(lon - previous_lon);
+        Encode(lat - previous_lat);
+        previous_lon = lon;
+        previous_lat = lat;
+    }
+    point_count_ += geometry.size();
+    offsets_.push_back(data_.size());
+}
+
+bool EdgeGeometryStore::Contains(unsigned_id_type uid) const {
+    return uid + 1 < offsets_.size() && offsets_[uid] != offsets_[uid + 1];
+}
+
+vector<utility::Point> EdgeGeometryStore::GetGeometry(unsigned_id_type uid) const {
+    vector<utility::Point> geometry{};
+    ForEachPoint(uid, [&](const utility::Point& p) {
+        geometry.push_back(p);
+    });
+    return geometry;
+}
+
+void EdgeGeometryStore::AppendGeoJson(string& output, unsigned_id_type uid) const {
+    output += "{\"type\":\"LineString\",\"coordinates\":[";
+    if (Contains(uid)) {
+        const uint8_t* it = data_.data() + offsets_[uid];
+        const uint8_t* end = data_.data() + offsets_[uid + 1];
+        int32_t lon = 0;
+        int32_t lat = 0;
+        bool first = true;
+        while (it != end) {
+            lon += Decode(it);
+            lat += Decode(it);
+            if (!first) {
+                output += ',';
+            }
+            first = false;
+            output += '[';
+            AppendFixedPoint(output, lon);
+            output += ',';
+            AppendFixedPoint(output, lat);
+            output += ']';
+        }
+    }
+    output += "]}";
+}
+
+void EdgeGeometryStore::Encode(int32_t value) {
+    uint32_t zigzag = (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    while (zigzag >= 0x80) {
+        data_.push_back(static_cast<uint8_t>(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+    data_.push_back(static_cast<uint8_t>(zigzag));
+}
+
+void EdgeGeometryStore::AppendFixedPoint(string& output, int32_t value) {
+    if (value < 0) {
+        output += '-';
+    }
+    uint32_t absolute = (value < 0) ? -static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+    output += to_string(absolute / 1000000);
+    output += '.';
+    char fraction[6];
+    uint32_t rest = absolute % 1000000;
+    for (int i = 5; i >= 0; --i) {
+        fraction[i] = static_cast<char>('0' + rest % 10);
+        rest /= 10;
+    }
+    output.append(fraction, 6);
+}
+
+}
+}
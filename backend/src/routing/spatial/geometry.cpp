@@ -0,0 +1,71 @@
+#include "routing/spatial/geometry.h"
+#include "routing/exception.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+namespace routing {
+namespace spatial {
+
+vector<utility::Point> ParseWktLineString(const string& wkt) {
+    size_t open = wkt.find('(');
+    size_t close = wkt.rfind(')');
+    if (open == string::npos || close == string::npos || close < open) {
+        throw ParseException{"Invalid WKT linestring: " + wkt};
+    }
+    vector<utility::Point> points{};
+    const char* it = wkt.c_str() + open + 1;
+    const char* end = wkt.c_str() + close;
+    while (it < end) {
+        char* next = nullptr;
+        double lon = strtod(it, &next);
+        if (next == it) {
+            throw ParseException{"Invalid WKT linestring: " + wkt};
+        }
+        it = next;
+        double lat = strtod(it, &next);
+        if (next == it) {
+            throw ParseException{"Invalid WKT linestring: " + wkt};
+        }
+        it = next;
+        points.emplace_back(static_cast<float>(lon), static_cast<float>(lat));
+        while (it < end && (*it == ',' || *it == ' ')) {
+            ++it;
+        }
+    }
+    return points;
+}
+
+void AppendGeoJsonLineString(string& output, const utility::Point* begin, const utility::Point* end) {
+    output += "{\"type\":\"LineString\",\"coordinates\":[";
+    char buffer[64];
+    for (auto it = begin; it != end; ++it) {
+        if (it != begin) {
+            output += ',';
+        }
+        int size = snprintf(buffer, sizeof(buffer), "[%.6f,%.6f]", it->lon_, it->lat_);
+        output.append(buffer, size);
+    }
+    output += "]}";
+}
+
+string MakeGeoJsonLineString(const vector<utility::Point>& points) {
+    string output{};
+    AppendGeoJsonLineString(output, points.data(), points.data() + points.size());
+    return output;
+}
+
+double CalculateDistance(const utility::Point& a, const utility::Point& b) {
+    constexpr double kDegreesToRadians = M_PI / 180.0;
+    double lat_a = a.lat_ * kDegreesToRadians;
+    double lat_b = b.lat_ * kDegreesToRadians;
+    double sin_lat = sin((lat_b - lat_a) / 2);
+    double sin_lon = sin((b.lon_ - a.lon_) * kDegreesToRadians / 2);
+    double h = sin_lat * sin_lat + cos(lat_a) * cos(lat_b) * sin_lon * sin_lon;
+    return 2 * kEarthRadius * asin(min(1.0, sqrt(h)));
+}
+
+}
+}
@@ -0,0 +1,168 @@
+#include "routing/spatial/polyline.h"
+#include "routing/spatial/geometry.h"
+#include "routing/exception.h"
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+using namespace std;
+namespace routing {
+namespace spatial {
+
+/**
+ * Append one coordinate difference - zigzag encoded in 5 bit chunks offset by 63.
+ */
+static void AppendEncodedValue(string& output, int64_t value) {
+    uint64_t zigzag = value < 0 ? ~(static_cast<uint64_t>(value) << 1) : static_cast<uint64_t>(value) << 1;
+    while (zigzag >= 0x20) {
+        output += static_cast<char>((0x20 | (zigzag & 0x1f)) + 63);
+        zigzag >>= 5;
+    }
+    output += static_cast<char>(zigzag + 63);
+}
+
+static int64_t DecodeValue(const string& polyline, size_t& i) {
+    uint64_t zigzag = 0;
+    int shift = 0;
+    uint64_t chunk;
+    do {
+        if (i >= polyline.size()) {
+            throw ParseException{"Polyline ends in the middle of a point."};
+        }
+        chunk = static_cast<uint64_t>(polyline[i++] - 63);
+        zigzag |= (chunk & 0x1f) << shift;
+        shift += 5;
+    } while (chunk >= 0x20);
+    return (zigzag & 1) ? ~static_cast<int64_t>(zigzag >> 1) : static_cast<int64_t>(zigzag >> 1);
+}
+
+vector<utility::Point> SimplifyLine(const vector<utility::Point>& points, double tolerance) {
+    if (tolerance <= 0 || points.size() <= 2) {
+        return points;
+    }
+    // Points are projected to a plane in meters around the first point which is precise enough for routes.
+    constexpr double kDegreesToRadians = M_PI / 180.0;
+    double lon_scale = cos(points.front().lat_ * kDegreesToRadians) * kEarthRadius * kDegreesToRadians;
+    double lat_scale = kEarthRadius * kDegreesToRadians;
+    vector<pair<double, double>> projected{};
+    projected.reserve(points.size());
+    for (auto&& point : points) {
+        projected.emplace_back(point.lon_ * lon_scale, point.lat_ * lat_scale);
+    }
+    double squared_tolerance = tolerance * tolerance;
+    auto&& squared_distance = [&](size_t p, size_t a, size_t b) {
+        double dx = projected[b].first - projected[a].first;
+        double dy = projected[b].second - projected[a].second;
+        double px = projected[p].first - projected[a].first;
+        double py = projected[p].second - projected[a].second;
+        double length = dx * dx + dy * dy;
+        double t = length > 0 ? max(0.0, min(1.0, (px * dx + py * dy) / length)) : 0;
+        double x = px - t * dx;
+        double y = py - t * dy;
+        return x * x + y * y;
+    };
+
+    vector<bool> kept(points.size(), false);
+    kept.front() = true;
+    kept.back() = true;
+    // Ranges are processed by an explicit stack since routes have too many points for recursion.
+    vector<pair<size_t, size_t>> ranges{{0, points.size() - 1}};
+    while (!ranges.empty()) {
+        auto [first, last] = ranges.back();
+        ranges.pop_back();
+        double max_distance = 0;
+        size_t farthest = first;
+        for (size_t i = first + 1; i < last; ++i) {
+            double distance = squared_distance(i, first, last);
+            if (distance > max_distance) {
+                max_distance = distance;
+                farthest = i;
+            }
+        }
+        if (max_distance > squared_tolerance) {
+            kept[farthest] = true;
+            ranges.emplace_back(first, farthest);
+            ranges.emplace_back(farthest, last);
+        }
+    }
+
+    vector<utility::Point> simplified{};
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (kept[i]) {
+            simplified.push_back(points[i]);
+        }
+    }
+    return simplified;
+}
+
+void AppendEncodedPolyline(string& output, const vector<utility::Point>& points, int precision) {
+    double factor = pow(10, precision);
+    int64_t previous_lat = 0;
+    int64_t previous_lon = 0;
+    for (auto&& point : points) {
+        int64_t lat = llround(point.lat_ * factor);
+        int64_t lon = llround(point.lon_ * factor);
+        AppendEncodedValue(output, lat - previous_lat);
+        AppendEncodedValue(output, lon - previous_lon);
+        previous_lat = lat;
+        previous_lon = lon;
+    }
+}
+
+string EncodePolyline(const vector<utility::Point>& points, int precision) {
+    string output{};
+    // Most differences of consecutive route points fit in 2 or 3 characters.
+    output.reserve(points.size() * 6);
+    AppendEncodedPolyline(output, points, precision);
+    return output;
+}
+
+PolylinePoint DecodePolylineEnd(const string& polyline) {
+    PolylinePoint end{0, 0};
+    size_t i = 0;
+    while (i < polyline.size()) {
+        end.lat += DecodeValue(polyline, i);
+        end.lon += DecodeValue(polyline, i);
+    }
+    return end;
+}
+
+void AppendPolyline(string& polyline, const PolylinePoint& end, const string& next) {
+    if (next.empty()) {
+        return;
+    }
+    size_t i = 0;
+    int64_t next_lat = DecodeValue(next, i);
+    int64_t next_lon = DecodeValue(next, i);
+    // Differences after the first point of `next` stay the same.
+    if (polyline.empty() || next_lat != end.lat || next_lon != end.lon) {
+        AppendEncodedValue(polyline, next_lat - end.lat);
+        AppendEncodedValue(polyline, next_lon - end.lon);
+    }
+    polyline.append(next, i, string::npos);
+}
+
+vector<utility::Point> DecodePolyline(const string& polyline, int precision) {
+    double factor = pow(10, precision);
+    vector<utility::Point> points{};
+    int64_t lat = 0;
+    int64_t lon = 0;
+    size_t i = 0;
+    while (i < polyline.size()) {
+        lat += DecodeValue(polyline, i);
+        lon += DecodeValue(polyline, i);
+        points.emplace_back(static_cast<float>(lon / factor), static_cast<float>(lat / factor));
+    }
+    return points;
+}
+
+double GetZoomTolerance(double zoom) {
+    // Web Mercator tile of 256 pixels spans the equator of the WGS 84 ellipsoid at zoom 0.
+    constexpr double kEquatorialRadius = 6378137.0;
+    constexpr double kEquatorPixelSize = 2 * M_PI * kEquatorialRadius / 256;
+    return kEquatorPixelSize / pow(2, zoom);
+}
+
+}
+}
@@ -0,0 +1,262 @@
+#include "routing/spatial/segment_index.h"
+#include "routing/spatial/geometry.h"
+#include "routing/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+using namespace std;
+namespace routing {
+namespace spatial {
+
+namespace {
+
+constexpr double kMetersPerDegree = kEarthRadius * M_PI / 180.0;
+
+/**
+ * Cells smaller than this do not speed up the search but cost memory.
+ */
+constexpr double kMinCellSize = 25.0;
+
+/**
+ * Desired average number of segments in one cell.
+ */
+constexpr double kSegmentsPerCell = 2.0;
+
+constexpr uint32_t kNoEdge = numeric_limits<uint32_t>::max();
+
+}
+
+SegmentIndex::SegmentIndex(const std::shared_ptr<const EdgeGeometryStore>& geometry_store)
+    : geometry_store_(geometry_store), uids_(), from_(), to_(), uid_edges_(), reference_cos_(1), min_x_(0), min_y_(0), cell_size_(kMinCellSize),
+        column_count_(0), row_count_(0), cell_offsets_(), cell_segments_() {}
+
+void SegmentIndex::AddEdge(unsigned_id_type uid, unsigned_id_type from, unsigned_id_type to) {
+    uids_.push_back(uid);
+    from_.push_back(from);
+    to_.push_back(to);
+}
+
+void SegmentIndex::Build() {
+    cell_offsets_.clear();
+    cell_segments_.clear();
+    column_count_ = 0;
+    row_count_ = 0;
+
+    uid_edges_.clear();
+    for (uint32_t edge = 0; edge < uids_.size(); ++edge) {
+        if (uids_[edge] >= uid_edges_.size()) {
+            uid_edges_.resize(uids_[edge] + 1, kNoEdge);
+        }
+        uid_edges_[uids_[edge]] = edge;
+    }
+
+    float min_lat = numeric_limits<float>::max();
+    float max_lat = numeric_limits<float>::lowest();
+    size_t segment_count = 0;
+    for (auto&& uid : uids_) {
+        size_t point_count = 0;
+        geometry_store_->ForEachPoint(uid, [&](const utility::Point& p) {
+            min_lat = min(min_lat, p.lat_);
+            max_lat = max(max_lat, p.lat_);
+            ++point_count;
+        });
+        segment_count += (point_count > 0) ? point_count - 1 : 0;
+    }
+    if (segment_count == 0) {
+        return;
+    }
+    reference_cos_ = cos((min_lat + max_lat) / 2 * M_PI / 180.0);
+
+    double max_x = numeric_limits<double>::lowest();
+    double max_y = numeric_limits<double>::lowest();
+    min_x_ = numeric_limits<double>::max();
+    min_y_ = numeric_limits<double>::max();
+    ForEachSegment([&](uint32_t edge, uint32_t first_point, const ProjectedPoint& a, const ProjectedPoint& b) {
+        min_x_ = min({min_x_, a.x, b.x});
+        min_y_ = min({min_y_, a.y, b.y});
+        max_x = max({max_x, a.x, b.x});
+        max_y = max({max_y, a.y, b.y});
+    });
+
+    double area = max(max_x - min_x_, kMinCellSize) * max(max_y - min_y_, kMinCellSize);
+    cell_size_ = max(kMinCellSize, sqrt(area * kSegmentsPerCell / segment_count));
+    column_count_ = static_cast<size_t>((max_x - min_x_) / cell_size_) + 1;
+    row_count_ = static_cast<size_t>((max_y - min_y_) / cell_size_) + 1;
+
+    // Counting sort of segments to cells - the first pass counts segments in each cell
+    // and the second one places them.
+    auto&& for_each_segment_cell = [&](const auto& f) {
+        ForEachSegment([&](uint32_t edge, uint32_t first_point, const ProjectedPoint& a, const ProjectedPoint& b) {
+            size_t column_end = GetColumn(max(a.x, b.x));
+            size_t row_end = GetRow(max(a.y, b.y));
+            for (size_t column = GetColumn(min(a.x, b.x)); column <= column_end; ++column) {
+                for (size_t row = GetRow(min(a.y, b.y)); row <= row_end; ++row) {
+                    f(row * column_count_ + column, Segment{edge, first_point});
+                }
+            }
+        });
+    };
+
+    cell_offsets_.assign(column_count_ * row_count_ + 1, 0);
+    for_each_segment_cell([&](size_t cell, const Segment& segment) {
+        ++cell_offsets_[cell + 1];
+    });
+    for (size_t i = 1; i < cell_offsets_.size(); ++i) {
+        cell_offsets_[i] += cell_offsets_[i - 1];
+    }
+    cell_segments_.resize(cell_offsets_.back());
+    vector<uint32_t> cell_fill{cell_offsets_.begin(), cell_offsets_.end() - 1};
+    for_each_segment_cell([&](size_t cell, const Segment& segment) {
+        cell_segments_[cell_fill[cell]++] = segment;
+    });
+}
+
+unsigned_id_type SegmentIndex::GetGeometryStart(unsigned_id_type uid) const {
+    if (uid >= uid_edges_.size() || uid_edges_[uid] == kNoEdge) {
+        return 0;
+    }
+    return from_[uid_edges_[uid]];
+}
+
+EdgeSplit SegmentIndex::FindClosestEdge(utility::Point location) const {
+    if (cell_segments_.empty()) {
+        throw RouteNotFoundException{"Route cannot be found - no edge is close to the endpoint."};
+    }
+    ProjectedPoint p = Project(location);
+    size_t column = GetColumn(p.x);
+    size_t row = GetRow(p.y);
+
+    double best_distance = numeric_limits<double>::max();
+    Segment best_segment{0, 0};
+    ProjectedPoint best_point{0, 0};
+    size_t max_radius = max(column_count_, row_count_);
+    // Projected points of edges whose segments were visited. Segments of one edge are in many cells
+    // so each edge is decoded from the geometry store at most once per lookup.
+    unordered_map<uint32_t, size_t> edge_first_points{};
+    vector<ProjectedPoint> edge_points{};
+    for (size_t radius = 0; radius <= max_radius; ++radius) {
+        ForEachCellInRing(column, row, radius, [&](size_t cell) {
+            for (uint32_t i = cell_offsets_[cell]; i < cell_offsets_[cell + 1]; ++i) {
+                const Segment& segment = cell_segments_[i];
+                auto&& [it, inserted] = edge_first_points.try_emplace(segment.edge, edge_points.size());
+                if (inserted) {
+                    geometry_store_->ForEachPoint(uids_[segment.edge], [&](const utility::Point& point) {
+                        edge_points.push_back(Project(point));
+                    });
+                }
+                ProjectedPoint a = edge_points[it->second + segment.first_point];
+                ProjectedPoint b = edge_points[it->second + segment.first_point + 1];
+                double dx = b.x - a.x;
+                double dy = b.y - a.y;
+                double squared_length = dx * dx + dy * dy;
+                double t = 0;
+                if (squared_length > 0) {
+                    t = clamp(((p.x - a.x) * dx + (p.y - a.y) * dy) / squared_length, 0.0, 1.0);
+                }
+                ProjectedPoint closest{a.x + t * dx, a.y + t * dy};
+                double distance = (p.x - closest.x) * (p.x - closest.x) + (p.y - closest.y) * (p.y - closest.y);
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best_segment = segment;
+                    best_point = closest;
+                }
+            }
+        });
+        // Location clamped to the grid is in the (column, row) cell so all segments
+        // in the unvisited cells are at least radius * cell_size_ far away.
+        double searched_range = radius * cell_size_;
+        if (best_distance <= searched_range * searched_range) {
+            break;
+        }
+    }
+    return SplitEdge(best_segment, best_point);
+}
+
+SegmentIndex::ProjectedPoint SegmentIndex::Project(const utility::Point& p) const {
+    return ProjectedPoint{p.lon_ * kMetersPerDegree * reference_cos_, p.lat_ * kMetersPerDegree};
+}
+
+utility::Point SegmentIndex::Unproject(const ProjectedPoint& p) const {
+    return utility::Point{static_cast<float>(p.x / (kMetersPerDegree * reference_cos_)), static_cast<float>(p.y / kMetersPerDegree)};
+}
+
+size_t SegmentIndex::GetColumn(double x) const {
+    double column = floor((x - min_x_) / cell_size_);
+    return static_cast<size_t>(clamp(column, 0.0, static_cast<double>(column_count_ - 1)));
+}
+
+size_t SegmentIndex::GetRow(double y) const {
+    double row = floor((y - min_y_) / cell_size_);
+    return static_cast<size_t>(clamp(row, 0.0, static_cast<double>(row_count_ - 1)));
+}
+
+template <typename Function>
+void SegmentIndex::ForEachSegment(const Function& f) const {
+    for (uint32_t edge = 0; edge < uids_.size(); ++edge) {
+        uint32_t point_index = 0;
+        ProjectedPoint previous{0, 0};
+        geometry_store_->ForEachPoint(uids_[edge], [&](const utility::Point& p) {
+            ProjectedPoint current = Project(p);
+            if (point_index > 0) {
+                f(edge, point_index - 1, previous, current);
+            }
+            previous = current;
+            ++point_index;
+        });
+    }
+}
+
+template <typename Function>
+void SegmentIndex::ForEachCellInRing(size_t column, size_t row, size_t radius, const Function& f) const {
+    long long c = static_cast<long long>(column);
+    long long r = static_cast<long long>(row);
+    long long d = static_cast<long long>(radius);
+    auto&& visit = [&](long long x, long long y) {
+        if (x >= 0 && y >= 0 && x < static_cast<long long>(column_count_) && y < static_cast<long long>(row_count_)) {
+            f(static_cast<size_t>(y) * column_count_ + static_cast<size_t>(x));
+        }
+    };
+    if (d == 0) {
+        visit(c, r);
+        return;
+    }
+    for (long long x = c - d; x <= c + d; ++x) {
+        visit(x, r - d);
+        visit(x, r + d);
+    }
+    for (long long y = r - d + 1; y <= r + d - 1; ++y) {
+        visit(c - d, y);
+        visit(c + d, y);
+    }
+}
+
+EdgeSplit SegmentIndex::SplitEdge(const Segment& segment, const ProjectedPoint& split_point) const {
+    vector<utility::Point> geometry = geometry_store_->GetGeometry(uids_[segment.edge]);
+    auto&& split = geometry.begin() + segment.first_point + 1;
+    utility::Point split_location = Unproject(split_point);
+
+    EdgeSplit result{uids_[segment.edge], from_[segment.edge], to_[segment.edge],
+        vector<utility::Point>{geometry.begin(), split}, vector<utility::Point>{split, geometry.end()}, 0};
+    result.from_segment.push_back(split_location);
+    result.to_segment.insert(result.to_segment.begin(), split_location);
+
+    auto&& calculate_length = [&](const vector<utility::Point>& points) {
+        double length = 0;
+        for (size_t i = 1; i < points.size(); ++i) {
+            ProjectedPoint a = Project(points[i - 1]);
+            ProjectedPoint b = Project(points[i]);
+            length += hypot(b.x - a.x, b.y - a.y);
+        }
+        return length;
+    };
+    double from_length = calculate_length(result.from_segment);
+    double total_length = from_length + calculate_length(result.to_segment);
+    result.from_segment_relative_length = (total_length > 0) ? static_cast<float>(from_length / total_length) : 0.5f;
+    return result;
+}
+
+}
+}
@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/utility/atomic_shared_ptr.h"
+
+#include <memory>
+#include <vector>
+#include <thread>
+#include <atomic>
+using namespace std;
+using namespace routing;
+using namespace utility;
+
+TEST(AtomicSharedPtrTests, ReplacedValueLivesWhileLoaded) {
+    AtomicSharedPtr<int> value{make_shared<int>(1)};
+    auto&& loaded = value.Load();
+    auto&& old = value.Exchange(make_shared<int>(2));
+    EXPECT_EQ(1, *loaded);
+    EXPECT_EQ(loaded, old);
+    EXPECT_EQ(2, *value.Load());
+}
+
+TEST(AtomicSharedPtrTests, ReplacedValueIsFreedByItsLastReader) {
+    auto&& initial = make_shared<int>(1);
+    weak_ptr<int> weak_initial{initial};
+    AtomicSharedPtr<int> value{std::move(initial)};
+    EXPECT_EQ(1, weak_initial.use_count());
+    auto&& loaded = value.Load();
+    value.Exchange(make_shared<int>(2));
+    EXPECT_FALSE(weak_initial.expired());
+    loaded.reset();
+    EXPECT_TRUE(weak_initial.expired());
+}
+
+TEST(AtomicSharedPtrTests, ConcurrentReadersSeeWholeValues) {
+    AtomicSharedPtr<vector<int>> value{make_shared<vector<int>>(100, 0)};
+    atomic<bool> done{false};
+    vector<thread> readers{};
+    for (size_t r = 0; r < 4; ++r) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                auto&& loaded = value.Load();
+                for (auto&& item : *loaded) {
+                    EXPECT_EQ(loaded->front(), item);
+                }
+            }
+        });
+    }
+    for (int i = 1; i <= 100; ++i) {
+        value.Exchange(make_shared<vector<int>>(100, i));
+    }
+    done = true;
+    for (auto&& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(100, value.Load()->front());
+}
@@ -0,0 +1,38 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/utility/background_task.h"
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+using namespace std;
+using namespace routing;
+using namespace utility;
+
+TEST(BackgroundTaskTests, RunningTaskIsNotStartedAgain) {
+    mutex m;
+    condition_variable cv;
+    bool released = false;
+    atomic<size_t> runs{0};
+    {
+        BackgroundTask task{[&]() {
+            ++runs;
+            unique_lock<mutex> lock{m};
+            cv.wait(lock, [&]() { return released; });
+        }};
+        EXPECT_TRUE(task.Start());
+        EXPECT_TRUE(task.IsRunning());
+        EXPECT_FALSE(task.Start());
+        {
+            lock_guard<mutex> lock{m};
+            released = true;
+        }
+        cv.notify_all();
+        while (task.IsRunning()) {
+            this_thread::yield();
+        }
+        EXPECT_TRUE(task.Start());
+    }
+    EXPECT_EQ(2, runs);
+}
@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/bench/workload.h"
+#include "routing/bench/bench_report.h"
+#include "routing/exception.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+using namespace routing;
+using namespace bench;
+
+TEST(BenchWorkloadTests, WorkloadRoundTrip) {
+    istringstream in{
+        "# source_lon,source_lat,target_lon,target_lat,preferences\n"
+        "14.4,50.1,14.5,50.05,green:1|peak_distance:0.5\n"
+        "\n"
+        "14.3,50.0,14.35,50.02\n"};
+    auto&& queries = ReadWorkload(in);
+    ASSERT_EQ(2, queries.size());
+    EXPECT_FLOAT_EQ(14.5f, queries[0].target.lon_);
+    EXPECT_THAT(queries[0].preferences, testing::ElementsAre(Preferences::value_type{"green", 1}, Preferences::value_type{"peak_distance", 0.5f}));
+    EXPECT_TRUE(queries[1].preferences.empty());
+    EXPECT_EQ("[{\"name\":\"green\",\"importance\":1},{\"name\":\"peak_distance\",\"importance\":0.5}]", WriteProfileJson(queries[0].preferences));
+
+    ostringstream out{};
+    WriteWorkload(out, queries);
+    istringstream written{out.str()};
+    auto&& read_again = ReadWorkload(written);
+    ASSERT_EQ(2, read_again.size());
+    EXPECT_FLOAT_EQ(queries[0].source.lat_, read_again[0].source.lat_);
+    EXPECT_EQ(queries[0].preferences, read_again[0].preferences);
+
+    istringstream invalid{"14.4,50.1,14.5\n"};
+    EXPECT_THROW(ReadWorkload(invalid), ParseException);
+}
+
+TEST(BenchWorkloadTests, GeneratedWorkloadIsReproducible) {
+    vector<Preferences> profiles{ParsePreferences("green:1"), Preferences{}};
+    auto&& queries = GenerateWorkload(utility::Point{14, 50}, utility::Point{15, 51}, 100, profiles, 42);
+    auto&& again = GenerateWorkload(utility::Point{14, 50}, utility::Point{15, 51}, 100, profiles, 42);
+    ASSERT_EQ(100, queries.size());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(again[i].source.lon_, queries[i].source.lon_);
+        EXPECT_EQ(again[i].target.lat_, queries[i].target.lat_);
+        EXPECT_GE(queries[i].source.lon_, 14);
+        EXPECT_LE(queries[i].source.lon_, 15);
+        EXPECT_GE(queries[i].target.lat_, 50);
+        EXPECT_LE(queries[i].target.lat_, 51);
+        EXPECT_EQ(i % 2 == 0 ? 1 : 0, queries[i].preferences.size());
+    }
+}
+
+TEST(BenchWorkloadTests, ReportPercentilesAndStages) {
+    vector<double> latencies{};
+    for (size_t i = 100; i >= 1; --i) {
+        latencies.push_back(i / 1000.0);
+    }
+    string metrics =
+        "# TYPE routing_stage_duration_seconds histogram\n"
+        "routing_stage_duration_seconds_bucket{stage=\"search\",le=\"+Inf\"} 12\n"
+        "routing_stage_duration_seconds_sum{stage=\"search\"} 0.6\n"
+        "routing_stage_duration_seconds_count{stage=\"search\"} 12\n";
+    StageTotals before{{"search", StageTotal{0.1, 2}}};
+    BenchResult result{"ch", 4, move(latencies), 1, 2, SubtractStageTotals(ParseStageTotals(metrics), before)};
+    EXPECT_DOUBLE_EQ(0.05, GetPercentile(result.latencies, 50));
+    EXPECT_DOUBLE_EQ(0.099, GetPercentile(result.latencies, 99));
+    EXPECT_DOUBLE_EQ(0.1, GetPercentile(result.latencies, 100));
+    EXPECT_EQ(101, result.GetQueryCount());
+    EXPECT_DOUBLE_EQ(50.5, result.GetThroughput());
+    EXPECT_DOUBLE_EQ(50, GetMeanMs(result.stages.at("search")));
+
+    ostringstream csv{};
+    WriteCsv(csv, result);
+    EXPECT_EQ("label,queries,errors,concurrency,wall_seconds,throughput_qps,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,search_ms\n"
+        "ch,101,1,4,2,50.5,50.5,50,95,99,100,50\n", csv.str());
+}
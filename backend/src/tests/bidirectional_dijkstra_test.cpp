@@ -7,6 +7,7 @@
 #include "routing/query/dijkstra.h"
 #include "routing/bidirectional_graph.h"
 #include "routing/query/bidirectional_dijkstra.h"
+#include "routing/query/alternative_route_parameters.h"
 #include "routing/exception.h"
 #include "routing/database/database_helper.h"
 #include "routing/utility/point.h"
@@ -21,6 +22,7 @@
 
 #include <string>
 #include <vector>
+#include <tuple>
 
 using namespace std;
 using namespace routing;
@@ -245,3 +247,119 @@ TEST(BidirectionalDijkstraTestsNotFixture, GraphWithTwowayEdges) {
 
     EXPECT_THAT(path, testing::ElementsAreArray(expected_path));
 }
+
+TEST_F(BidirectionalDijkstraTests, StallOnDemandKeepsRoutes) {
+    for (unsigned_id_type source = 1; source <= 6; ++source) {
+        for (unsigned_id_type target = 1; target <= 6; ++target) {
+            if (source == target) {
+                continue;
+            }
+            BidirectionalDijkstra<SearchGraph> expected_alg{g_};
+            expected_alg.SetStallOnDemand(false);
+            BidirectionalDijkstra<SearchGraph> alg{g_};
+            try {
+                expected_alg.Run(source, target);
+            } catch (const RouteNotFoundException&) {
+                EXPECT_THROW(alg.Run(source, target), RouteNotFoundException);
+                continue;
+            }
+            alg.Run(source, target);
+            EXPECT_THAT(alg.GetRoute(), testing::ElementsAreArray(expected_alg.GetRoute())) << "Route from " << source << " to " << target;
+            EXPECT_LT(0, alg.GetSettledVertexCount());
+            EXPECT_LE(alg.GetStalledVertexCount(), alg.GetSettledVertexCount());
+        }
+    }
+}
+
+TEST(BidirectionalDijkstraTestsNotFixture, SearchStopsAfterBestPath) {
+    G load_graph;
+    TestPathGraph(load_graph);
+    SearchGraph search_graph{};
+    search_graph.Load(load_graph);
+    Algorithm<BidirectionalDijkstra<SearchGraph>> alg{search_graph};
+    alg.Run(4, 5);
+    // Vertices after 5 are farther than the found path so they are not settled.
+    EXPECT_GE(3, alg.GetSettledVertexCount());
+}
+
+/**
+ * Load hierarchy of twoway `edges` - {from, to, length} - where vertices have `ranks` to `search_graph`.
+ * Routes from 1 to 2 only go up to their via vertex and then down so no shortcuts are needed.
+ */
+static void LoadHierarchy(const vector<tuple<unsigned_id_type, unsigned_id_type, float>>& edges, const vector<unsigned_id_type>& ranks,
+    SearchGraph& search_graph) {
+    G g{};
+    unsigned_id_type uid = 0;
+    for (auto&& [from, to, length] : edges) {
+        g.AddEdge(Edge{uid++, from, to, length, Edge::EdgeType::twoway});
+    }
+    for (unsigned_id_type vertex_id = 1; vertex_id <= ranks.size(); ++vertex_id) {
+        g.GetVertex(vertex_id).set_ordering_rank(ranks[vertex_id - 1]);
+    }
+    search_graph.Load(g);
+}
+
+/**
+ * Check that `route` leads from `source` to `target` without shortcuts and return its length.
+ * Twoway edges can be in either direction.
+ */
+static float GetConnectedRouteLength(const vector<Edge>& route, unsigned_id_type source, unsigned_id_type target) {
+    unsigned_id_type vertex_id = source;
+    float length = 0;
+    for (auto&& edge : route) {
+        EXPECT_FALSE(edge.IsShortcut());
+        EXPECT_TRUE(edge.get_from() == vertex_id || edge.get_to() == vertex_id) << "Route is not connected in " << vertex_id;
+        vertex_id = edge.get_from() == vertex_id ? edge.get_to() : edge.get_from();
+        length += edge.get_length();
+    }
+    EXPECT_EQ(target, vertex_id);
+    return length;
+}
+
+TEST(BidirectionalDijkstraTestsNotFixture, AlternativeRoutesWithinStretch) {
+    SearchGraph search_graph{};
+    // Three disjoint routes from 1 to 2 of lengths 3, 3.5 and 7 through via vertices 3, 4 and 5.
+    LoadHierarchy({{1, 3, 1.5}, {3, 2, 1.5}, {1, 6, 1}, {6, 4, 0.75}, {4, 7, 0.75}, {7, 2, 1}, {1, 8, 1}, {8, 5, 2.5}, {5, 9, 2.5}, {9, 2, 1}},
+        {1, 2, 10, 9, 8, 5, 6, 3, 4}, search_graph);
+    Algorithm<BidirectionalDijkstra<SearchGraph>> alg{search_graph};
+    alg.RunAlternatives(1, 2, AlternativeRouteParameters{1.25f, 0.5f, 0.25f});
+    EXPECT_NEAR(3, GetConnectedRouteLength(alg.GetRoute(), 1, 2), 1e-5);
+    auto&& routes = alg.GetAlternativeRoutes(3);
+    ASSERT_EQ(1, routes.size());
+    EXPECT_NEAR(3.5, GetConnectedRouteLength(routes[0], 1, 2), 1e-5);
+    EXPECT_TRUE(alg.GetAlternativeRoutes(0).empty());
+
+    alg.RunAlternatives(1, 2, AlternativeRouteParameters{3, 0.5f, 0.25f});
+    routes = alg.GetAlternativeRoutes(3);
+    ASSERT_EQ(2, routes.size());
+    EXPECT_NEAR(3.5, GetConnectedRouteLength(routes[0], 1, 2), 1e-5);
+    EXPECT_NEAR(7, GetConnectedRouteLength(routes[1], 1, 2), 1e-5);
+}
+
+TEST(BidirectionalDijkstraTestsNotFixture, AlternativeRoutesLimitedSharing) {
+    SearchGraph search_graph{};
+    // Routes from 1 to 2 share the edge from 1 to 3 which is most of their lengths 12 and 12.5.
+    LoadHierarchy({{1, 3, 10}, {3, 4, 1}, {4, 2, 1}, {3, 5, 1}, {5, 2, 1.5}}, {1, 3, 2, 10, 9}, search_graph);
+    Algorithm<BidirectionalDijkstra<SearchGraph>> alg{search_graph};
+    alg.RunAlternatives(1, 2, AlternativeRouteParameters{1.25f, 0.8f, 0});
+    EXPECT_TRUE(alg.GetAlternativeRoutes(1).empty());
+
+    alg.RunAlternatives(1, 2, AlternativeRouteParameters{1.25f, 0.9f, 0});
+    auto&& routes = alg.GetAlternativeRoutes(1);
+    ASSERT_EQ(1, routes.size());
+    EXPECT_NEAR(12.5, GetConnectedRouteLength(routes[0], 1, 2), 1e-5);
+}
+
+TEST(BidirectionalDijkstraTestsNotFixture, AlternativeRoutesLocallyOptimal) {
+    SearchGraph search_graph{};
+    // Route through 5 is short enough but its detour from 3 to 4 is much longer than the edge between them.
+    LoadHierarchy({{1, 3, 4}, {3, 4, 1}, {4, 2, 4}, {3, 5, 1}, {5, 4, 1.5}}, {1, 2, 3, 4, 5}, search_graph);
+    Algorithm<BidirectionalDijkstra<SearchGraph>> alg{search_graph};
+    alg.RunAlternatives(1, 2, AlternativeRouteParameters{1.25f, 1, 0.1f});
+    EXPECT_TRUE(alg.GetAlternativeRoutes(1).empty());
+
+    alg.RunAlternatives(1, 2, AlternativeRouteParameters{1.25f, 1, 0});
+    auto&& routes = alg.GetAlternativeRoutes(1);
+    ASSERT_EQ(1, routes.size());
+    EXPECT_NEAR(10.5, GetConnectedRouteLength(routes[0], 1, 2), 1e-5);
+}
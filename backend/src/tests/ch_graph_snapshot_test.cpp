@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/adjacency_list_graph.h"
+#include "routing/bidirectional_graph.h"
+#include "routing/exception.h"
+#include "tests/graph_test.h"
+#include "routing/edges/ch_edge.h"
+#include "routing/ch_search_graph.h"
+#include "routing/vertices/ch_vertex.h"
+#include "routing/edge_ranges/vector_edge_range.h"
+#include "routing/edge_ranges/iterator_edge_range.h"
+#include "routing/edges/length_source.h"
+#include "routing/snapshot/ch_graph_snapshot.h"
+#include "routing/types.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+
+using namespace std;
+using namespace routing;
+using namespace snapshot;
+using Edge = CHEdge<NumberLengthSource>;
+using G = BidirectionalGraph<AdjacencyListGraph<CHVertex<Edge, VectorEdgeRange<Edge>>, Edge>>;
+using SearchGraph = CHSearchGraph<CHVertex<Edge, IteratorEdgeRange<Edge, std::vector<Edge>::iterator>>, Edge>;
+
+static string WriteTestSnapshot() {
+    G g{};
+    TestBidirectedSearchGraph(g);
+    SearchGraph search_graph{};
+    search_graph.Load(g);
+    string path = testing::TempDir() + "snapshot_test" + CHGraphSnapshot::kFileExtension;
+    CHGraphSnapshot::Write(path, search_graph, "chczedges", 42);
+    return path;
+}
+
+/**
+ * Overwrite one byte of a file at `offset` from its end.
+ */
+static void DamageFile(const string& path, long offset) {
+    fstream file{path, ios::in | ios::out | ios::binary};
+    file.seekg(-offset, ios::end);
+    char c = static_cast<char>(file.get());
+    file.seekp(-offset, ios::end);
+    file.put(static_cast<char>(c ^ 0x5a));
+}
+
+TEST(CHGraphSnapshotTests, LoadedGraphIsSameAsWrittenOne) {
+    G g{};
+    TestBidirectedSearchGraph(g);
+    SearchGraph expected_graph{};
+    expected_graph.Load(g);
+    string path = WriteTestSnapshot();
+
+    CHGraphSnapshot graph_snapshot{path};
+    SearchGraph actual_graph{};
+    actual_graph.LoadSnapshot(graph_snapshot);
+    ASSERT_EQ(expected_graph.GetVertexCount(), actual_graph.GetVertexCount());
+    ASSERT_EQ(expected_graph.GetEdgeCount(), actual_graph.GetEdgeCount());
+    for (unsigned_id_type id = 1; id < expected_graph.GetVertexCount(); ++id) {
+        auto&& expected_vertex = expected_graph.GetVertex(id);
+        auto&& actual_vertex = actual_graph.GetVertex(id);
+        EXPECT_EQ(expected_vertex.get_ordering_rank(), actual_vertex.get_ordering_rank());
+        vector<Edge> expected_edges{expected_vertex.get_edges().begin(), expected_vertex.get_edges().end()};
+        vector<Edge> actual_edges{actual_vertex.get_edges().begin(), actual_vertex.get_edges().end()};
+        ASSERT_EQ(expected_edges.size(), actual_edges.size());
+        for (size_t i = 0; i < expected_edges.size(); ++i) {
+            EXPECT_EQ(expected_edges[i], actual_edges[i]);
+            EXPECT_EQ(expected_edges[i].get_uid(), actual_edges[i].get_uid());
+            EXPECT_EQ(expected_edges[i].get_contracted_vertex(), actual_edges[i].get_contracted_vertex());
+        }
+    }
+    remove(path.c_str());
+}
+
+TEST(CHGraphSnapshotTests, SnapshotOfOtherTableOrRunIsRejected) {
+    string path = WriteTestSnapshot();
+    CHGraphSnapshot graph_snapshot{path};
+    EXPECT_EQ("chczedges", graph_snapshot.GetSourceTable());
+    EXPECT_EQ(42, graph_snapshot.GetPreprocessingId());
+    EXPECT_NO_THROW(graph_snapshot.CheckSource("chczedges", 42));
+    EXPECT_THROW(graph_snapshot.CheckSource("chczedges", 43), SnapshotException);
+    // Table preprocessed before preprocessing ids were stored.
+    EXPECT_THROW(graph_snapshot.CheckSource("chczedges", 0), SnapshotException);
+    EXPECT_THROW(graph_snapshot.CheckSource("chczedges_green", 42), SnapshotException);
+    remove(path.c_str());
+}
+
+TEST(CHGraphSnapshotTests, DamagedSnapshotIsRejected) {
+    string path = WriteTestSnapshot();
+    DamageFile(path, 10);
+    EXPECT_THROW(CHGraphSnapshot{path}, SnapshotException);
+    remove(path.c_str());
+}
+
+TEST(CHGraphSnapshotTests, TruncatedSnapshotIsRejected) {
+    string path = WriteTestSnapshot();
+    {
+        ofstream file{path, ios::binary | ios::trunc};
+        file << "RGCHSNAP";
+    }
+    EXPECT_THROW(CHGraphSnapshot{path}, SnapshotException);
+    remove(path.c_str());
+}
+
+TEST(CHGraphSnapshotTests, MissingSnapshotIsRejected) {
+    EXPECT_THROW(CHGraphSnapshot{testing::TempDir() + "missing" + CHGraphSnapshot::kFileExtension}, SnapshotException);
+}
+
+TEST(CHGraphSnapshotTests, SnapshotPath) {
+    EXPECT_EQ("snapshots/chczedges.chsnap", CHGraphSnapshot::GetPath("snapshots", "chczedges"));
+    EXPECT_EQ("snapshots/chczedges.chsnap", CHGraphSnapshot::GetPath("snapshots/", "chczedges"));
+}
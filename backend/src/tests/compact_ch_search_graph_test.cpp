@@ -0,0 +1,112 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/adjacency_list_graph.h"
+#include "routing/edges/basic_edge.h"
+#include "routing/algorithm.h"
+#include "routing/bidirectional_graph.h"
+#include "routing/query/bidirectional_dijkstra.h"
+#include "routing/query/endpoint_algorithm_policy.h"
+#include "routing/query/edge_range_policy.h"
+#include "routing/exception.h"
+#include "tests/graph_test.h"
+#include "routing/edges/ch_edge.h"
+#include "routing/ch_search_graph.h"
+#include "routing/compact_ch_search_graph.h"
+#include "routing/routing_graph.h"
+#include "routing/vertices/ch_vertex.h"
+#include "routing/edge_ranges/vector_edge_range.h"
+#include "routing/edge_ranges/iterator_edge_range.h"
+#include "routing/edges/length_source.h"
+#include "routing/types.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace routing;
+using namespace query;
+using Edge = CHEdge<NumberLengthSource>;
+using G = BidirectionalGraph<AdjacencyListGraph<CHVertex<Edge, VectorEdgeRange<Edge>>, Edge>>;
+using SearchGraph = CHSearchGraph<CHVertex<Edge, IteratorEdgeRange<Edge, std::vector<Edge>::iterator>>, Edge>;
+using CompactGraph = CompactCHSearchGraph<Edge>;
+
+class CompactCHSearchGraphTests : public testing::Test {
+protected:
+    SearchGraph search_graph_;
+    CompactGraph compact_graph_;
+
+    void SetUp() override {
+        G g{};
+        TestBasicContractedGraph(g);
+        search_graph_.Load(g);
+        compact_graph_.Load(g);
+    }
+};
+
+TEST_F(CompactCHSearchGraphTests, SameEdgesAsCHSearchGraph) {
+    vector<Edge> expected{};
+    search_graph_.ForEachEdge([&](Edge& edge) {
+        expected.push_back(edge);
+    });
+    vector<Edge> actual{};
+    compact_graph_.ForEachEdge([&](Edge& edge) {
+        actual.push_back(edge);
+    });
+    EXPECT_EQ(expected.size(), compact_graph_.GetEdgeCount());
+    EXPECT_THAT(actual, testing::UnorderedElementsAreArray(expected));
+    EXPECT_EQ(search_graph_.GetMaxVertexId(), compact_graph_.GetMaxVertexId());
+    EXPECT_EQ(search_graph_.GetMaxEdgeId(), compact_graph_.GetMaxEdgeId());
+    EXPECT_LT(compact_graph_.GetMemorySize(), expected.size() * sizeof(Edge));
+}
+
+TEST_F(CompactCHSearchGraphTests, SameRoutesAsCHSearchGraph) {
+    for (unsigned_id_type source = 1; source <= 6; ++source) {
+        for (unsigned_id_type target = 1; target <= 6; ++target) {
+            if (source == target) {
+                continue;
+            }
+            Algorithm<BidirectionalDijkstra<SearchGraph>> expected_alg{search_graph_};
+            Algorithm<BidirectionalDijkstra<CompactGraph>> alg{compact_graph_};
+            try {
+                expected_alg.Run(source, target);
+            } catch (const RouteNotFoundException&) {
+                EXPECT_THROW(alg.Run(source, target), RouteNotFoundException);
+                continue;
+            }
+            alg.Run(source, target);
+            EXPECT_THAT(alg.GetRoute(), testing::ElementsAreArray(expected_alg.GetRoute())) << "Route from " << source << " to " << target;
+        }
+    }
+}
+
+TEST_F(CompactCHSearchGraphTests, RouteBetweenEndpointVertices) {
+    RoutingGraph<CompactGraph> routing_graph{compact_graph_};
+    EndpointAlgorithmPolicyContractionHierarchies<RoutingGraph<CompactGraph>, EdgeRangePolicyCompact<Edge>> policy{routing_graph, EdgeRangePolicyCompact<Edge>{}};
+    unsigned_id_type source = compact_graph_.GetMaxVertexId() + 1;
+    unsigned_id_type target = compact_graph_.GetMaxVertexId() + 2;
+    policy.AddSource(vector<Edge>{Edge{20, source, 1, 1}}, source);
+    policy.AddTarget(vector<Edge>{Edge{21, target, 6, 1}}, target);
+    Algorithm<BidirectionalDijkstra<RoutingGraph<CompactGraph>>> alg{routing_graph};
+    alg.Run(source, target);
+    vector<Edge> route = alg.GetRoute();
+    ASSERT_LE(2, route.size());
+    EXPECT_EQ(20, route.front().get_uid());
+    EXPECT_EQ(21, route.back().get_uid());
+    float length = 0;
+    for (auto&& edge : route) {
+        length += edge.get_length();
+    }
+    EXPECT_FLOAT_EQ(11, length);
+}
+
+TEST(CompactCHVertexTests, DefaultVertexHasNoEdges) {
+    CompactGraph::Vertex vertex{};
+    size_t edge_count = 0;
+    vertex.ForEachEdge([&](Edge&) { ++edge_count; });
+    vertex.ForEachBackwardEdge([&](Edge&) { ++edge_count; });
+    for (auto&& edge : vertex.get_edges()) {
+        ++edge_count;
+    }
+    EXPECT_EQ(0, edge_count);
+    EXPECT_THROW(vertex.FindEdge([](const Edge&) { return true; }), EdgeNotFoundException);
+}
@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/database/connection_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+using namespace std;
+using namespace routing;
+using namespace database;
+
+/**
+ * Connection that counts how many connections were opened.
+ */
+class FakeConnection {
+public:
+    FakeConnection(size_t id) : id_(id), healthy_(true) {}
+
+    size_t get_id() const {
+        return id_;
+    }
+
+    bool IsHealthy() {
+        return healthy_;
+    }
+
+    void Break() {
+        healthy_ = false;
+    }
+
+private:
+    size_t id_;
+    bool healthy_;
+};
+
+class ConnectionPoolTests : public testing::Test {
+protected:
+    atomic<size_t> opened_{0};
+
+    unique_ptr<ConnectionPool<FakeConnection>> CreatePool(size_t max_size, chrono::steady_clock::duration health_check_interval = chrono::seconds{30}) {
+        return make_unique<ConnectionPool<FakeConnection>>(max_size, [&]() {
+            return make_unique<FakeConnection>(opened_++);
+        }, health_check_interval);
+    }
+};
+
+TEST_F(ConnectionPoolTests, ReturnedConnectionIsReused) {
+    auto&& pool = CreatePool(2);
+    {
+        auto&& connection = pool->Acquire();
+        EXPECT_EQ(0, connection->get_id());
+    }
+    EXPECT_EQ(1, pool->GetIdleCount());
+    auto&& connection = pool->Acquire();
+    EXPECT_EQ(0, connection->get_id());
+    EXPECT_EQ(1, opened_);
+    EXPECT_EQ(1, pool->GetOpenCount());
+}
+
+TEST_F(ConnectionPoolTests, UnhealthyConnectionIsReopened) {
+    auto&& pool = CreatePool(1, chrono::seconds{0});
+    {
+        auto&& connection = pool->Acquire();
+        connection->Break();
+    }
+    auto&& connection = pool->Acquire();
+    EXPECT_EQ(1, connection->get_id());
+    EXPECT_EQ(1, pool->GetOpenCount());
+}
+
+TEST_F(ConnectionPoolTests, InvalidatedConnectionIsClosed) {
+    auto&& pool = CreatePool(1);
+    {
+        auto&& connection = pool->Acquire();
+        connection.Invalidate();
+    }
+    EXPECT_EQ(0, pool->GetOpenCount());
+    EXPECT_EQ(0, pool->GetIdleCount());
+    auto&& connection = pool->Acquire();
+    EXPECT_EQ(1, connection->get_id());
+}
+
+TEST_F(ConnectionPoolTests, FailedOpenFreesSlot) {
+    bool fail = true;
+    ConnectionPool<FakeConnection> pool{1, [&]() {
+        if (fail) {
+            throw runtime_error{"Connection refused."};
+        }
+        return make_unique<FakeConnection>(opened_++);
+    }};
+    EXPECT_THROW(pool.Acquire(), runtime_error);
+    EXPECT_EQ(0, pool.GetOpenCount());
+    fail = false;
+    auto&& connection = pool.Acquire();
+    EXPECT_EQ(0, connection->get_id());
+}
+
+TEST_F(ConnectionPoolTests, ConcurrentLeasesAreBounded) {
+    auto&& pool = CreatePool(3);
+    atomic<size_t> leased{0};
+    atomic<size_t> max_leased{0};
+    vector<thread> threads{};
+    for (size_t t = 0; t < 8; ++t) {
+        threads.emplace_back([&]() {
+            for (size_t i = 0; i < 50; ++i) {
+                auto&& connection = pool->Acquire();
+                size_t current = ++leased;
+                size_t max = max_leased;
+                while (current > max && !max_leased.compare_exchange_weak(max, current)) {}
+                --leased;
+            }
+        });
+    }
+    for (auto&& t : threads) {
+        t.join();
+    }
+    EXPECT_LE(max_leased, 3);
+    EXPECT_LE(opened_, 3);
+    EXPECT_EQ(pool->GetOpenCount(), pool->GetIdleCount());
+}
@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/adjacency_list_graph.h"
+#include "routing/edges/basic_edge.h"
+#include "routing/algorithm.h"
+#include "routing/vertices/basic_vertex.h"
+#include "routing/query/dijkstra.h"
+#include "routing/query/bidirectional_dijkstra.h"
+#include "routing/edges/ch_edge.h"
+#include "routing/ch_search_graph.h"
+#include "routing/vertices/ch_vertex.h"
+#include "routing/edge_ranges/vector_edge_range.h"
+#include "routing/edge_ranges/iterator_edge_range.h"
+#include "routing/edges/length_source.h"
+#include "routing/cch/nested_dissection.h"
+#include "routing/cch/customizable_graph.h"
+#include "routing/types.h"
+#include "tests/graph_test.h"
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+using namespace std;
+using namespace routing;
+using namespace query;
+using namespace cch;
+using BaseEdge = BasicEdge<NumberLengthSource>;
+using BaseGraph = AdjacencyListGraph<BasicVertex<BaseEdge, VectorEdgeRange<BaseEdge>>, BaseEdge>;
+using Edge = CHEdge<NumberLengthSource>;
+using SearchGraph = CHSearchGraph<CHVertex<Edge, IteratorEdgeRange<Edge, std::vector<Edge>::iterator>>, Edge>;
+
+/**
+ * Lengths of base graph edges given by their uids.
+ */
+class UidEdgeLength {
+public:
+    UidEdgeLength(const function<float(unsigned_id_type)>& length) : length_(length) {}
+
+    float operator()(const BaseEdge& edge) const {
+        return length_(edge.get_uid());
+    }
+private:
+    function<float(unsigned_id_type)> length_;
+};
+
+static float FirstTestLength(unsigned_id_type uid) {
+    return static_cast<float>(1 + (uid * 7919) % 13);
+}
+
+static float SecondTestLength(unsigned_id_type uid) {
+    return static_cast<float>(1 + (uid * 104729) % 29);
+}
+
+class CustomizableGraphTests : public testing::Test {
+protected:
+    static const unsigned_id_type kRows = 6;
+    static const unsigned_id_type kColumns = 7;
+
+    BaseGraph base_graph_;
+    vector<CustomizableGraph::BaseEdge> edges_;
+    CustomizableGraph graph_;
+
+    void SetUp() override {
+        // Base edges have unit lengths, the tests customize the graph with FirstTestLength and SecondTestLength.
+        TestOnewayGrid(kRows, kColumns, 1, [&](unsigned_id_type uid, unsigned_id_type from, unsigned_id_type to, float length, bool twoway) {
+            base_graph_.AddEdge(BaseEdge{uid, from, to, 1, twoway ? BaseEdge::EdgeType::twoway : BaseEdge::EdgeType::forward});
+            edges_.emplace_back(uid, from, to, twoway);
+        });
+        NestedDissection nested_dissection{};
+        for (auto&& edge : edges_) {
+            nested_dissection.AddEdge(edge.from, edge.to);
+        }
+        graph_ = CustomizableGraph{nested_dissection.ComputeOrdering(), edges_};
+    }
+
+    static unsigned_id_type GetVertex(unsigned_id_type row, unsigned_id_type column) {
+        return 1 + row * kColumns + column;
+    }
+
+    /**
+     * Compare lengths of routes in the customized graph to lengths of routes found by Dijkstra in the base graph.
+     */
+    void ExpectShortestRoutes(const function<float(unsigned_id_type)>& length, size_t thread_count) {
+        SearchGraph search_graph = graph_.CreateSearchGraph<SearchGraph>(graph_.Customize(length, thread_count));
+        unsigned_id_type max_base_edge_id = edges_.size();
+        for (unsigned_id_type source = 1; source <= kRows * kColumns; ++source) {
+            for (unsigned_id_type target = 1; target <= kRows * kColumns; ++target) {
+                if (source == target) {
+                    continue;
+                }
+                Dijkstra<BaseGraph, UidEdgeLength> dijkstra{base_graph_, UidEdgeLength{length}};
+                dijkstra.Run(source, target);
+                float expected_length = dijkstra.GetPathLength(target);
+
+                Algorithm<BidirectionalDijkstra<SearchGraph>> alg{search_graph};
+                alg.Run(source, target);
+                vector<Edge> route = alg.GetRoute();
+                ASSERT_FALSE(route.empty());
+                float route_length = 0;
+                for (auto&& edge : route) {
+                    // Shortcuts are unpacked to base edges.
+                    EXPECT_LE(edge.get_uid(), max_base_edge_id);
+                    route_length += length(edge.get_uid());
+                }
+                EXPECT_NEAR(expected_length, route_length, 1e-3) << "Route from " << source << " to " << target;
+            }
+        }
+    }
+};
+
+TEST(NestedDissectionTests, SeparatorHasTheHighestRank) {
+    NestedDissection nested_dissection{};
+    nested_dissection.AddEdge(1, 2);
+    nested_dissection.AddEdge(2, 3);
+    nested_dissection.AddEdge(3, 4);
+    nested_dissection.AddEdge(5, 4);
+    vector<unsigned_id_type> ranks = nested_dissection.ComputeOrdering();
+    ASSERT_EQ(6, ranks.size());
+    EXPECT_EQ(5, ranks[3]);
+    vector<unsigned_id_type> sorted_ranks{ranks};
+    sort(sorted_ranks.begin(), sorted_ranks.end());
+    EXPECT_THAT(sorted_ranks, testing::ElementsAre(0, 1, 2, 3, 4, 5));
+}
+
+TEST_F(CustomizableGraphTests, GraphIsContracted) {
+    EXPECT_EQ(kRows * kColumns + 1, graph_.GetVertexCount());
+    EXPECT_GT(graph_.GetArcCount(), 0);
+    EXPECT_GT(graph_.GetTriangleCount(), 0);
+    EXPECT_GT(graph_.GetLevelCount(), 1);
+}
+
+TEST_F(CustomizableGraphTests, RoutesAreShortest) {
+    ExpectShortestRoutes(FirstTestLength, 1);
+}
+
+TEST_F(CustomizableGraphTests, RoutesAreShortestAfterParallelCustomization) {
+    ExpectShortestRoutes(FirstTestLength, 4);
+    ExpectShortestRoutes(SecondTestLength, 4);
+}
+
+TEST_F(CustomizableGraphTests, ParallelCustomizationIsSameAsSequential) {
+    CustomizableGraph::Metric expected_metric = graph_.Customize(SecondTestLength, 1);
+    CustomizableGraph::Metric actual_metric = graph_.Customize(SecondTestLength, 3);
+    EXPECT_EQ(expected_metric.forward_lengths, actual_metric.forward_lengths);
+    EXPECT_EQ(expected_metric.backward_lengths, actual_metric.backward_lengths);
+    EXPECT_EQ(expected_metric.forward_middle_vertices, actual_metric.forward_middle_vertices);
+    EXPECT_EQ(expected_metric.backward_middle_vertices, actual_metric.backward_middle_vertices);
+}
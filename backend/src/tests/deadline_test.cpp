@@ -0,0 +1,28 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/utility/deadline.h"
+#include "routing/exception.h"
+
+#include <chrono>
+#include <thread>
+using namespace std;
+using namespace routing;
+using namespace utility;
+
+TEST(DeadlineTests, ZeroTimeoutNeverExpires) {
+    Deadline deadline{chrono::milliseconds{0}};
+    EXPECT_FALSE(deadline.IsExpired());
+    EXPECT_NO_THROW(deadline.Check());
+    deadline.Cancel();
+    EXPECT_TRUE(deadline.IsExpired());
+    EXPECT_THROW(deadline.Check(), TimeoutException);
+}
+
+TEST(DeadlineTests, ChecksOnlyAtInterval) {
+    Deadline deadline{chrono::milliseconds{1}};
+    this_thread::sleep_for(chrono::milliseconds{5});
+    EXPECT_TRUE(deadline.IsExpired());
+    EXPECT_NO_THROW(Deadline::Check(&deadline, 1));
+    EXPECT_THROW(Deadline::Check(&deadline, Deadline::kCheckInterval), TimeoutException);
+    EXPECT_NO_THROW(Deadline::Check(nullptr, Deadline::kCheckInterval));
+}
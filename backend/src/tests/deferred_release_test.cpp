@@ -0,0 +1,50 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/utility/deferred_release.h"
+
+#include <memory>
+#include <thread>
+#include <atomic>
+using namespace std;
+using namespace routing;
+using namespace utility;
+
+/**
+ * Records the thread that destroys it.
+ */
+class ThreadRecorder {
+public:
+    ThreadRecorder(thread::id* destroyed_by) : destroyed_by_(destroyed_by) {}
+
+    ~ThreadRecorder() {
+        *destroyed_by_ = this_thread::get_id();
+    }
+private:
+    thread::id* destroyed_by_;
+};
+
+TEST(DeferredReleaseTests, LastReaderDoesNotFreeValue) {
+    thread::id destroyed_by{};
+    atomic<bool> released{false};
+    auto&& owner = make_unique<DeferredRelease<ThreadRecorder>>(make_shared<ThreadRecorder>(&destroyed_by));
+    shared_ptr<ThreadRecorder> shared = owner->Share();
+    thread reader{[shared = std::move(shared), &released]() mutable {
+        shared.reset();
+        released = true;
+    }};
+    thread::id reader_id = reader.get_id();
+    // The owner waits for the reader and frees the value on this thread.
+    owner.reset();
+    reader.join();
+    EXPECT_TRUE(released);
+    EXPECT_EQ(this_thread::get_id(), destroyed_by);
+    EXPECT_NE(reader_id, destroyed_by);
+}
+
+TEST(DeferredReleaseTests, UnsharedValueIsFreedAtOnce) {
+    thread::id destroyed_by{};
+    {
+        DeferredRelease<ThreadRecorder> owner{make_shared<ThreadRecorder>(&destroyed_by)};
+    }
+    EXPECT_EQ(this_thread::get_id(), destroyed_by);
+}
@@ -71,3 +71,60 @@ TEST_F(DijkstraTest, NotExistingPath) {
     EXPECT_THROW(alg.Run(5, 1), RouteNotFoundException);
 }
 
+
+/**
+ * Lengths of one search - edge 3 is made longer than in the graph.
+ */
+class TestEdgeLength {
+public:
+    float operator()(const Edge& edge) const {
+        if (edge.get_uid() == 3) {
+            return edge.get_length() * 2;
+        }
+        return edge.get_length();
+    }
+};
+
+TEST_F(DijkstraTest, LengthsDefinedPerSearch) {
+    Algorithm<Dijkstra<G, TestEdgeLength>> alg{g_, TestEdgeLength{}};
+    alg.Run(1, 6);
+    vector<Dijkstra<G>::Edge> path = alg.GetRoute();
+
+    vector<Dijkstra<G>::Edge> expected_path{
+        Edge{0, 1, 2, 2}, Edge{2, 2, 6, 8}
+    };
+
+    EXPECT_THAT(path, testing::ElementsAreArray(expected_path));
+}
+
+TEST_F(DijkstraTest, SharedWorkspace) {
+    Dijkstra<G>::Workspace workspace{};
+    {
+        Algorithm<Dijkstra<G>> alg{g_, EdgeLength{}, &workspace};
+        EXPECT_THROW(alg.Run(5, 1), RouteNotFoundException);
+    }
+    Algorithm<Dijkstra<G>> alg{g_, EdgeLength{}, &workspace};
+    alg.Run(1, 6);
+    vector<Dijkstra<G>::Edge> path = alg.GetRoute();
+
+    vector<Dijkstra<G>::Edge> expected_path{
+        Edge{1, 1, 3, 2}, Edge{3, 3, 4, 3}, Edge{5, 4, 5, 2}, Edge{7, 5, 6, 2}
+    };
+
+    EXPECT_THAT(path, testing::ElementsAreArray(expected_path));
+}
+
+TEST(DijkstraDeadlineTests, CancelledSearchStops) {
+    G g{};
+    for (unsigned_id_type i = 1; i < 3 * utility::Deadline::kCheckInterval; ++i) {
+        g.AddEdge(Edge{i, i, i + 1, 1});
+    }
+    unsigned_id_type unreachable = 4 * utility::Deadline::kCheckInterval;
+    utility::Deadline deadline{};
+    Algorithm<Dijkstra<G>> alg{g};
+    alg.SetDeadline(&deadline);
+    EXPECT_THROW(alg.Run(1, unreachable), RouteNotFoundException);
+    deadline.Cancel();
+    EXPECT_THROW(alg.Run(1, unreachable), TimeoutException);
+    EXPECT_EQ(utility::Deadline::kCheckInterval, alg.GetSettledVertexCount());
+}
@@ -0,0 +1,54 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/spatial/edge_geometry_store.h"
+#include "routing/utility/point.h"
+#include "routing/exception.h"
+#include "routing/types.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace routing;
+using namespace spatial;
+
+TEST(EdgeGeometryStoreTests, GeometriesAreDecodedInOrder) {
+    EdgeGeometryStore store{};
+    vector<utility::Point> first{utility::Point{14.421345f, 50.087465f}, utility::Point{14.421401f, 50.087399f}, utility::Point{14.420987f, 50.087012f}};
+    vector<utility::Point> second{utility::Point{-0.127758f, 51.507351f}, utility::Point{-0.128011f, 51.507001f}};
+    store.AddEdge(2, first);
+    store.AddEdge(5, second);
+
+    EXPECT_FALSE(store.Contains(0));
+    EXPECT_TRUE(store.Contains(2));
+    EXPECT_FALSE(store.Contains(3));
+    EXPECT_TRUE(store.Contains(5));
+    EXPECT_FALSE(store.Contains(6));
+    EXPECT_EQ(5, store.GetPointCount());
+
+    auto&& check = [](const vector<utility::Point>& expected, const vector<utility::Point>& actual) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_NEAR(expected[i].lon_, actual[i].lon_, 0.000001f);
+            EXPECT_NEAR(expected[i].lat_, actual[i].lat_, 0.000001f);
+        }
+    };
+    check(first, store.GetGeometry(2));
+    check(second, store.GetGeometry(5));
+    EXPECT_TRUE(store.GetGeometry(4).empty());
+}
+
+TEST(EdgeGeometryStoreTests, GeoJson) {
+    EdgeGeometryStore store{};
+    store.AddEdge(1, vector<utility::Point>{utility::Point{14.5f, 50.25f}, utility::Point{-0.0625f, 51.5f}});
+    string geojson{};
+    store.AppendGeoJson(geojson, 1);
+    EXPECT_EQ("{\"type\":\"LineString\",\"coordinates\":[[14.500000,50.250000],[-0.062500,51.500000]]}", geojson);
+}
+
+TEST(EdgeGeometryStoreTests, EdgesOutOfOrder) {
+    EdgeGeometryStore store{};
+    store.AddEdge(3, vector<utility::Point>{utility::Point{14.5f, 50.25f}, utility::Point{14.5f, 50.5f}});
+    EXPECT_THROW(store.AddEdge(3, vector<utility::Point>{utility::Point{14.5f, 50.25f}}), InvalidArgumentException);
+    EXPECT_THROW(store.AddEdge(1, vector<utility::Point>{utility::Point{14.5f, 50.25f}}), InvalidArgumentException);
+}
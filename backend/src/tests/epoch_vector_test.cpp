@@ -0,0 +1,58 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/utility/epoch_vector.h"
+#include "routing/utility/object_pool.h"
+#include "routing/types.h"
+
+#include <vector>
+using namespace std;
+using namespace routing;
+using namespace utility;
+
+struct TestValue {
+    int value;
+
+    TestValue() : value(-1) {}
+
+    TestValue(int v) : value(v) {}
+};
+
+TEST(EpochVectorTests, UntouchedValuesAreDefault) {
+    EpochVector<TestValue> values{};
+    EXPECT_FALSE(values.Contains(5));
+    EXPECT_EQ(-1, values[5].value);
+    EXPECT_TRUE(values.Contains(5));
+    values[1000] = TestValue{7};
+    EXPECT_EQ(7, values[1000].value);
+    EXPECT_EQ(-1, values.Get(3, TestValue{}).value);
+}
+
+TEST(EpochVectorTests, ClearResetsValues) {
+    EpochVector<TestValue> values{};
+    values[2] = TestValue{4};
+    values[3] = TestValue{5};
+    values.Clear();
+    EXPECT_FALSE(values.Contains(2));
+    EXPECT_EQ(-1, values.Get(2, TestValue{}).value);
+    EXPECT_EQ(-1, values[3].value);
+    values[2] = TestValue{6};
+    EXPECT_EQ(6, values[2].value);
+}
+
+TEST(ObjectPoolTests, ObjectsAreReused) {
+    ObjectPool<vector<int>> pool{};
+    vector<int>* first = nullptr;
+    {
+        auto&& object = pool.Acquire();
+        object->push_back(1);
+        first = object.get();
+        auto&& other_object = pool.Acquire();
+        EXPECT_NE(first, other_object.get());
+    }
+    EXPECT_EQ(2, pool.GetSize());
+    auto&& object = pool.Acquire();
+    EXPECT_EQ(1, pool.GetSize());
+    auto&& other_object = pool.Acquire();
+    EXPECT_TRUE(object.get() == first || other_object.get() == first);
+    EXPECT_EQ(0, pool.GetSize());
+}
@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/adjacency_list_graph.h"
+#include "routing/edges/basic_edge.h"
+#include "routing/algorithm.h"
+#include "routing/vertices/basic_vertex.h"
+#include "routing/query/dijkstra.h"
+#include "routing/bidirectional_graph.h"
+#include "routing/query/bidirectional_dijkstra.h"
+#include "routing/preprocessing/graph_contractor.h"
+#include "routing/edges/ch_edge.h"
+#include "routing/ch_search_graph.h"
+#include "routing/vertices/ch_vertex.h"
+#include "routing/edge_ranges/vector_edge_range.h"
+#include "routing/edge_ranges/iterator_edge_range.h"
+#include "routing/edges/length_source.h"
+#include "routing/types.h"
+#include "tests/graph_test.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace routing;
+using namespace query;
+using namespace preprocessing;
+using BaseEdge = BasicEdge<NumberLengthSource>;
+using BaseGraph = AdjacencyListGraph<BasicVertex<BaseEdge, VectorEdgeRange<BaseEdge>>, BaseEdge>;
+using Edge = CHEdge<NumberLengthSource>;
+using G = BidirectionalGraph<AdjacencyListGraph<CHVertex<Edge, VectorEdgeRange<Edge>>, Edge>>;
+using SearchGraph = CHSearchGraph<CHVertex<Edge, IteratorEdgeRange<Edge, std::vector<Edge>::iterator>>, Edge>;
+
+class GraphContractorParallelTests : public testing::Test {
+protected:
+    static const unsigned_id_type kRows = 6;
+    static const unsigned_id_type kColumns = 7;
+
+    BaseGraph base_graph_;
+    unsigned_id_type max_edge_id_;
+
+    void SetUp() override {
+        unsigned_id_type uid = TestOnewayGrid(kRows, kColumns, 0, [&](unsigned_id_type uid, unsigned_id_type from, unsigned_id_type to, float length, bool twoway) {
+            base_graph_.AddEdge(BaseEdge{uid, from, to, length, twoway ? BaseEdge::EdgeType::twoway : BaseEdge::EdgeType::forward});
+        });
+        max_edge_id_ = uid - 1;
+    }
+
+    G CreateContractedGraph(size_t thread_count) {
+        G g{};
+        base_graph_.ForEachEdge([&](BaseEdge& edge) {
+            // Twoway edges are stored in both directions in the base graph.
+            if (edge.IsTwoway() && edge.get_from() > edge.get_to()) {
+                return;
+            }
+            g.AddEdge(Edge{edge.get_uid(), edge.get_from(), edge.get_to(), edge.get_length(), edge.IsTwoway() ? Edge::EdgeType::twoway : Edge::EdgeType::forward});
+        });
+        GraphContractor<G> contractor{g, ContractionParameters{5, 190, 120, 0, thread_count}, max_edge_id_ + 1};
+        contractor.ContractGraph();
+        return g;
+    }
+};
+
+TEST_F(GraphContractorParallelTests, RoutesAreShortest) {
+    G g = CreateContractedGraph(4);
+    SearchGraph search_graph{};
+    search_graph.Load(g);
+    for (unsigned_id_type source = 1; source <= kRows * kColumns; ++source) {
+        for (unsigned_id_type target = 1; target <= kRows * kColumns; ++target) {
+            if (source == target) {
+                continue;
+            }
+            Dijkstra<BaseGraph> dijkstra{base_graph_};
+            dijkstra.Run(source, target);
+            float expected_length = dijkstra.GetPathLength(target);
+
+            Algorithm<BidirectionalDijkstra<SearchGraph>> alg{search_graph};
+            alg.Run(source, target);
+            vector<Edge> route = alg.GetRoute();
+            float route_length = 0;
+            for (auto&& edge : route) {
+                EXPECT_FALSE(edge.IsShortcut());
+                route_length += edge.get_length();
+            }
+            EXPECT_NEAR(expected_length, route_length, 1e-3) << "Route from " << source << " to " << target;
+        }
+    }
+}
+
+TEST_F(GraphContractorParallelTests, ContractionDoesNotDependOnThreadCount) {
+    G two_threads_graph = CreateContractedGraph(2);
+    G four_threads_graph = CreateContractedGraph(4);
+    EXPECT_EQ(two_threads_graph.GetEdgeCount(), four_threads_graph.GetEdgeCount());
+    for (unsigned_id_type vertex_id = 1; vertex_id <= kRows * kColumns; ++vertex_id) {
+        EXPECT_TRUE(four_threads_graph.GetVertex(vertex_id).IsContracted());
+        EXPECT_EQ(two_threads_graph.GetVertex(vertex_id).get_ordering_rank(), four_threads_graph.GetVertex(vertex_id).get_ordering_rank());
+    }
+}
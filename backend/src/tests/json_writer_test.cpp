@@ -0,0 +1,60 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/utility/json_writer.h"
+
+#include <string>
+using namespace std;
+using namespace routing;
+using namespace utility;
+
+TEST(JsonWriterTests, CommasBetweenValues) {
+    string out{};
+    JsonWriter writer{out};
+    writer.BeginObject();
+    writer.Key("length");
+    writer.Number(12.5);
+    writer.Key("alternatives");
+    writer.BeginArray();
+    writer.BeginObject();
+    writer.Key("length");
+    writer.Number(3);
+    writer.EndObject();
+    writer.BeginObject();
+    writer.EndObject();
+    writer.EndArray();
+    writer.Key("ok");
+    writer.String("true");
+    writer.EndObject();
+    EXPECT_EQ("{\"length\":12.5,\"alternatives\":[{\"length\":3},{}],\"ok\":\"true\"}", out);
+}
+
+TEST(JsonWriterTests, NullsInArray) {
+    string out{};
+    JsonWriter writer{out};
+    writer.BeginArray();
+    writer.Number(1);
+    writer.Null();
+    writer.Number(2);
+    writer.EndArray();
+    EXPECT_EQ("[1,null,2]", out);
+}
+
+TEST(JsonWriterTests, StringIsEscaped) {
+    string geometry = "[{\"type\":\"LineString\"}]\\\n";
+    string out{};
+    JsonWriter writer{out};
+    writer.String(geometry);
+    EXPECT_EQ("\"[{\\\"type\\\":\\\"LineString\\\"}]\\\\\\u000a\"", out);
+    EXPECT_EQ(out.size() - 2, JsonWriter::GetEscapedSize(geometry));
+}
+
+TEST(JsonWriterTests, ReserveAllocatesOnce) {
+    string geometry(1000, 'a');
+    geometry += "\"";
+    string out{};
+    JsonWriter writer{out};
+    writer.Reserve(JsonWriter::GetEscapedSize(geometry) + 2);
+    size_t capacity = out.capacity();
+    writer.String(geometry);
+    EXPECT_EQ(capacity, out.capacity());
+}
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/utility/lru_cache.h"
+
+#include <memory>
+#include <vector>
+#include <thread>
+using namespace std;
+using namespace routing;
+using namespace utility;
+
+using IntCache = ShardedLruCache<int, int>;
+
+TEST(LruCacheTests, GetReturnsPutValue) {
+    IntCache cache{100, 1};
+    cache.Put(1, make_shared<const int>(10), 10);
+    cache.Put(2, make_shared<const int>(20), 10);
+    EXPECT_EQ(10, *cache.Get(1));
+    EXPECT_EQ(20, *cache.Get(2));
+    EXPECT_EQ(nullptr, cache.Get(3));
+    EXPECT_EQ(2, cache.GetHitCount());
+    EXPECT_EQ(1, cache.GetMissCount());
+    EXPECT_EQ(20, cache.GetSize());
+}
+
+TEST(LruCacheTests, LeastRecentlyUsedValueIsRemoved) {
+    IntCache cache{30, 1};
+    cache.Put(1, make_shared<const int>(10), 10);
+    cache.Put(2, make_shared<const int>(20), 10);
+    cache.Put(3, make_shared<const int>(30), 10);
+    cache.Get(1);
+    cache.Put(4, make_shared<const int>(40), 10);
+    EXPECT_EQ(nullptr, cache.Get(2));
+    EXPECT_EQ(10, *cache.Get(1));
+    EXPECT_EQ(30, *cache.Get(3));
+    EXPECT_EQ(40, *cache.Get(4));
+    EXPECT_EQ(30, cache.GetSize());
+}
+
+TEST(LruCacheTests, ReplacedValueUpdatesSize) {
+    IntCache cache{30, 1};
+    cache.Put(1, make_shared<const int>(10), 10);
+    cache.Put(1, make_shared<const int>(11), 25);
+    EXPECT_EQ(11, *cache.Get(1));
+    EXPECT_EQ(1, cache.GetEntryCount());
+    EXPECT_EQ(25, cache.GetSize());
+}
+
+TEST(LruCacheTests, OversizedValueIsNotCached) {
+    IntCache cache{40, 4};
+    cache.Put(1, make_shared<const int>(10), 11);
+    EXPECT_EQ(nullptr, cache.Get(1));
+    IntCache disabled{0};
+    disabled.Put(1, make_shared<const int>(10), 0);
+    EXPECT_EQ(nullptr, disabled.Get(1));
+    EXPECT_EQ(0, disabled.GetEntryCount());
+}
+
+TEST(LruCacheTests, RemovedValueOutlivesCache) {
+    IntCache cache{10, 1};
+    cache.Put(1, make_shared<const int>(10), 10);
+    auto&& value = cache.Get(1);
+    cache.Clear();
+    EXPECT_EQ(nullptr, cache.Get(1));
+    EXPECT_EQ(10, *value);
+}
+
+TEST(LruCacheTests, ConcurrentCallers) {
+    IntCache cache{1000, 4};
+    vector<thread> callers{};
+    for (int c = 0; c < 4; ++c) {
+        callers.emplace_back([&, c]() {
+            for (int i = 0; i < 1000; ++i) {
+                int key = c * 1000 + i % 50;
+                auto&& value = cache.Get(key);
+                if (value) {
+                    EXPECT_EQ(key, *value);
+                } else {
+                    cache.Put(key, make_shared<const int>(key), 1);
+                }
+            }
+        });
+    }
+    for (auto&& caller : callers) {
+        caller.join();
+    }
+    EXPECT_EQ(4000, cache.GetHitCount() + cache.GetMissCount());
+    EXPECT_LE(cache.GetSize(), 1000);
+}
@@ -0,0 +1,172 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/adjacency_list_graph.h"
+#include "routing/edges/basic_edge.h"
+#include "routing/vertices/basic_vertex.h"
+#include "routing/query/dijkstra.h"
+#include "routing/query/many_to_many.h"
+#include "routing/query/distance_table.h"
+#include "routing/query/endpoint_algorithm_policy.h"
+#include "routing/query/edge_range_policy.h"
+#include "routing/bidirectional_graph.h"
+#include "routing/preprocessing/graph_contractor.h"
+#include "routing/edges/ch_edge.h"
+#include "routing/ch_search_graph.h"
+#include "routing/compact_ch_search_graph.h"
+#include "routing/routing_graph.h"
+#include "routing/vertices/ch_vertex.h"
+#include "routing/edge_ranges/vector_edge_range.h"
+#include "routing/edge_ranges/iterator_edge_range.h"
+#include "routing/edges/length_source.h"
+#include "routing/utility/deadline.h"
+#include "routing/exception.h"
+#include "routing/types.h"
+#include "tests/graph_test.h"
+
+#include <vector>
+
+using namespace std;
+using namespace routing;
+using namespace query;
+using namespace preprocessing;
+using BaseEdge = BasicEdge<NumberLengthSource>;
+using BaseGraph = AdjacencyListGraph<BasicVertex<BaseEdge, VectorEdgeRange<BaseEdge>>, BaseEdge>;
+using Edge = CHEdge<NumberLengthSource>;
+using G = BidirectionalGraph<AdjacencyListGraph<CHVertex<Edge, VectorEdgeRange<Edge>>, Edge>>;
+using SearchGraph = CHSearchGraph<CHVertex<Edge, IteratorEdgeRange<Edge, std::vector<Edge>::iterator>>, Edge>;
+using CompactGraph = CompactCHSearchGraph<Edge>;
+
+class ManyToManyTests : public testing::Test {
+protected:
+    static const unsigned_id_type kRows = 5;
+    static const unsigned_id_type kColumns = 6;
+
+    BaseGraph base_graph_;
+    G contracted_graph_;
+    SearchGraph search_graph_;
+    vector<unsigned_id_type> vertices_;
+
+    void SetUp() override {
+        G& g = contracted_graph_;
+        unsigned_id_type uid = TestOnewayGrid(kRows, kColumns, 0, [&](unsigned_id_type uid, unsigned_id_type from, unsigned_id_type to, float length, bool twoway) {
+            base_graph_.AddEdge(BaseEdge{uid, from, to, length, twoway ? BaseEdge::EdgeType::twoway : BaseEdge::EdgeType::forward});
+            g.AddEdge(Edge{uid, from, to, length, twoway ? Edge::EdgeType::twoway : Edge::EdgeType::forward});
+        });
+        for (unsigned_id_type row = 0; row < kRows; ++row) {
+            for (unsigned_id_type column = 0; column < kColumns; ++column) {
+                vertices_.push_back(GetVertex(row, column));
+            }
+        }
+        GraphContractor<G> contractor{g, ContractionParameters{5, 190, 120, 0, 1}, uid};
+        contractor.ContractGraph();
+        search_graph_.Load(g);
+    }
+
+    static unsigned_id_type GetVertex(unsigned_id_type row, unsigned_id_type column) {
+        return 1 + row * kColumns + column;
+    }
+
+    float GetExpectedDistance(unsigned_id_type source, unsigned_id_type target) {
+        Dijkstra<BaseGraph> dijkstra{base_graph_};
+        dijkstra.Run(source, [=](BaseGraph::Vertex* v) { return v->get_uid() == target; }, [](BaseGraph::Vertex*) { return false; });
+        return dijkstra.GetPathLength(target);
+    }
+
+    template <typename Algorithm>
+    void ExpectShortestDistances(Algorithm& alg, const vector<unsigned_id_type>& sources, const vector<unsigned_id_type>& targets) {
+        alg.Run(sources, targets);
+        auto&& distances = alg.GetDistances();
+        ASSERT_EQ(sources.size() * targets.size(), distances.size());
+        for (size_t i = 0; i < sources.size(); ++i) {
+            for (size_t j = 0; j < targets.size(); ++j) {
+                EXPECT_NEAR(GetExpectedDistance(sources[i], targets[j]), distances[i * targets.size() + j], 1e-3)
+                    << "Distance from " << sources[i] << " to " << targets[j];
+            }
+        }
+    }
+};
+
+TEST_F(ManyToManyTests, ContractionHierarchiesAllPairs) {
+    ManyToManyContractionHierarchies<SearchGraph> alg{search_graph_};
+    ExpectShortestDistances(alg, vertices_, vertices_);
+    EXPECT_LT(0, alg.GetBucketEntryCount());
+}
+
+TEST_F(ManyToManyTests, CompactGraphDifferentSourcesAndTargets) {
+    CompactGraph compact_graph{};
+    compact_graph.Load(contracted_graph_);
+    ManyToManyContractionHierarchies<CompactGraph> alg{compact_graph};
+    vector<unsigned_id_type> sources{GetVertex(0, 0), GetVertex(4, 5), GetVertex(2, 3), GetVertex(0, 0)};
+    vector<unsigned_id_type> targets{GetVertex(4, 0), GetVertex(1, 1), GetVertex(3, 4)};
+    ExpectShortestDistances(alg, sources, targets);
+}
+
+TEST_F(ManyToManyTests, DijkstraAllPairs) {
+    ManyToManyDijkstra<BaseGraph> alg{base_graph_};
+    ExpectShortestDistances(alg, vertices_, vertices_);
+}
+
+TEST_F(ManyToManyTests, EndpointVertices) {
+    RoutingGraph<SearchGraph> routing_graph{search_graph_};
+    EndpointAlgorithmPolicyContractionHierarchies<RoutingGraph<SearchGraph>, EdgeRangePolicyVectorIterator<Edge>> policy{
+        routing_graph, EdgeRangePolicyVectorIterator<Edge>{}};
+    // More endpoints than the routing graph scans so that they are looked up by their ids.
+    unsigned_id_type endpoint_id = search_graph_.GetMaxVertexId() + 1;
+    vector<unsigned_id_type> sources{};
+    vector<unsigned_id_type> targets{};
+    for (unsigned_id_type column = 0; column < kColumns; ++column) {
+        sources.push_back(endpoint_id);
+        policy.AddSource(vector<Edge>{Edge{100, endpoint_id, GetVertex(0, column), 1}}, endpoint_id);
+        ++endpoint_id;
+        targets.push_back(endpoint_id);
+        policy.AddTarget(vector<Edge>{Edge{101, endpoint_id, GetVertex(kRows - 1, column), 2}}, endpoint_id);
+        ++endpoint_id;
+    }
+    ManyToManyContractionHierarchies<RoutingGraph<SearchGraph>> alg{routing_graph};
+    alg.Run(sources, targets);
+    auto&& distances = alg.GetDistances();
+    for (unsigned_id_type i = 0; i < kColumns; ++i) {
+        for (unsigned_id_type j = 0; j < kColumns; ++j) {
+            float expected = 3 + GetExpectedDistance(GetVertex(0, i), GetVertex(kRows - 1, j));
+            EXPECT_NEAR(expected, distances[i * kColumns + j], 1e-3) << "Distance from column " << i << " to column " << j;
+        }
+    }
+}
+
+TEST(ManyToManyTestsNotFixture, UnreachableTarget) {
+    BaseGraph g{};
+    g.AddEdge(BaseEdge{0, 1, 2, 4});
+    g.AddEdge(BaseEdge{1, 3, 2, 4});
+    ManyToManyDijkstra<BaseGraph> alg{g};
+    alg.Run(vector<unsigned_id_type>{1}, vector<unsigned_id_type>{2, 3});
+    EXPECT_THAT(alg.GetDistances(), testing::ElementsAre(4, DistanceTable::kUnreachable));
+}
+
+TEST(ManyToManyTestsNotFixture, CancelledDeadlineStopsSearches) {
+    // Searches check the deadline once per Deadline::kCheckInterval settled vertices so the graph must be larger.
+    const unsigned_id_type rows = 40;
+    const unsigned_id_type columns = 40;
+    BaseGraph base_graph{};
+    G g{};
+    unsigned_id_type uid = TestOnewayGrid(rows, columns, 0, [&](unsigned_id_type uid, unsigned_id_type from, unsigned_id_type to, float length, bool twoway) {
+        base_graph.AddEdge(BaseEdge{uid, from, to, length, twoway ? BaseEdge::EdgeType::twoway : BaseEdge::EdgeType::forward});
+        g.AddEdge(Edge{uid, from, to, length, twoway ? Edge::EdgeType::twoway : Edge::EdgeType::forward});
+    });
+    GraphContractor<G> contractor{g, ContractionParameters{5, 190, 120, 0, 1}, uid};
+    contractor.ContractGraph();
+    SearchGraph search_graph{};
+    search_graph.Load(g);
+    vector<unsigned_id_type> vertices{};
+    for (unsigned_id_type vertex_id = 1; vertex_id <= rows * columns; ++vertex_id) {
+        vertices.push_back(vertex_id);
+    }
+    utility::Deadline deadline{};
+    deadline.Cancel();
+
+    ManyToManyContractionHierarchies<SearchGraph> ch{search_graph};
+    ch.SetDeadline(&deadline);
+    EXPECT_THROW(ch.Run(vertices, vertices), TimeoutException);
+    ManyToManyDijkstra<BaseGraph> dijkstra{base_graph};
+    dijkstra.SetDeadline(&deadline);
+    EXPECT_THROW(dijkstra.Run(vector<unsigned_id_type>{1}, vector<unsigned_id_type>{rows * columns}), TimeoutException);
+}
@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/utility/metrics.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+using namespace std;
+using namespace routing;
+using namespace utility;
+
+TEST(MetricsTests, HistogramBucketsAreCumulative) {
+    Histogram histogram{{1, 10, 100}};
+    histogram.Observe(0.5);
+    histogram.Observe(1);
+    histogram.Observe(50);
+    histogram.Observe(1000);
+    EXPECT_EQ(2, histogram.GetCumulativeCount(0));
+    EXPECT_EQ(2, histogram.GetCumulativeCount(1));
+    EXPECT_EQ(3, histogram.GetCumulativeCount(2));
+    EXPECT_EQ(4, histogram.GetCumulativeCount(3));
+    EXPECT_EQ(4, histogram.GetCount());
+    EXPECT_DOUBLE_EQ(1051.5, histogram.GetSum());
+}
+
+TEST(MetricsTests, ConcurrentObservations) {
+    Counter counter{};
+    Histogram histogram{{1}};
+    vector<thread> threads{};
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (size_t i = 0; i < 1000; ++i) {
+                counter.Increment();
+                histogram.Observe(2);
+            }
+        });
+    }
+    for (auto&& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(4000, counter.Get());
+    EXPECT_EQ(4000, histogram.GetCount());
+    EXPECT_DOUBLE_EQ(8000, histogram.GetSum());
+}
+
+TEST(MetricsTests, PrometheusTextFormat) {
+    Counter counter{};
+    counter.Increment(3);
+    Histogram histogram{{0.5}};
+    histogram.Observe(0.25);
+    ostringstream out{};
+    PrometheusWriter writer{out};
+    writer.WriteHeader("hits_total", "Hits.", "counter");
+    writer.WriteCounter("hits_total", "", counter);
+    writer.WriteHeader("duration_seconds", "Duration.", "histogram");
+    writer.WriteHistogram("duration_seconds", "stage=\"search\"", histogram);
+    string expected =
+        "# HELP hits_total Hits.\n"
+        "# TYPE hits_total counter\n"
+        "hits_total 3\n"
+        "# HELP duration_seconds Duration.\n"
+        "# TYPE duration_seconds histogram\n"
+        "duration_seconds_bucket{stage=\"search\",le=\"0.5\"} 1\n"
+        "duration_seconds_bucket{stage=\"search\",le=\"+Inf\"} 1\n"
+        "duration_seconds_sum{stage=\"search\"} 0.25\n"
+        "duration_seconds_count{stage=\"search\"} 1\n";
+    EXPECT_EQ(expected, out.str());
+}
@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/adjacency_list_graph.h"
+#include "routing/edges/basic_edge.h"
+#include "routing/vertices/basic_vertex.h"
+#include "routing/query/dijkstra.h"
+#include "routing/query/one_to_all.h"
+#include "routing/bidirectional_graph.h"
+#include "routing/preprocessing/graph_contractor.h"
+#include "routing/edges/ch_edge.h"
+#include "routing/ch_search_graph.h"
+#include "routing/compact_ch_search_graph.h"
+#include "routing/vertices/ch_vertex.h"
+#include "routing/edge_ranges/vector_edge_range.h"
+#include "routing/edge_ranges/iterator_edge_range.h"
+#include "routing/edges/length_source.h"
+#include "routing/utility/deadline.h"
+#include "routing/exception.h"
+#include "routing/types.h"
+#include "tests/graph_test.h"
+
+#include <vector>
+#include <limits>
+
+using namespace std;
+using namespace routing;
+using namespace query;
+using namespace preprocessing;
+using BaseEdge = BasicEdge<NumberLengthSource>;
+using BaseGraph = AdjacencyListGraph<BasicVertex<BaseEdge, VectorEdgeRange<BaseEdge>>, BaseEdge>;
+using Edge = CHEdge<NumberLengthSource>;
+using G = BidirectionalGraph<AdjacencyListGraph<CHVertex<Edge, VectorEdgeRange<Edge>>, Edge>>;
+using SearchGraph = CHSearchGraph<CHVertex<Edge, IteratorEdgeRange<Edge, std::vector<Edge>::iterator>>, Edge>;
+using CompactGraph = CompactCHSearchGraph<Edge>;
+
+class OneToAllTests : public testing::Test {
+protected:
+    static const unsigned_id_type kRows = 6;
+    static const unsigned_id_type kColumns = 5;
+
+    BaseGraph base_graph_;
+    G contracted_graph_;
+    SearchGraph search_graph_;
+
+    void SetUp() override {
+        unsigned_id_type uid = TestOnewayGrid(kRows, kColumns, 0, [&](unsigned_id_type uid, unsigned_id_type from, unsigned_id_type to, float length, bool twoway) {
+            base_graph_.AddEdge(BaseEdge{uid, from, to, length, twoway ? BaseEdge::EdgeType::twoway : BaseEdge::EdgeType::forward});
+            contracted_graph_.AddEdge(Edge{uid, from, to, length, twoway ? Edge::EdgeType::twoway : Edge::EdgeType::forward});
+        });
+        GraphContractor<G> contractor{contracted_graph_, ContractionParameters{5, 190, 120, 0, 1}, uid};
+        contractor.ContractGraph();
+        search_graph_.Load(contracted_graph_);
+    }
+
+    static unsigned_id_type GetVertex(unsigned_id_type row, unsigned_id_type column) {
+        return 1 + row * kColumns + column;
+    }
+
+    float GetExpectedCost(unsigned_id_type source, unsigned_id_type target, float max_cost) {
+        Dijkstra<BaseGraph> dijkstra{base_graph_};
+        dijkstra.Run(source, [=](BaseGraph::Vertex* v) { return v->get_uid() == target; }, [](BaseGraph::Vertex*) { return false; });
+        float cost = dijkstra.GetPathLength(target);
+        return cost <= max_cost ? cost : numeric_limits<float>::max();
+    }
+
+    template <typename Algorithm>
+    void ExpectShortestCosts(Algorithm& alg, const vector<unsigned_id_type>& sources, float max_cost) {
+        alg.Run(sources, max_cost);
+        for (size_t i = 0; i < sources.size(); ++i) {
+            for (unsigned_id_type target = 1; target <= kRows * kColumns; ++target) {
+                EXPECT_NEAR(GetExpectedCost(sources[i], target, max_cost), alg.GetCost(i, target), 1e-3)
+                    << "Cost from " << sources[i] << " to " << target;
+            }
+        }
+    }
+};
+
+TEST_F(OneToAllTests, PhastOneSource) {
+    Phast<SearchGraph> alg{search_graph_};
+    ExpectShortestCosts(alg, vector<unsigned_id_type>{GetVertex(2, 2)}, numeric_limits<float>::max());
+}
+
+TEST_F(OneToAllTests, PhastMoreSourcesInOneSweep) {
+    CompactGraph compact_graph{};
+    compact_graph.Load(contracted_graph_);
+    Phast<CompactGraph> alg{compact_graph};
+    vector<unsigned_id_type> sources{};
+    for (unsigned_id_type vertex_id = 1; vertex_id <= kRows * kColumns; vertex_id += 3) {
+        sources.push_back(vertex_id);
+    }
+    ExpectShortestCosts(alg, sources, numeric_limits<float>::max());
+}
+
+TEST_F(OneToAllTests, PhastMaxCost) {
+    Phast<SearchGraph> alg{search_graph_};
+    ExpectShortestCosts(alg, vector<unsigned_id_type>{GetVertex(0, 0), GetVertex(5, 4)}, 15);
+    // The workspace keeps the sweep order for the next run.
+    ExpectShortestCosts(alg, vector<unsigned_id_type>{GetVertex(3, 1)}, 20);
+}
+
+TEST_F(OneToAllTests, PhastSourceEdges) {
+    Phast<SearchGraph> alg{search_graph_};
+    unsigned_id_type endpoint_id = search_graph_.GetMaxVertexId() + 1;
+    alg.Run(vector<vector<Edge>>{{Edge{100, endpoint_id, GetVertex(1, 1), 2}, Edge{101, endpoint_id, GetVertex(1, 2), 1}}});
+    for (unsigned_id_type target = 1; target <= kRows * kColumns; ++target) {
+        float max = numeric_limits<float>::max();
+        float expected = min(2 + GetExpectedCost(GetVertex(1, 1), target, max), 1 + GetExpectedCost(GetVertex(1, 2), target, max));
+        EXPECT_NEAR(expected, alg.GetCost(0, target), 1e-3) << "Cost to " << target;
+    }
+}
+
+TEST_F(OneToAllTests, DijkstraMaxCost) {
+    OneToAllDijkstra<BaseGraph> alg{base_graph_};
+    ExpectShortestCosts(alg, vector<unsigned_id_type>{GetVertex(0, 0), GetVertex(5, 4)}, 15);
+}
+
+TEST(OneToAllTestsNotFixture, CancelledDeadlineStopsSearches) {
+    // Searches check the deadline once per Deadline::kCheckInterval vertices so the graph must be larger.
+    const unsigned_id_type rows = 40;
+    const unsigned_id_type columns = 40;
+    BaseGraph base_graph{};
+    G g{};
+    unsigned_id_type uid = TestOnewayGrid(rows, columns, 0, [&](unsigned_id_type uid, unsigned_id_type from, unsigned_id_type to, float length, bool twoway) {
+        base_graph.AddEdge(BaseEdge{uid, from, to, length, twoway ? BaseEdge::EdgeType::twoway : BaseEdge::EdgeType::forward});
+        g.AddEdge(Edge{uid, from, to, length, twoway ? Edge::EdgeType::twoway : Edge::EdgeType::forward});
+    });
+    GraphContractor<G> contractor{g, ContractionParameters{5, 190, 120, 0, 1}, uid};
+    contractor.ContractGraph();
+    SearchGraph search_graph{};
+    search_graph.Load(g);
+    utility::Deadline deadline{};
+    deadline.Cancel();
+
+    Phast<SearchGraph> phast{search_graph};
+    phast.SetDeadline(&deadline);
+    EXPECT_THROW(phast.Run(vector<unsigned_id_type>{1}), TimeoutException);
+    OneToAllDijkstra<BaseGraph> dijkstra{base_graph};
+    dijkstra.SetDeadline(&deadline);
+    EXPECT_THROW(dijkstra.Run(vector<unsigned_id_type>{1}), TimeoutException);
+
+    Phast<SearchGraph> unlimited_phast{search_graph};
+    unlimited_phast.Run(vector<unsigned_id_type>{1});
+    EXPECT_NE(Phast<SearchGraph>::kUnreachable, unlimited_phast.GetCost(0, rows * columns));
+}
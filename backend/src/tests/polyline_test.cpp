@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/spatial/polyline.h"
+#include "routing/utility/point.h"
+
+#include <string>
+#include <vector>
+using namespace std;
+using namespace routing;
+using namespace spatial;
+
+TEST(PolylineTests, EncodeReferenceExample) {
+    vector<utility::Point> points{utility::Point{-120.2f, 38.5f}, utility::Point{-120.95f, 40.7f}, utility::Point{-126.453f, 43.252f}};
+    EXPECT_EQ("_p~iF~ps|U_ulLnnqC_mqNvxq`@", EncodePolyline(points, 5));
+}
+
+TEST(PolylineTests, DecodeEncodedPoints) {
+    vector<utility::Point> points{utility::Point{14.421254f, 50.087465f}, utility::Point{14.421301f, 50.087512f}, utility::Point{14.4190f, 50.0801f}};
+    auto&& decoded = DecodePolyline(EncodePolyline(points, 6), 6);
+    ASSERT_EQ(points.size(), decoded.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_NEAR(points[i].lon_, decoded[i].lon_, 1e-5);
+        EXPECT_NEAR(points[i].lat_, decoded[i].lat_, 1e-5);
+    }
+}
+
+TEST(PolylineTests, AppendSharesJoinPoint) {
+    utility::Point a{14.42f, 50.08f};
+    utility::Point b{14.43f, 50.09f};
+    utility::Point c{14.41f, 50.1f};
+    string polyline = EncodePolyline({a, b}, 5);
+    AppendPolyline(polyline, DecodePolylineEnd(polyline), EncodePolyline({b, c}, 5));
+    EXPECT_EQ(EncodePolyline({a, b, c}, 5), polyline);
+}
+
+TEST(PolylineTests, DecodeEnd) {
+    utility::Point a{14.42f, 50.08f};
+    utility::Point b{14.43f, 50.09f};
+    auto&& end = DecodePolylineEnd(EncodePolyline({a, b}, 5));
+    EXPECT_EQ(5009000, end.lat);
+    EXPECT_EQ(1443000, end.lon);
+    EXPECT_EQ(0, DecodePolylineEnd("").lat);
+}
+
+TEST(PolylineTests, SimplifyRemovesClosePoints) {
+    // Points are about 111 m apart along a meridian, the middle ones deviate by a few meters.
+    vector<utility::Point> points{utility::Point{14.0f, 50.0f}, utility::Point{14.00003f, 50.001f}, utility::Point{14.0f, 50.002f},
+        utility::Point{14.01f, 50.003f}, utility::Point{14.0f, 50.004f}};
+    auto&& simplified = SimplifyLine(points, 10);
+    ASSERT_EQ(4, simplified.size());
+    EXPECT_EQ(points[0].lat_, simplified[0].lat_);
+    EXPECT_EQ(points[2].lat_, simplified[1].lat_);
+    EXPECT_EQ(points[3].lat_, simplified[2].lat_);
+    EXPECT_EQ(points[4].lat_, simplified[3].lat_);
+    EXPECT_EQ(points.size(), SimplifyLine(points, 0).size());
+    EXPECT_EQ(2, SimplifyLine(points, 10000).size());
+}
+
+TEST(PolylineTests, ZoomTolerance) {
+    EXPECT_NEAR(156543.0, GetZoomTolerance(0), 1);
+    EXPECT_NEAR(GetZoomTolerance(10) / 2, GetZoomTolerance(11), 1e-9);
+}
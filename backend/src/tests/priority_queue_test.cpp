@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/utility/priority_queue.h"
+#include "routing/types.h"
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <unordered_map>
+using namespace std;
+using namespace routing;
+using namespace utility;
+
+template <typename Q>
+class PriorityQueueTests : public testing::Test {
+protected:
+    Q queue_;
+
+    vector<unsigned_id_type> PopAll() {
+        vector<unsigned_id_type> vertices{};
+        while (!queue_.Empty()) {
+            vertices.push_back(queue_.Pop().vertex_id);
+        }
+        return vertices;
+    }
+};
+
+using PriorityQueueTypes = testing::Types<IndexedDaryHeap<>, IndexedDaryHeap<2>, IndexedDaryHeap<8>, LazyBinaryHeap>;
+TYPED_TEST_SUITE(PriorityQueueTests, PriorityQueueTypes);
+
+TYPED_TEST(PriorityQueueTests, PopsInCostOrder) {
+    this->queue_.Push(5, 3.0f);
+    this->queue_.Push(2, 1.0f);
+    this->queue_.Push(9, 7.0f);
+    this->queue_.Push(1, 2.0f);
+    EXPECT_EQ(2, this->queue_.Top().vertex_id);
+    EXPECT_THAT(this->PopAll(), testing::ElementsAre(2, 1, 5, 9));
+}
+
+TYPED_TEST(PriorityQueueTests, DecreaseKey) {
+    this->queue_.Push(1, 5.0f);
+    this->queue_.Push(2, 4.0f);
+    this->queue_.Push(3, 3.0f);
+    this->queue_.Push(1, 1.0f);
+    EXPECT_TRUE(this->queue_.Contains(1));
+    QueueMember top = this->queue_.Pop();
+    EXPECT_EQ(1, top.vertex_id);
+    EXPECT_FLOAT_EQ(1.0f, top.cost);
+    EXPECT_FALSE(this->queue_.Contains(1));
+    EXPECT_THAT(this->PopAll(), testing::ElementsAre(3, 2));
+}
+
+TYPED_TEST(PriorityQueueTests, ClearedQueueIsReusable) {
+    this->queue_.Push(1, 5.0f);
+    this->queue_.Push(7, 4.0f);
+    this->queue_.Clear();
+    EXPECT_TRUE(this->queue_.Empty());
+    EXPECT_FALSE(this->queue_.Contains(7));
+    this->queue_.Push(7, 2.0f);
+    this->queue_.Push(3, 1.0f);
+    EXPECT_THAT(this->PopAll(), testing::ElementsAre(3, 7));
+}
+
+TYPED_TEST(PriorityQueueTests, RandomOperationsKeepHeapOrder) {
+    mt19937 generator{42};
+    uniform_int_distribution<unsigned_id_type> vertex_distribution{1, 500};
+    uniform_real_distribution<float> cost_distribution{0.0f, 1000.0f};
+    unordered_map<unsigned_id_type, float> costs{};
+    for (size_t i = 0; i < 3000; ++i) {
+        unsigned_id_type vertex = vertex_distribution(generator);
+        float cost = cost_distribution(generator);
+        auto&& it = costs.find(vertex);
+        if (it == costs.end() || cost < it->second) {
+            costs[vertex] = cost;
+            this->queue_.Push(vertex, cost);
+        }
+    }
+    float previous_cost = 0;
+    size_t popped = 0;
+    while (!this->queue_.Empty()) {
+        QueueMember member = this->queue_.Pop();
+        EXPECT_LE(previous_cost, member.cost);
+        EXPECT_FLOAT_EQ(costs[member.vertex_id], member.cost);
+        previous_cost = member.cost;
+        ++popped;
+    }
+    EXPECT_EQ(costs.size(), popped);
+}
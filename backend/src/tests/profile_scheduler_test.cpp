@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/preprocessing/profile_scheduler.h"
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+using namespace std;
+using namespace routing;
+using namespace preprocessing;
+
+TEST(ProfileSchedulerTests, WorkerCountIsLimitedByMemoryBudget) {
+    EXPECT_EQ(4, ProfileScheduler(4, 0, 100).GetWorkerCount());
+    EXPECT_EQ(2, ProfileScheduler(4, 250, 100).GetWorkerCount());
+    EXPECT_EQ(1, ProfileScheduler(4, 50, 100).GetWorkerCount());
+    EXPECT_EQ(1, ProfileScheduler(0, 0, 100).GetWorkerCount());
+}
+
+TEST(ProfileSchedulerTests, EachProfileRunsOnce) {
+    ProfileScheduler scheduler{3, 0, 0};
+    vector<atomic<size_t>> runs(20);
+    vector<atomic<bool>> busy_workers(scheduler.GetWorkerCount());
+    atomic<bool> concurrent_worker{false};
+    scheduler.Run(runs.size(), [&](size_t worker, size_t profile) {
+        if (busy_workers[worker].exchange(true)) {
+            concurrent_worker = true;
+        }
+        ++runs[profile];
+        busy_workers[worker] = false;
+    });
+    for (auto&& run_count : runs) {
+        EXPECT_EQ(1, run_count);
+    }
+    EXPECT_FALSE(concurrent_worker);
+}
+
+TEST(ProfileSchedulerTests, ExceptionIsRethrown) {
+    ProfileScheduler scheduler{2, 0, 0};
+    EXPECT_THROW(scheduler.Run(10, [](size_t worker, size_t profile) {
+        if (profile == 3) {
+            throw runtime_error{"Preprocessing failed."};
+        }
+    }), runtime_error);
+}
@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/query/route.h"
+#include "routing/edges/basic_edge.h"
+#include "routing/edges/length_source.h"
+#include "routing/profile/preference_index.h"
+#include "routing/types.h"
+
+#include <vector>
+#include <string>
+
+using namespace std;
+using namespace routing;
+using namespace query;
+using Edge = BasicEdge<NumberLengthSource>;
+
+/**
+ * Index whose original value of an edge is its uid.
+ */
+class UidIndex : public profile::PreferenceIndex {
+public:
+    void Load(database::DatabaseHelper& d, const std::string& index_table) override {}
+
+    void Create(database::DatabaseHelper& d, const std::vector<std::pair<unsigned_id_type, float>>& index_values, const std::string& index_table) const override {}
+
+    float Get(unsigned_id_type uid) const override {
+        return uid;
+    }
+
+    float GetOriginal(unsigned_id_type uid) const override {
+        return uid;
+    }
+
+    const std::string& GetName() const override {
+        return name_;
+    }
+
+private:
+    std::string name_ = "uid";
+
+    void Normalize() override {}
+};
+
+TEST(RouteTests, OneLegLengthSkipsEndpointEdges) {
+    UidIndex index{};
+    Route<Edge> route{vector<Edge>{Edge{1, 100, 2, 1}, Edge{10, 2, 3, 1}, Edge{20, 3, 4, 1}, Edge{2, 4, 101, 1}}, "[a,b,c,d]", 0.5};
+    EXPECT_FLOAT_EQ(30.5, route.GetLength(&index));
+    EXPECT_EQ(1, route.GetLegCount());
+}
+
+TEST(RouteTests, AppendedLegs) {
+    UidIndex index{};
+    Route<Edge> route{vector<Edge>{Edge{1, 100, 2, 1}, Edge{10, 2, 3, 1}, Edge{2, 3, 101, 1}}, "[a,b,c]", 0.5};
+    // Endpoint edges of each leg have their own ids that can be the same as ids of graph edges.
+    route.Append(Route<Edge>{vector<Edge>{Edge{10, 100, 3, 1}, Edge{30, 3, 4, 1}, Edge{40, 4, 5, 1}, Edge{11, 5, 101, 1}}, "[d,e,f,g]", 2});
+    route.Append(Route<Edge>{vector<Edge>{Edge{1, 100, 5, 1}, Edge{2, 5, 101, 1}}, "[h,i]", 1});
+    EXPECT_FLOAT_EQ(10 + 30 + 40 + 3.5, route.GetLength(&index));
+    EXPECT_EQ(3, route.GetLegCount());
+    EXPECT_EQ("[a,b,c,d,e,f,g,h,i]", route.get_geometry());
+}
+
+TEST(RouteTests, AppendedPolylineLegs) {
+    vector<utility::Point> points{utility::Point{14.42f, 50.08f}, utility::Point{14.43f, 50.09f}, utility::Point{14.41f, 50.1f},
+        utility::Point{14.4f, 50.11f}};
+    Route<Edge> route{vector<Edge>{Edge{1, 100, 101, 1}}, spatial::EncodePolyline({points[0], points[1]}, 5), 0, GeometryFormat::kPolyline};
+    route.Append(Route<Edge>{vector<Edge>{Edge{1, 100, 101, 1}}, spatial::EncodePolyline({points[1], points[2]}, 5), 0, GeometryFormat::kPolyline});
+    route.Append(Route<Edge>{vector<Edge>{Edge{1, 100, 101, 1}}, spatial::EncodePolyline({points[2], points[3]}, 5), 0, GeometryFormat::kPolyline});
+    EXPECT_EQ(spatial::EncodePolyline(points, 5), route.get_geometry());
+}
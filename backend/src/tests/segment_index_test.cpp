@@ -0,0 +1,105 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/spatial/segment_index.h"
+#include "routing/spatial/geometry.h"
+#include "routing/spatial/edge_geometry_store.h"
+#include "routing/utility/point.h"
+#include "routing/exception.h"
+#include "routing/types.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+using namespace std;
+using namespace routing;
+using namespace spatial;
+
+/**
+ * Small street network around a square. Edge 3 has a bend in the middle.
+ */
+static SegmentIndex CreateTestSegmentIndex() {
+    auto&& store = std::make_shared<EdgeGeometryStore>();
+    store->AddEdge(1, vector<utility::Point>{utility::Point{14.40f, 50.00f}, utility::Point{14.41f, 50.00f}});
+    store->AddEdge(2, vector<utility::Point>{utility::Point{14.41f, 50.00f}, utility::Point{14.41f, 50.01f}});
+    store->AddEdge(3, vector<utility::Point>{utility::Point{14.41f, 50.01f}, utility::Point{14.405f, 50.015f}, utility::Point{14.40f, 50.01f}});
+    store->AddEdge(4, vector<utility::Point>{utility::Point{14.40f, 50.00f}, utility::Point{14.40f, 50.01f}});
+    store->AddEdge(5, vector<utility::Point>{utility::Point{14.40f, 50.01f}, utility::Point{14.35f, 50.01f}});
+    SegmentIndex index{store};
+    index.AddEdge(1, 1, 2);
+    index.AddEdge(2, 2, 3);
+    index.AddEdge(3, 3, 4);
+    index.AddEdge(4, 1, 4);
+    index.AddEdge(5, 4, 5);
+    index.Build();
+    return index;
+}
+
+TEST(SegmentIndexTests, ParseWktLineString) {
+    vector<utility::Point> points = ParseWktLineString("LINESTRING(14.4 50.1,14.5 50.25, 14.75 50)");
+    ASSERT_EQ(3, points.size());
+    EXPECT_FLOAT_EQ(14.4f, points[0].lon_);
+    EXPECT_FLOAT_EQ(50.1f, points[0].lat_);
+    EXPECT_FLOAT_EQ(14.5f, points[1].lon_);
+    EXPECT_FLOAT_EQ(50.25f, points[1].lat_);
+    EXPECT_FLOAT_EQ(14.75f, points[2].lon_);
+    EXPECT_FLOAT_EQ(50.0f, points[2].lat_);
+    EXPECT_THROW(ParseWktLineString("LINESTRING 14.4 50.1"), ParseException);
+}
+
+TEST(SegmentIndexTests, GeoJsonLineString) {
+    string geojson = MakeGeoJsonLineString(vector<utility::Point>{utility::Point{14.5f, 50.25f}, utility::Point{14.75f, 50.0f}});
+    EXPECT_EQ("{\"type\":\"LineString\",\"coordinates\":[[14.500000,50.250000],[14.750000,50.000000]]}", geojson);
+}
+
+TEST(SegmentIndexTests, ClosestEdgeIsSplitInTheMiddle) {
+    SegmentIndex index = CreateTestSegmentIndex();
+    EdgeSplit split = index.FindClosestEdge(utility::Point{14.4025f, 49.9995f});
+    EXPECT_EQ(1, split.uid);
+    EXPECT_EQ(1, split.from);
+    EXPECT_EQ(2, split.to);
+    EXPECT_NEAR(0.25f, split.from_segment_relative_length, 0.001f);
+    ASSERT_EQ(2, split.from_segment.size());
+    ASSERT_EQ(2, split.to_segment.size());
+    EXPECT_FLOAT_EQ(14.40f, split.from_segment.front().lon_);
+    EXPECT_NEAR(14.4025f, split.from_segment.back().lon_, 0.00001f);
+    EXPECT_NEAR(50.0f, split.from_segment.back().lat_, 0.00001f);
+    EXPECT_NEAR(14.4025f, split.to_segment.front().lon_, 0.00001f);
+    EXPECT_FLOAT_EQ(14.41f, split.to_segment.back().lon_);
+}
+
+TEST(SegmentIndexTests, SplitKeepsInnerPointsOfGeometry) {
+    SegmentIndex index = CreateTestSegmentIndex();
+    EdgeSplit split = index.FindClosestEdge(utility::Point{14.4040f, 50.0150f});
+    EXPECT_EQ(3, split.uid);
+    ASSERT_EQ(3, split.from_segment.size());
+    ASSERT_EQ(2, split.to_segment.size());
+    EXPECT_FLOAT_EQ(14.405f, split.from_segment[1].lon_);
+    EXPECT_FLOAT_EQ(50.015f, split.from_segment[1].lat_);
+    EXPECT_GT(split.from_segment_relative_length, 0.5f);
+    EXPECT_LT(split.from_segment_relative_length, 0.75f);
+}
+
+TEST(SegmentIndexTests, LocationOutsideOfIndexedArea) {
+    SegmentIndex index = CreateTestSegmentIndex();
+    EdgeSplit split = index.FindClosestEdge(utility::Point{14.20f, 50.02f});
+    EXPECT_EQ(5, split.uid);
+    EXPECT_FLOAT_EQ(0.0f, 1 - split.from_segment_relative_length);
+    EXPECT_FLOAT_EQ(14.35f, split.to_segment.front().lon_);
+
+    split = index.FindClosestEdge(utility::Point{14.60f, 50.005f});
+    EXPECT_EQ(2, split.uid);
+}
+
+TEST(SegmentIndexTests, GeometryStartsAtFromIntersection) {
+    SegmentIndex index = CreateTestSegmentIndex();
+    EXPECT_EQ(3, index.GetGeometryStart(3));
+    EXPECT_EQ(1, index.GetGeometryStart(4));
+    EXPECT_EQ(0, index.GetGeometryStart(6));
+}
+
+TEST(SegmentIndexTests, EmptyIndex) {
+    SegmentIndex index{std::make_shared<EdgeGeometryStore>()};
+    index.Build();
+    EXPECT_THROW(index.FindClosestEdge(utility::Point{14.40f, 50.00f}), RouteNotFoundException);
+}
@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/microbench/synthetic_graph.h"
+#include "routing/adjacency_list_graph.h"
+#include "routing/edges/basic_edge.h"
+#include "routing/vertices/basic_vertex.h"
+#include "routing/edge_ranges/vector_edge_range.h"
+#include "routing/edges/length_source.h"
+#include "routing/query/dijkstra.h"
+#include "routing/exception.h"
+
+#include <vector>
+using namespace std;
+using namespace routing;
+using namespace microbench;
+using Edge = BasicEdge<NumberLengthSource>;
+using G = AdjacencyListGraph<BasicVertex<Edge, VectorEdgeRange<Edge>>, Edge>;
+
+TEST(SyntheticGraphTests, GeneratedGraphsAreReproducible) {
+    for (auto&& kind : {GraphKind::kGrid, GraphKind::kRandomGeometric, GraphKind::kRoadLike}) {
+        SyntheticGraph graph = GenerateGraph(kind, 400, 7);
+        SyntheticGraph again = GenerateGraph(kind, 400, 7);
+        ASSERT_EQ(again.edges.size(), graph.edges.size());
+        EXPECT_EQ(again.vertex_count, graph.vertex_count);
+        for (size_t i = 0; i < graph.edges.size(); ++i) {
+            EXPECT_EQ(again.edges[i].from, graph.edges[i].from);
+            EXPECT_EQ(again.edges[i].to, graph.edges[i].to);
+            EXPECT_EQ(again.edges[i].length, graph.edges[i].length);
+        }
+        EXPECT_GT(graph.vertex_count, 300) << GetGraphKindName(kind);
+        EXPECT_EQ(kind, ParseGraphKind(GetGraphKindName(kind)));
+    }
+    EXPECT_THROW(ParseGraphKind("tree"), InvalidArgumentException);
+    SyntheticGraph grid = GenerateGridGraph(400, 7);
+    EXPECT_EQ(400, grid.vertex_count);
+    EXPECT_EQ(2 * 20 * 19, grid.edges.size());
+}
+
+TEST(SyntheticGraphTests, AllVerticesAreReachable) {
+    for (auto&& kind : {GraphKind::kRandomGeometric, GraphKind::kRoadLike}) {
+        SyntheticGraph graph = GenerateGraph(kind, 900, 3);
+        G g{};
+        graph.AddTo(g);
+        size_t directed_edge_count = 0;
+        for (auto&& edge : graph.edges) {
+            directed_edge_count += edge.twoway ? 2 : 1;
+        }
+        for (unsigned_id_type source : {unsigned_id_type{1}, static_cast<unsigned_id_type>(graph.vertex_count)}) {
+            query::Dijkstra<G> dijkstra{g};
+            dijkstra.Run(source, [](G::Vertex*) { return false; }, [](G::Vertex*) { return false; });
+            EXPECT_EQ(graph.vertex_count, dijkstra.GetSettledVertexCount()) << GetGraphKindName(kind);
+            // Each edge is relaxed once from its settled source vertex.
+            EXPECT_EQ(directed_edge_count, dijkstra.GetRelaxedEdgeCount());
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/utility/thread_pool.h"
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+using namespace std;
+using namespace routing;
+using namespace utility;
+
+TEST(ThreadPoolTests, EachIndexRunsOnce) {
+    ThreadPool pool{3};
+    vector<atomic<size_t>> runs(100);
+    pool.ParallelFor(runs.size(), [&](size_t i) {
+        ++runs[i];
+    });
+    for (auto&& run_count : runs) {
+        EXPECT_EQ(1, run_count);
+    }
+}
+
+TEST(ThreadPoolTests, ConcurrentCallers) {
+    ThreadPool pool{2};
+    vector<atomic<size_t>> runs(4 * 50);
+    vector<thread> callers{};
+    for (size_t c = 0; c < 4; ++c) {
+        callers.emplace_back([&, c]() {
+            pool.ParallelFor(50, [&](size_t i) {
+                ++runs[c * 50 + i];
+            });
+        });
+    }
+    for (auto&& caller : callers) {
+        caller.join();
+    }
+    for (auto&& run_count : runs) {
+        EXPECT_EQ(1, run_count);
+    }
+}
+
+TEST(ThreadPoolTests, WithoutWorkersCallerRunsAll) {
+    ThreadPool pool{0};
+    size_t sum = 0;
+    pool.ParallelFor(10, [&](size_t i) {
+        sum += i;
+    });
+    EXPECT_EQ(45, sum);
+    pool.ParallelFor(0, [&](size_t i) {
+        sum += 100;
+    });
+    EXPECT_EQ(45, sum);
+}
+
+TEST(ThreadPoolTests, ExceptionIsRethrown) {
+    ThreadPool pool{2};
+    EXPECT_THROW(pool.ParallelFor(10, [](size_t i) {
+        if (i == 3) {
+            throw runtime_error{"Route failed."};
+        }
+    }), runtime_error);
+}
+
+TEST(ThreadPoolTests, NestedParallelFor) {
+    ThreadPool pool{2};
+    vector<atomic<size_t>> runs(8 * 20);
+    // All workers can wait in inner calls while their helpers are queued.
+    pool.ParallelFor(8, [&](size_t i) {
+        pool.ParallelFor(20, [&](size_t j) {
+            ++runs[i * 20 + j];
+        });
+    });
+    for (auto&& run_count : runs) {
+        EXPECT_EQ(1, run_count);
+    }
+}
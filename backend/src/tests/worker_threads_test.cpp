@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "routing/utility/worker_threads.h"
+
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+using namespace std;
+using namespace routing;
+using namespace utility;
+
+TEST(WorkerThreadsTests, EachIndexRunsOnceWithoutConcurrentWorker) {
+    size_t worker_count = 4;
+    vector<atomic<size_t>> runs(100);
+    vector<atomic<bool>> busy_workers(worker_count);
+    atomic<bool> concurrent_worker{false};
+    RunOnWorkerThreads(worker_count, runs.size(), [&](size_t worker, size_t i) {
+        if (busy_workers[worker].exchange(true)) {
+            concurrent_worker = true;
+        }
+        ++runs[i];
+        busy_workers[worker] = false;
+    });
+    for (auto&& run_count : runs) {
+        EXPECT_EQ(1, run_count);
+    }
+    EXPECT_FALSE(concurrent_worker);
+}
+
+TEST(WorkerThreadsTests, SingleWorkerRunsInOrder) {
+    vector<size_t> indices{};
+    RunOnWorkerThreads(1, 5, [&](size_t worker, size_t i) {
+        EXPECT_EQ(0, worker);
+        indices.push_back(i);
+    });
+    EXPECT_THAT(indices, testing::ElementsAre(0, 1, 2, 3, 4));
+}
+
+TEST(WorkerThreadsTests, FirstExceptionIsRethrown) {
+    EXPECT_THROW(RunOnWorkerThreads(3, 1000, [&](size_t, size_t i) {
+        if (i == 5) {
+            throw runtime_error{"failed"};
+        }
+    }), runtime_error);
+}